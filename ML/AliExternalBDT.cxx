@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -36,11 +37,60 @@ AliExternalBDT::AliExternalBDT(std::string name) :
   fModelName{""},
   fCompiler{},
   fPredictor{},
+  fLibraryPath{""},
+  fThreadPredictors{},
   fOutSize{0u},
   fNumFeatures{0u}
 {
 }
 
+AliExternalBDT::AliExternalBDT(const AliExternalBDT &source) :
+  fBDTname{source.fBDTname},
+  fModel{source.fModel},
+  fModelPath{source.fModelPath},
+  fModelName{source.fModelName},
+  fCompiler{source.fCompiler},
+  fPredictor{source.fPredictor},
+  fLibraryPath{source.fLibraryPath},
+  fThreadPredictors{},
+  fOutSize{source.fOutSize},
+  fNumFeatures{source.fNumFeatures}
+{
+  if (!source.fThreadPredictors.empty())
+    CreateThreadPredictors(source.GetNumberOfThreadPredictors());
+}
+
+AliExternalBDT &AliExternalBDT::operator=(const AliExternalBDT &source) {
+  if (this == &source)
+    return *this;
+
+  FreeThreadPredictors();
+  fBDTname = source.fBDTname;
+  fModel = source.fModel;
+  fModelPath = source.fModelPath;
+  fModelName = source.fModelName;
+  fCompiler = source.fCompiler;
+  fPredictor = source.fPredictor;
+  fLibraryPath = source.fLibraryPath;
+  fOutSize = source.fOutSize;
+  fNumFeatures = source.fNumFeatures;
+  if (!source.fThreadPredictors.empty())
+    CreateThreadPredictors(source.GetNumberOfThreadPredictors());
+
+  return *this;
+}
+
+AliExternalBDT::~AliExternalBDT() {
+  FreeThreadPredictors();
+}
+
+void AliExternalBDT::FreeThreadPredictors() {
+  for (std::size_t iThread = 0; iThread < fThreadPredictors.size(); ++iThread) {
+    TreelitePredictorFree(fThreadPredictors[iThread]);
+  }
+  fThreadPredictors.clear();
+}
+
 
 bool AliExternalBDT::CompileAndLoadModelLibrary() {
   std::string path = GetUniquePath();
@@ -129,6 +179,8 @@ bool AliExternalBDT::LoadLightGBMModel(std::string path) {
 
 bool AliExternalBDT::LoadModelLibrary(std::string path) {
   const int status = TreelitePredictorLoad(path.data(), 1, &fPredictor);
+  fLibraryPath = path;
+  FreeThreadPredictors();
 
   TreelitePredictorQueryResultSizeSingleInst(fPredictor, &fOutSize);
   TreelitePredictorQueryNumFeature(fPredictor, &fNumFeatures);
@@ -159,3 +211,59 @@ bool AliExternalBDT::Predict(double *features, int size, std::vector<double> &ou
 
   return true;
 }
+
+bool AliExternalBDT::Predict(const float *features, float *outputScores, bool useRawScore) {
+  // one input buffer per thread, allocated only when the number of features grows
+  thread_local std::vector<TreelitePredictorEntry> entries;
+  if (entries.size() < fNumFeatures)
+    entries.resize(fNumFeatures);
+  for (std::size_t iEntry = 0; iEntry < fNumFeatures; ++iEntry) {
+    entries[iEntry].fvalue = features[iEntry];
+  }
+
+  std::size_t outSize = fOutSize;
+  int predict = TreelitePredictorPredictInst(fPredictor, entries.data(), static_cast<int>(useRawScore), outputScores,
+      &outSize);
+  return predict >= 0;
+}
+
+bool AliExternalBDT::CreateThreadPredictors(int nThreads) {
+  if (fLibraryPath.empty()) {
+    std::cerr << "No model library loaded, cannot create the thread predictors" << std::endl;
+    return false;
+  }
+  // every handle owns its own predictor state, so different threads never share one
+  while (static_cast<int>(fThreadPredictors.size()) < nThreads) {
+    PredictorHandle predictor;
+    if (TreelitePredictorLoad(fLibraryPath.data(), 1, &predictor) != 0) {
+      std::cerr << "Library loading failed for thread predictor " << fThreadPredictors.size() << std::endl;
+      return false;
+    }
+    fThreadPredictors.push_back(predictor);
+  }
+  return true;
+}
+
+bool AliExternalBDT::PredictBatch(const float *features, std::size_t nRows, float *outputScores, bool useRawScore,
+    int iThread) {
+  if (nRows == 0u)
+    return true;
+
+  // the dense batch only wraps the input buffer, no copy of the features is done here
+  DenseBatchHandle batch;
+  if (TreeliteAssembleDenseBatch(features, std::numeric_limits<float>::quiet_NaN(), nRows, fNumFeatures, &batch) != 0) {
+    std::cerr << "Dense batch assembly failed" << std::endl;
+    return false;
+  }
+
+  std::size_t outSize = 0u;
+  PredictorHandle predictor = iThread < 0 ? fPredictor : fThreadPredictors.at(iThread);
+  int predict = TreelitePredictorPredictBatch(predictor, batch, 0, 0, static_cast<int>(useRawScore), outputScores,
+      &outSize);
+  TreeliteDeleteDenseBatch(batch);
+
+  if (predict != 0 || outSize != nRows * fOutSize)
+    return false;
+
+  return true;
+}
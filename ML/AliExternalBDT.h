@@ -23,13 +23,26 @@
 class AliExternalBDT {
 public:
   AliExternalBDT(std::string name = "");
-  virtual ~AliExternalBDT(){};
+  /// the copy shares the model library and predictor of the source, and loads its own thread predictors
+  AliExternalBDT(const AliExternalBDT &source);
+  AliExternalBDT &operator=(const AliExternalBDT &source);
+  virtual ~AliExternalBDT();
 
   bool LoadLightGBMModel(std::string path);
   bool LoadModelLibrary(std::string path);
   bool LoadXGBoostModel(std::string path);
 
   bool Predict(double *features, int size, std::vector<double> &outputScores, bool useRaw = false);
+  /// single-entry prediction on a float feature array of GetNumberOfFeatures() values, no allocation per call.
+  /// The input buffer is per thread, so different threads can call it on the same object
+  bool Predict(const float *features, float *outputScores, bool useRaw = false);
+  /// predict a row-major batch of nRows x GetNumberOfFeatures() entries, outputScores must hold nRows x GetOutputSize().
+  /// iThread >= 0 selects one of the per-thread predictor handles created with CreateThreadPredictors
+  bool PredictBatch(const float *features, std::size_t nRows, float *outputScores, bool useRaw = false,
+                    int iThread = -1);
+  /// load nThreads independent predictor handles from the compiled model library, one per worker thread
+  bool CreateThreadPredictors(int nThreads);
+  int GetNumberOfThreadPredictors() const { return static_cast<int>(fThreadPredictors.size()); }
 
   std::size_t GetOutputSize() const {return fOutSize;}
   std::size_t GetNumberOfFeatures() const {return fNumFeatures;}
@@ -39,6 +52,7 @@ private:
   bool CreateModelCode();
   std::string GetUniquePath();
   bool LoadModel(const std::string &path, int type);
+  void FreeThreadPredictors();
 
   std::string fBDTname;       /// Unique name of this external BDT handler
   ModelHandle fModel;
@@ -46,6 +60,8 @@ private:
   std::string fModelName;
   CompilerHandle fCompiler;
   PredictorHandle fPredictor;
+  std::string fLibraryPath;                          /// path of the loaded model library
+  std::vector<PredictorHandle> fThreadPredictors;    /// one predictor handle per worker thread
   std::size_t fOutSize;
   std::size_t fNumFeatures;
 };
@@ -12,6 +12,9 @@
 
 #include "AliMLResponse.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "yaml-cpp/yaml.h"
 
 #include "AliExternalBDT.h"
@@ -29,7 +32,8 @@ ClassImp(AliMLResponse);
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
     : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+      fBinsBegin{}, fRaw{}, fFeatureSlots{}, fFeatures{}, fOutScores{}, fNThreads{1}, fMinCandPerThread{1000},
+      fBatchBins{}, fBatchOffsets{}, fBatchOrder{}, fBatchFeatures{}, fBatchScores{} {
   //
   // Default constructor
   //
@@ -38,7 +42,8 @@ AliMLResponse::AliMLResponse()
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
     : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+      fNVariables{}, fBinsBegin{}, fRaw{}, fFeatureSlots{}, fFeatures{}, fOutScores{}, fNThreads{1},
+      fMinCandPerThread{1000}, fBatchBins{}, fBatchOffsets{}, fBatchOrder{}, fBatchFeatures{}, fBatchScores{} {
   //
   // Standard constructor
   //
@@ -55,7 +60,11 @@ AliMLResponse::~AliMLResponse() {
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
     : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw},
+      fFeatureSlots{source.fFeatureSlots}, fFeatures(source.fFeatures.size(), 0.f),
+      fOutScores(source.fOutScores.size(), 0.f), fNThreads{source.fNThreads},
+      fMinCandPerThread{source.fMinCandPerThread}, fBatchBins{}, fBatchOffsets{}, fBatchOrder{}, fBatchFeatures{},
+      fBatchScores{} {
   //
   // Copy constructor
   //
@@ -78,6 +87,11 @@ AliMLResponse &AliMLResponse::operator=(const AliMLResponse &source) {
   fNVariables     = source.fNVariables;
   fBinsBegin      = source.fBinsBegin;
   fRaw            = source.fRaw;
+  fFeatureSlots   = source.fFeatureSlots;
+  fFeatures.assign(source.fFeatures.size(), 0.f);
+  fOutScores.assign(source.fOutScores.size(), 0.f);
+  fNThreads         = source.fNThreads;
+  fMinCandPerThread = source.fMinCandPerThread;
 
   return *this;
 }
@@ -136,6 +150,21 @@ void AliMLResponse::CompileModels(std::string configLocalPath) {
       AliFatal("Inconsistency between number of features in model and yaml! Exit");
     }
   }
+
+  /// bind the feature names to fixed slots once, all the models share the same layout
+  fFeatureSlots.clear();
+  for (int iVar = 0; iVar < fNVariables; ++iVar) {
+    if (!fFeatureSlots.emplace(fVariableNames[iVar], iVar).second) {
+      AliFatal(Form("Variable |%s| appears twice in the variable list provided in config! Exit",
+                    fVariableNames[iVar].data()));
+    }
+  }
+  fFeatures.assign(fNVariables, 0.f);
+  fOutScores.assign(GetNumberOfOutputs(), 0.f);
+
+  if (fNThreads > 1 && !CreateThreadPredictors()) {
+    AliFatal("Error in the creation of the thread predictors! Exit");
+  }
 }
 
 //_______________________________________________________________________________
@@ -258,4 +287,214 @@ bool AliMLResponse::IsSelectedMultiClass(double binvar, map<std::string, double>
 bool AliMLResponse::IsSelectedMultiClass(double binvar, vector<double> variables) {
   vector<double> score;
   return IsSelectedMultiClass(binvar, variables, score);
-}
\ No newline at end of file
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::GetFeatureSlot(const std::string &name) const {
+  auto slot = fFeatureSlots.find(name);
+  if (slot == fFeatureSlots.end())
+    return -1;
+  return slot->second;
+}
+
+//_______________________________________________________________________________
+double AliMLResponse::PredictFeatures(double binvar) {
+  int bin = FindBin(binvar);
+  if (bin < 0)
+    return -999.;
+
+  bool predict = fModels.at(bin - 1).GetModel()->Predict(fFeatures.data(), fOutScores.data(), fRaw);
+  if (!predict)
+    return -999.;
+
+  return fOutScores[0];
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::IsSelectedFeatures(double binvar, double &score) {
+  int bin = FindBin(binvar);
+  if (bin < 0)
+    return false;
+  score = PredictFeatures(binvar);
+  return score >= fModels.at(bin - 1).GetScoreCut()[0];
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::GetNumberOfOutputs() const {
+  if (fModels.empty())
+    return 0;
+  return static_cast<int>(fModels.front().GetScoreCut().size());
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::SetNumberOfThreads(int nThreads) {
+  if (nThreads <= 0)
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  fNThreads = nThreads;
+  /// models already compiled: load the missing predictor handles now
+  if (fNThreads > 1 && !fModels.empty() && !CreateThreadPredictors()) {
+    AliFatal("Error in the creation of the thread predictors! Exit");
+  }
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::CreateThreadPredictors() {
+  for (auto &model : fModels) {
+    if (!model.GetModel()->CreateThreadPredictors(fNThreads))
+      return false;
+  }
+  return true;
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::PredictBatch(const double *features, const double *binvars, int nCandidates, double *scores,
+                                 bool *selected) {
+  if (nCandidates <= 0)
+    return true;
+  if (fModels.empty()) {
+    AliError("No model loaded, call MLResponseInit() before predicting! Exit");
+    return false;
+  }
+  for (auto &model : fModels) {
+    if ((int)model.GetModel()->GetOutputSize() != GetNumberOfOutputs()) {
+      AliFatal("All the models must have the same output size for the batch prediction! Exit");
+    }
+  }
+
+  /// split in contiguous chunks: every candidate is written only by the worker owning its chunk
+  int nWorkers = 1;
+  if (fNThreads > 1)
+    nWorkers = std::max(1, std::min(fNThreads, nCandidates / std::max(1, fMinCandPerThread)));
+  if ((int)fBatchBins.size() < nWorkers) {
+    fBatchBins.resize(nWorkers);
+    fBatchOffsets.resize(nWorkers);
+    fBatchOrder.resize(nWorkers);
+    fBatchFeatures.resize(nWorkers);
+    fBatchScores.resize(nWorkers);
+  }
+
+  int nOutside = 0;
+  bool success = true;
+  if (nWorkers == 1) {
+    nOutside = PredictBatchChunk(features, binvars, 0, nCandidates, scores, selected, -1, success);
+  } else {
+    vector<int> nOutsideChunk(nWorkers, 0);
+    vector<char> successChunk(nWorkers, 1);
+    vector<std::thread> workers;
+    workers.reserve(nWorkers);
+    const int chunkSize = (nCandidates + nWorkers - 1) / nWorkers;
+    for (int iWorker = 0; iWorker < nWorkers; ++iWorker) {
+      const int first = iWorker * chunkSize;
+      const int nInChunk = std::min(chunkSize, nCandidates - first);
+      workers.emplace_back([=, &nOutsideChunk, &successChunk]() {
+        bool chunkSuccess = true;
+        nOutsideChunk[iWorker] =
+            PredictBatchChunk(features, binvars, first, nInChunk, scores, selected, iWorker, chunkSuccess);
+        successChunk[iWorker] = chunkSuccess;
+      });
+    }
+    for (auto &worker : workers)
+      worker.join();
+    for (int iWorker = 0; iWorker < nWorkers; ++iWorker) {
+      nOutside += nOutsideChunk[iWorker];
+      success = success && successChunk[iWorker];
+    }
+  }
+
+  /// logging is not thread safe, warn once from the calling thread
+  if (nOutside > 0)
+    AliWarning(Form("Binned variable outside range for %d candidates, no model available!", nOutside));
+
+  return success;
+}
+
+//_______________________________________________________________________________
+int AliMLResponse::PredictBatchChunk(const double *features, const double *binvars, int first, int nCandidates,
+                                     double *scores, bool *selected, int iWorker, bool &success) {
+  const int nOutputs = GetNumberOfOutputs();
+  const int iBuffer = std::max(iWorker, 0);
+  vector<int> &bins = fBatchBins[iBuffer];
+  vector<int> &offsets = fBatchOffsets[iBuffer];
+  vector<int> &order = fBatchOrder[iBuffer];
+  vector<float> &binFeatures = fBatchFeatures[iBuffer];
+  vector<float> &binScores = fBatchScores[iBuffer];
+
+  /// assign each candidate to its bin (same convention as FindBin) and count the candidates per bin
+  bins.resize(nCandidates);
+  offsets.assign(fNBins + 1, 0);
+  int nOutside = 0;
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    const int iGlobal = first + iCand;
+    int bin = std::lower_bound(fBins.begin(), fBins.end(), binvars[iGlobal]) - fBins.begin();
+    if (bin == 0 || bin == fNBins) {
+      bin = -1;
+      ++nOutside;
+      for (int iOut = 0; iOut < nOutputs; ++iOut)
+        scores[iGlobal * nOutputs + iOut] = -999.;
+      if (selected)
+        selected[iGlobal] = false;
+    } else {
+      ++offsets[bin + 1];
+    }
+    bins[iCand] = bin;
+  }
+
+  /// counting sort of the candidate indices by bin
+  for (int iBin = 1; iBin <= fNBins; ++iBin)
+    offsets[iBin] += offsets[iBin - 1];
+  order.resize(nCandidates - nOutside);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    if (bins[iCand] > 0)
+      order[offsets[bins[iCand]]++] = first + iCand;
+  }
+  /// after the placement offsets[bin] points to the end of bin and offsets[bin - 1] to its start
+
+  success = true;
+  for (int iBin = 1; iBin < fNBins; ++iBin) {
+    const int firstInBin = offsets[iBin - 1];
+    const int nInBin = offsets[iBin] - firstInBin;
+    if (nInBin == 0)
+      continue;
+
+    AliMLModelHandler &model = fModels.at(iBin - 1);
+
+    /// gather the features of this bin into a contiguous float buffer, reused across calls
+    binFeatures.resize(static_cast<size_t>(nInBin) * fNVariables);
+    binScores.resize(static_cast<size_t>(nInBin) * nOutputs);
+    for (int iRow = 0; iRow < nInBin; ++iRow) {
+      const double *row = features + static_cast<size_t>(order[firstInBin + iRow]) * fNVariables;
+      float *dest = &binFeatures[static_cast<size_t>(iRow) * fNVariables];
+      for (int iVar = 0; iVar < fNVariables; ++iVar)
+        dest[iVar] = static_cast<float>(row[iVar]);
+    }
+
+    bool predict = model.GetModel()->PredictBatch(binFeatures.data(), nInBin, binScores.data(), fRaw, iWorker);
+
+    /// scatter the scores back to the input order and apply the score cuts of the bin, as IsSelected
+    /// (score >= cut) for a single output and as IsSelectedMultiClass (cut options) otherwise
+    const vector<double> &cuts = model.GetScoreCut();
+    const vector<int> &cutOpts = model.GetScoreCutOpt();
+    for (int iRow = 0; iRow < nInBin; ++iRow) {
+      const int iCand = order[firstInBin + iRow];
+      bool isSel = predict;
+      for (int iOut = 0; iOut < nOutputs; ++iOut) {
+        double score = predict ? static_cast<double>(binScores[iRow * nOutputs + iOut]) : -999.;
+        scores[iCand * nOutputs + iOut] = score;
+        if (nOutputs == 1) {
+          if (score < cuts[iOut])
+            isSel = false;
+          continue;
+        }
+        if (cutOpts[iOut] == AliMLModelHandler::kLowerCut && score < cuts[iOut])
+          isSel = false;
+        if (cutOpts[iOut] == AliMLModelHandler::kUpperCut && score > cuts[iOut])
+          isSel = false;
+      }
+      if (selected)
+        selected[iCand] = isSel;
+    }
+    success = success && predict;
+  }
+
+  return nOutside;
+}
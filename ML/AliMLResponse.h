@@ -72,8 +72,42 @@ public:
   bool IsSelectedMultiClass(double binvar, std::vector<double> variables);
   /// overload for getting the model score too
   template <typename F> bool IsSelectedMultiClass(double binvar, std::vector<double> variables, std::vector<F> &outScores);
+  /// batch prediction on a row-major (nCandidates x NUM_VAR) feature matrix, candidates are grouped by bin and
+  /// each model is called once per bin. scores must hold nCandidates x GetNumberOfOutputs() values, selected
+  /// (optional) nCandidates flags, with the score cuts of IsSelected for single-output models and of
+  /// IsSelectedMultiClass otherwise. Candidates outside the bin range get score -999 and are not selected.
+  /// With more than one thread the batch is split in contiguous chunks, the output order does not depend on it
+  bool PredictBatch(const double *features, const double *binvars, int nCandidates, double *scores,
+                    bool *selected = nullptr);
+  /// number of worker threads used by PredictBatch, each with its own predictor handles (0: hardware concurrency)
+  void SetNumberOfThreads(int nThreads);
+  int GetNumberOfThreads() const { return fNThreads; }
+  /// minimum number of candidates per thread for the batch to be split
+  void SetMinCandidatesPerThread(int nMin) { fMinCandPerThread = nMin; }
+  /// number of output scores per candidate (1 for binary classification)
+  int GetNumberOfOutputs() const;
+
+  /// return the slot of a feature in the flat candidate buffer, resolved once at MLResponseInit() (-1 if not used).
+  /// The slot layout is the VAR_NAMES order and it is shared by the models of all bins
+  int GetFeatureSlot(const std::string &name) const;
+  /// fill the flat per-candidate feature buffer through a slot obtained with GetFeatureSlot
+  template <typename T> void SetFeature(int slot, T value) {
+    if (slot >= 0)
+      fFeatures[slot] = static_cast<float>(value);
+  }
+  /// read-only access to the flat per-candidate feature buffer
+  const std::vector<float> &GetFeatures() const { return fFeatures; }
+  /// return the ML model predicted score for the features filled with SetFeature
+  double PredictFeatures(double binvar);
+  /// return true if the score for the features filled with SetFeature is above the threshold given in the config
+  bool IsSelectedFeatures(double binvar, double &score);
 
 protected:
+  /// score the candidates [first, first + nCandidates) of a batch with the predictors and buffers of one worker
+  int PredictBatchChunk(const double *features, const double *binvars, int first, int nCandidates, double *scores,
+                        bool *selected, int iWorker, bool &success);
+  bool CreateThreadPredictors();
+
   std::string fConfigFilePath;    /// path of the config file
 
   std::vector<AliMLModelHandler> fModels;     //!<! vector of models
@@ -88,8 +122,22 @@ protected:
 
   bool fRaw;    /// set to true to use raw score instead of probability
 
+  std::map<std::string, int> fFeatureSlots;    //!<! feature name -> slot in fFeatures
+  std::vector<float> fFeatures;                //!<! flat per-candidate feature buffer
+  std::vector<float> fOutScores;               //!<! output scores of the last PredictFeatures call
+
+  int fNThreads;             /// number of worker threads for the batch prediction
+  int fMinCandPerThread;     /// minimum number of candidates per worker thread
+
+  /// batch buffers, one entry per worker
+  std::vector<std::vector<int> > fBatchBins;           //!<! bin of each candidate in the current chunk
+  std::vector<std::vector<int> > fBatchOffsets;        //!<! position of each bin in fBatchOrder
+  std::vector<std::vector<int> > fBatchOrder;          //!<! candidate indices sorted by bin
+  std::vector<std::vector<float> > fBatchFeatures;     //!<! features of the candidates of a single bin
+  std::vector<std::vector<float> > fBatchScores;       //!<! scores of the candidates of a single bin
+
   /// \cond CLASSIMP
-  ClassDef(AliMLResponse, 2);    ///
+  ClassDef(AliMLResponse, 3);    ///
   /// \endcond
 };
 
@@ -0,0 +1,126 @@
+#include <TFile.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <TTree.h>
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AliMLResponse.h"
+
+#define DELTA 1.0e-6
+
+/// Compare the single-candidate AliMLResponse::Predict path with AliMLResponse::PredictBatch
+/// on the test model (same inputs as test_AliEsternalBDT.cc), checking that the scores agree
+int benchmark_AliMLResponseBatch(string path = "", int nRepetitions = 10) {
+
+  string tree_path, model_path;
+
+  if (path == "") {
+    tree_path  = "test_tree_pt8_12.root";
+    model_path = "test_xgboost_pt8_12.model";
+  } else {
+    tree_path  = path + "/" + "test_tree_pt8_12.root";
+    model_path = path + "/" + "test_xgboost_pt8_12.model";
+  }
+
+  const char *varNames[12] = {"delta_mass_KK", "d_len",       "norm_dl_xy",  "sig_vert",
+                              "cos_PiKPhi_3",  "norm_IP",     "sigComb_K_0", "sigComb_K_1",
+                              "sigComb_K_2",   "sigComb_Pi_0", "sigComb_Pi_1", "sigComb_Pi_2"};
+
+  /// two pt bins sharing the same model, to exercise the grouping by bin
+  ofstream config("benchmark_batch_config.yml");
+  config << "BINS: [8, 10, 12]" << std::endl;
+  config << "N_MODELS: 2" << std::endl;
+  config << "MODELS:" << std::endl;
+  for (int iModel = 0; iModel < 2; ++iModel) {
+    config << "  - {path: " << model_path << ", library: kXGBoost, cut: 0.5}" << std::endl;
+  }
+  config << "NUM_VAR: 12" << std::endl;
+  config << "VAR_NAMES: [";
+  for (int iVar = 0; iVar < 12; ++iVar) {
+    config << varNames[iVar] << (iVar < 11 ? ", " : "]");
+  }
+  config << std::endl << "RAW_SCORE: true" << std::endl;
+  config.close();
+
+  AliMLResponse *response = new AliMLResponse("benchmark", "benchmark");
+  response->SetConfigFilePath("benchmark_batch_config.yml");
+  response->MLResponseInit();
+
+  TFile *fInput = new TFile(tree_path.data(), "READ");
+  TTreeReader fReader("tree_real_data", fInput);
+  std::vector<TTreeReaderValue<float> *> values;
+  for (int iVar = 0; iVar < 12; ++iVar) {
+    values.push_back(new TTreeReaderValue<float>(fReader, varNames[iVar]));
+  }
+
+  TRandom3 rnd(42);
+  std::vector<double> features, pts;
+  while (fReader.Next()) {
+    for (auto value : values) {
+      features.push_back(**value);
+    }
+    pts.push_back(rnd.Uniform(8., 12.));
+  }
+  fInput->Close();
+  const int nCandidates = pts.size();
+
+  std::vector<double> scoresSingle(nCandidates), scoresBatch(nCandidates);
+  std::vector<char> selSingle(nCandidates);
+  bool *selBatch = new bool[nCandidates];
+
+  TStopwatch timer;
+  timer.Start();
+  for (int iRep = 0; iRep < nRepetitions; ++iRep) {
+    for (int iCand = 0; iCand < nCandidates; ++iCand) {
+      std::vector<double> row(features.begin() + iCand * 12, features.begin() + (iCand + 1) * 12);
+      double score = 0.;
+      selSingle[iCand] = response->IsSelected(pts[iCand], row, score);
+      scoresSingle[iCand] = score;
+    }
+  }
+  timer.Stop();
+  double timeSingle = timer.RealTime();
+
+  timer.Start();
+  for (int iRep = 0; iRep < nRepetitions; ++iRep) {
+    response->PredictBatch(features.data(), pts.data(), nCandidates, scoresBatch.data(), selBatch);
+  }
+  timer.Stop();
+  double timeBatch = timer.RealTime();
+
+  int nMismatch = 0;
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    if (std::abs(scoresSingle[iCand] - scoresBatch[iCand]) > DELTA || bool(selSingle[iCand]) != selBatch[iCand]) {
+      ++nMismatch;
+    }
+  }
+
+  std::cout << "Candidates: " << nCandidates << ", repetitions: " << nRepetitions << std::endl;
+  std::cout << "Single-candidate path: " << timeSingle << " s (" << 1.e6 * timeSingle / (nCandidates * nRepetitions)
+            << " us/candidate)" << std::endl;
+  std::cout << "Batch path:            " << timeBatch << " s (" << 1.e6 * timeBatch / (nCandidates * nRepetitions)
+            << " us/candidate)" << std::endl;
+  if (timeBatch > 0.) {
+    std::cout << "Speed-up: " << timeSingle / timeBatch << std::endl;
+  }
+
+  delete[] selBatch;
+  for (auto value : values) {
+    delete value;
+  }
+  delete response;
+
+  if (nMismatch) {
+    std::cout << "TEST: Fail! " << nMismatch << " candidates with different score or selection" << std::endl;
+    return 1;
+  }
+  std::cout << "TEST: Success!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <TFile.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <TTree.h>
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AliMLResponse.h"
+
+/// Scaling of AliMLResponse::PredictBatch with the number of worker threads (1 to maxThreads) on the test model.
+/// The candidates of the test tree are replicated nCopies times to get a batch large enough to be split.
+/// The scores obtained with N threads must be identical to the single-thread ones.
+int benchmark_AliMLResponseThreads(string path = "", int maxThreads = 0, int nCopies = 100) {
+
+  string tree_path, model_path;
+
+  if (path == "") {
+    tree_path  = "test_tree_pt8_12.root";
+    model_path = "test_xgboost_pt8_12.model";
+  } else {
+    tree_path  = path + "/" + "test_tree_pt8_12.root";
+    model_path = path + "/" + "test_xgboost_pt8_12.model";
+  }
+  if (maxThreads <= 0) {
+    maxThreads = std::thread::hardware_concurrency();
+  }
+
+  const char *varNames[12] = {"delta_mass_KK", "d_len",       "norm_dl_xy",  "sig_vert",
+                              "cos_PiKPhi_3",  "norm_IP",     "sigComb_K_0", "sigComb_K_1",
+                              "sigComb_K_2",   "sigComb_Pi_0", "sigComb_Pi_1", "sigComb_Pi_2"};
+
+  ofstream config("benchmark_threads_config.yml");
+  config << "BINS: [8, 10, 12]" << std::endl;
+  config << "N_MODELS: 2" << std::endl;
+  config << "MODELS:" << std::endl;
+  for (int iModel = 0; iModel < 2; ++iModel) {
+    config << "  - {path: " << model_path << ", library: kXGBoost, cut: 0.5}" << std::endl;
+  }
+  config << "NUM_VAR: 12" << std::endl;
+  config << "VAR_NAMES: [";
+  for (int iVar = 0; iVar < 12; ++iVar) {
+    config << varNames[iVar] << (iVar < 11 ? ", " : "]");
+  }
+  config << std::endl << "RAW_SCORE: true" << std::endl;
+  config.close();
+
+  AliMLResponse *response = new AliMLResponse("benchmark", "benchmark");
+  response->SetConfigFilePath("benchmark_threads_config.yml");
+  response->SetNumberOfThreads(maxThreads);
+  response->MLResponseInit();
+
+  TFile *fInput = new TFile(tree_path.data(), "READ");
+  TTreeReader fReader("tree_real_data", fInput);
+  std::vector<TTreeReaderValue<float> *> values;
+  for (int iVar = 0; iVar < 12; ++iVar) {
+    values.push_back(new TTreeReaderValue<float>(fReader, varNames[iVar]));
+  }
+
+  std::vector<double> treeFeatures;
+  while (fReader.Next()) {
+    for (auto value : values) {
+      treeFeatures.push_back(**value);
+    }
+  }
+  fInput->Close();
+
+  TRandom3 rnd(42);
+  std::vector<double> features, pts;
+  for (int iCopy = 0; iCopy < nCopies; ++iCopy) {
+    features.insert(features.end(), treeFeatures.begin(), treeFeatures.end());
+  }
+  const int nCandidates = features.size() / 12;
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    pts.push_back(rnd.Uniform(8., 12.));
+  }
+
+  std::vector<double> reference(nCandidates), scores(nCandidates);
+  bool *selected = new bool[nCandidates];
+
+  TStopwatch timer;
+  double timeOneThread = 0.;
+  int nFailures = 0;
+  std::cout << "Candidates: " << nCandidates << std::endl;
+  for (int nThreads = 1; nThreads <= maxThreads; ++nThreads) {
+    response->SetNumberOfThreads(nThreads);
+    timer.Start();
+    response->PredictBatch(features.data(), pts.data(), nCandidates, nThreads == 1 ? reference.data() : scores.data(),
+                           selected);
+    timer.Stop();
+    if (nThreads == 1) {
+      timeOneThread = timer.RealTime();
+    } else if (scores != reference) {
+      std::cout << "Scores with " << nThreads << " threads differ from the single-thread ones!" << std::endl;
+      ++nFailures;
+    }
+    std::cout << "Threads: " << nThreads << "  time: " << timer.RealTime() << " s  speed-up: "
+              << (timer.RealTime() > 0. ? timeOneThread / timer.RealTime() : 0.) << std::endl;
+  }
+
+  delete[] selected;
+  for (auto value : values) {
+    delete value;
+  }
+  delete response;
+
+  if (nFailures) {
+    std::cout << "TEST: Fail!" << std::endl;
+    return 1;
+  }
+  std::cout << "TEST: Success!" << std::endl;
+  return 0;
+}
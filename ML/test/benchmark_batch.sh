@@ -0,0 +1,10 @@
+#!/bin/bash
+
+DIRPATH="test_extBDT"
+mkdir -p ${DIRPATH}
+
+curl http://personalpages.to.infn.it/~fecchio/test_extBDT/test_xgboost_pt8_12.model -o ${DIRPATH}/test_xgboost_pt8_12.model
+curl http://personalpages.to.infn.it/~fecchio/test_extBDT/test_tree_pt8_12.root -o ${DIRPATH}/test_tree_pt8_12.root
+
+root -q -b -l ../macros/benchmark_AliMLResponseBatch.cc\(\"${DIRPATH}\"\)
+root -q -b -l ../macros/benchmark_AliMLResponseThreads.cc\(\"${DIRPATH}\"\)
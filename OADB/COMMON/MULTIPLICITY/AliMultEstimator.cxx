@@ -19,12 +19,154 @@
 #include "TObjString.h"
 #include "TBrowser.h"
 #include "TFormula.h"
+#include "TH1F.h"
+#include "TMath.h"
 #include "RVersion.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+  //Operations of the compiled estimator definitions
+  enum EProgramOp { kOpVariable = 0, kOpConstant, kOpAdd, kOpSub, kOpMul, kOpDiv, kOpNeg, kOpNot, kOpPow };
+  const Int_t kMaxStackDepth = 64;
+  
+  //Recursive descent over the definition after replacement of the variables by [i].
+  //Supported: numbers, [i], + - * / with parentheses, unary - + !, TMath::Power(a,b).
+  //The operations are emitted in the order of the C++ evaluation (as done by TFormula),
+  //such that the results are bitwise identical. Anything else makes the compilation fail
+  //and the estimator stays with TFormula. Types are tracked as in C++: the division of two
+  //integer expressions (integer division in TFormula) is not compiled either.
+  class DefinitionCompiler {
+  public:
+    DefinitionCompiler(const TString& lExpr, Long_t lNVar, std::vector<Int_t>& lOp, std::vector<Double_t>& lArg)
+    : fExpr(lExpr), fPos(fExpr.Data()), fNVar(lNVar), fOp(lOp), fArg(lArg), fDepth(0), fMaxDepth(0) {}
+    
+    Bool_t Compile(){
+      fOp.clear();
+      fArg.clear();
+      Bool_t lIsInt = kFALSE;
+      if (!ParseSum(lIsInt)) return kFALSE;
+      SkipSpaces();
+      return *fPos == 0 && fMaxDepth <= kMaxStackDepth;
+    }
+    
+  private:
+    void SkipSpaces(){ while (*fPos == ' ' || *fPos == '\t') fPos++; }
+    void Emit(Int_t lOp, Double_t lArg = 0){
+      fOp.push_back(lOp);
+      fArg.push_back(lArg);
+      if (lOp == kOpVariable || lOp == kOpConstant) fDepth++;
+      else if (lOp != kOpNeg && lOp != kOpNot) fDepth--;
+      if (fDepth > fMaxDepth) fMaxDepth = fDepth;
+    }
+    Bool_t ParseSum(Bool_t& lIsInt){
+      if (!ParseProduct(lIsInt)) return kFALSE;
+      while (kTRUE) {
+        SkipSpaces();
+        char c = *fPos;
+        if (c != '+' && c != '-') return kTRUE;
+        fPos++;
+        Bool_t lIsIntR = kFALSE;
+        if (!ParseProduct(lIsIntR)) return kFALSE;
+        Emit(c == '+' ? kOpAdd : kOpSub);
+        lIsInt = lIsInt && lIsIntR;
+      }
+    }
+    Bool_t ParseProduct(Bool_t& lIsInt){
+      if (!ParseUnary(lIsInt)) return kFALSE;
+      while (kTRUE) {
+        SkipSpaces();
+        char c = *fPos;
+        if (c != '*' && c != '/') return kTRUE;
+        fPos++;
+        if (*fPos == '*') return kFALSE; //power operator
+        Bool_t lIsIntR = kFALSE;
+        if (!ParseUnary(lIsIntR)) return kFALSE;
+        if (c == '/' && lIsInt && lIsIntR) return kFALSE; //integer division
+        Emit(c == '*' ? kOpMul : kOpDiv);
+        lIsInt = lIsInt && lIsIntR;
+      }
+    }
+    Bool_t ParseUnary(Bool_t& lIsInt){
+      SkipSpaces();
+      char c = *fPos;
+      if (c == '-' || c == '+' || c == '!') {
+        fPos++;
+        if (c == '!' && *fPos == '=') return kFALSE;
+        if (!ParseUnary(lIsInt)) return kFALSE;
+        if (c == '-') Emit(kOpNeg);
+        if (c == '!') { Emit(kOpNot); lIsInt = kTRUE; }
+        return kTRUE;
+      }
+      return ParsePrimary(lIsInt);
+    }
+    Bool_t ParsePrimary(Bool_t& lIsInt){
+      SkipSpaces();
+      lIsInt = kFALSE;
+      if (*fPos == '(') {
+        fPos++;
+        if (!ParseSum(lIsInt)) return kFALSE;
+        SkipSpaces();
+        if (*fPos != ')') return kFALSE;
+        fPos++;
+        return kTRUE;
+      }
+      if (*fPos == '[') {
+        char* lEnd = 0;
+        long lIdx = strtol(fPos+1, &lEnd, 10);
+        if (lEnd == fPos+1 || *lEnd != ']' || lIdx < 0 || lIdx >= fNVar) return kFALSE;
+        fPos = lEnd+1;
+        Emit(kOpVariable, lIdx);
+        return kTRUE;
+      }
+      if ((*fPos >= '0' && *fPos <= '9') || *fPos == '.') {
+        char* lEnd = 0;
+        Double_t lVal = strtod(fPos, &lEnd);
+        if (lEnd == fPos) return kFALSE;
+        lIsInt = kTRUE;
+        for (const char* p = fPos; p != lEnd; p++) {
+          if (*p == 'x' || *p == 'X') return kFALSE; //hexadecimal
+          if (*p == '.' || *p == 'e' || *p == 'E') lIsInt = kFALSE;
+        }
+        fPos = lEnd;
+        Emit(kOpConstant, lVal);
+        return kTRUE;
+      }
+      const char* lPower = "TMath::Power(";
+      if (strncmp(fPos, lPower, strlen(lPower)) == 0) {
+        fPos += strlen(lPower);
+        Bool_t lDummy = kFALSE;
+        if (!ParseSum(lDummy)) return kFALSE;
+        SkipSpaces();
+        if (*fPos != ',') return kFALSE;
+        fPos++;
+        if (!ParseSum(lDummy)) return kFALSE;
+        SkipSpaces();
+        if (*fPos != ')') return kFALSE;
+        fPos++;
+        Emit(kOpPow);
+        return kTRUE;
+      }
+      return kFALSE;
+    }
+    
+    TString                fExpr;
+    const char*            fPos;
+    Long_t                 fNVar;
+    std::vector<Int_t>&    fOp;
+    std::vector<Double_t>& fArg;
+    Int_t                  fDepth;
+    Int_t                  fMaxDepth;
+  };
+}
 
 ClassImp(AliMultEstimator);
 //________________________________________________________________
 AliMultEstimator::AliMultEstimator() :
   TNamed(), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0),
+fNParameters(0), fProgramOp(), fProgramArg(),
+fQuantileNBins(0), fQuantileXmin(0), fQuantileXmax(0), fQuantileEdges(), fQuantileContent(),
 fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 {
   // Constructor
@@ -32,6 +174,8 @@ fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 }
 AliMultEstimator::AliMultEstimator(const char * name, const char * title, TString lInitDef):
 TNamed(name,title), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0),
+fNParameters(0), fProgramOp(), fProgramArg(),
+fQuantileNBins(0), fQuantileXmin(0), fQuantileXmax(0), fQuantileEdges(), fQuantileContent(),
 fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 {
     //Named, titled, definition constructor
@@ -46,6 +190,14 @@ fValue(e.fValue),
 fMean(e.fMean),
 fPercentile(e.fPercentile),
 fFormula(0),
+fNParameters(e.fNParameters),
+fProgramOp(e.fProgramOp),
+fProgramArg(e.fProgramArg),
+fQuantileNBins(e.fQuantileNBins),
+fQuantileXmin(e.fQuantileXmin),
+fQuantileXmax(e.fQuantileXmax),
+fQuantileEdges(e.fQuantileEdges),
+fQuantileContent(e.fQuantileContent),
 fkUseAnchor(e.fkUseAnchor),
 fAnchorPoint(e.fAnchorPoint),
 fAnchorPercentile(e.fAnchorPercentile)
@@ -67,6 +219,15 @@ AliMultEstimator& AliMultEstimator::operator=(const AliMultEstimator& e)
     if (fFormula) delete fFormula;
     fFormula = 0;
     if (e.fFormula) fFormula = new TFormula(*e.fFormula);
+    fNParameters = e.fNParameters;
+    fProgramOp   = e.fProgramOp;
+    fProgramArg  = e.fProgramArg;
+    
+    fQuantileNBins   = e.fQuantileNBins;
+    fQuantileXmin    = e.fQuantileXmin;
+    fQuantileXmax    = e.fQuantileXmax;
+    fQuantileEdges   = e.fQuantileEdges;
+    fQuantileContent = e.fQuantileContent;
     
     //Anchor point configs
     fkUseAnchor         = e.fkUseAnchor;
@@ -107,8 +268,10 @@ Float_t AliMultEstimator::GetZ() const {
     return lReturnVal; 
 }
 //________________________________________________________________
-void AliMultEstimator::SetupFormula(const AliMultInput* lInput)
+void AliMultEstimator::SetupFormula(const AliMultInput* lInput, Bool_t lCompile)
 {
+    //Definition compiled once per run to operations on the input vector;
+    //TFormula only if the definition is beyond the compiler (or if requested)
     TString expr = fDefinition;
     Int_t   nVar = lInput->GetNVariables();
     for (Int_t i = 0; i < nVar; i++) {
@@ -121,24 +284,94 @@ void AliMultEstimator::SetupFormula(const AliMultInput* lInput)
         lVarName.Prepend("(");
         expr.ReplaceAll(lVarName, repl);
     }
+    fNParameters = nVar;
+    if (fFormula) delete fFormula;
+    fFormula = 0;
+    fProgramOp.clear();
+    fProgramArg.clear();
+    if (lCompile && Compile(expr, nVar)) return;
     fFormula = new TFormula(Form("e%s", GetName()), expr);
 #if ROOT_VERSION_CODE < ROOT_VERSION(5,99,4)
     fFormula->Optimize();
 #endif
 }
 //________________________________________________________________
-Float_t AliMultEstimator::Evaluate(const AliMultInput* lInput)
+Bool_t AliMultEstimator::Compile(const TString& lExpr, Long_t lNVar)
 {
-    if (!fFormula) return fValue = 0;
-    Float_t lVertexZ = lInput->GetVariable("fEvSel_VtxZ")->GetValue();
-    for (Int_t i = 0; i < lInput->GetNVariables(); i++) {
-        AliMultVariable* v = lInput->GetVariable(i);
-        Double_t lv = v->IsInteger() ? v->GetValueInteger() : v->GetValue();
-        if(v->GetUseVertexZCorrection()){
-          Float_t lCorrection = lInput->GetVtxZCorrection(v, lVertexZ)/lInput->GetVtxZCorrection(v, 0.0);
-          lv = lv / lCorrection; //automatic vertex correction if requested
+    DefinitionCompiler lCompiler(lExpr, lNVar, fProgramOp, fProgramArg);
+    if (lCompiler.Compile()) return kTRUE;
+    fProgramOp.clear();
+    fProgramArg.clear();
+    return kFALSE;
+}
+//________________________________________________________________
+Double_t AliMultEstimator::EvaluateProgram(const Double_t* lValues) const
+{
+    Double_t lStack[kMaxStackDepth];
+    Int_t    n = 0;
+    const Int_t lNOp = fProgramOp.size();
+    for (Int_t i = 0; i < lNOp; i++) {
+        switch (fProgramOp[i]) {
+            case kOpVariable: lStack[n++] = lValues[(Long_t)fProgramArg[i]]; break;
+            case kOpConstant: lStack[n++] = fProgramArg[i]; break;
+            case kOpAdd: n--; lStack[n-1] = lStack[n-1] + lStack[n]; break;
+            case kOpSub: n--; lStack[n-1] = lStack[n-1] - lStack[n]; break;
+            case kOpMul: n--; lStack[n-1] = lStack[n-1] * lStack[n]; break;
+            case kOpDiv: n--; lStack[n-1] = lStack[n-1] / lStack[n]; break;
+            case kOpPow: n--; lStack[n-1] = std::pow(lStack[n-1], lStack[n]); break;
+            case kOpNeg: lStack[n-1] = -lStack[n-1]; break;
+            case kOpNot: lStack[n-1] = (lStack[n-1] == 0) ? 1. : 0.; break;
         }
-        fFormula->SetParameter(i, lv);
     }
+    return lStack[0];
+}
+//________________________________________________________________
+Float_t AliMultEstimator::Evaluate(const AliMultInput* lInput)
+{
+    if (!fFormula && fProgramOp.empty()) return fValue = 0;
+    std::vector<Double_t> lValues;
+    lInput->FillValues(lValues);
+    return Evaluate(lValues.data(), lValues.size());
+}
+//________________________________________________________________
+Float_t AliMultEstimator::Evaluate(const Double_t* lValues, Long_t lNValues)
+{
+    //lValues: input variables incl. vertex-Z correction, see AliMultInput::FillValues
+    if (!fProgramOp.empty()) return fValue = (lNValues >= fNParameters) ? EvaluateProgram(lValues) : 0;
+    if (!fFormula) return fValue = 0;
+    for (Long_t i = 0; i < lNValues && i < fNParameters; i++) fFormula->SetParameter(i, lValues[i]);
     return fValue = fFormula->Eval(0);
 }
+//________________________________________________________________
+void AliMultEstimator::SetupQuantileTable(const TH1F* lCalibHisto)
+{
+    //Copy of the calibration histogram: percentile for each bin
+    fQuantileEdges.clear();
+    fQuantileContent.clear();
+    if (!lCalibHisto) return;
+    const TAxis* lAxis = lCalibHisto->GetXaxis();
+    fQuantileNBins = lAxis->GetNbins();
+    fQuantileXmin  = lAxis->GetXmin();
+    fQuantileXmax  = lAxis->GetXmax();
+    const TArrayD* lEdges = lAxis->GetXbins();
+    if (lEdges->GetSize() > 0) fQuantileEdges.assign(lEdges->GetArray(), lEdges->GetArray()+lEdges->GetSize());
+    fQuantileContent.resize(fQuantileNBins+2);
+    for (Int_t i = 0; i < fQuantileNBins+2; i++) fQuantileContent[i] = lCalibHisto->GetBinContent(i);
+}
+//________________________________________________________________
+Float_t AliMultEstimator::GetQuantile(Float_t lValue) const
+{
+    //Same as GetBinContent(FindBin(lValue)) of the calibration histogram
+    Double_t x = lValue;
+    Int_t lBin = 0;
+    if (x < fQuantileXmin) {
+        lBin = 0;
+    } else if (!(x < fQuantileXmax)) { //also NaN
+        lBin = fQuantileNBins+1;
+    } else if (fQuantileEdges.empty()) {
+        lBin = 1 + Int_t(fQuantileNBins*(x-fQuantileXmin)/(fQuantileXmax-fQuantileXmin));
+    } else {
+        lBin = 1 + TMath::BinarySearch((Long64_t)fQuantileEdges.size(), fQuantileEdges.data(), x);
+    }
+    return fQuantileContent[lBin];
+}
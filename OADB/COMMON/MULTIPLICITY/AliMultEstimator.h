@@ -1,8 +1,10 @@
 #ifndef AliMultEstimator_H
 #define AliMultEstimator_H
 #include <TNamed.h>
+#include <vector>
 class AliMultInput;
 class TFormula;
+class TH1F;
 
 class AliMultEstimator : public TNamed {
     
@@ -41,10 +43,21 @@ public:
     Float_t GetZ () const; //check for zero
 
     //Pre-processing for speed
-    void SetupFormula(const AliMultInput* lInput);
+    void SetupFormula(const AliMultInput* lInput, Bool_t lCompile = kTRUE);
     Float_t Evaluate(const AliMultInput* lInput);
+    Float_t Evaluate(const Double_t* lValues, Long_t lNValues);
+    Bool_t  IsCompiled() const { return !fProgramOp.empty(); }
+    
+    //Percentile look-up without the calibration histogram (prepared once per run)
+    void    SetupQuantileTable(const TH1F* lCalibHisto);
+    Bool_t  HasQuantileTable() const { return !fQuantileContent.empty(); }
+    Float_t GetQuantile(Float_t lValue) const;
     
 private:
+    Bool_t   Compile(const TString& lExpr, Long_t lNVar);
+    Double_t EvaluateProgram(const Double_t* lValues) const;
+    
+
     TString fDefinition; //How to evaluate based on AliMultVariables
     Bool_t fIsInteger; //Requires special treatment when calibrating
     
@@ -52,6 +65,18 @@ private:
     Float_t fMean;   // estimator mean value
     Float_t fPercentile;   //Percentile
     TFormula* fFormula; //!
+    Long_t    fNParameters; //! number of formula parameters (input variables)
+    
+    //Compiled definition: operations in reverse polish notation
+    std::vector<Int_t>    fProgramOp;  //! operation codes
+    std::vector<Double_t> fProgramArg; //! constant value or variable index
+    
+    //Quantile table: calibration histogram bins, look-up as in TAxis::FindBin
+    Int_t    fQuantileNBins;               //! number of bins
+    Double_t fQuantileXmin;                //! lower edge
+    Double_t fQuantileXmax;                //! upper edge
+    std::vector<Double_t> fQuantileEdges;  //! bin edges, empty for equidistant bins
+    std::vector<Float_t>  fQuantileContent;//! percentiles incl. under- and overflow
     
     //Anchor point definition
     Bool_t  fkUseAnchor;        //Use Anchor Logic (default: No)
@@ -59,7 +59,8 @@ AliMultInput::AliMultInput() :
 TNamed(),
 fNVars(0), fVariableList(0x0),
 fNVtxZ(0), fVariableVertexZList(0x0),
-fMap(0)
+fMap(0), fVtxZVariable(0),
+fVtxZOffset(), fVtxZNorm(), fVtxZAxis(), fVtxZContent(), fVtxZCenter(), fVtxZWidth()
 {
   // Constructor
   fVariableList = new TList();
@@ -71,7 +72,8 @@ AliMultInput::AliMultInput(const char * name, const char * title):
 TNamed(name,title),
 fNVars(0), fVariableList(0x0),
 fNVtxZ(0), fVariableVertexZList(0x0),
-fMap(0)
+fMap(0), fVtxZVariable(0),
+fVtxZOffset(), fVtxZNorm(), fVtxZAxis(), fVtxZContent(), fVtxZCenter(), fVtxZWidth()
 {
   // Constructor
   fVariableList = new TList();
@@ -83,7 +85,8 @@ AliMultInput::AliMultInput(const AliMultInput& o)
 : TNamed(o),
 fNVars(0), fVariableList(0x0),
 fNVtxZ(0), fVariableVertexZList(0x0),
-fMap(0)
+fMap(0), fVtxZVariable(0),
+fVtxZOffset(), fVtxZNorm(), fVtxZAxis(), fVtxZContent(), fVtxZCenter(), fVtxZWidth()
 {
   // Constructor
   fVariableList = new TList();
@@ -119,6 +122,10 @@ AliMultInput& AliMultInput::operator=(const AliMultInput& o)
   TProfile* vp  = 0;
   while ((vp = static_cast<TProfile*>(nextp())))  AddVtxZ(vp);
   
+  //tables refer to the previous variables
+  fVtxZVariable = 0;
+  fVtxZOffset.clear();
+  
   return *this;
 }
 
@@ -217,11 +224,38 @@ Double_t AliMultInput::GetVtxZCorrection (const AliMultVariable *v, Double_t lVt
   return lReturnValue;
 }
 
+Double_t AliMultInput::GetVtxZCorrectionFromTable (Long_t iVar, Double_t lVtxZ) const
+{
+  //Same as GetVtxZCorrection, bin values from the table
+  Int_t lBin = fVtxZAxis[iVar]->FindFixBin(lVtxZ);
+  Int_t lIdx = fVtxZOffset[iVar] + lBin + 1;
+  Float_t lReturnValue = 1.0;
+  Float_t lBinContent = fVtxZContent[lIdx];
+  Float_t lBinCenter = fVtxZCenter[lIdx];
+  Float_t lBinWidth = fVtxZWidth[lIdx];
+  if(lBinContent<1e-6) return 1.0; //not dealt with / uncalibrated
+  if( lVtxZ >= lBinCenter ){
+    //check next bin
+    Float_t lFrac = (lVtxZ-lBinCenter)/lBinWidth;
+    Float_t lBinContent1 = fVtxZContent[lIdx+1];
+    if(lBinContent1<1e-6) lBinContent1 = lBinContent;
+    lReturnValue = (1-lFrac)*lBinContent + lFrac*lBinContent1;
+  }else{
+    //check preceding bin
+    Float_t lFrac = (lBinCenter-lVtxZ)/lBinWidth;
+    Float_t lBinContent1 = fVtxZContent[lIdx-1];
+    if(lBinContent1<1e-6) lBinContent1 = lBinContent;
+    lReturnValue = (1-lFrac)*lBinContent + lFrac*lBinContent1;
+  }
+  return lReturnValue;
+}
+
 void AliMultInput::ClearVtxZ()
 {
   if (fVariableVertexZList)
     fVariableVertexZList->Delete();
   fNVtxZ = fVariableVertexZList->GetEntries(); 
+  fVtxZOffset.clear(); //profiles are gone
 }
 
 void AliMultInput::Clear(Option_t* option)
@@ -286,6 +320,7 @@ void AliMultInput::SetupAutoVtxZCorrection(){
     fMap->Add(v, h);
   }
   Printf("Number of automatically calibrated inputs: %i",fMap->GetEntries());
+  SetupVtxZCorrectionTable();
 }
 //________________________________________________________________
 void AliMultInput::SetupAutoVtxZCorrection( const AliOADBMultSelection *oadb){
@@ -316,6 +351,56 @@ void AliMultInput::SetupAutoVtxZCorrection( const AliOADBMultSelection *oadb){
     fMap->Add(v, h);
   }
   Printf("Number of automatically calibrated inputs: %i",fMap->GetEntries()); 
+  SetupVtxZCorrectionTable();
+}
+//________________________________________________________________
+void AliMultInput::SetupVtxZCorrectionTable(){
+  //Profile contents, centers and widths copied once; per event only the
+  //interpolation is left (no map look-up, no TProfile::GetBinContent)
+  fVtxZVariable = GetVariable("fEvSel_VtxZ");
+  fVtxZOffset.assign(fNVars, -1);
+  fVtxZNorm.assign(fNVars, 1.0);
+  fVtxZAxis.assign(fNVars, 0);
+  fVtxZContent.clear();
+  fVtxZCenter.clear();
+  fVtxZWidth.clear();
+  for(Long_t ii=0 ; ii<fNVars; ii++){
+    AliMultVariable* v = GetVariable(ii);
+    if (!v || !v->GetUseVertexZCorrection()) continue;
+    TProfile* h = GetVtxZProfile(v);
+    if (!h) continue;
+    Int_t lNBins = h->GetNbinsX();
+    fVtxZOffset[ii] = fVtxZContent.size();
+    fVtxZNorm[ii] = GetVtxZCorrection(v, 0.0);
+    fVtxZAxis[ii] = h->GetXaxis();
+    for(Int_t lBin=-1; lBin<=lNBins+2; lBin++){
+      Bool_t lInRange = lBin>=0 && lBin<=lNBins+1;
+      fVtxZContent.push_back( lInRange ? h->GetBinContent(lBin) : 0. );
+      fVtxZCenter.push_back( lInRange ? h->GetBinCenter(lBin) : 0. );
+      fVtxZWidth.push_back( lInRange ? h->GetBinWidth(lBin) : 0. );
+    }
+  }
+}
+//________________________________________________________________
+void AliMultInput::FillValues(std::vector<Double_t>& lValues) const
+{
+  //Input of the estimators: variable values, divided by the vertex-Z correction if requested
+  lValues.resize(fNVars);
+  const AliMultVariable* lVtxZVar = fVtxZVariable ? fVtxZVariable : GetVariable("fEvSel_VtxZ");
+  Float_t lVertexZ = lVtxZVar ? lVtxZVar->GetValue() : 0;
+  TIter next(fVariableList);
+  AliMultVariable* v = 0;
+  Long_t i = 0;
+  while ((v = static_cast<AliMultVariable*>(next())) && i < fNVars) {
+    Double_t lv = v->IsInteger() ? v->GetValueInteger() : v->GetValue();
+    if(v->GetUseVertexZCorrection()){
+      Float_t lCorrection = 0;
+      if (i < (Long_t)fVtxZOffset.size() && fVtxZOffset[i] >= 0)
+        lCorrection = GetVtxZCorrectionFromTable(i, lVertexZ)/fVtxZNorm[i];
+      else
+        lCorrection = GetVtxZCorrection(v, lVertexZ)/GetVtxZCorrection(v, 0.0);
+      lv = lv / lCorrection; //automatic vertex correction if requested
+    }
+    lValues[i++] = lv;
+  }
 }
-
-
@@ -3,6 +3,7 @@
 #include <TNamed.h>
 #include "TProfile.h"
 #include <TMap.h>
+#include <vector>
 #include "AliMultVariable.h"
 #include "AliOADBMultSelection.h"
 
@@ -33,6 +34,12 @@ public:
   void SetupAutoVtxZCorrection();
   void SetupAutoVtxZCorrection(const AliOADBMultSelection *oadb); 
   
+  //Pre-processing for speed: vertex-Z corrections tabulated once per run,
+  //variables (corrected if requested) as dense vector for the estimators
+  void SetupVtxZCorrectionTable();
+  Double_t GetVtxZCorrectionFromTable (Long_t iVar, Double_t lVtxZ) const;
+  void FillValues(std::vector<Double_t>& lValues) const;
+  
   //Aliases for multiplicity selection criteria
   enum MultSelVar {
     kAmplitude_V0A = 0,
@@ -108,6 +115,15 @@ private:
   
   TMap* fMap; //! Map variable to profile histogram if it exits
   
+  //Vertex-Z correction table, bins -1 ... nbins+2 of each profile (outermost: zero content)
+  AliMultVariable* fVtxZVariable;   //! fEvSel_VtxZ
+  std::vector<Int_t>    fVtxZOffset;  //! per variable: entry of bin -1, -1 if no correction
+  std::vector<Double_t> fVtxZNorm;    //! per variable: correction at vertex-Z = 0
+  std::vector<const TAxis*> fVtxZAxis; //! per variable: axis of the profile
+  std::vector<Float_t>  fVtxZContent; //! bin content
+  std::vector<Float_t>  fVtxZCenter;  //! bin center
+  std::vector<Float_t>  fVtxZWidth;   //! bin width
+  
   ClassDef(AliMultInput, 2)
   //2 - vertex-Z correction
 };
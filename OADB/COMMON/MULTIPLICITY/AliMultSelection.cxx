@@ -239,11 +239,14 @@ void AliMultSelection::Evaluate( AliMultInput *lInput )
 //Master function to evaluate all existing estimators based on
 //a set of input variables. Error handling to be done with care...
 {
+    //Input variables (incl. vertex-Z corrections) once for all estimators
+    lInput->FillValues(fInputValues);
+    
     //Loop over estimators defined in the acquired list
     AliMultEstimator* estimator = 0;
     TIter             next(fEstimatorList);
     while ((estimator = static_cast<AliMultEstimator*>(next())))
-        estimator->Evaluate(lInput);
+        estimator->Evaluate(fInputValues.data(), fInputValues.size());
 
 //deprecated evaluation
 #if 0
@@ -2,6 +2,7 @@
 #define AliMultSelection_H
 #include <TNamed.h>
 #include <TList.h>
+#include <vector>
 #include "AliMultSelectionBase.h"
 #include "AliMultEstimator.h"
 
@@ -90,6 +91,8 @@ private:
     Bool_t fThisEvent_IsNotIncompleteDAQ;       //!
     Bool_t fThisEvent_HasGoodVertex2016;         //!
     
+    std::vector<Double_t> fInputValues; //! input variables of the current event, see AliMultInput::FillValues
+    
     ClassDef(AliMultSelection, 7)
     // 1 - original implementation
     // 2 - added fEvSelCode for EvSel bypass + getter changed
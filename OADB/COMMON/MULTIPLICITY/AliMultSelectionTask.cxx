@@ -1844,6 +1844,14 @@ void AliMultSelectionTask::UserExec(Option_t *)
     TString lThisCalibHistoName;
     Float_t lThisQuantile = -1;
     for(Long_t iEst=0; iEst<lSelection->GetNEstimators(); iEst++) {
+      //Quantile table prepared by AliOADBMultSelection::Setup: same as the histogram look-up
+      AliMultEstimator *lThisEstimator = lSelection->GetEstimator(iEst);
+      if ( lThisEstimator->HasQuantileTable() ) {
+        lThisQuantile = lThisEstimator->GetQuantile( lThisEstimator->GetValue() );
+        if( iEst < fNDebug ) fQuantiles[iEst] = lThisQuantile;
+        lThisEstimator->SetPercentile(lThisQuantile);
+        continue;
+      }
       //Changed: no need for run number, object already matches required one
       lThisCalibHistoName = Form("hCalib_%s",lSelection->GetEstimator(iEst)->GetName());
       lThisCalibHisto = 0x0;
@@ -300,6 +300,8 @@ void AliOADBMultSelection::Setup()
         
       TString name(Form("hCalib_%s", e->GetName()));
         TH1F*   h = GetCalibHisto(name);
+        //percentile look-up without the histogram (empty table if no calibration)
+        e->SetupQuantileTable(h);
         if (!h) continue;
         
         fMap->Add(e, h);
@@ -26,12 +26,14 @@
 #include <TMath.h>
 #include <TRandom.h>
 #include <TChain.h>
+#include <TChainElement.h>
 #include <TGrid.h>
 #include <TGridResult.h>
 #include <TSystem.h>
 #include <TUUID.h>
 #include <TKey.h>
 #include <TProfile.h>
+#include <TTreeCache.h>
 #include <TH1F.h>
 #include <TRandom3.h>
 #include <TList.h>
@@ -173,7 +175,12 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper() :
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fPrefetchCacheSize(0),
+  fAsyncPrefetching(false),
+  fAsyncOpenNextFile(false),
+  fOpenedNewFile(false),
+  fStallTimer()
 {
   if (fgInstance != nullptr) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -250,7 +257,12 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper(const c
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fPrefetchCacheSize(0),
+  fAsyncPrefetching(false),
+  fAsyncOpenNextFile(false),
+  fOpenedNewFile(false),
+  fStallTimer()
 {
   if (fgInstance != 0) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -336,6 +348,9 @@ void AliAnalysisTaskEmcalEmbeddingHelper::RetrieveTaskPropertiesFromYAMLConfig()
   res = fYAMLConfig.GetProperty("randomFileAccess", fRandomFileAccess, false);
   res = fYAMLConfig.GetProperty("createHisto", fCreateHisto, false);
   res = fYAMLConfig.GetProperty("printTimingInfoInLog", fPrintTimingInfoToLog, false);
+  res = fYAMLConfig.GetProperty("prefetchCacheSize", fPrefetchCacheSize, false);
+  res = fYAMLConfig.GetProperty("asyncPrefetching", fAsyncPrefetching, false);
+  res = fYAMLConfig.GetProperty("asyncOpenNextFile", fAsyncOpenNextFile, false);
   // More general embedding helper properties
   res = fYAMLConfig.GetProperty("filePattern", fFilePattern, false);
   res = fYAMLConfig.GetProperty("inputFilename", fInputFilename, false);
@@ -1307,6 +1322,20 @@ void AliAnalysisTaskEmcalEmbeddingHelper::UserCreateOutputObjects()
   histTitle = "Number of embedded events rejected by event selection before success;Number of rejected events;Counts";
   fHistManager.CreateTH1(histName, histTitle, 200, 0, 200);
 
+  // Time spent waiting for the embedded event
+  histName = "fHistEmbeddedEventStallTime";
+  histTitle = "Time to retrieve the embedded event;Real time (ms);Counts";
+  fHistManager.CreateTH1(histName, histTitle, 1000, 0, 1000);
+
+  histName = "fHistEmbeddedEventStallTimeSummary";
+  histTitle = "Mean time to retrieve the embedded event;Event type;Real time (ms)";
+  binLabels = {"All", "NewFile", "SameFile"};
+  fHistManager.CreateTProfile(histName, histTitle, binLabels.size(), 0, binLabels.size());
+  auto histStallTimeSummary = static_cast<TProfile *>(fHistManager.FindObject(histName));
+  for (unsigned int i = 1; i <= binLabels.size(); i++) {
+    histStallTimeSummary->GetXaxis()->SetBinLabel(i, binLabels.at(i-1).c_str());
+  }
+
   // Number of files embedded
   histName = "fHistNumberOfFilesEmbedded";
   histTitle = "Number of files which contributed events to be embedded";
@@ -1422,6 +1451,11 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::SetupInputFiles()
   if (fFilenames.size() > fMaxNumberOfFiles) {
     AliErrorStream() << "Number of input files (" << fFilenames.size() << ") is larger than the number of available files (" << fMaxNumberOfFiles << "). Something went wrong when adding some of those files to the TChain!\n";
   }
+
+  // Read cache of the chain. It is moved from one file to the next by the TChain and configured in SetupPrefetching()
+  if (fPrefetchCacheSize > 0) {
+    fChain->SetCacheSize(static_cast<Long64_t>(fPrefetchCacheSize) * 1024 * 1024);
+  }
   
   // Setup input event
   Bool_t res = InitEvent();
@@ -1566,6 +1600,10 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
   if (fLowerEntry > 0) {
     fFileNumber++;
   }
+  fOpenedNewFile = true;
+
+  // Read ahead in the new file and open the next one in the background
+  SetupPrefetching();
 
   // Add to the count the number of files which were embedded
   fHistManager.FillTH1("fHistNumberOfFilesEmbedded", 1);
@@ -1610,6 +1648,49 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
 
 }
 
+/**
+ * Configure the reading of the file which has just been loaded by InitTree():
+ * - the read cache caches all branches right away (no learning phase), so that the events following
+ *   the starting entry are read in large blocks. If requested, the cache is filled by a background
+ *   thread while the current events are processed.
+ * - if requested, the opening of the next file of the chain is started in the background. The TChain
+ *   picks up the pending request when it moves to that file, instead of opening it synchronously.
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::SetupPrefetching()
+{
+  // Past the end of the chain: GetNextEntry() will restart from the first file
+  if (!fChain->GetTree() || !fChain->GetCurrentFile()) {
+    return;
+  }
+
+  if (fPrefetchCacheSize > 0) {
+    TTreeCache * cache = fChain->GetReadCache(fChain->GetCurrentFile(), kTRUE);
+    if (cache) {
+      if (fAsyncPrefetching) {
+        cache->SetEnablePrefetching(kTRUE);
+      }
+      fChain->AddBranchToCache("*", kTRUE);
+      fChain->StopCacheLearningPhase();
+    }
+    else {
+      AliWarningStream() << "Unable to create the read cache for file " << fChain->GetCurrentFile()->GetName() << ".\n";
+    }
+  }
+
+  if (fAsyncOpenNextFile) {
+    // After the last file, GetNextEntry() restarts from the beginning of the chain
+    Int_t nextTree = fChain->GetTreeNumber() + 1;
+    if (nextTree >= static_cast<Int_t>(fMaxNumberOfFiles)) {
+      nextTree = 0;
+    }
+    TChainElement * nextElement = static_cast<TChainElement *>(fChain->GetListOfFiles()->At(nextTree));
+    if (nextElement && nextTree != fChain->GetTreeNumber()) {
+      AliDebugStream(2) << "Opening next file \"" << nextElement->GetTitle() << "\" in the background.\n";
+      TFile::AsyncOpen(nextElement->GetTitle());
+    }
+  }
+}
+
 /**
  * Extract pythia information from a cross section file. Modified from AliAnalysisTaskEmcal::PythiaInfoFromFile().
  *
@@ -1777,12 +1858,25 @@ void AliAnalysisTaskEmcalEmbeddingHelper::UserExec(Option_t*)
     }
   }
 
+  // Time spent waiting for the embedded event (opening files, reading and decompressing baskets, rejected events)
+  fStallTimer.Start(kTRUE);
+  fOpenedNewFile = false;
+
   if (!fInitializedNewFile) {
     InitTree();
   }
 
   Bool_t res = GetNextEntry();
 
+  fStallTimer.Stop();
+  if (fCreateHisto) {
+    Double_t stallTime = fStallTimer.RealTime() * 1000.;
+    fHistManager.FillTH1("fHistEmbeddedEventStallTime", stallTime);
+    // Bins: all events, events where a new file was opened, events from the already open file
+    fHistManager.FillProfile("fHistEmbeddedEventStallTimeSummary", 0.5, stallTime);
+    fHistManager.FillProfile("fHistEmbeddedEventStallTimeSummary", fOpenedNewFile ? 1.5 : 2.5, stallTime);
+  }
+
   if (!res) {
     AliError("Unable to get the event to embed. Nothing will be embedded.");
     return;
@@ -2007,6 +2101,9 @@ std::string AliAnalysisTaskEmcalEmbeddingHelper::toString(bool includeFileList)
   tempSS << "File list filename: \"" << fFileListFilename << "\"\n";
   tempSS << "Tree name: " << fTreeName << "\n";
   tempSS << "Print timing info to log: " << fPrintTimingInfoToLog << "\n";
+  tempSS << "Prefetch cache size (MB): " << fPrefetchCacheSize << "\n";
+  tempSS << "Asynchronous prefetching: " << fAsyncPrefetching << "\n";
+  tempSS << "Asynchronous opening of the next file: " << fAsyncOpenNextFile << "\n";
   tempSS << "Random event number access: " << fRandomEventNumberAccess << "\n";
   tempSS << "Random file access: " << fRandomFileAccess << "\n";
   tempSS << "Starting file index: " << fFilenameIndex << "\n";
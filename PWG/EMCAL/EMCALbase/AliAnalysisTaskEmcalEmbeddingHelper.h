@@ -123,6 +123,9 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   Int_t GetStartingFileIndex()                              const { return fFilenameIndex; }
   TString GetFileListFilename()                             const { return fFileListFilename; }
   bool GetCreateHistos()                                    const { return fCreateHisto; }
+  Int_t GetPrefetchCacheSize()                              const { return fPrefetchCacheSize; }
+  bool GetAsyncPrefetching()                                const { return fAsyncPrefetching; }
+  bool GetAsyncOpenNextFile()                               const { return fAsyncOpenNextFile; }
   TString GetExternalFilePath()                             const ;
   
   // Set
@@ -136,6 +139,16 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   void SetAOD(const char * treeName = "aodTree")                  { fTreeName     = treeName; }
   /// Set whether to print and plot execution time of InitTree()
   void SetPrintTimingInfoToLog(bool b)                            { fPrintTimingInfoToLog = b;}
+  /**
+   * Set the size of the read cache (TTreeCache) of the embedded chain. All branches are cached from the
+   * first entry read in each file, so the events following the (random) starting entry are read in large
+   * blocks instead of basket by basket. 0 leaves the ROOT default.
+   */
+  void SetPrefetchCacheSize(Int_t sizeMB)                         { fPrefetchCacheSize = sizeMB; }
+  /// Fill the read cache of the embedded chain in a background thread (requires SetPrefetchCacheSize())
+  void SetAsyncPrefetching(bool b = true)                         { fAsyncPrefetching = b; }
+  /// Open the next file of the embedded chain in the background while the current file is embedded
+  void SetAsyncOpenNextFile(bool b = true)                        { fAsyncOpenNextFile = b; }
   /**
    * Enable to begin embedding at a random entry in each embedded file. Will then loop around in order
    * so that all entries are made available.
@@ -308,6 +321,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   virtual Bool_t  CheckIsEmbeddedEventSelected();
   Bool_t          InitEvent()           ;
   void            InitTree()            ;
+  void            SetupPrefetching()    ;
   bool            PythiaInfoFromCrossSectionFile(std::string filename);
   // Validation helper
   void            ValidatePhysicsSelectionForInternalEventSelection();
@@ -386,6 +400,11 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   
   bool                                          fPrintTimingInfoToLog; ///< Flag to print time to execute InitTree(), for logging purposes
   TStopwatch                                    fTimer            ;    //!<! Timer for the InitTree() function
+  Int_t                                         fPrefetchCacheSize;    ///< Size (MB) of the read cache of the embedded chain (0: ROOT default)
+  bool                                          fAsyncPrefetching ;    ///< Fill the read cache in a background thread
+  bool                                          fAsyncOpenNextFile;    ///< Open the next file of the chain in the background
+  bool                                          fOpenedNewFile    ;    //!<! A new file was initialized while getting the current embedded event
+  TStopwatch                                    fStallTimer       ;    //!<! Timer for the time spent waiting for the embedded event
 
   static AliAnalysisTaskEmcalEmbeddingHelper   *fgInstance        ; //!<! Global instance of this class
 
@@ -394,7 +413,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   AliAnalysisTaskEmcalEmbeddingHelper &operator=(const AliAnalysisTaskEmcalEmbeddingHelper&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 14);
+  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 15);
   /// \endcond
 };
 #endif
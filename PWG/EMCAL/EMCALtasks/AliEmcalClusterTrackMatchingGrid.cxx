@@ -0,0 +1,137 @@
+/************************************************************************************
+ * Copyright (C) 2021, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include "AliEmcalClusterTrackMatchingGrid.h"
+#include <TMath.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace PWG::EMCAL;
+
+namespace {
+  const double kSectorSize = TMath::TwoPi() / 18.;    // Phi size of a supermodule sector (20 degrees)
+  const double kEtaRange = 0.7;                       // EMCal / DCal eta acceptance
+  const double kMinCellSize = 0.01;                   // Lower limit of the cell size, bounds the number of cells
+  const double kCellMargin = 1.01;                    // Cell size relative to the maximum distance
+}
+
+AliEmcalClusterTrackMatchingGrid::AliEmcalClusterTrackMatchingGrid():
+  fEtaMin(-kEtaRange),
+  fEtaCellSize(2. * kEtaRange),
+  fPhiCellSize(TMath::TwoPi()),
+  fNEtaCells(1),
+  fNPhiCells(1),
+  fNClusters(0),
+  fCellOffsets(),
+  fCellClusters(),
+  fClusterCells(),
+  fUnbucketed()
+{
+}
+
+void AliEmcalClusterTrackMatchingGrid::Configure(double maxDistance) {
+  fEtaMin = -kEtaRange;
+  if(!std::isfinite(maxDistance)) {
+    // Every pair passes (or fails) the distance cut: a single cell keeps all clusters as candidates
+    fNEtaCells = 1;
+    fNPhiCells = 1;
+  } else {
+    double minCellSize = std::max(kCellMargin * std::abs(maxDistance), kMinCellSize);
+    fNEtaCells = std::max(1, static_cast<int>(2. * kEtaRange / minCellSize));
+    int cellsPerSector = static_cast<int>(kSectorSize / minCellSize);
+    if(cellsPerSector >= 1) fNPhiCells = 18 * cellsPerSector;
+    else fNPhiCells = static_cast<int>(TMath::TwoPi() / minCellSize);
+    // Less than 3 cells in phi: the neighbours would overlap, use a single cell
+    if(fNPhiCells < 3) fNPhiCells = 1;
+  }
+  fEtaCellSize = 2. * kEtaRange / fNEtaCells;
+  fPhiCellSize = TMath::TwoPi() / fNPhiCells;
+  fNClusters = 0;
+}
+
+int AliEmcalClusterTrackMatchingGrid::EtaCell(double eta) const {
+  double x = (eta - fEtaMin) / fEtaCellSize;
+  if(x < 0.) return 0;
+  if(x >= fNEtaCells) return fNEtaCells - 1;
+  return static_cast<int>(x);
+}
+
+int AliEmcalClusterTrackMatchingGrid::PhiCell(double phi) const {
+  double x = (phi - TMath::TwoPi() * std::floor(phi / TMath::TwoPi())) / fPhiCellSize;
+  if(x < 0.) return 0;
+  if(x >= fNPhiCells) return fNPhiCells - 1;
+  return static_cast<int>(x);
+}
+
+void AliEmcalClusterTrackMatchingGrid::Build(int nclusters, const double *eta, const double *phi) {
+  const int ncells = fNEtaCells * fNPhiCells;
+  fNClusters = nclusters;
+  fCellOffsets.assign(ncells + 1, 0);
+  fClusterCells.resize(nclusters);
+  fUnbucketed.clear();
+
+  // Counting sort of the clusters by cell, keeping the index order within a cell
+  for(int icl = 0; icl < nclusters; icl++) {
+    if(std::isfinite(eta[icl]) && std::isfinite(phi[icl])) {
+      int cell = EtaCell(eta[icl]) * fNPhiCells + PhiCell(phi[icl]);
+      fClusterCells[icl] = cell;
+      fCellOffsets[cell + 1]++;
+    } else {
+      fClusterCells[icl] = -1;
+      fUnbucketed.push_back(icl);
+    }
+  }
+  for(int icell = 0; icell < ncells; icell++) fCellOffsets[icell + 1] += fCellOffsets[icell];
+  fCellClusters.resize(fCellOffsets[ncells]);
+  for(int icl = 0; icl < nclusters; icl++) {
+    if(fClusterCells[icl] < 0) continue;
+    fCellClusters[fCellOffsets[fClusterCells[icl]]++] = icl;
+  }
+  // The fill loop moved each offset to the start of the next cell
+  for(int icell = ncells; icell > 0; icell--) fCellOffsets[icell] = fCellOffsets[icell - 1];
+  fCellOffsets[0] = 0;
+}
+
+void AliEmcalClusterTrackMatchingGrid::GetCandidates(double eta, double phi, std::vector<int> &candidates) const {
+  candidates.clear();
+  if(!(std::isfinite(eta) && std::isfinite(phi))) {
+    for(int icl = 0; icl < fNClusters; icl++) candidates.push_back(icl);
+    return;
+  }
+
+  const int etacell = EtaCell(eta), phicell = PhiCell(phi);
+  const int etamin = std::max(0, etacell - 1), etamax = std::min(fNEtaCells - 1, etacell + 1);
+  for(int ieta = etamin; ieta <= etamax; ieta++) {
+    for(int iphi = 0; iphi < std::min(3, fNPhiCells); iphi++) {
+      // Neighbours in phi wrap around at 2 pi
+      int cellphi = fNPhiCells < 3 ? iphi : (phicell + iphi - 1 + fNPhiCells) % fNPhiCells;
+      int cell = ieta * fNPhiCells + cellphi;
+      candidates.insert(candidates.end(), fCellClusters.begin() + fCellOffsets[cell], fCellClusters.begin() + fCellOffsets[cell + 1]);
+    }
+  }
+  candidates.insert(candidates.end(), fUnbucketed.begin(), fUnbucketed.end());
+  std::sort(candidates.begin(), candidates.end());
+}
@@ -0,0 +1,107 @@
+/************************************************************************************
+ * Copyright (C) 2021, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALCLUSTERTRACKMATCHINGGRID_H
+#define ALIEMCALCLUSTERTRACKMATCHINGGRID_H
+
+#include <vector>
+
+namespace PWG {
+
+namespace EMCAL {
+
+/**
+ * @class AliEmcalClusterTrackMatchingGrid
+ * @brief Eta-phi grid of cluster positions for the cluster-track matching
+ * @ingroup EMCALCORRECTIONFW
+ * @since Oct 18, 2026
+ *
+ * The clusters of an event are bucketed in cells of an eta-phi grid, so that
+ * a track has to be compared only to the clusters in the cell containing its
+ * position on the EMCal surface and in the 8 neighbouring cells. The cells are
+ * at least 1% larger than the maximum matching distance, so the candidates
+ * contain all clusters within the maximum distance in eta and in phi
+ * (phi distance on the circle). The phi cells subdivide the 20 degree
+ * supermodule sectors, so that the cell boundaries coincide with the
+ * EMCal and DCal supermodule boundaries.
+ *
+ * Positions which are not finite are never bucketed: a track with such a
+ * position gets all clusters as candidates, a cluster with such a position
+ * is a candidate for every track. The candidates are returned sorted by
+ * cluster index, so that a matching loop over the candidates visits the
+ * clusters in the same order as a loop over all clusters.
+ */
+class AliEmcalClusterTrackMatchingGrid {
+public:
+  AliEmcalClusterTrackMatchingGrid();
+  ~AliEmcalClusterTrackMatchingGrid() {}
+
+  /**
+   * @brief Define the grid cells for a given maximum matching distance
+   * @param[in] maxDistance Maximum matching distance (in eta and phi)
+   */
+  void Configure(double maxDistance);
+
+  /**
+   * @brief Bucket the clusters of an event
+   * @param[in] nclusters Number of clusters
+   * @param[in] eta Cluster eta, indexed by cluster
+   * @param[in] phi Cluster phi, indexed by cluster
+   */
+  void Build(int nclusters, const double *eta, const double *phi);
+
+  /**
+   * @brief Get the clusters which can be matched to a track
+   * @param[in] eta Track eta on the EMCal surface
+   * @param[in] phi Track phi on the EMCal surface
+   * @param[out] candidates Indices of the candidate clusters, sorted
+   */
+  void GetCandidates(double eta, double phi, std::vector<int> &candidates) const;
+
+  int GetNumberOfEtaCells() const { return fNEtaCells; }
+  int GetNumberOfPhiCells() const { return fNPhiCells; }
+
+private:
+  int EtaCell(double eta) const;
+  int PhiCell(double phi) const;
+
+  double            fEtaMin;          ///< Lower eta edge of the grid (clusters and tracks beyond the edges go to the edge cells)
+  double            fEtaCellSize;     ///< Cell size in eta
+  double            fPhiCellSize;     ///< Cell size in phi
+  int               fNEtaCells;       ///< Number of cells in eta
+  int               fNPhiCells;       ///< Number of cells in phi, covering the full azimuth
+  int               fNClusters;       ///< Number of clusters in the grid
+  std::vector<int>  fCellOffsets;     ///< Position of the first cluster of each cell in fCellClusters (size: number of cells + 1)
+  std::vector<int>  fCellClusters;    ///< Cluster indices ordered by cell, and by index within the cell
+  std::vector<int>  fClusterCells;    ///< Cell of each cluster, -1 if the position is not finite
+  std::vector<int>  fUnbucketed;      ///< Clusters with non-finite position
+};
+
+}
+
+}
+
+#endif /* ALIEMCALCLUSTERTRACKMATCHINGGRID_H */
@@ -5,6 +5,7 @@
 
 #include <TH1.h>
 #include <TList.h>
+#include <TVector3.h>
 
 #include "AliClusterContainer.h"
 #include "AliParticleContainer.h"
@@ -38,12 +39,17 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
   fUseOuterParamInESDs(kFALSE),
   fUpdateTracks(kTRUE),
   fUpdateClusters(kTRUE),
+  fUseMatchingGrid(kTRUE),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap(),
+  fMatchingGrid(),
   fEmcalTracks(0),
   fEmcalClusters(0),
   fNEmcalTracks(0),
   fNEmcalClusters(0),
+  fClusterEta(),
+  fClusterPhi(),
+  fMatchCandidates(),
   fHistMatchEtaAll(0),
   fHistMatchPhiAll(0),
   fNMCGenerToAccept(0),
@@ -82,6 +88,7 @@ Bool_t AliEmcalCorrectionClusterTrackMatcher::Initialize()
   GetProperty("maxDist", fMaxDistance);
   GetProperty("updateClusters", fUpdateClusters);
   GetProperty("updateTracks", fUpdateTracks);
+  GetProperty("useMatchingGrid", fUseMatchingGrid);
   
   // Track extrapolation to EMCal surface
   //
@@ -191,6 +198,8 @@ void AliEmcalCorrectionClusterTrackMatcher::ExecOnce()
 {
   fClusterContainerIndexMap.CopyMappingFrom(AliClusterContainer::GetEmcalContainerIndexMap(), fClusterCollArray);
   fParticleContainerIndexMap.CopyMappingFrom(AliParticleContainer::GetEmcalContainerIndexMap(), fParticleCollArray);
+
+  fMatchingGrid.Configure(fMaxDistance);
 }
 
 /**
@@ -373,16 +382,43 @@ void AliEmcalCorrectionClusterTrackMatcher::GenerateEmcalParticles()
 
 /**
  * Set the links between tracks and clusters.
+ *
+ * With the matching grid, each track is tested only against the clusters in the
+ * neighbouring grid cells. These candidates include all clusters within the maximum
+ * distance and are visited in the order of the loop over all clusters, so the matches
+ * (including their order in AliEmcalParticle) are the same as without the grid.
  */
 void AliEmcalCorrectionClusterTrackMatcher::DoMatching()
 {
   const Double_t maxd2 = fMaxDistance*fMaxDistance;
 
+  if (fUseMatchingGrid) {
+    // Cluster position as in GetEtaPhiDiff
+    fClusterEta.resize(fNEmcalClusters);
+    fClusterPhi.resize(fNEmcalClusters);
+    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+      AliVCluster* cluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster))->GetCluster();
+      Float_t pos[3] = {0};
+      cluster->GetPosition(pos);
+      TVector3 cpos(pos);
+      fClusterEta[icluster] = cpos.Eta();
+      fClusterPhi[icluster] = cpos.Phi();
+    }
+    fMatchingGrid.Build(fNEmcalClusters, fClusterEta.data(), fClusterPhi.data());
+  }
+
   for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
     AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
     AliVTrack* track = emcalTrack->GetTrack();
 
-    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    Int_t ncandidates = fNEmcalClusters;
+    if (fUseMatchingGrid) {
+      fMatchingGrid.GetCandidates(track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), fMatchCandidates);
+      ncandidates = fMatchCandidates.size();
+    }
+
+    for (Int_t icandidate = 0; icandidate < ncandidates; icandidate++) {
+      Int_t icluster = fUseMatchingGrid ? fMatchCandidates[icandidate] : icandidate;
       AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
       AliVCluster* cluster = emcalCluster->GetCluster();
       
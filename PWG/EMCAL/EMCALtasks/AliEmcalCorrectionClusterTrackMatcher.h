@@ -3,8 +3,11 @@
 
 #include "AliEmcalCorrectionComponent.h"
 
+#include <vector>
+
 #if !(defined(__CINT__) || defined(__MAKECINT__))
 #include "AliEmcalContainerIndexMap.h"
+#include "AliEmcalClusterTrackMatchingGrid.h"
 #endif
 
 class TH1;
@@ -88,17 +91,22 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   Bool_t        fUseOuterParamInESDs;   ///< Use TPC outer parameters instead of inner parameters for track propagation, ESDs only
   Bool_t        fUpdateTracks;          ///< update tracks with matching info
   Bool_t        fUpdateClusters;        ///< update clusters with matching info
+  Bool_t        fUseMatchingGrid;       ///< test each track only against the clusters in the neighbouring cells of an eta-phi grid, instead of all clusters
   
 #if !(defined(__CINT__) || defined(__MAKECINT__))
   // Handle mapping between index and containers
   AliEmcalContainerIndexMap <AliClusterContainer, AliVCluster> fClusterContainerIndexMap;    //!<! Mapping between index and cluster containers
   AliEmcalContainerIndexMap <AliParticleContainer, AliVParticle> fParticleContainerIndexMap; //!<! Mapping between index and particle containers
+  PWG::EMCAL::AliEmcalClusterTrackMatchingGrid fMatchingGrid; //!<! Clusters bucketed on an eta-phi grid
 #endif
 
   TClonesArray *fEmcalTracks;           //!<!emcal tracks
   TClonesArray *fEmcalClusters;         //!<!emcal clusters
   Int_t         fNEmcalTracks;          //!<!number of emcal tracks
   Int_t         fNEmcalClusters;        //!<!number of emcal clusters
+  std::vector<Double_t> fClusterEta;    //!<!cluster eta, input to the matching grid
+  std::vector<Double_t> fClusterPhi;    //!<!cluster phi, input to the matching grid
+  std::vector<Int_t> fMatchCandidates;  //!<!clusters to be tested against the current track
   TH1          *fHistMatchEtaAll;       //!<!deta distribution
   TH1          *fHistMatchPhiAll;       //!<!dphi distribution
   TH1          *fHistMatchEta[10][9][2]; //!<!deta distribution
@@ -116,7 +124,7 @@ private:
   static RegisterCorrectionComponent<AliEmcalCorrectionClusterTrackMatcher> reg;
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 5); // EMCal cluster track matcher correction component
+  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 6); // EMCal cluster track matcher correction component
   /// \endcond
 };
 
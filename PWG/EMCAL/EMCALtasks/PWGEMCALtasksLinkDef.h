@@ -77,4 +77,5 @@
 #pragma link C++ class PWG::EMCAL::TestImplAliEmcalTrackSelectionITSpure+;
 #pragma link C++ class PWG::EMCAL::TestImplAliEmcalTrackSelectionHybrid+;
 #pragma link C++ class PWG::EMCAL::TestImplAliEmcalTrackSelectionTPConly+;
+#pragma link C++ class PWG::EMCAL::TestAliEmcalClusterTrackMatchingGrid+;
 #endif
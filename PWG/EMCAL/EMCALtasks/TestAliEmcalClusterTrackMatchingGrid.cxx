@@ -0,0 +1,222 @@
+/************************************************************************************
+ * Copyright (C) 2021, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include <TMath.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <TVector2.h>
+
+#include "AliEmcalClusterTrackMatchingGrid.h"
+#include "TestAliEmcalClusterTrackMatchingGrid.h"
+
+using namespace PWG::EMCAL;
+
+namespace {
+  // Multiplicity classes (number of tracks and clusters in the EMCal / DCal acceptance)
+  const int kNClasses = 5;
+  const char *kClassNames[kNClasses] = {"pp", "peripheral Pb-Pb", "semi-central Pb-Pb", "central Pb-Pb", "central Pb-Pb + embedding"};
+  const int kNTracks[kNClasses] = {10, 100, 500, 1500, 3000};
+  const int kNClusters[kNClasses] = {5, 50, 250, 700, 1400};
+}
+
+bool TestAliEmcalClusterTrackMatchingGrid::RunAllTests() const {
+  bool result = true;
+  const double maxDistances[] = {0.1, 0.025, 0.3, 0.5};
+  for(auto maxDistance : maxDistances) {
+    for(int iclass = 0; iclass < kNClasses; iclass++) {
+      if(!TestMultiplicityClass(kNTracks[iclass], kNClusters[iclass], maxDistance, 20)) {
+        std::cerr << "Matching differs for multiplicity class " << kClassNames[iclass] << ", max distance " << maxDistance << std::endl;
+        result = false;
+      }
+    }
+  }
+  if(!TestEdgeCases()) {
+    std::cerr << "Matching differs for edge cases" << std::endl;
+    result = false;
+  }
+  std::cout << "TestAliEmcalClusterTrackMatchingGrid: " << (result ? "passed" : "failed") << std::endl;
+  return result;
+}
+
+void TestAliEmcalClusterTrackMatchingGrid::RunBenchmark(int nevents) const {
+  const double maxDistance = 0.1;
+  TRandom3 rnd(42);
+  std::vector<double> trackEta, trackPhi, clusterEta, clusterPhi;
+  std::vector<Match> matches;
+  TStopwatch timer;
+  for(int iclass = 0; iclass < kNClasses; iclass++) {
+    double timeAllPairs = 0., timeGrid = 0.;
+    size_t nmatches = 0;
+    for(int iev = 0; iev < nevents; iev++) {
+      GenerateEvent(rnd, kNTracks[iclass], kNClusters[iclass], trackEta, trackPhi, clusterEta, clusterPhi);
+      timer.Start();
+      MatchAllPairs(trackEta, trackPhi, clusterEta, clusterPhi, maxDistance, matches);
+      timer.Stop();
+      timeAllPairs += timer.CpuTime();
+      nmatches += matches.size();
+      timer.Start();
+      MatchGrid(trackEta, trackPhi, clusterEta, clusterPhi, maxDistance, matches);
+      timer.Stop();
+      timeGrid += timer.CpuTime();
+    }
+    std::cout << kClassNames[iclass] << " (" << kNTracks[iclass] << " tracks, " << kNClusters[iclass] << " clusters, "
+              << static_cast<double>(nmatches) / nevents << " matches/event): all pairs " << 1000. * timeAllPairs / nevents
+              << " ms/event, grid " << 1000. * timeGrid / nevents << " ms/event";
+    if(timeGrid > 0.) std::cout << ", speed-up " << timeAllPairs / timeGrid;
+    std::cout << std::endl;
+  }
+}
+
+bool TestAliEmcalClusterTrackMatchingGrid::TestMultiplicityClass(int ntracks, int nclusters, double maxDistance, int nevents) const {
+  TRandom3 rnd(ntracks + nclusters);
+  std::vector<double> trackEta, trackPhi, clusterEta, clusterPhi;
+  for(int iev = 0; iev < nevents; iev++) {
+    GenerateEvent(rnd, ntracks, nclusters, trackEta, trackPhi, clusterEta, clusterPhi);
+    if(!CompareMatching(trackEta, trackPhi, clusterEta, clusterPhi, maxDistance)) return false;
+  }
+  return true;
+}
+
+bool TestAliEmcalClusterTrackMatchingGrid::TestEdgeCases() const {
+  const double nan = std::numeric_limits<double>::quiet_NaN(), inf = std::numeric_limits<double>::infinity();
+  // Clusters on cell boundaries (multiples of the sector size and of the cell sizes for maxDistance 0.1),
+  // at the phi wrap in both conventions, beyond the eta acceptance and with non-finite eta
+  // (non-finite phi are not tested, TVector2::Phi_mpi_pi does not accept them)
+  std::vector<double> clusterEta = {0., -0.7, 0.7, 0.1077, -0.1077, 0.75, -2., nan, inf, 0.};
+  std::vector<double> clusterPhi = {0., TMath::Pi(), -TMath::Pi(), TMath::TwoPi() / 18., 1.3963, 2. * TMath::TwoPi() / 54., 3.1, 1., 2., -1e-12};
+  std::vector<double> trackEta, trackPhi;
+  for(size_t icl = 0; icl < clusterEta.size(); icl++) {
+    // Tracks at the cluster positions, shifted by the maximum distance and by a bit more
+    const double shifts[] = {0., 0.0999999, 0.1, 0.1000001, -0.1, -0.0999999};
+    for(auto deta : shifts) {
+      for(auto dphi : shifts) {
+        trackEta.push_back(clusterEta[icl] + deta);
+        trackPhi.push_back(clusterPhi[icl] + dphi);
+      }
+    }
+  }
+  // Tracks not propagated to the EMCal surface and with non-finite eta
+  trackEta.insert(trackEta.end(), {-999., 0., nan, inf, -inf});
+  trackPhi.insert(trackPhi.end(), {-999., -999., 1., 1., 1.});
+  // Phi in [0, 2 pi) for the tracks
+  trackEta.push_back(0.);
+  trackPhi.push_back(TMath::TwoPi() - 1e-12);
+
+  const double maxDistances[] = {0.1, 0., -0.1, 1e-4, 0.35, 2., 10., nan, inf};
+  for(auto maxDistance : maxDistances) {
+    if(!CompareMatching(trackEta, trackPhi, clusterEta, clusterPhi, maxDistance)) {
+      std::cerr << "Edge cases: matching differs for max distance " << maxDistance << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestAliEmcalClusterTrackMatchingGrid::CompareMatching(const std::vector<double> &trackEta, const std::vector<double> &trackPhi,
+                                                           const std::vector<double> &clusterEta, const std::vector<double> &clusterPhi, double maxDistance) const {
+  std::vector<Match> reference, grid;
+  MatchAllPairs(trackEta, trackPhi, clusterEta, clusterPhi, maxDistance, reference);
+  MatchGrid(trackEta, trackPhi, clusterEta, clusterPhi, maxDistance, grid);
+  if(reference.size() != grid.size()) {
+    std::cerr << "Number of matches differs: " << reference.size() << " (all pairs) " << grid.size() << " (grid)" << std::endl;
+    return false;
+  }
+  for(size_t imatch = 0; imatch < reference.size(); imatch++) {
+    const Match &ref = reference[imatch], &test = grid[imatch];
+    bool sameDistance = (ref.fDistance == test.fDistance) || (std::isnan(ref.fDistance) && std::isnan(test.fDistance));
+    if(ref.fTrack != test.fTrack || ref.fCluster != test.fCluster || !sameDistance) {
+      std::cerr << "Match " << imatch << " differs: track " << ref.fTrack << " cluster " << ref.fCluster << " d " << ref.fDistance
+                << " (all pairs), track " << test.fTrack << " cluster " << test.fCluster << " d " << test.fDistance << " (grid)" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void TestAliEmcalClusterTrackMatchingGrid::GenerateEvent(TRandom &rnd, int ntracks, int nclusters, std::vector<double> &trackEta, std::vector<double> &trackPhi,
+                                                         std::vector<double> &clusterEta, std::vector<double> &clusterPhi) {
+  // Clusters in the EMCal (80-187 degrees) and DCal (260-327 degrees) acceptance, phi in (-pi, pi] as from TVector3
+  clusterEta.resize(nclusters);
+  clusterPhi.resize(nclusters);
+  for(int icl = 0; icl < nclusters; icl++) {
+    clusterEta[icl] = rnd.Uniform(-0.7, 0.7);
+    double phi = rnd.Rndm() < 0.6 ? rnd.Uniform(80., 187.) : rnd.Uniform(260., 327.);
+    clusterPhi[icl] = TVector2::Phi_mpi_pi(phi * TMath::DegToRad());
+  }
+  // Half of the tracks close to a cluster, the others anywhere in the acceptance, phi in [0, 2 pi)
+  trackEta.resize(ntracks);
+  trackPhi.resize(ntracks);
+  for(int itr = 0; itr < ntracks; itr++) {
+    if(nclusters && rnd.Rndm() < 0.5) {
+      int icl = static_cast<int>(rnd.Rndm() * nclusters);
+      trackEta[itr] = clusterEta[icl] + rnd.Gaus(0., 0.03);
+      trackPhi[itr] = TVector2::Phi_0_2pi(clusterPhi[icl] + rnd.Gaus(0., 0.05));
+    } else {
+      trackEta[itr] = rnd.Uniform(-0.9, 0.9);
+      trackPhi[itr] = rnd.Uniform(0., TMath::TwoPi());
+    }
+  }
+}
+
+void TestAliEmcalClusterTrackMatchingGrid::MatchAllPairs(const std::vector<double> &trackEta, const std::vector<double> &trackPhi,
+                                                         const std::vector<double> &clusterEta, const std::vector<double> &clusterPhi, double maxDistance, std::vector<Match> &matches) {
+  // Same distance and selection as AliEmcalCorrectionClusterTrackMatcher::DoMatching
+  const double maxd2 = maxDistance * maxDistance;
+  matches.clear();
+  for(size_t itr = 0; itr < trackEta.size(); itr++) {
+    for(size_t icl = 0; icl < clusterEta.size(); icl++) {
+      double deta = trackEta[itr] - clusterEta[icl];
+      double dphi = TVector2::Phi_mpi_pi(trackPhi[itr] - clusterPhi[icl]);
+      double d2 = deta * deta + dphi * dphi;
+      if(d2 > maxd2) continue;
+      matches.push_back({static_cast<int>(itr), static_cast<int>(icl), std::sqrt(d2)});
+    }
+  }
+}
+
+void TestAliEmcalClusterTrackMatchingGrid::MatchGrid(const std::vector<double> &trackEta, const std::vector<double> &trackPhi,
+                                                     const std::vector<double> &clusterEta, const std::vector<double> &clusterPhi, double maxDistance, std::vector<Match> &matches) {
+  const double maxd2 = maxDistance * maxDistance;
+  matches.clear();
+  AliEmcalClusterTrackMatchingGrid grid;
+  grid.Configure(maxDistance);
+  grid.Build(clusterEta.size(), clusterEta.data(), clusterPhi.data());
+  std::vector<int> candidates;
+  for(size_t itr = 0; itr < trackEta.size(); itr++) {
+    grid.GetCandidates(trackEta[itr], trackPhi[itr], candidates);
+    for(auto icl : candidates) {
+      double deta = trackEta[itr] - clusterEta[icl];
+      double dphi = TVector2::Phi_mpi_pi(trackPhi[itr] - clusterPhi[icl]);
+      double d2 = deta * deta + dphi * dphi;
+      if(d2 > maxd2) continue;
+      matches.push_back({static_cast<int>(itr), icl, std::sqrt(d2)});
+    }
+  }
+}
@@ -0,0 +1,99 @@
+/************************************************************************************
+ * Copyright (C) 2021, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef TESTALIEMCALCLUSTERTRACKMATCHINGGRID_H
+#define TESTALIEMCALCLUSTERTRACKMATCHINGGRID_H
+
+#include <vector>
+
+class TRandom;
+
+namespace PWG {
+
+namespace EMCAL {
+
+/**
+ * @class TestAliEmcalClusterTrackMatchingGrid
+ * @brief Unit test and benchmark for the grid of AliEmcalCorrectionClusterTrackMatcher
+ * @ingroup EMCALCORRECTIONFW
+ * @since Oct 18, 2026
+ *
+ * Compares the matches obtained with AliEmcalClusterTrackMatchingGrid to the
+ * matches of the loop over all track-cluster pairs, using the distance
+ * definition of AliEmcalCorrectionComponent::GetEtaPhiDiff. The matches
+ * (track, cluster, distance, in matching order) must be identical. Events are
+ * generated for several multiplicity classes, from peripheral pp-like events
+ * to central Pb-Pb with embedding, and for edge cases (positions at the cell
+ * boundaries and at the phi wrap, non-propagated tracks, non-finite eta,
+ * degenerate maximum distances).
+ */
+class TestAliEmcalClusterTrackMatchingGrid {
+public:
+
+  /**
+   * @struct Match
+   * @brief Matched track-cluster pair
+   */
+  struct Match {
+    int fTrack;           ///< Track index
+    int fCluster;         ///< Cluster index
+    double fDistance;     ///< Distance in eta-phi
+  };
+
+  TestAliEmcalClusterTrackMatchingGrid() {}
+  virtual ~TestAliEmcalClusterTrackMatchingGrid() {}
+
+  /**
+   * @brief Run the comparison for all multiplicity classes and edge cases
+   * @return True if all matches agree, false otherwise
+   */
+  bool RunAllTests() const;
+
+  /**
+   * @brief Time the loop over all pairs and the grid for all multiplicity classes
+   * @param[in] nevents Number of events per multiplicity class
+   */
+  void RunBenchmark(int nevents = 200) const;
+
+protected:
+  bool TestMultiplicityClass(int ntracks, int nclusters, double maxDistance, int nevents) const;
+  bool TestEdgeCases() const;
+  bool CompareMatching(const std::vector<double> &trackEta, const std::vector<double> &trackPhi,
+                       const std::vector<double> &clusterEta, const std::vector<double> &clusterPhi, double maxDistance) const;
+
+  static void GenerateEvent(TRandom &rnd, int ntracks, int nclusters, std::vector<double> &trackEta, std::vector<double> &trackPhi,
+                            std::vector<double> &clusterEta, std::vector<double> &clusterPhi);
+  static void MatchAllPairs(const std::vector<double> &trackEta, const std::vector<double> &trackPhi,
+                            const std::vector<double> &clusterEta, const std::vector<double> &clusterPhi, double maxDistance, std::vector<Match> &matches);
+  static void MatchGrid(const std::vector<double> &trackEta, const std::vector<double> &trackPhi,
+                        const std::vector<double> &clusterEta, const std::vector<double> &clusterPhi, double maxDistance, std::vector<Match> &matches);
+};
+
+}
+
+}
+
+#endif /* TESTALIEMCALCLUSTERTRACKMATCHINGGRID_H */
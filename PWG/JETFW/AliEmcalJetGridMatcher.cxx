@@ -0,0 +1,219 @@
+/************************************************************************************
+ * Copyright (C) 2017, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <algorithm>
+
+#include <TMath.h>
+#include <TVector2.h>
+
+#include "AliEmcalJet.h"
+#include "AliEmcalJetGridMatcher.h"
+#include "AliJetContainer.h"
+
+using namespace PWG::JETFW;
+
+/// Upper limit on the number of cells per dimension (very small matching radii)
+const Int_t kMaxCellsPerDim = 1000;
+
+AliEmcalJetGridMatcher::AliEmcalJetGridMatcher():
+  fPeriodicPhi(kTRUE),
+  fEta1(),
+  fPhi1(),
+  fEta2(),
+  fPhi2(),
+  fEntries1(),
+  fEntries2(),
+  fGrid1(),
+  fGrid2(),
+  fClosest12(),
+  fClosest21(),
+  fDistance12(),
+  fDistance21(),
+  fMatches()
+{
+}
+
+Int_t AliEmcalJetGridMatcher::MatchJets(const AliJetContainer &cont1, const AliJetContainer &cont2, Double_t maxDist) {
+  const Int_t nJets1 = cont1.GetNJets(), nJets2 = cont2.GetNJets();
+  fEta1.assign(nJets1, 0.);
+  fPhi1.assign(nJets1, 0.);
+  fEta2.assign(nJets2, 0.);
+  fPhi2.assign(nJets2, 0.);
+  fEntries1.clear();
+  fEntries2.clear();
+
+  for (Int_t i = 0; i < nJets1; i++) {
+    AliEmcalJet *jet = cont1.GetAcceptJet(i);
+    if (!jet) continue;
+    fEta1[i] = jet->Eta();
+    fPhi1[i] = jet->Phi();
+    fEntries1.push_back(i);
+  }
+  for (Int_t j = 0; j < nJets2; j++) {
+    AliEmcalJet *jet = cont2.GetAcceptJet(j);
+    if (!jet) continue;
+    fEta2[j] = jet->Eta();
+    fPhi2[j] = jet->Phi();
+    fEntries2.push_back(j);
+  }
+
+  Int_t nmatches = MatchEntries(fEntries1, fEntries2, maxDist);
+  for (auto &match : fMatches) {
+    match.fJet1 = cont1.GetJet(match.fIndex1);
+    match.fJet2 = cont2.GetJet(match.fIndex2);
+  }
+  return nmatches;
+}
+
+Int_t AliEmcalJetGridMatcher::MatchPositions(const std::vector<Double_t> &eta1, const std::vector<Double_t> &phi1,
+                                             const std::vector<Double_t> &eta2, const std::vector<Double_t> &phi2, Double_t maxDist) {
+  fEta1 = eta1;
+  fPhi1 = phi1;
+  fEta2 = eta2;
+  fPhi2 = phi2;
+  const Int_t n1 = std::min(eta1.size(), phi1.size()), n2 = std::min(eta2.size(), phi2.size());
+  fEntries1.resize(n1);
+  fEntries2.resize(n2);
+  for (Int_t i = 0; i < n1; i++) fEntries1[i] = i;
+  for (Int_t j = 0; j < n2; j++) fEntries2[j] = j;
+  return MatchEntries(fEntries1, fEntries2, maxDist);
+}
+
+Double_t AliEmcalJetGridMatcher::DeltaPhi(Double_t phi1, Double_t phi2) {
+  return TVector2::Phi_mpi_pi(phi1 - phi2);
+}
+
+Int_t AliEmcalJetGridMatcher::MatchEntries(const std::vector<Int_t> &entries1, const std::vector<Int_t> &entries2, Double_t maxDist) {
+  fClosest12.assign(fEta1.size(), -1);
+  fClosest21.assign(fEta2.size(), -1);
+  fDistance12.assign(fEta1.size(), maxDist);
+  fDistance21.assign(fEta2.size(), maxDist);
+  fMatches.clear();
+  if (maxDist <= 0 || entries1.empty() || entries2.empty()) return 0;
+
+  // closest entry of the other set, searched on the grid of the other set
+  BuildGrid(fGrid2, fEta2, fPhi2, entries2, maxDist);
+  FindClosest(fGrid2, fEta2, fPhi2, fEta1, fPhi1, entries1, maxDist, fClosest12, fDistance12);
+  BuildGrid(fGrid1, fEta1, fPhi1, entries1, maxDist);
+  FindClosest(fGrid1, fEta1, fPhi1, fEta2, fPhi2, entries2, maxDist, fClosest21, fDistance21);
+
+  for (auto i : entries1) {
+    Int_t j = fClosest12[i];
+    if (j < 0 || fClosest21[j] != i) continue;
+    Match match;
+    match.fIndex1 = i;
+    match.fIndex2 = j;
+    match.fJet1 = 0;
+    match.fJet2 = 0;
+    match.fDistance = fDistance12[i];
+    fMatches.push_back(match);
+  }
+  return fMatches.size();
+}
+
+Int_t AliEmcalJetGridMatcher::PhiCell(const Grid &grid, Double_t phi) const {
+  if (fPeriodicPhi) return std::min(Int_t(TVector2::Phi_0_2pi(phi) / grid.fPhiWidth), grid.fNPhi - 1);
+  // outside [0, 2pi) in the first resp. last cell: neighbours within maxDist are still in the adjacent cells
+  return std::max(0, std::min(Int_t(TMath::Floor(phi / grid.fPhiWidth)), grid.fNPhi - 1));
+}
+
+void AliEmcalJetGridMatcher::BuildGrid(Grid &grid, const std::vector<Double_t> &eta, const std::vector<Double_t> &phi, const std::vector<Int_t> &entries, Double_t maxDist) {
+  Double_t etaMin = eta[entries.front()], etaMax = etaMin;
+  for (auto i : entries) {
+    etaMin = std::min(etaMin, eta[i]);
+    etaMax = std::max(etaMax, eta[i]);
+  }
+
+  // cells not smaller than the maximum distance: all candidates within the 3x3 cells around
+  grid.fEtaMin = etaMin;
+  grid.fEtaWidth = std::max(maxDist, (etaMax - etaMin) / kMaxCellsPerDim);
+  grid.fNEta = std::min(Int_t((etaMax - etaMin) / grid.fEtaWidth) + 1, kMaxCellsPerDim);
+  grid.fNPhi = std::max(1, std::min(Int_t(TMath::TwoPi() / maxDist), kMaxCellsPerDim));
+  grid.fPhiWidth = TMath::TwoPi() / grid.fNPhi;
+
+  const Int_t ncells = grid.fNEta * grid.fNPhi;
+  std::vector<Int_t> cellOf(entries.size());
+  grid.fCellStart.assign(ncells + 1, 0);
+  for (UInt_t k = 0; k < entries.size(); k++) {
+    Int_t i = entries[k];
+    Int_t ieta = std::min(Int_t((eta[i] - grid.fEtaMin) / grid.fEtaWidth), grid.fNEta - 1);
+    Int_t iphi = PhiCell(grid, phi[i]);
+    cellOf[k] = ieta * grid.fNPhi + iphi;
+    grid.fCellStart[cellOf[k] + 1]++;
+  }
+  for (Int_t icell = 0; icell < ncells; icell++) grid.fCellStart[icell + 1] += grid.fCellStart[icell];
+
+  // entries keep their order inside a cell
+  std::vector<Int_t> fill(grid.fCellStart.begin(), grid.fCellStart.end() - 1);
+  grid.fEntries.resize(entries.size());
+  for (UInt_t k = 0; k < entries.size(); k++) grid.fEntries[fill[cellOf[k]]++] = entries[k];
+}
+
+void AliEmcalJetGridMatcher::FindClosest(const Grid &grid, const std::vector<Double_t> &etaTarget, const std::vector<Double_t> &phiTarget,
+                                         const std::vector<Double_t> &eta, const std::vector<Double_t> &phi, const std::vector<Int_t> &entries,
+                                         Double_t maxDist, std::vector<Int_t> &closest, std::vector<Double_t> &distance) const {
+  Int_t phiCells[3];
+  for (auto i : entries) {
+    Double_t etaRel = (eta[i] - grid.fEtaMin) / grid.fEtaWidth;
+    if (etaRel < -1 || etaRel >= grid.fNEta + 1) continue;     // farther than maxDist from all cells
+    Int_t ieta = Int_t(TMath::Floor(etaRel));
+    Int_t iphi = PhiCell(grid, phi[i]);
+
+    // neighbouring phi cells, periodic if requested, each cell only once
+    Int_t nPhiCells = 0;
+    if (grid.fNPhi < 3) {
+      for (Int_t ip = 0; ip < grid.fNPhi; ip++) phiCells[nPhiCells++] = ip;
+    }
+    else if (!fPeriodicPhi) {
+      for (Int_t ip = std::max(iphi - 1, 0); ip <= std::min(iphi + 1, grid.fNPhi - 1); ip++) phiCells[nPhiCells++] = ip;
+    }
+    else {
+      phiCells[nPhiCells++] = (iphi + grid.fNPhi - 1) % grid.fNPhi;
+      phiCells[nPhiCells++] = iphi;
+      phiCells[nPhiCells++] = (iphi + 1) % grid.fNPhi;
+    }
+
+    Int_t best = -1;
+    Double_t bestDist = maxDist;
+    for (Int_t ie = std::max(ieta - 1, 0); ie <= std::min(ieta + 1, grid.fNEta - 1); ie++) {
+      for (Int_t ip = 0; ip < nPhiCells; ip++) {
+        Int_t icell = ie * grid.fNPhi + phiCells[ip];
+        for (Int_t k = grid.fCellStart[icell]; k < grid.fCellStart[icell + 1]; k++) {
+          Int_t j = grid.fEntries[k];
+          Double_t dPhi = fPeriodicPhi ? DeltaPhi(phi[i], phiTarget[j]) : phi[i] - phiTarget[j];
+          Double_t dEta = eta[i] - etaTarget[j];
+          Double_t dR = TMath::Sqrt(dPhi * dPhi + dEta * dEta);
+          if (dR < bestDist || (dR == bestDist && best >= 0 && j < best)) {
+            best = j;
+            bestDist = dR;
+          }
+        }
+      }
+    }
+    closest[i] = best;
+    distance[i] = best >= 0 ? bestDist : maxDist;
+  }
+}
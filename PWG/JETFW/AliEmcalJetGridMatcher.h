@@ -0,0 +1,193 @@
+/************************************************************************************
+ * Copyright (C) 2017, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALJETGRIDMATCHER_H
+#define ALIEMCALJETGRIDMATCHER_H
+
+#include <vector>
+#include <Rtypes.h>
+
+class AliEmcalJet;
+class AliJetContainer;
+
+namespace PWG {
+
+namespace JETFW {
+
+/**
+ * @class AliEmcalJetGridMatcher
+ * @brief Geometrical matching of the jets of two jet containers using an eta-phi grid
+ * @ingroup JETFW
+ *
+ * Jets of both containers are matched if they are mutually closest in
+ * \f$\Delta R = \sqrt{\Delta\eta^2 + \Delta\varphi^2}\f$ (periodic in \f$\varphi\f$,
+ * as in AliEmcalJet::DeltaR) and closer than the maximum distance. This is the
+ * matching done in the jet taggers, where the distance between all pairs of jets
+ * was computed. Here the jets of each container are binned on an eta-phi grid
+ * with cells not smaller than the maximum distance, so that the nearest neighbour
+ * of a jet is searched only in the 3x3 cells around it.
+ *
+ * Ties are resolved in favour of the jet with the lowest index, as in the
+ * loops over all pairs.
+ *
+ * With SetPeriodicPhi(kFALSE) the distance uses the plain difference of the
+ * azimuthal angles, as the kd-tree matching of AliEmcalJetTaggerTaskFast did:
+ * jets on both sides of \f$\varphi = 0\f$ are not matched.
+ *
+ * ~~~{.cxx}
+ * PWG::JETFW::AliEmcalJetGridMatcher matcher;
+ * matcher.MatchJets(*GetJetContainer(0), *GetJetContainer(1), 0.3);
+ * for (const auto &match : matcher.GetMatches()) {
+ *   match.fJet1->SetClosestJet(match.fJet2, match.fDistance);
+ *   match.fJet2->SetClosestJet(match.fJet1, match.fDistance);
+ * }
+ * ~~~
+ */
+class AliEmcalJetGridMatcher {
+public:
+
+  /**
+   * @struct Match
+   * @brief Pair of mutually closest jets
+   */
+  struct Match {
+    Int_t        fIndex1;       ///< Index of the jet in the array of the first container
+    Int_t        fIndex2;       ///< Index of the jet in the array of the second container
+    AliEmcalJet *fJet1;         ///< Jet of the first container (0 if matched from positions only)
+    AliEmcalJet *fJet2;         ///< Jet of the second container (0 if matched from positions only)
+    Double_t     fDistance;     ///< Distance between the two jets
+  };
+
+  /**
+   * @brief Constructor
+   */
+  AliEmcalJetGridMatcher();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalJetGridMatcher() {}
+
+  /**
+   * @brief Match the accepted jets of two jet containers
+   * @param cont1 First jet container
+   * @param cont2 Second jet container
+   * @param maxDist Maximum distance (exclusive) between matched jets
+   * @return Number of matched pairs
+   */
+  Int_t MatchJets(const AliJetContainer &cont1, const AliJetContainer &cont2, Double_t maxDist);
+
+  /**
+   * @brief Match two sets of positions
+   *
+   * Indices in the matches and in the closest neighbour lists refer to the
+   * position in the input vectors.
+   *
+   * @param eta1 Pseudorapidities of the first set
+   * @param phi1 Azimuthal angles of the first set
+   * @param eta2 Pseudorapidities of the second set
+   * @param phi2 Azimuthal angles of the second set
+   * @param maxDist Maximum distance (exclusive) between matched positions
+   * @return Number of matched pairs
+   */
+  Int_t MatchPositions(const std::vector<Double_t> &eta1, const std::vector<Double_t> &phi1,
+                       const std::vector<Double_t> &eta2, const std::vector<Double_t> &phi2, Double_t maxDist);
+
+  /**
+   * @brief Define whether the distance is periodic in \f$\varphi\f$
+   * @param periodic If true (default) \f$\Delta\varphi\f$ is taken in \f$[-\pi, \pi)\f$, otherwise as plain difference
+   */
+  void SetPeriodicPhi(Bool_t periodic) { fPeriodicPhi = periodic; }
+
+  /**
+   * @brief Get the mutually closest pairs found in the last matching
+   * @return List of matches, ordered by the index in the first set
+   */
+  const std::vector<Match> &GetMatches() const { return fMatches; }
+
+  /**
+   * @brief Get the closest neighbour in the second set of an entry of the first set
+   * @param i Entry in the first set (index in the container array for MatchJets)
+   * @return Entry in the second set, -1 if none is closer than the maximum distance
+   */
+  Int_t GetClosest12(Int_t i) const { return i >= 0 && i < (Int_t)fClosest12.size() ? fClosest12[i] : -1; }
+
+  /**
+   * @brief Get the closest neighbour in the first set of an entry of the second set
+   * @param j Entry in the second set (index in the container array for MatchJets)
+   * @return Entry in the first set, -1 if none is closer than the maximum distance
+   */
+  Int_t GetClosest21(Int_t j) const { return j >= 0 && j < (Int_t)fClosest21.size() ? fClosest21[j] : -1; }
+
+  /**
+   * @brief Azimuthal distance in \f$[-\pi, \pi)\f$
+   */
+  static Double_t DeltaPhi(Double_t phi1, Double_t phi2);
+
+protected:
+
+  /**
+   * @struct Grid
+   * @brief Positions binned in eta-phi cells, stored cell by cell
+   */
+  struct Grid {
+    Double_t              fEtaMin;      ///< Lower edge of the first eta cell
+    Double_t              fEtaWidth;    ///< Width of the eta cells
+    Double_t              fPhiWidth;    ///< Width of the phi cells
+    Int_t                 fNEta;        ///< Number of eta cells
+    Int_t                 fNPhi;        ///< Number of phi cells
+    std::vector<Int_t>    fCellStart;   ///< Offset of each cell in fEntries (size: number of cells + 1)
+    std::vector<Int_t>    fEntries;     ///< Entries sorted by cell
+  };
+
+  Int_t PhiCell(const Grid &grid, Double_t phi) const;
+  void  BuildGrid(Grid &grid, const std::vector<Double_t> &eta, const std::vector<Double_t> &phi, const std::vector<Int_t> &entries, Double_t maxDist);
+  void  FindClosest(const Grid &grid, const std::vector<Double_t> &etaTarget, const std::vector<Double_t> &phiTarget,
+                    const std::vector<Double_t> &eta, const std::vector<Double_t> &phi, const std::vector<Int_t> &entries,
+                    Double_t maxDist, std::vector<Int_t> &closest, std::vector<Double_t> &distance) const;
+  Int_t MatchEntries(const std::vector<Int_t> &entries1, const std::vector<Int_t> &entries2, Double_t maxDist);
+
+  Bool_t                  fPeriodicPhi; ///< Distance periodic in phi
+  std::vector<Double_t>   fEta1;        ///< Pseudorapidities of the first set
+  std::vector<Double_t>   fPhi1;        ///< Azimuthal angles of the first set
+  std::vector<Double_t>   fEta2;        ///< Pseudorapidities of the second set
+  std::vector<Double_t>   fPhi2;        ///< Azimuthal angles of the second set
+  std::vector<Int_t>      fEntries1;    ///< Entries of the first set taking part in the matching
+  std::vector<Int_t>      fEntries2;    ///< Entries of the second set taking part in the matching
+  Grid                    fGrid1;       ///< Grid of the first set
+  Grid                    fGrid2;       ///< Grid of the second set
+  std::vector<Int_t>      fClosest12;   ///< Closest entry of the second set for each entry of the first set
+  std::vector<Int_t>      fClosest21;   ///< Closest entry of the first set for each entry of the second set
+  std::vector<Double_t>   fDistance12;  ///< Distance to the closest entry of the second set
+  std::vector<Double_t>   fDistance21;  ///< Distance to the closest entry of the first set
+  std::vector<Match>      fMatches;     ///< Mutually closest pairs
+};
+
+}
+
+}
+
+#endif
@@ -40,6 +40,9 @@
 #include "THnSparse.h"
 #include "TMath.h"
 
+#include <limits>
+#include <thread>
+
 templateClassImp(AliTHnT)
 
 template <class TemplateArray, typename TemplateType>
@@ -53,7 +56,18 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT() :
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fXminCache(0),
+  fXmaxCache(0),
+  fInvWidthCache(0),
+  fEdgesCache(0),
+  fStrides(0),
+  fBinBuffer(0),
+  fBinBufferSize(0),
+  fShardValues(),
+  fShardSumw2(),
+  fShardBins()
 {
   // Constructor
 }
@@ -69,7 +83,18 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const Char_t* name, const Char_t*
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fXminCache(0),
+  fXmaxCache(0),
+  fInvWidthCache(0),
+  fEdgesCache(0),
+  fStrides(0),
+  fBinBuffer(0),
+  fBinBufferSize(0),
+  fShardValues(),
+  fShardSumw2(),
+  fShardBins()
 {
   // Constructor
 
@@ -106,7 +131,18 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fXminCache(0),
+  fXmaxCache(0),
+  fInvWidthCache(0),
+  fEdgesCache(0),
+  fStrides(0),
+  fBinBuffer(0),
+  fBinBufferSize(0),
+  fShardValues(),
+  fShardSumw2(),
+  fShardBins()
 {
   //
   // AliTHnT copy constructor
@@ -120,6 +156,8 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
     if (c.fSumw2[i])  fSumw2[i]  = new TemplateArray(*(c.fSumw2[i]));
   }
 
+  // the copy contains the shards of c already merged
+  c.AddShardsTo(fValues, fSumw2, 1);
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -131,10 +169,117 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
   
   delete[] fValues;
   delete[] fSumw2;
+  ClearCache();
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::InitCache()
+{
+  // fills the axis caches used by Fill, FillN and GetGlobalBinIndex
+  // the binning must not be changed after the first fill
+  
+  ClearCache();
+  
+  axisCache = new TAxis*[fNVars];
+  fNbinsCache = new Int_t[fNVars];
+  fLastVars = new Double_t[fNVars];
+  fLastBins = new Int_t[fNVars];
+  fUniformCache = new Bool_t[fNVars];
+  fXminCache = new Double_t[fNVars];
+  fXmaxCache = new Double_t[fNVars];
+  fInvWidthCache = new Double_t[fNVars];
+  fEdgesCache = new const Double_t*[fNVars];
+  fStrides = new Long64_t[fNVars];
+  
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    axisCache[i] = GetAxis(i, 0);
+    fNbinsCache[i] = axisCache[i]->GetNbins();
+    
+    // NaN never compares equal, so the first lookup is never taken from the cache
+    fLastVars[i] = std::numeric_limits<Double_t>::quiet_NaN();
+    fLastBins[i] = 0;
+    
+    fXminCache[i] = axisCache[i]->GetXmin();
+    fXmaxCache[i] = axisCache[i]->GetXmax();
+    fUniformCache[i] = (axisCache[i]->GetXbins()->GetSize() == 0);
+    fInvWidthCache[i] = fNbinsCache[i] / (fXmaxCache[i] - fXminCache[i]);
+    fEdgesCache[i] = (fUniformCache[i]) ? 0 : axisCache[i]->GetXbins()->GetArray();
+  }
+  
+  // row-major layout: the last axis is contiguous
+  Long64_t stride = 1;
+  for (Int_t i=fNVars-1; i>=0; i--)
+  {
+    fStrides[i] = stride;
+    stride *= fNbinsCache[i];
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::ClearCache()
+{
+  // deletes the axis caches, they are rebuilt at the next fill
+  
   delete[] axisCache;
   delete[] fNbinsCache;
   delete[] fLastVars;
   delete[] fLastBins;
+  delete[] fUniformCache;
+  delete[] fXminCache;
+  delete[] fXmaxCache;
+  delete[] fInvWidthCache;
+  delete[] fEdgesCache;
+  delete[] fStrides;
+  delete[] fBinBuffer;
+  
+  axisCache = 0;
+  fNbinsCache = 0;
+  fLastVars = 0;
+  fLastBins = 0;
+  fUniformCache = 0;
+  fXminCache = 0;
+  fXmaxCache = 0;
+  fInvWidthCache = 0;
+  fEdgesCache = 0;
+  fStrides = 0;
+  fBinBuffer = 0;
+  fBinBufferSize = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+inline Int_t AliTHnT<TemplateArray, TemplateType>::FindBinFast(Int_t axis, Double_t x) const
+{
+  // returns the same bin as TAxis::FindBin without calling it
+  // fixed bin width: the bin is computed with the cached inverse bin width
+  // variable bin width: binary search on the cached bin edges without branches in the loop
+  
+  if (x < fXminCache[axis])
+    return 0;
+  if (!(x < fXmaxCache[axis]))
+    return fNbinsCache[axis] + 1;
+  
+  if (fUniformCache[axis])
+  {
+    Double_t t = (x - fXminCache[axis]) * fInvWidthCache[axis];
+    Int_t bin = (Int_t) t;
+    // close to a bin edge the multiplication can round differently than the division in TAxis::FindBin, use the latter there
+    Double_t frac = t - bin;
+    if (frac < 1e-9 || frac > 1 - 1e-9)
+      bin = (Int_t) (fNbinsCache[axis] * (x - fXminCache[axis]) / (fXmaxCache[axis] - fXminCache[axis]));
+    return bin + 1;
+  }
+  
+  // last edge <= x, edges[0] <= x < edges[nbins] is guaranteed above
+  const Double_t* base = fEdgesCache[axis];
+  Int_t n = fNbinsCache[axis] + 1;
+  while (n > 1)
+  {
+    Int_t half = n / 2;
+    base = (base[half] <= x) ? base + half : base;
+    n -= half;
+  }
+  return (Int_t) (base - fEdgesCache[axis]) + 1;
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -156,6 +301,15 @@ void AliTHnT<TemplateArray, TemplateType>::DeleteContainers()
       fSumw2[i] = 0;
     }
   }
+  
+  for (UInt_t s=0; s<fShardValues.size(); s++)
+  {
+    for (Int_t i=0; i<fNSteps; i++)
+    {
+      std::vector<TemplateType>().swap(fShardValues[s][i]);
+      std::vector<TemplateType>().swap(fShardSumw2[s][i]);
+    }
+  }
 }
 
 //____________________________________________________________________
@@ -191,9 +345,13 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
       fValues = 0;
       fSumw2 = 0;
     }
-    delete [] axisCache;
-    axisCache = new TAxis*[fNVars];
-    memcpy(axisCache, c.axisCache, fNVars*sizeof(TAxis*));
+    c.AddShardsTo(fValues, fSumw2, 1);
+    fShardValues.clear();
+    fShardSumw2.clear();
+    fShardBins.clear();
+
+    // the caches point to the axes of c
+    ClearCache();
   }
   return *this;
 }
@@ -213,6 +371,7 @@ void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
   target.fNVars = fNVars;
   
   target.Init();
+  target.ClearCache();
 
   for (Int_t i=0; i<fNSteps; i++)
   {
@@ -226,6 +385,11 @@ void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
     else
       target.fSumw2[i] = 0;
   }
+
+  AddShardsTo(target.fValues, target.fSumw2, 1);
+  target.fShardValues.clear();
+  target.fShardSumw2.clear();
+  target.fShardBins.clear();
 }
 
 //____________________________________________________________________
@@ -244,6 +408,8 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
   
   AliCFContainer::Merge(list);
 
+  MergeShards();
+
   TIterator* iter = list->MakeIterator();
   TObject* obj;
   
@@ -254,6 +420,8 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
     if (entry == 0) 
       continue;
 
+    entry->MergeShards();
+
     for (Int_t i=0; i<fNSteps; i++)
     {
       if (entry->fValues[i])
@@ -286,40 +454,19 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 {
   // fills an entry
 
-  // fill axis cache
   if (!axisCache)
-  {
-    axisCache = new TAxis*[fNVars];
-    fNbinsCache = new Int_t[fNVars];
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      axisCache[i] = GetAxis(i, 0);
-      fNbinsCache[i] = axisCache[i]->GetNbins();
-    }
-    
-    fLastVars = new Double_t[fNVars];
-    fLastBins = new Int_t[fNVars];
-    
-    // initial values to prevent checking for 0 below
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      fLastBins[i] = axisCache[i]->FindBin(var[i]);
-      fLastVars[i] = var[i];
-    }
-  }
+    InitCache();
   
   // calculate global bin index
   Long64_t bin = 0;
   for (Int_t i=0; i<fNVars; i++)
   {
-    bin *= fNbinsCache[i];
-    
     Int_t tmpBin = 0;
     if (fLastVars[i] == var[i])
       tmpBin = fLastBins[i];
     else
     {
-      tmpBin = axisCache[i]->FindBin(var[i]);
+      tmpBin = FindBinFast(i, var[i]);
       fLastBins[i] = tmpBin;
       fLastVars[i] = var[i];
     }
@@ -330,7 +477,7 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
       return;
     
     // bins start from 0 here
-    bin += tmpBin - 1;
+    bin += (tmpBin - 1) * fStrides[i];
 //     Printf("%lld", bin);
   }
 
@@ -360,6 +507,277 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 //   AliCFContainer::Fill(var, istep, weight);
 }
 
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FindBins(Int_t n, const Double_t *var, Int_t stride, Long64_t *bins) const
+{
+  // calculates the global bin index of n entries, -1 flags entries in under/overflow
+  // the bins are found axis by axis over all entries, so that the inner loops contain only arithmetics on the cached axes
+  // only reads the caches, so it can be called from several threads at the same time
+  
+  for (Int_t j=0; j<n; j++)
+    bins[j] = 0;
+  
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    const Int_t nBins = fNbinsCache[i];
+    const Long64_t axisStride = fStrides[i];
+    for (Int_t j=0; j<n; j++)
+    {
+      Int_t tmpBin = FindBinFast(i, var[(Long64_t) j * stride + i]);
+      if (tmpBin < 1 || tmpBin > nBins)
+        bins[j] = -1;
+      else if (bins[j] >= 0)
+        bins[j] += (tmpBin - 1) * axisStride;
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight, Int_t stride)
+{
+  // fills n entries at once
+  // the variables of entry j are var[j*stride] ... var[j*stride+fNVars-1], stride = 0 means fNVars
+  // weight (if given) contains one weight per entry
+  // results are identical to calling Fill for each entry
+
+  if (n <= 0)
+    return;
+  
+  if (!axisCache)
+    InitCache();
+  
+  if (stride <= 0)
+    stride = fNVars;
+  
+  if (n > fBinBufferSize)
+  {
+    delete[] fBinBuffer;
+    fBinBuffer = new Long64_t[n];
+    fBinBufferSize = n;
+  }
+  
+  FindBins(n, var, stride, fBinBuffer);
+  
+  for (Int_t j=0; j<n; j++)
+  {
+    Long64_t bin = fBinBuffer[j];
+    if (bin < 0)
+      continue;
+    
+    Double_t w = (weight) ? weight[j] : 1.;
+
+    if (!fValues[istep])
+    {
+      fValues[istep] = new TemplateArray(fNBins);
+      AliInfo(Form("Created values container for step %d", istep));
+    }
+    
+    if (w != 1 && !fSumw2[istep])
+    {
+      // initialize with already filled entries (which have been filled with weight == 1), in this case fSumw2 := fValues
+      fSumw2[istep] = new TemplateArray(*fValues[istep]);
+      AliInfo(Form("Created sumw2 container for step %d", istep));
+    }
+    
+    fValues[istep]->GetArray()[bin] += w;
+    if (fSumw2[istep])
+      fSumw2[istep]->GetArray()[bin] += w * w;
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::SetNumberOfShards(Int_t nShards)
+{
+  // creates nShards private dense buffers for FillNShard
+  // shard s may be filled by one thread while other threads fill the other shards
+  // the shards are added to the container by MergeShards, which is called by FillParent, FillContainer, ReduceAxis and Merge
+  // the memory of a shard is allocated at its first fill per step, see PrintMemoryUsage
+  
+  MergeShards();
+  
+  if (nShards < 0)
+    nShards = 0;
+  
+  // the caches are only read by FillNShard, they have to exist before the threads start
+  if (!axisCache)
+    InitCache();
+  
+  fShardValues.assign(nShards, std::vector<std::vector<TemplateType> >(fNSteps));
+  fShardSumw2.assign(nShards, std::vector<std::vector<TemplateType> >(fNSteps));
+  fShardBins.assign(nShards, std::vector<Long64_t>());
+  
+  AliInfo(Form("Using %d shards", nShards));
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillNShard(Int_t shard, Int_t n, const Double_t *var, Int_t istep, const Double_t *weight, Int_t stride)
+{
+  // as FillN, but fills the private buffer of shard <shard>
+  // different shards can be filled from different threads at the same time
+  
+  if (shard < 0 || shard >= (Int_t) fShardValues.size())
+    AliFatal(Form("Invalid shard %d, %d shards have been created with SetNumberOfShards", shard, (Int_t) fShardValues.size()));
+  
+  if (n <= 0)
+    return;
+  
+  if (stride <= 0)
+    stride = fNVars;
+  
+  std::vector<Long64_t>& bins = fShardBins[shard];
+  if ((Int_t) bins.size() < n)
+    bins.resize(n);
+  
+  FindBins(n, var, stride, &bins[0]);
+  
+  std::vector<TemplateType>& values = fShardValues[shard][istep];
+  std::vector<TemplateType>& sumw2 = fShardSumw2[shard][istep];
+  
+  for (Int_t j=0; j<n; j++)
+  {
+    Long64_t bin = bins[j];
+    if (bin < 0)
+      continue;
+    
+    Double_t w = (weight) ? weight[j] : 1.;
+    
+    if (values.empty())
+      values.assign(fNBins, 0);
+    
+    // same as in Fill: the entries filled so far had weight 1
+    if (w != 1 && sumw2.empty())
+      sumw2 = values;
+    
+    values[bin] += w;
+    if (!sumw2.empty())
+      sumw2[bin] += w * w;
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AddShardsTo(TemplateArray **values, TemplateArray **sumw2, Int_t nThreads) const
+{
+  // adds the content of all shards to the containers <values> and <sumw2>
+  // with nThreads > 1 the bins are split in contiguous ranges, one per thread, which do not need any locking
+  
+  if (fShardValues.empty())
+    return;
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    Bool_t filled = kFALSE;
+    Bool_t withSumw2 = (sumw2[i] != 0);
+    for (UInt_t s=0; s<fShardValues.size(); s++)
+    {
+      filled |= !fShardValues[s][i].empty();
+      withSumw2 |= !fShardSumw2[s][i].empty();
+    }
+    
+    if (!filled)
+      continue;
+    
+    if (!values[i])
+      values[i] = new TemplateArray(fNBins);
+    // as in Fill: sumw2 of entries filled with weight 1 is equal to the values
+    if (withSumw2 && !sumw2[i])
+      sumw2[i] = new TemplateArray(*values[i]);
+    
+    TemplateType* target = values[i]->GetArray();
+    TemplateType* targetSumw2 = (withSumw2) ? sumw2[i]->GetArray() : 0;
+    
+    auto reduce = [this, i, target, targetSumw2](Long64_t first, Long64_t last)
+    {
+      for (UInt_t s=0; s<fShardValues.size(); s++)
+      {
+        const std::vector<TemplateType>& shardValues = fShardValues[s][i];
+        if (shardValues.empty())
+          continue;
+        const std::vector<TemplateType>& shardSumw2 = (fShardSumw2[s][i].empty()) ? shardValues : fShardSumw2[s][i];
+        
+        for (Long64_t l=first; l<last; l++)
+          target[l] += shardValues[l];
+        if (targetSumw2)
+          for (Long64_t l=first; l<last; l++)
+            targetSumw2[l] += shardSumw2[l];
+      }
+    };
+    
+    if (nThreads <= 1)
+      reduce(0, fNBins);
+    else
+    {
+      std::vector<std::thread> threads;
+      for (Int_t t=0; t<nThreads; t++)
+        threads.emplace_back(reduce, fNBins * t / nThreads, fNBins * (t+1) / nThreads);
+      for (auto& thread : threads)
+        thread.join();
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::MergeShards(Int_t nThreads)
+{
+  // adds the shards to the containers and releases their memory, the shards can be filled again afterwards
+  
+  if (fShardValues.empty())
+    return;
+  
+  AddShardsTo(fValues, fSumw2, nThreads);
+  
+  for (UInt_t s=0; s<fShardValues.size(); s++)
+  {
+    for (Int_t i=0; i<fNSteps; i++)
+    {
+      std::vector<TemplateType>().swap(fShardValues[s][i]);
+      std::vector<TemplateType>().swap(fShardSumw2[s][i]);
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::GetMemoryUsage() const
+{
+  // returns the memory used by the data containers and the shards in bytes
+  
+  Long64_t bytes = 0;
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (fValues[i])
+      bytes += fNBins * sizeof(TemplateType);
+    if (fSumw2[i])
+      bytes += fNBins * sizeof(TemplateType);
+    
+    for (UInt_t s=0; s<fShardValues.size(); s++)
+      bytes += (fShardValues[s][i].capacity() + fShardSumw2[s][i].capacity()) * sizeof(TemplateType);
+  }
+  
+  return bytes;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::PrintMemoryUsage() const
+{
+  // prints the memory used per step by the data containers and the shards
+  
+  const Double_t kMB = 1024 * 1024;
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    Long64_t shardBytes = 0;
+    for (UInt_t s=0; s<fShardValues.size(); s++)
+      shardBytes += (fShardValues[s][i].capacity() + fShardSumw2[s][i].capacity()) * sizeof(TemplateType);
+    
+    AliInfo(Form("Step %d: values %.1f MB, sumw2 %.1f MB, %d shards %.1f MB", i, 
+      (fValues[i]) ? fNBins * sizeof(TemplateType) / kMB : 0., 
+      (fSumw2[i]) ? fNBins * sizeof(TemplateType) / kMB : 0., 
+      (Int_t) fShardValues.size(), shardBytes / kMB));
+  }
+  
+  AliInfo(Form("Total %.1f MB. %lld bins, one filled step takes %.1f MB (twice with sumw2) in the container and in each shard", 
+    GetMemoryUsage() / kMB, fNBins, fNBins * sizeof(TemplateType) / kMB));
+}
+
 template <class TemplateArray, typename TemplateType>
 Long64_t AliTHnT<TemplateArray, TemplateType>::GetGlobalBinIndex(const Int_t* binIdx)
 {
@@ -367,12 +785,12 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::GetGlobalBinIndex(const Int_t* bi
   // binIdx contains TAxis bin indexes
   // here bin count starts at 0 because we do not have over/underflow bins
   
+  if (!fStrides)
+    InitCache();
+  
   Long64_t bin = 0;
   for (Int_t i=0; i<fNVars; i++)
-  {
-    bin *= GetAxis(i, 0)->GetNbins();
-    bin += binIdx[i] - 1;
-  }
+    bin += (binIdx[i] - 1) * fStrides[i];
 
   return bin;
 }
@@ -382,6 +800,8 @@ void AliTHnT<TemplateArray, TemplateType>::FillContainer(AliCFContainer* cont)
 {
   // fills the information stored in the buffer in this class into the container <cont>
   
+  MergeShards();
+  
   for (Int_t i=0; i<fNSteps; i++)
   {
     if (!fValues[i])
@@ -457,6 +877,8 @@ void AliTHnT<TemplateArray, TemplateType>::ReduceAxis()
   // "removes" one axis by summing over the axis and putting the entry to bin 1
   // TODO presently only implemented for the last axis
   
+  MergeShards();
+  
   Int_t axis = fNVars-1;
   
   for (Int_t i=0; i<fNSteps; i++)
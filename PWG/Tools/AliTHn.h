@@ -14,6 +14,8 @@
 #include "TString.h"
 #include "AliCFContainer.h"
 
+#include <vector>
+
 class TArray;
 class TArrayF;
 class TArrayD;
@@ -26,6 +28,7 @@ public:
   AliTHnBase(const Char_t* name, const Char_t* title,const Int_t nSelStep, const Int_t nVarIn, const Int_t* nBinIn) : AliCFContainer(name, title, nSelStep, nVarIn, nBinIn) { }
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) = 0;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight=0, Int_t stride=0) = 0;
   virtual void FillParent() = 0;
   virtual void FillContainer(AliCFContainer* cont) = 0;
 
@@ -35,6 +38,16 @@ public:
   virtual void DeleteContainers() = 0;
   virtual void ReduceAxis() = 0;  
   
+  // sharded filling: each shard is a private dense buffer which one thread can fill concurrently with the other shards
+  virtual void SetNumberOfShards(Int_t nShards) = 0;
+  virtual Int_t GetNumberOfShards() const = 0;
+  virtual void FillNShard(Int_t shard, Int_t n, const Double_t *var, Int_t istep, const Double_t *weight=0, Int_t stride=0) = 0;
+  void FillShard(Int_t shard, const Double_t *var, Int_t istep, Double_t weight=1.) { FillNShard(shard, 1, var, istep, &weight); }
+  virtual void MergeShards(Int_t nThreads=1) = 0;
+  
+  virtual Long64_t GetMemoryUsage() const = 0;
+  virtual void PrintMemoryUsage() const = 0;
+  
   ClassDef(AliTHnBase, 1) // AliTHn base class
 };
 
@@ -48,6 +61,7 @@ class AliTHnT : public AliTHnBase
   virtual ~AliTHnT();
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight=0, Int_t stride=0);
   virtual void FillParent();
   virtual void FillContainer(AliCFContainer* cont);
   
@@ -57,6 +71,14 @@ class AliTHnT : public AliTHnBase
   virtual void DeleteContainers();
   virtual void ReduceAxis();
   
+  virtual void SetNumberOfShards(Int_t nShards);
+  virtual Int_t GetNumberOfShards() const { return (Int_t) fShardValues.size(); }
+  virtual void FillNShard(Int_t shard, Int_t n, const Double_t *var, Int_t istep, const Double_t *weight=0, Int_t stride=0);
+  virtual void MergeShards(Int_t nThreads=1);
+  
+  virtual Long64_t GetMemoryUsage() const;
+  virtual void PrintMemoryUsage() const;
+  
   AliTHnT(const AliTHnT &c);
   AliTHnT& operator=(const AliTHnT& corr);
   virtual void Copy(TObject& c) const;
@@ -65,6 +87,11 @@ class AliTHnT : public AliTHnBase
   
 protected:
   void Init();
+  void InitCache();
+  void ClearCache();
+  Int_t FindBinFast(Int_t axis, Double_t x) const;
+  void FindBins(Int_t n, const Double_t *var, Int_t stride, Long64_t *bins) const;
+  void AddShardsTo(TemplateArray **values, TemplateArray **sumw2, Int_t nThreads) const;
   Long64_t GetGlobalBinIndex(const Int_t* binIdx);
   
   Long64_t fNBins;   // number of total bins
@@ -77,6 +104,17 @@ protected:
   Int_t* fNbinsCache; //! cache Nbins per axis
   Double_t* fLastVars; //! caching of last used bins (in many loops some vars are the same for a while)
   Int_t* fLastBins; //! caching of last used bins (in many loops some vars are the same for a while)
+  Bool_t* fUniformCache; //! axis has fixed bin width
+  Double_t* fXminCache; //! lower edge per axis
+  Double_t* fXmaxCache; //! upper edge per axis
+  Double_t* fInvWidthCache; //! inverse bin width per axis (fixed bin width only)
+  const Double_t** fEdgesCache; //! bin edges per axis (variable bin width only)
+  Long64_t* fStrides; //! distance in the global bin index between two consecutive bins of each axis
+  Long64_t* fBinBuffer; //! global bin index per entry in FillN
+  Int_t fBinBufferSize; //! size of fBinBuffer
+  std::vector<std::vector<std::vector<TemplateType> > > fShardValues; //! per shard and step: values filled with FillNShard, empty if not filled
+  std::vector<std::vector<std::vector<TemplateType> > > fShardSumw2;  //! per shard and step: sumw2 filled with FillNShard, empty if all weights were 1
+  std::vector<std::vector<Long64_t> > fShardBins; //! per shard: global bin index per entry in FillNShard
   
   ClassDef(AliTHnT, 5) // THn like container
 };
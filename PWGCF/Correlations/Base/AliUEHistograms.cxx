@@ -25,6 +25,7 @@
 #include "AliUEHistograms.h"
 
 #include "AliCFContainer.h"
+#include "AliTHn.h"
 #include "AliBasicParticle.h"
 #include "AliVParticle.h"
 #include "AliAODTrack.h"
@@ -37,6 +38,10 @@
 #include "TMath.h"
 #include "TLorentzVector.h"
 
+#include <mutex>
+#include <thread>
+#include <vector>
+
 ClassImp(AliUEHistograms)
 
 const Int_t AliUEHistograms::fgkUEHists = 3;
@@ -85,6 +90,7 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
   fPtOrder(kTRUE),
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
+  fNThreads(1),
   fRunNumber(0),
   fMergeCount(1)
 {
@@ -266,6 +272,7 @@ AliUEHistograms::AliUEHistograms(const AliUEHistograms &c) :
   fPtOrder(kTRUE),
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
+  fNThreads(1),
   fRunNumber(0),
   fMergeCount(1)
 {
@@ -711,6 +718,12 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
     }
     
+    // trigger particles passing the trigger selection
+    std::vector<Int_t> triggers;
+    std::vector<Float_t> triggerEtas;
+    triggers.reserve(particles->GetEntriesFast());
+    triggerEtas.reserve(particles->GetEntriesFast());
+    
     for (Int_t i=0; i<particles->GetEntriesFast(); i++)
     {
       AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
@@ -737,297 +750,380 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 // 	  Printf("Skipped i=%d", i);
 	  continue;
 	}
-	
-      for (Int_t j=0; j<jMax; j++)
+
+      triggers.push_back(i);
+      triggerEtas.push_back(triggerEta);
+    }
+    
+    const Int_t nTriggers = triggers.size();
+    
+    // the pairs of one trigger particle are collected and filled at once if the track histogram is an AliTHn
+    AliCFContainer* trackHist = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward);
+    AliTHnBase* trackHistTHn = dynamic_cast<AliTHnBase*> (trackHist);
+    const Int_t kNPairVars = 6;
+    
+    // with fNThreads > 1 the trigger particles are split in contiguous ranges, each range is filled by one thread into its own shard of the track histogram
+    const Int_t nThreads = (trackHistTHn) ? TMath::Min(fNThreads, nTriggers) : 1;
+    
+    // the control histograms are only filled for pairs close to the cuts, a lock is cheap enough
+    std::mutex controlMutex;
+    auto fillControl = [&](Double_t type, Double_t mass)
+    {
+      std::lock_guard<std::mutex> lock(controlMutex);
+      fControlConvResoncances->Fill(type, mass);
+    };
+    auto fillTwoTrackDistance = [&](Int_t i, Double_t deta, Double_t dphistar, Double_t dpt)
+    {
+      std::lock_guard<std::mutex> lock(controlMutex);
+      fTwoTrackDistancePt[i]->Fill(deta, dphistar, dpt);
+    };
+    
+    // pairs of the trigger particles [first, last), filled into <shard> of the track histogram (-1: no sharding)
+    auto fillPairs = [&](Int_t first, Int_t last, Int_t shard)
+    {
+      std::vector<Double_t> pairVars;
+      std::vector<Double_t> pairWeights;
+      if (trackHistTHn)
       {
-        if (!mixed && i == j)
-          continue;
+        pairVars.reserve(kNPairVars * jMax);
+        pairWeights.reserve(jMax);
+      }
       
-        AliVParticle* particle = 0;
-        if (!mixed)
-          particle = (AliVParticle*) particles->UncheckedAt(j);
-        else
-          particle = (AliVParticle*) mixed->UncheckedAt(j);
+      Float_t pairWeight = weight;
+      
+      for (Int_t t=first; t<last; t++)
+      {
+        Int_t i = triggers[t];
+        AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
+        Float_t triggerEta = triggerEtas[t];
         
-        // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
-        if (fCheckEventNumberInCorrelation)
-        {
-          AliBasicParticle* triggerParticleBasic = dynamic_cast<AliBasicParticle*>(triggerParticle);
-          AliBasicParticle* particleBasic        = dynamic_cast<AliBasicParticle*>(particle);
-          if(!triggerParticleBasic || !particleBasic)
-            AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
+	for (Int_t j=0; j<jMax; j++)
+	{
+	  if (!mixed && i == j)
+	    continue;
       
-          if(triggerParticleBasic->IsInSameEvent(particleBasic))
-            continue;
-        }
-        else if (mixed && triggerParticle->IsEqual(particle))
-          continue;
+	  AliVParticle* particle = 0;
+	  if (!mixed)
+	    particle = (AliVParticle*) particles->UncheckedAt(j);
+	  else
+	    particle = (AliVParticle*) mixed->UncheckedAt(j);
         
-        if (fPtOrder)
-	  if (particle->Pt() >= triggerParticle->Pt())
+	  // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
+	  if (fCheckEventNumberInCorrelation)
+	  {
+	    AliBasicParticle* triggerParticleBasic = dynamic_cast<AliBasicParticle*>(triggerParticle);
+	    AliBasicParticle* particleBasic        = dynamic_cast<AliBasicParticle*>(particle);
+	    if(!triggerParticleBasic || !particleBasic)
+	      AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
+      
+	    if(triggerParticleBasic->IsInSameEvent(particleBasic))
+	      continue;
+	  }
+	  else if (mixed && triggerParticle->IsEqual(particle))
 	    continue;
+        
+	  if (fPtOrder)
+	    if (particle->Pt() >= triggerParticle->Pt())
+	      continue;
 	
-	if (fAssociatedSelectCharge != 0)
-	  if (particle->Charge() * fAssociatedSelectCharge < 0)
-	    continue;
+	  if (fAssociatedSelectCharge != 0)
+	    if (particle->Charge() * fAssociatedSelectCharge < 0)
+	      continue;
 
-        if (fSelectCharge > 0)
-        {
-          // skip like sign
-          if (fSelectCharge == 1 && particle->Charge() * triggerParticle->Charge() > 0)
-            continue;
+	  if (fSelectCharge > 0)
+	  {
+	    // skip like sign
+	    if (fSelectCharge == 1 && particle->Charge() * triggerParticle->Charge() > 0)
+	      continue;
             
-          // skip unlike sign
-          if (fSelectCharge == 2 && particle->Charge() * triggerParticle->Charge() < 0)
-            continue;
-        }
+	    // skip unlike sign
+	    if (fSelectCharge == 2 && particle->Charge() * triggerParticle->Charge() < 0)
+	      continue;
+	  }
         
-        if (fOnlyOneAssocEtaSide != 0)
-          if (fOnlyOneAssocEtaSide * eta[j] < 0)
-            continue;
-
-	if (fEtaOrdering)
-	{
-	  if (triggerEta < 0 && eta[j] < triggerEta)
-	    continue;
-	  if (triggerEta > 0 && eta[j] > triggerEta)
-	    continue;
-	}
+	  if (fOnlyOneAssocEtaSide != 0)
+	    if (fOnlyOneAssocEtaSide * eta[j] < 0)
+	      continue;
 
-	if (fRejectResonanceDaughters > 0)
-	  if (particle->TestBit(kResonanceDaughterFlag))
+	  if (fEtaOrdering)
 	  {
-// 	    Printf("Skipped j=%d", j);
-	    continue;
+	    if (triggerEta < 0 && eta[j] < triggerEta)
+	      continue;
+	    if (triggerEta > 0 && eta[j] > triggerEta)
+	      continue;
 	  }
 
-	// conversions
-	if (twoTrackCuts && fCutConversionsV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
-	  
-	  if (mass < fCutConversionsV * 5)
+	  if (fRejectResonanceDaughters > 0)
+	    if (particle->TestBit(kResonanceDaughterFlag))
+	    {
+// 	    Printf("Skipped j=%d", j);
+	      continue;
+	    }
+
+	  // conversions
+	  if (twoTrackCuts && fCutConversionsV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
 	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
+	    Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
+	  
+	    if (mass < fCutConversionsV * 5)
+	    {
+	      mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
 	    
-	    fControlConvResoncances->Fill(0.0, mass);
+	      fillControl(0.0, mass);
 
-	    if (mass < fCutConversionsV*fCutConversionsV) 
-	      continue;
+	      if (mass < fCutConversionsV*fCutConversionsV) 
+		continue;
+	    }
 	  }
-	}
 	
-	// K0s
-	if (twoTrackCuts && fCutK0sV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	  // K0s
+	  if (twoTrackCuts && fCutK0sV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	  {
+	    Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
 	  
-	  const Float_t kK0smass = 0.4976;
+	    const Float_t kK0smass = 0.4976;
 	  
-	  if (TMath::Abs(mass - kK0smass*kK0smass) < fCutK0sV * 5)
-	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	    if (TMath::Abs(mass - kK0smass*kK0smass) < fCutK0sV * 5)
+	    {
+	      mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
 	    
-	    fControlConvResoncances->Fill(1, mass - kK0smass*kK0smass);
+	      fillControl(1, mass - kK0smass*kK0smass);
 
-	    if (mass > (kK0smass-fCutK0sV)*(kK0smass-fCutK0sV) && mass < (kK0smass+fCutK0sV)*(kK0smass+fCutK0sV))
-	      continue;
+	      if (mass > (kK0smass-fCutK0sV)*(kK0smass-fCutK0sV) && mass < (kK0smass+fCutK0sV)*(kK0smass+fCutK0sV))
+		continue;
+	    }
 	  }
-	}
 
-	// Lambda
-	if (twoTrackCuts && fCutLambdaV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass1 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
-	  Float_t mass2 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
+	  // Lambda
+	  if (twoTrackCuts && fCutLambdaV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	  {
+	    Float_t mass1 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
+	    Float_t mass2 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
 	  
-	  const Float_t kLambdaMass = 1.115;
+	    const Float_t kLambdaMass = 1.115;
 
-	  if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
-	  {
-	    mass1 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
+	    if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
+	    {
+	      mass1 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
 
-	    fControlConvResoncances->Fill(2, mass1 - kLambdaMass*kLambdaMass);
+	      fillControl(2, mass1 - kLambdaMass*kLambdaMass);
 	    
-	    if (mass1 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass1 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
-	      continue;
-	  }
-	  if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
-	  {
-	    mass2 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
+	      if (mass1 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass1 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
+		continue;
+	    }
+	    if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
+	    {
+	      mass2 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
 
-	    fControlConvResoncances->Fill(2, mass2 - kLambdaMass*kLambdaMass);
+	      fillControl(2, mass2 - kLambdaMass*kLambdaMass);
 
-	    if (mass2 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass2 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
-	      continue;
+	      if (mass2 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass2 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
+		continue;
+	    }
 	  }
-	}
 
-        // Phi
-	if (twoTrackCuts && fCutPhiV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
+	  // Phi
+	  if (twoTrackCuts && fCutPhiV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	  {
+	    Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
 	  
-	  const Float_t kPhimass = 1.019;
+	    const Float_t kPhimass = 1.019;
 	  
-	  if (TMath::Abs(mass - kPhimass*kPhimass) < fCutPhiV * 5)
-	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
+	    if (TMath::Abs(mass - kPhimass*kPhimass) < fCutPhiV * 5)
+	    {
+	      mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
 	    
-	    fControlConvResoncances->Fill(3, mass - kPhimass*kPhimass);
+	      fillControl(3, mass - kPhimass*kPhimass);
 	    
-	    if (mass > (kPhimass-fCutPhiV)*(kPhimass-fCutPhiV) && mass < (kPhimass+fCutPhiV)*(kPhimass+fCutPhiV))
-	      continue;
-	  }
-	}	
+	      if (mass > (kPhimass-fCutPhiV)*(kPhimass-fCutPhiV) && mass < (kPhimass+fCutPhiV)*(kPhimass+fCutPhiV))
+		continue;
+	    }
+	  }	
 
-        // Rho
-	if (twoTrackCuts && fCutRhoV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-        {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	  // Rho
+	  if (twoTrackCuts && fCutRhoV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	  {
+	    Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
 	  
-	  const Float_t kRhomass = 0.770;
+	    const Float_t kRhomass = 0.770;
 	  
-	  if (TMath::Abs(mass - kRhomass*kRhomass) < fCutRhoV * 5)
-          {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
+	    if (TMath::Abs(mass - kRhomass*kRhomass) < fCutRhoV * 5)
+	    {
+	      mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
 	    
-	    fControlConvResoncances->Fill(4, mass - kRhomass*kRhomass);
+	      fillControl(4, mass - kRhomass*kRhomass);
 	    
-	    if (mass > (kRhomass-fCutRhoV)*(kRhomass-fCutRhoV) && mass < (kRhomass+fCutRhoV)*(kRhomass+fCutRhoV))
-	      continue;
+	      if (mass > (kRhomass-fCutRhoV)*(kRhomass-fCutRhoV) && mass < (kRhomass+fCutRhoV)*(kRhomass+fCutRhoV))
+		continue;
+	    }
 	  }
-	}
 
-        // User-defined cut
-	if (twoTrackCuts && fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-        {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
+	  // User-defined cut
+	  if (twoTrackCuts && fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+	  {
+	    Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
 	  
-	  if (TMath::Abs(mass - fCutCustomMass*fCutCustomMass) < fCutCustomV * 5)
-          {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
+	    if (TMath::Abs(mass - fCutCustomMass*fCutCustomMass) < fCutCustomV * 5)
+	    {
+	      mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
 	    
-	    fControlConvResoncances->Fill(5, mass - fCutCustomMass*fCutCustomMass);
+	      fillControl(5, mass - fCutCustomMass*fCutCustomMass);
 	    
-	    if (mass > (fCutCustomMass-fCutCustomV)*(fCutCustomMass-fCutCustomV) && mass < (fCutCustomMass+fCutCustomV)*(fCutCustomMass+fCutCustomV))
-	      continue;
+	      if (mass > (fCutCustomMass-fCutCustomV)*(fCutCustomMass-fCutCustomV) && mass < (fCutCustomMass+fCutCustomV)*(fCutCustomMass+fCutCustomV))
+		continue;
+	    }
 	  }
-	}
 
-	if (twoTrackCuts && twoTrackEfficiencyCutValue > 0)
-	{
-	  // the variables & cuthave been developed by the HBT group 
-	  // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
+	  if (twoTrackCuts && twoTrackEfficiencyCutValue > 0)
+	  {
+	    // the variables & cuthave been developed by the HBT group 
+	    // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
 
-	  Float_t phi1 = triggerParticle->Phi();
-	  Float_t pt1 = triggerParticle->Pt();
-	  Float_t charge1 = triggerParticle->Charge();
+	    Float_t phi1 = triggerParticle->Phi();
+	    Float_t pt1 = triggerParticle->Pt();
+	    Float_t charge1 = triggerParticle->Charge();
 	    
-	  Float_t phi2 = particle->Phi();
-	  Float_t pt2 = particle->Pt();
-	  Float_t charge2 = particle->Charge();
+	    Float_t phi2 = particle->Phi();
+	    Float_t pt2 = particle->Pt();
+	    Float_t charge2 = particle->Charge();
 	      
-	  Float_t deta = triggerEta - eta[j];
+	    Float_t deta = triggerEta - eta[j];
 	      
-	  // optimization
-	  if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
-	  {
-	    // check first boundaries to see if is worth to loop and find the minimum
-	    Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
-	    Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
+	    // optimization
+	    if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
+	    {
+	      // check first boundaries to see if is worth to loop and find the minimum
+	      Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
+	      Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
 	    
-	    const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
+	      const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
 
-	    Float_t dphistarminabs = 1e5;
-	    Float_t dphistarmin = 1e5;
-	    if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
-	    {
-	      for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
+	      Float_t dphistarminabs = 1e5;
+	      Float_t dphistarmin = 1e5;
+	      if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
 	      {
-		Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
+		for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
+		{
+		  Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
 
-		Float_t dphistarabs = TMath::Abs(dphistar);
+		  Float_t dphistarabs = TMath::Abs(dphistar);
 		
-		if (dphistarabs < dphistarminabs)
-		{
-		  dphistarmin = dphistar;
-		  dphistarminabs = dphistarabs;
+		  if (dphistarabs < dphistarminabs)
+		  {
+		    dphistarmin = dphistar;
+		    dphistarminabs = dphistarabs;
+		  }
 		}
-	      }
 	      
-	      fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+		fillTwoTrackDistance(0, deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	      
-	      if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
-	      {
+		if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
+		{
 // 		Printf("Removed track pair %d %d with %f %f %f %f %f %f %f %f %f", i, j, deta, dphistarminabs, phi1, pt1, charge1, phi2, pt2, charge2, bSign);
-		continue;
-	      }
+		  continue;
+		}
 
-    	      fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+		fillTwoTrackDistance(1, deta, dphistarmin, TMath::Abs(pt1 - pt2));
+	      }
 	    }
 	  }
-	}
         
-        Double_t vars[6];
-        vars[0] = triggerEta - eta[j];
-        vars[1] = particle->Pt();
-        vars[2] = triggerParticle->Pt();
-        vars[3] = centrality;
-        vars[4] = triggerParticle->Phi() - particle->Phi();
-        if (vars[4] > 1.5 * TMath::Pi()) 
-          vars[4] -= TMath::TwoPi();
-        if (vars[4] < -0.5 * TMath::Pi())
-          vars[4] += TMath::TwoPi();
-	vars[5] = zVtx;
+	  Double_t vars[6];
+	  vars[0] = triggerEta - eta[j];
+	  vars[1] = particle->Pt();
+	  vars[2] = triggerParticle->Pt();
+	  vars[3] = centrality;
+	  vars[4] = triggerParticle->Phi() - particle->Phi();
+	  if (vars[4] > 1.5 * TMath::Pi()) 
+	    vars[4] -= TMath::TwoPi();
+	  if (vars[4] < -0.5 * TMath::Pi())
+	    vars[4] += TMath::TwoPi();
+	  vars[5] = zVtx;
 	
-	if (fillpT)
-	  weight = particle->Pt();
+	  if (fillpT)
+	    pairWeight = particle->Pt();
 	
-	Double_t useWeight = weight;
-	if (applyEfficiency)
-	{
-	  if (fEfficiencyCorrectionAssociated)
+	  Double_t useWeight = pairWeight;
+	  if (applyEfficiency)
 	  {
-	    Int_t effVars[4];
-	    // associated particle
-	    effVars[0] = fEfficiencyCorrectionAssociated->GetAxis(0)->FindBin(eta[j]);
-	    effVars[1] = fEfficiencyCorrectionAssociated->GetAxis(1)->FindBin(vars[1]); //pt
-	    effVars[2] = fEfficiencyCorrectionAssociated->GetAxis(2)->FindBin(vars[3]); //centrality
-	    effVars[3] = fEfficiencyCorrectionAssociated->GetAxis(3)->FindBin(vars[5]); //zVtx
+	    if (fEfficiencyCorrectionAssociated)
+	    {
+	      Int_t effVars[4];
+	      // associated particle
+	      effVars[0] = fEfficiencyCorrectionAssociated->GetAxis(0)->FindBin(eta[j]);
+	      effVars[1] = fEfficiencyCorrectionAssociated->GetAxis(1)->FindBin(vars[1]); //pt
+	      effVars[2] = fEfficiencyCorrectionAssociated->GetAxis(2)->FindBin(vars[3]); //centrality
+	      effVars[3] = fEfficiencyCorrectionAssociated->GetAxis(3)->FindBin(vars[5]); //zVtx
 	    
-	    // 	  Printf("%d %d %d %d %f", effVars[0], effVars[1], effVars[2], effVars[3], fEfficiencyCorrectionAssociated->GetBinContent(effVars));
+	      // 	  Printf("%d %d %d %d %f", effVars[0], effVars[1], effVars[2], effVars[3], fEfficiencyCorrectionAssociated->GetBinContent(effVars));
 	  
-	    useWeight *= fEfficiencyCorrectionAssociated->GetBinContent(effVars);
-	  }
-	  if (fEfficiencyCorrectionTriggers)
-	  {
-	    Int_t effVars[4];
+	      useWeight *= fEfficiencyCorrectionAssociated->GetBinContent(effVars);
+	    }
+	    if (fEfficiencyCorrectionTriggers)
+	    {
+	      Int_t effVars[4];
 
-	    effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(triggerEta);
-	    effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(vars[2]); //pt
-	    effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(vars[3]); //centrality
-	    effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(vars[5]); //zVtx
-	    useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
+	      effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(triggerEta);
+	      effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(vars[2]); //pt
+	      effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(vars[3]); //centrality
+	      effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(vars[5]); //zVtx
+	      useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
+	    }
 	  }
-	}
 
-	if (fWeightPerEvent)
-	{
-	  Int_t weightBin = triggerWeighting->GetXaxis()->FindBin(vars[2]);
+	  if (fWeightPerEvent)
+	  {
+	    Int_t weightBin = triggerWeighting->GetXaxis()->FindBin(vars[2]);
 // 	  Printf("Using weight %f", triggerWeighting->GetBinContent(weightBin));
-	  useWeight /= triggerWeighting->GetBinContent(weightBin);
-	}
+	    useWeight /= triggerWeighting->GetBinContent(weightBin);
+	  }
     
-        // fill all in toward region and do not use the other regions
-	fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->Fill(vars, step, useWeight);
+	  // fill all in toward region and do not use the other regions
+	  if (trackHistTHn)
+	  {
+	    pairVars.insert(pairVars.end(), vars, vars + kNPairVars);
+	    pairWeights.push_back(useWeight);
+	  }
+	  else
+	    trackHist->Fill(vars, step, useWeight);
 
 // 	Printf("%.2f %.2f --> %.2f", triggerEta, eta[j], vars[0]);
+	}
+        
+        if (!pairWeights.empty())
+        {
+          if (shard >= 0)
+            trackHistTHn->FillNShard(shard, (Int_t) pairWeights.size(), &pairVars[0], step, &pairWeights[0], kNPairVars);
+          else
+            trackHistTHn->FillN((Int_t) pairWeights.size(), &pairVars[0], step, &pairWeights[0], kNPairVars);
+          pairVars.clear();
+          pairWeights.clear();
+        }
       }
- 
-      if (firstTime)
+    };
+    
+    if (nThreads > 1)
+    {
+      if (trackHistTHn->GetNumberOfShards() < nThreads)
+        trackHistTHn->SetNumberOfShards(fNThreads);
+      
+      std::vector<std::thread> threads;
+      for (Int_t ithread=0; ithread<nThreads; ithread++)
+        threads.emplace_back(fillPairs, nTriggers * ithread / nThreads, nTriggers * (ithread + 1) / nThreads, ithread);
+      for (auto& thread : threads)
+        thread.join();
+    }
+    else
+      fillPairs(0, nTriggers, -1);
+    
+    if (firstTime)
+    {
+      for (Int_t t=0; t<nTriggers; t++)
       {
         // once per trigger particle
+        AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(triggers[t]);
+        Float_t triggerEta = triggerEtas[t];
+        
         Double_t vars[3];
         vars[0] = triggerParticle->Pt();
         vars[1] = centrality;
@@ -1374,6 +1470,7 @@ void AliUEHistograms::Copy(TObject& c) const
   target.fPtOrder = fPtOrder;
   target.fTwoTrackCutMinRadius = fTwoTrackCutMinRadius;
   target.fCheckEventNumberInCorrelation = fCheckEventNumberInCorrelation;
+  target.fNThreads = fNThreads;
 }
 
 //____________________________________________________________________
@@ -1548,3 +1645,19 @@ void AliUEHistograms::Reset()
     if (GetUEHist(i))
       GetUEHist(i)->Reset();
 }
+
+void AliUEHistograms::MergeShards()
+{
+  // adds the per-thread shards filled in FillCorrelations (SetNumberOfThreads) to the track histogram
+  // has to be called before the object is written, e.g. in FinishTaskOutput
+  
+  if (!fNumberDensityPhi)
+    return;
+  
+  AliTHnBase* trackHist = dynamic_cast<AliTHnBase*> (fNumberDensityPhi->GetTrackHist(AliUEHist::kToward));
+  if (!trackHist || trackHist->GetNumberOfShards() == 0)
+    return;
+  
+  trackHist->PrintMemoryUsage();
+  trackHist->MergeShards(fNThreads);
+}
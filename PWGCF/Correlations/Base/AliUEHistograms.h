@@ -106,6 +106,8 @@ class AliUEHistograms : public TNamed
   void SetTwoTrackCutMinRadius(Float_t min) { fTwoTrackCutMinRadius = min; }
 
   void SetCheckEventNumberInCorrelation(Bool_t val) { fCheckEventNumberInCorrelation = val; }
+  void SetNumberOfThreads(Int_t nThreads) { fNThreads = nThreads; }
+  void MergeShards();
   void ExtendTrackingEfficiency(Bool_t verbose = kFALSE);
   void Reset();
 
@@ -178,11 +180,13 @@ protected:
 
   Bool_t fCheckEventNumberInCorrelation; // do not correlate two particles from the same event (only works for AliBasicParticles)
 
+  Int_t fNThreads;               // number of threads for the pair loop in FillCorrelations (requires an AliTHn track histogram, see MergeShards)
+
   Long64_t fRunNumber;           // run number that has been processed
   
   Int_t fMergeCount;		// counts how many objects have been merged together
   
-  ClassDef(AliUEHistograms, 33)  // underlying event histogram container
+  ClassDef(AliUEHistograms, 34)  // underlying event histogram container
 };
 
 Float_t AliUEHistograms::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
@@ -209,7 +209,8 @@ fCustomParticlesA(""),
 fCustomParticlesB(""),
 fEventPoolOutputList(),
 fUsePtBinnedEventPool(0),
-fCheckEventNumberInMixedEvent(kFALSE)
+fCheckEventNumberInMixedEvent(kFALSE),
+fNThreads(1)
 {
   // Default constructor
   // Define input and output slots here
@@ -383,6 +384,9 @@ void  AliAnalysisTaskPhiCorrelations::CreateOutputObjects()
   fHistos->SetTwoTrackCutMinRadius(fTwoTrackCutMinRadius);
   fHistosMixed->SetTwoTrackCutMinRadius(fTwoTrackCutMinRadius);
 
+  fHistos->SetNumberOfThreads(fNThreads);
+  fHistosMixed->SetNumberOfThreads(fNThreads);
+
   if (fEfficiencyCorrectionTriggers) {
     fHistos->SetEfficiencyCorrectionTriggers(fEfficiencyCorrectionTriggers);
     fHistosMixed->SetEfficiencyCorrectionTriggers((THnF*) fEfficiencyCorrectionTriggers->Clone());
@@ -2177,4 +2181,10 @@ void AliAnalysisTaskPhiCorrelations::FinishTaskOutput()
 {
   // Clear unnecessary pools before saving
   fPoolMgr->ClearPools();
+
+  // Add the per-thread buffers of the pair loop to the output containers
+  if (fHistos)
+    fHistos->MergeShards();
+  if (fHistosMixed)
+    fHistosMixed->MergeShards();
 }
@@ -185,6 +185,9 @@ public:
   void SetUsePtBinnedEventPool(Bool_t val) {fUsePtBinnedEventPool = val;}
   void SetCheckEventNumberInMixedEvent(Bool_t val) {fCheckEventNumberInMixedEvent = val;}
 
+  // Number of threads for the pair loop (same and mixed events), requires AliTHn containers
+  void SetNumberOfThreads(Int_t nThreads) { fNThreads = nThreads; }
+
   // Set which pools will be saved
   void AddEventPoolsToOutput(Double_t minCent, Double_t maxCent,  Double_t minZvtx, Double_t maxZvtx, Double_t minPt, Double_t maxPt);
 
@@ -342,8 +345,9 @@ private:
   vector<vector<Double_t> > fEventPoolOutputList; // vector representing a list of pools (given by value range) that will be saved
   Bool_t fUsePtBinnedEventPool;                   // uses event pool in pt bins
   Bool_t fCheckEventNumberInMixedEvent;           // check event number before correlation in mixed event
+  Int_t fNThreads;                                // number of threads for the pair loop in AliUEHistograms::FillCorrelations
 
-  ClassDef(AliAnalysisTaskPhiCorrelations, 64); // Analysis task for delta phi correlations
+  ClassDef(AliAnalysisTaskPhiCorrelations, 65); // Analysis task for delta phi correlations
 };
 
 #endif
@@ -195,4 +195,18 @@ AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEv
 
   return *this;
 }
+//_________________
+void AliFemtoPicoEvent::Clear()
+{
+  // Delete the particles and empty the collections, keeping the collections
+  // themselves so that the event can be filled again
+  AliFemtoParticleCollection* collections[3] = {fFirstParticleCollection, fSecondParticleCollection, fThirdParticleCollection};
+  for (int icoll = 0; icoll < 3; icoll++) {
+    if (!collections[icoll]) continue;
+    for (AliFemtoParticleIterator iter = collections[icoll]->begin(); iter != collections[icoll]->end(); iter++) {
+      delete *iter;
+    }
+    collections[icoll]->clear();
+  }
+}
 
@@ -52,6 +52,8 @@ public:
 
   AliFemtoPicoEvent& operator=(const AliFemtoPicoEvent& aPicoEvent);
 
+  void Clear();
+
   /* may want to have other stuff in here, like where is primary vertex */
 
   AliFemtoParticleCollection* FirstParticleCollection();
@@ -183,7 +183,10 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis():
   fMinSizePartCollection(0),
   fVerbose(kTRUE),
   fPerformSharedDaughterCut(kFALSE),
-  fEnablePairMonitors(kFALSE)
+  fEnablePairMonitors(kFALSE),
+  fPicoEventPool(),
+  fPairParticles1(),
+  fPairParticles2()
 {
   // Default constructor
   fCorrFctnCollection = new AliFemtoCorrFctnCollection;
@@ -205,7 +208,10 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
   fMinSizePartCollection(a.fMinSizePartCollection),
   fVerbose(a.fVerbose),
   fPerformSharedDaughterCut(a.fPerformSharedDaughterCut),
-  fEnablePairMonitors(a.fEnablePairMonitors)
+  fEnablePairMonitors(a.fEnablePairMonitors),
+  fPicoEventPool(),
+  fPairParticles1(),
+  fPairParticles2()
 {
   /// Copy constructor
 
@@ -317,6 +323,10 @@ AliFemtoSimpleAnalysis::~AliFemtoSimpleAnalysis()
     }
     delete fMixingBuffer;
   }
+
+  for (auto &event : fPicoEventPool) {
+    delete event;
+  }
 }
 //______________________
 AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAnalysis& aAna)
@@ -471,9 +481,9 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
   // Analysis likes the event -- build a pico event from it, using tracks the
   // analysis likes. This is what we will make pairs from and put in Mixing
   // Buffer.
-  // No memory leak: we will delete picoevents when they come out of the
-  // mixing buffer
-  fPicoEvent = new AliFemtoPicoEvent;
+  // No memory leak: picoevents coming out of the mixing buffer are emptied
+  // and reused by NewPicoEvent()
+  fPicoEvent = NewPicoEvent();
 
   AliFemtoParticleCollection *collection1 = fPicoEvent->FirstParticleCollection(),
                              *collection2 = fPicoEvent->SecondParticleCollection();
@@ -526,7 +536,8 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
 
   if (!tmpPassEvent) {
     EventEnd(hbtEvent);
-    delete fPicoEvent;
+    RecyclePicoEvent(fPicoEvent);
+    fPicoEvent = nullptr;
     return;
   }
 
@@ -562,9 +573,9 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
     cout << " - mixed done   \n";
   }
 
-  //--------- If mixing buffer is full, delete oldest event ---------//
-  if ( MixingBufferFull() ) {
-    delete MixingBuffer()->back();
+  //--------- If mixing buffer is full, recycle oldest event ---------//
+  if ( MixingBufferFull() && !MixingBuffer()->empty() ) {
+    RecyclePicoEvent(MixingBuffer()->back());
     MixingBuffer()->pop_back();
   }
 
@@ -598,60 +609,50 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
   // "Seed" this here.
   bool swpart = fNeventsProcessed % 2;
 
-  // Setup iterator ranges
+  // Copy the particle pointers into contiguous arrays: the pair loops then
+  // stream through memory instead of following the list nodes, which matters
+  // for the mixed pairs where the stored collections are long out of cache.
   //
   // The outer loop alway starts at beginning of particle collection 1.
   // * If we are iterating over both particle collections, then the loop simply
   // runs through both from beginning to end.
   // * If we are only iterating over one particle collection, the inner loop
-  // loops over all particles between the outer iterator and the end of the
-  // collection. The outer loop must skip the last entry of the list.
-  AliFemtoParticleConstIterator tStartOuterLoop = partCollection1->begin(),
-                                tEndOuterLoop = partCollection1->end(),
-                                tStartInnerLoop,
-                                tEndInnerLoop;
-
-  if (partCollection2) {                         // Two collections:
-    tStartInnerLoop = partCollection2->begin();  //   Full inner & outer loops
-    tEndInnerLoop   = partCollection2->end();    //
-  }
-  else {                                         // One collection:
-    tEndOuterLoop--;                             //   Outer loop goes to next-to-last particle
-    tEndInnerLoop = partCollection1->end() ;     //   Inner loop goes to last particle
+  // loops over all particles after the outer loop position.
+  fPairParticles1.assign(partCollection1->begin(), partCollection1->end());
+  if (partCollection2) {
+    fPairParticles2.assign(partCollection2->begin(), partCollection2->end());
   }
 
+  AliFemtoParticle* const* particles1 = fPairParticles1.data();
+  AliFemtoParticle* const* particles2 = partCollection2 ? fPairParticles2.data() : particles1;
+  const size_t nParticles1 = fPairParticles1.size(),
+               nParticles2 = partCollection2 ? fPairParticles2.size() : nParticles1;
+
   // Create the pair outside the loop - only allocate once
   AliFemtoPair* tPair = new AliFemtoPair;
 
   // Begin the outer loop
-  for (AliFemtoParticleConstIterator tPartIter1 = tStartOuterLoop;
-                                     tPartIter1 != tEndOuterLoop;
-                                     ++tPartIter1) {
+  for (size_t i1 = 0; i1 < nParticles1; ++i1) {
 
     // If analyzing identical particles, start inner loop at the particle
     // after the current outer loop position, (loops until end)
-    if (!partCollection2) {
-      tStartInnerLoop = tPartIter1;
-      tStartInnerLoop++;
-    }
+    const size_t tStartInnerLoop = partCollection2 ? 0 : i1 + 1;
 
     // If we have two collections - set the first track
     if (partCollection2 != nullptr) {
-      tPair->SetTrack1(*tPartIter1);
+      tPair->SetTrack1(particles1[i1]);
     }
 
     // Begin the inner loop
-    for (AliFemtoParticleConstIterator tPartIter2 = tStartInnerLoop;
-                                       tPartIter2 != tEndInnerLoop;
-                                     ++tPartIter2) {
+    for (size_t i2 = tStartInnerLoop; i2 < nParticles2; ++i2) {
       // If we have two collections - only set the second track
       if (partCollection2 != nullptr) {
-        tPair->SetTrack2(*tPartIter2);
+        tPair->SetTrack2(particles2[i2]);
 
       // Swap between first and second particles to avoid biased ordering
       } else {
-        tPair->SetTrack1(swpart ? *tPartIter2 : *tPartIter1);
-        tPair->SetTrack2(swpart ? *tPartIter1 : *tPartIter2);
+        tPair->SetTrack1(swpart ? particles2[i2] : particles1[i1]);
+        tPair->SetTrack2(swpart ? particles1[i1] : particles2[i2]);
         swpart = !swpart;
       }
 
@@ -680,6 +681,33 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
   delete tPair;
 }
 //_________________________
+AliFemtoPicoEvent* AliFemtoSimpleAnalysis::NewPicoEvent()
+{
+  /// Take an empty pico event from the pool, or allocate one if the pool is
+  /// empty. In steady state every event dropped from the mixing buffer is
+  /// reused, so no pico event is allocated per processed event.
+
+  if (fPicoEventPool.empty()) {
+    return new AliFemtoPicoEvent;
+  }
+
+  AliFemtoPicoEvent *picoEvent = fPicoEventPool.back();
+  fPicoEventPool.pop_back();
+  return picoEvent;
+}
+//_________________________
+void AliFemtoSimpleAnalysis::RecyclePicoEvent(AliFemtoPicoEvent* picoEvent)
+{
+  /// Release the particles of the pico event and return it to the pool
+
+  if (!picoEvent) {
+    return;
+  }
+
+  picoEvent->Clear();
+  fPicoEventPool.push_back(picoEvent);
+}
+//_________________________
 void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
 {
   /// Perform initialization operations at the beginning of the event processing
@@ -16,6 +16,8 @@
 #include "AliFemtoV0SharedDaughterCut.h"
 #include "AliFemtoXiSharedDaughterCut.h"
 
+#include <vector>
+
 class AliFemtoPicoEventCollectionVectorHideAway;
 class AliFemtoPicoEvent;
 
@@ -159,6 +161,14 @@ protected:
                  AliFemtoParticleCollection* ParticlesPssingCut2=NULL,
                  Bool_t enablePairMonitors=kFALSE);
 
+  /// Return an empty pico event, reusing one released by
+  /// RecyclePicoEvent() if available
+  AliFemtoPicoEvent* NewPicoEvent();
+
+  /// Delete the particles of the pico event and keep the (empty) event for
+  /// the next call of NewPicoEvent()
+  void RecyclePicoEvent(AliFemtoPicoEvent* picoEvent);
+
   AliFemtoPicoEventCollectionVectorHideAway* fPicoEventCollectionVectorHideAway; //!<! Mixing Buffer used for Analyses which wrap this one
 
   AliFemtoPairCut*             fPairCut;             ///< cut applied to pairs
@@ -178,6 +188,10 @@ protected:
   Bool_t fPerformSharedDaughterCut;
   Bool_t fEnablePairMonitors;
 
+  std::vector<AliFemtoPicoEvent*> fPicoEventPool;    //!<! Empty pico events, released from the mixing buffer
+  std::vector<AliFemtoParticle*> fPairParticles1;    //!<! Contiguous copy of the first particle collection in MakePairs
+  std::vector<AliFemtoParticle*> fPairParticles2;    //!<! Contiguous copy of the second particle collection in MakePairs
+
 #ifdef __ROOT__
   /// \cond CLASSIMP
   ClassDef(AliFemtoSimpleAnalysis, 0);
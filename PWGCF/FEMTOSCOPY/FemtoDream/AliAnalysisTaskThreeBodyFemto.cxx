@@ -84,7 +84,9 @@ AliAnalysisTaskThreeBodyFemto::AliAnalysisTaskThreeBodyFemto()
       fResultsSample(nullptr),
       fResultsSampleQA(nullptr),
       fTrackBufferSize(2000),
-      fGTI(nullptr) {
+      fGTI(nullptr),
+      fTripletQ3Limit(0),
+      fTripletEngine() {
 }
 
 AliAnalysisTaskThreeBodyFemto::AliAnalysisTaskThreeBodyFemto(const char* name, bool isMC)
@@ -162,7 +164,9 @@ AliAnalysisTaskThreeBodyFemto::AliAnalysisTaskThreeBodyFemto(const char* name, b
       fResultsSample(nullptr),
       fResultsSampleQA(nullptr),
       fTrackBufferSize(2000),
-      fGTI(nullptr) {
+      fGTI(nullptr),
+      fTripletQ3Limit(0),
+      fTripletEngine() {
         DefineOutput(1, TList::Class());  //Output for the Event Cuts
         DefineOutput(2, TList::Class());  //Output for the Proton Cuts
         DefineOutput(3, TList::Class());  //Output for the AntiProton Cuts
@@ -219,6 +223,7 @@ AliAnalysisTaskThreeBodyFemto::~AliAnalysisTaskThreeBodyFemto() {
 
 void AliAnalysisTaskThreeBodyFemto::UserCreateOutputObjects() {
   fGTI = new AliVTrack *[fTrackBufferSize];
+  fTripletEngine.SetQ3Limit(fTripletQ3Limit);
 
   if (!fEventCuts) {
     AliError("No Event cuts \n");
@@ -1055,6 +1060,30 @@ void AliAnalysisTaskThreeBodyFemto::FillTripletDistribution(std::vector<std::vec
   unsigned int DoThisPair23 = DaughterPart2*10+DaughterPart3;
   unsigned int DoThisPair31 = DaughterPart3*10+DaughterPart1;
 
+  if(fTripletQ3Limit>0){
+    // triplets below the Q3 limit from the triplet engine, same selection and histograms as the loops below
+    fTripletEngine.ClearLists();
+    int list1 = fTripletEngine.AddList(*Particle1Vector, massparticle1);
+    int list2 = fTripletEngine.AddList(*Particle2Vector, massparticle2);
+    int list3 = fTripletEngine.AddList(*Particle3Vector, massparticle3);
+    fTripletEngine.BuildTriplets(list1, list2, list3, firstSpecies==secondSpecies, firstSpecies==thirdSpecies, secondSpecies==thirdSpecies);
+    for (unsigned int iTriplet = 0; iTriplet < fTripletEngine.GetNTriplets(); ++iTriplet) {
+      const AliFemtoDreamTriplet &triplet = fTripletEngine.GetTriplet(iTriplet);
+      auto iPart1 = Particle1Vector->begin()+triplet.fPart1;
+      auto iPart2 = Particle2Vector->begin()+triplet.fPart2;
+      auto iPart3 = Particle3Vector->begin()+triplet.fPart3;
+      if(!TripletPassesCloseRejection(*iPart1,*iPart2,*iPart3,true,DoThisPair12,DoThisPair23,DoThisPair31,DoThisPair12==11,DoThisPair23==11,DoThisPair31==11,fEventTripletPhiThetaArray[phiEtaHistNo],fEventTripletPhiThetaArray[21+phiEtaHistNo],Config)) {continue;}
+      float Q3 = triplet.fQ3;
+      hist->Fill(Q3);
+      hist2d->Fill(Q3,mult+1);
+
+      if(firstSpecies == 2 || firstSpecies == 3) InvMassSame->Fill(Q3, iPart1->GetInvMass());
+      if(secondSpecies == 2 || secondSpecies == 3) InvMassSame->Fill(Q3, iPart2->GetInvMass());
+      if(thirdSpecies == 2 || thirdSpecies == 3) InvMassSame->Fill(Q3, iPart3->GetInvMass());
+    }
+    return;
+  }
+
   // loop over first particle 
   for (auto iPart1 = Particle1Vector->begin(); iPart1 != Particle1Vector->end(); ++iPart1) {
     // if second particle species is different than first - start with the first particle in the vector
@@ -1363,6 +1392,55 @@ void AliAnalysisTaskThreeBodyFemto::FillTripletDistributionME(std::vector<std::v
   unsigned int DoThisPair23 = DaughterPart2*10+DaughterPart3;
   unsigned int DoThisPair31 = DaughterPart3*10+DaughterPart1;
   
+  if(fTripletQ3Limit>0){
+    // triplets below the Q3 limit from the triplet engine, one engine list per event of the buffer
+    fTripletEngine.ClearLists();
+    int listSE = fTripletEngine.AddList(*ParticleSE, massParticleSE);
+    std::vector<int> listsME1;
+    std::vector<int> listsME2;
+    for (int iDepth = 0; iDepth < (int) MixedEvent1Container->GetMixingDepth(); ++iDepth) {
+      listsME1.push_back(fTripletEngine.AddList(MixedEvent1Container->GetEvent(iDepth), massParticleME1));
+    }
+    if(speciesME1==speciesME2) {
+      listsME2 = listsME1;
+    } else {
+      for (int iDepth = 0; iDepth < (int) MixedEvent2Container->GetMixingDepth(); ++iDepth) {
+        listsME2.push_back(fTripletEngine.AddList(MixedEvent2Container->GetEvent(iDepth), massParticleME2));
+      }
+    }
+    for (int iDepth1 = 0; iDepth1 < (int) listsME1.size(); ++iDepth1) {
+      std::vector<AliFemtoDreamBasePart> &iEvent2 = MixedEvent1Container->GetEvent(iDepth1);
+      int iDepth2 = 0;
+      if(speciesME1==speciesME2) iDepth2 = iDepth1+1;
+      for ( ; iDepth2 < (int) listsME2.size(); ++iDepth2) {
+        std::vector<AliFemtoDreamBasePart> &iEvent3 = MixedEvent2Container->GetEvent(iDepth2);
+        fTripletEngine.BuildTriplets(listSE, listsME1[iDepth1], listsME2[iDepth2], false, false, false);
+        for (unsigned int iTriplet = 0; iTriplet < fTripletEngine.GetNTriplets(); ++iTriplet) {
+          const AliFemtoDreamTriplet &triplet = fTripletEngine.GetTriplet(iTriplet);
+          auto iPart1 = ParticleSE->begin()+triplet.fPart1;
+          auto iPart2 = iEvent2.begin()+triplet.fPart2;
+          auto iPart3 = iEvent3.begin()+triplet.fPart3;
+          // pairs 23 and 31 selected with DoThisPair12, as in the loops below
+          if(!TripletPassesCloseRejection(*iPart1,*iPart2,*iPart3,false,DoThisPair12,DoThisPair23,DoThisPair31,DoThisPair12==11,DoThisPair12==23,DoThisPair12==31,fEventTripletPhiThetaArray[phiEtaHistNo],fEventTripletPhiThetaArray[20+phiEtaHistNo],Config)) {continue;}
+          float Q3 = triplet.fQ3;
+          hist->Fill(Q3);
+          hist2d->Fill(Q3,mult+1);
+
+          if(fRunPlotQ3Vsq){
+            Q3VskDistribution12Mixed->Fill(Q3, triplet.fQ12);
+            Q3VskDistribution23Mixed->Fill(Q3, triplet.fQ23);
+          }
+          if (fRunPlotInvMassTriplet){
+            if(speciesSE == 2 || speciesSE == 3) InvMassMixed->Fill(Q3, iPart1->GetInvMass());
+            if(speciesME1 == 2 || speciesME1 == 3) InvMassMixed->Fill(Q3, iPart2->GetInvMass());
+            if(speciesME2 == 2 || speciesME2 == 3) InvMassMixed->Fill(Q3, iPart3->GetInvMass());
+          }
+        }
+      }
+    }
+    return;
+  }
+
   // loop over first particle 
   for (auto iPart1 = ParticleSE->begin(); iPart1 != ParticleSE->end(); ++iPart1) {
     // loop over second particle ...
@@ -1707,6 +1785,34 @@ void AliAnalysisTaskThreeBodyFemto::FillTripletDistributionSE2ME1(std::vector<st
   unsigned int DoThisPair12 = DaughterPart1*10+DaughterPart2;
   unsigned int DoThisPair23 = DaughterPart2*10+DaughterPart3;
   unsigned int DoThisPair31 = DaughterPart3*10+DaughterPart1;
+  if(fTripletQ3Limit>0){
+    // triplets below the Q3 limit from the triplet engine, one engine list per event of the buffer
+    fTripletEngine.ClearLists();
+    int listSE1 = fTripletEngine.AddList(*ParticleSE1, massParticleSE1);
+    int listSE2 = fTripletEngine.AddList(*ParticleSE2, massParticleSE2);
+    for ( int iDepth1 = 0; iDepth1 < (int) MixedEventContainer->GetMixingDepth(); ++iDepth1) {
+      std::vector<AliFemtoDreamBasePart> &iEvent3 = MixedEventContainer->GetEvent(iDepth1);
+      int listME = fTripletEngine.AddList(iEvent3, massParticleME);
+      fTripletEngine.BuildTriplets(listSE1, listSE2, listME, speciesSE1==speciesSE2, false, false);
+      for (unsigned int iTriplet = 0; iTriplet < fTripletEngine.GetNTriplets(); ++iTriplet) {
+        const AliFemtoDreamTriplet &triplet = fTripletEngine.GetTriplet(iTriplet);
+        auto iPart1 = ParticleSE1->begin()+triplet.fPart1;
+        auto iPart2 = ParticleSE2->begin()+triplet.fPart2;
+        auto iPart3 = iEvent3.begin()+triplet.fPart3;
+        if(!TripletPassesCloseRejection(*iPart1,*iPart2,*iPart3,false,DoThisPair12,DoThisPair23,DoThisPair31,DoThisPair12==11,DoThisPair23==11,DoThisPair31==11,fEventTripletPhiThetaArray[phiEtaHistNo],fEventTripletPhiThetaArray[21+phiEtaHistNo],Config)) {continue;}
+        float Q3 = triplet.fQ3;
+        hist->Fill(Q3);
+        hist2d->Fill(Q3,mult+1);
+
+        if(fRunPlotQ3Vsq){
+          Q3VskDistribution12->Fill(Q3, triplet.fQ12);
+          Q3VskDistribution23->Fill(Q3, triplet.fQ23);
+        }
+      }
+    }
+    return;
+  }
+
   // loop over first particle 
   for (auto iPart1 = ParticleSE1->begin(); iPart1 != ParticleSE1->end(); ++iPart1) {
     auto iPart2 = ParticleSE2->begin();
@@ -1771,6 +1877,28 @@ void AliAnalysisTaskThreeBodyFemto::FillTripletDistributionSE2ME1(std::vector<st
   }
 }
 
+bool AliAnalysisTaskThreeBodyFemto::TripletPassesCloseRejection(
+    AliFemtoDreamBasePart &part1, AliFemtoDreamBasePart &part2, AliFemtoDreamBasePart &part3,
+    bool SEorME, unsigned int DoThisPair12, unsigned int DoThisPair23, unsigned int DoThisPair31,
+    bool check12, bool check23, bool check31, TH2F* beforeHist, TH2F* afterHist, AliFemtoDreamCollConfig &Config) {
+  // Close pair rejection of a triplet from the triplet engine, as in the
+  // triplet loops: all pairs with fClosePairRejectionForAll, otherwise the
+  // pairs with checkXY. All checked pairs are filled in the QA histograms
+  bool Pair12 = true;
+  bool Pair23 = true;
+  bool Pair31 = true;
+  if(fClosePairRejectionForAll || check12){
+    Pair12 = DeltaEtaDeltaPhi(part1,part2,SEorME,  DoThisPair12, beforeHist,afterHist,Config);
+  }
+  if(fClosePairRejectionForAll || check23){
+    Pair23 = DeltaEtaDeltaPhi(part2,part3,SEorME,  DoThisPair23, beforeHist,afterHist,Config);
+  }
+  if(fClosePairRejectionForAll || check31){
+    Pair31 = DeltaEtaDeltaPhi(part3,part1,SEorME,  DoThisPair31, beforeHist,afterHist,Config);
+  }
+  return Pair12 && Pair23 && Pair31;
+}
+
 bool AliAnalysisTaskThreeBodyFemto::DeltaEtaDeltaPhi(
                                                    AliFemtoDreamBasePart &part1,
                                                    AliFemtoDreamBasePart &part2,
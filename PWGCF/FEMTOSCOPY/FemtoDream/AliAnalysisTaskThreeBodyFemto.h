@@ -18,6 +18,7 @@
 #include "AliFemtoDreamPairCleaner.h"
 #include "AliFemtoDreamPartCollection.h"
 #include "AliFemtoDreamControlSample.h"
+#include "AliFemtoDreamTripletEngine.h"
 
 class AliAnalysisTaskThreeBodyFemto : public AliAnalysisTaskSE {
  public:
@@ -49,6 +50,7 @@ class AliAnalysisTaskThreeBodyFemto : public AliAnalysisTaskSE {
   void FillTripletDistributionSE2ME1(std::vector<std::vector<AliFemtoDreamBasePart>> &ParticleVector, std::vector<AliFemtoDreamPartContainer> &fPartContainer, int speciesSE1, int speciesSE2, int speciesME, TH1F* hist, std::vector<int> PDGCodes, int mult, TH2F* hist2d, TH2F **fEventTripletPhiThetaArray, int phiEtaHistNo, AliFemtoDreamCollConfig Config,TH2F* Q3VskDistribution12, TH2F* Q3VskDistribution23);
   // Add the close pair cut
   bool DeltaEtaDeltaPhi(AliFemtoDreamBasePart &part1,AliFemtoDreamBasePart &part2, bool SEorME,  unsigned int DoThisPair, TH2F* beforeHist,TH2F* afterHist, AliFemtoDreamCollConfig Config);
+  bool TripletPassesCloseRejection(AliFemtoDreamBasePart &part1,AliFemtoDreamBasePart &part2,AliFemtoDreamBasePart &part3, bool SEorME, unsigned int DoThisPair12, unsigned int DoThisPair23, unsigned int DoThisPair31, bool check12, bool check23, bool check31, TH2F* beforeHist,TH2F* afterHist, AliFemtoDreamCollConfig &Config);
   void FillPairInvMass(AliFemtoDreamBasePart &part1, AliFemtoDreamBasePart &part2, AliFemtoDreamBasePart &part3, TH2F* hist, float Q3) ;
   void FillPDGPairInvMass(AliFemtoDreamBasePart &part1, float massPart1, AliFemtoDreamBasePart &part2, float massPart2, AliFemtoDreamBasePart &part3, float massPart3, TH2F* hist, float Q3);
 
@@ -101,6 +103,13 @@ class AliAnalysisTaskThreeBodyFemto : public AliAnalysisTaskSE {
     fClosePairRejectionForAll=ClosePairRejectionForAll;
   }
 
+  // Build the triplets with AliFemtoDreamTripletEngine, only up to this Q3
+  // (typically the upper edge of the Q3 histograms). Triplets above are not
+  // built, hence not in the overflow bins nor in the close pair QA plots
+  void SetTripletQ3Limit(float limit) {
+    fTripletQ3Limit=limit;
+  }
+
   
 
   static TLorentzVector RelativePairMomentum(TLorentzVector &PartOne, TLorentzVector &PartTwo);
@@ -193,7 +202,9 @@ class AliAnalysisTaskThreeBodyFemto : public AliAnalysisTaskSE {
   TList *fResultsSampleQA;//!
   int fTrackBufferSize;//
   AliVTrack **fGTI;  //!
-  ClassDef(AliAnalysisTaskThreeBodyFemto,3)
+  float fTripletQ3Limit;//
+  AliFemtoDreamTripletEngine fTripletEngine;//!
+  ClassDef(AliAnalysisTaskThreeBodyFemto,4)
 };
 
 #endif /* PWGCF_FEMTOSCOPY_FEMTODREAM_ALIANALYSISTASKTHREEBODYFEMTO_H_ */
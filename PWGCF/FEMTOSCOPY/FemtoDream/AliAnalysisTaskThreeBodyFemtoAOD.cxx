@@ -75,7 +75,9 @@ AliAnalysisTaskThreeBodyFemtoAOD::AliAnalysisTaskThreeBodyFemtoAOD()
       fResultsSample(nullptr),
       fResultsSampleQA(nullptr),
       fTrackBufferSize(2000),
-      fGTI(nullptr) {
+      fGTI(nullptr),
+      fTripletQ3Limit(0),
+      fTripletEngine() {
 }
 
 AliAnalysisTaskThreeBodyFemtoAOD::AliAnalysisTaskThreeBodyFemtoAOD(const char* name, bool isMC, bool triggerOn)
@@ -144,7 +146,9 @@ AliAnalysisTaskThreeBodyFemtoAOD::AliAnalysisTaskThreeBodyFemtoAOD(const char* n
       fResultsSample(nullptr),
       fResultsSampleQA(nullptr),
       fTrackBufferSize(2000),
-      fGTI(nullptr) {
+      fGTI(nullptr),
+      fTripletQ3Limit(0),
+      fTripletEngine() {
         DefineOutput(1, TList::Class());  //Output for the Event Cuts
         DefineOutput(2, TList::Class());  //Output for the Proton Cuts
         DefineOutput(3, TList::Class());  //Output for the AntiProton Cuts
@@ -224,6 +228,7 @@ AliAnalysisTaskThreeBodyFemtoAOD::~AliAnalysisTaskThreeBodyFemtoAOD() {
 
 void AliAnalysisTaskThreeBodyFemtoAOD::UserCreateOutputObjects() {
   fGTI = new AliAODTrack *[fTrackBufferSize];
+  fTripletEngine.SetQ3Limit(fTripletQ3Limit);
 
   if (!fEventCuts) {
     AliError("No Event cuts \n");
@@ -966,6 +971,26 @@ void AliAnalysisTaskThreeBodyFemtoAOD::FillTripletDistribution(std::vector<std::
   unsigned int DoThisPair23 = DaughterPart2*10+DaughterPart3;
   unsigned int DoThisPair31 = DaughterPart3*10+DaughterPart1;
 
+  if(fTripletQ3Limit>0){
+    // triplets below the Q3 limit from the triplet engine, same selection and histograms as the loops below
+    fTripletEngine.ClearLists();
+    int list1 = fTripletEngine.AddList(*Particle1Vector, massparticle1);
+    int list2 = fTripletEngine.AddList(*Particle2Vector, massparticle2);
+    int list3 = fTripletEngine.AddList(*Particle3Vector, massparticle3);
+    fTripletEngine.BuildTriplets(list1, list2, list3, firstSpecies==secondSpecies, firstSpecies==thirdSpecies, secondSpecies==thirdSpecies);
+    for (unsigned int iTriplet = 0; iTriplet < fTripletEngine.GetNTriplets(); ++iTriplet) {
+      const AliFemtoDreamTriplet &triplet = fTripletEngine.GetTriplet(iTriplet);
+      auto iPart1 = Particle1Vector->begin()+triplet.fPart1;
+      auto iPart2 = Particle2Vector->begin()+triplet.fPart2;
+      auto iPart3 = Particle3Vector->begin()+triplet.fPart3;
+      if(!TripletPassesCloseRejection(*iPart1,*iPart2,*iPart3,true,DoThisPair12,DoThisPair23,DoThisPair31,fEventTripletPhiThetaArray[phiEtaHistNo],fEventTripletPhiThetaArray[20+phiEtaHistNo],Config)) {continue;}
+      float Q3 = triplet.fQ3;
+      hist->Fill(Q3);
+      hist2d->Fill(Q3,mult+1);
+    }
+    return;
+  }
+
   // loop over first particle 
   for (auto iPart1 = Particle1Vector->begin(); iPart1 != Particle1Vector->end(); ++iPart1) {
     // if second particle species is different than first - start with the first particle in the vector
@@ -1157,6 +1182,44 @@ void AliAnalysisTaskThreeBodyFemtoAOD::FillTripletDistributionMEPP(std::vector<s
   unsigned int DoThisPair23 = DaughterPart2*10+DaughterPart3;
   unsigned int DoThisPair31 = DaughterPart3*10+DaughterPart1;
   
+  if(fTripletQ3Limit>0){
+    // triplets below the Q3 limit from the triplet engine, one engine list per event of the buffer
+    fTripletEngine.ClearLists();
+    int listSE = fTripletEngine.AddList(*ParticleSE, massParticleSE);
+    std::vector<int> listsME1;
+    std::vector<int> listsME2;
+    for (int iDepth = 0; iDepth < (int) MixedEvent1Container->GetMixingDepth(); ++iDepth) {
+      listsME1.push_back(fTripletEngine.AddList(MixedEvent1Container->GetEvent(iDepth), massParticleME1));
+    }
+    if(speciesME1==speciesME2) {
+      listsME2 = listsME1;
+    } else {
+      for (int iDepth = 0; iDepth < (int) MixedEvent2Container->GetMixingDepth(); ++iDepth) {
+        listsME2.push_back(fTripletEngine.AddList(MixedEvent2Container->GetEvent(iDepth), massParticleME2));
+      }
+    }
+    for (int iDepth1 = 0; iDepth1 < (int) listsME1.size(); ++iDepth1) {
+      std::vector<AliFemtoDreamBasePart> &iEvent2 = MixedEvent1Container->GetEvent(iDepth1);
+      int iDepth2 = 0;
+      if(speciesME1==speciesME2) iDepth2 = iDepth1+1;
+      for ( ; iDepth2 < (int) listsME2.size(); ++iDepth2) {
+        std::vector<AliFemtoDreamBasePart> &iEvent3 = MixedEvent2Container->GetEvent(iDepth2);
+        fTripletEngine.BuildTriplets(listSE, listsME1[iDepth1], listsME2[iDepth2], false, false, false);
+        for (unsigned int iTriplet = 0; iTriplet < fTripletEngine.GetNTriplets(); ++iTriplet) {
+          const AliFemtoDreamTriplet &triplet = fTripletEngine.GetTriplet(iTriplet);
+          auto iPart1 = ParticleSE->begin()+triplet.fPart1;
+          auto iPart2 = iEvent2.begin()+triplet.fPart2;
+          auto iPart3 = iEvent3.begin()+triplet.fPart3;
+          if(!TripletPassesCloseRejection(*iPart1,*iPart2,*iPart3,false,DoThisPair12,DoThisPair23,DoThisPair31,fEventTripletPhiThetaArray[phiEtaHistNo],fEventTripletPhiThetaArray[20+phiEtaHistNo],Config)) {continue;}
+          float Q3 = triplet.fQ3;
+          hist->Fill(Q3);
+          hist2d->Fill(Q3,mult+1);
+        }
+      }
+    }
+    return;
+  }
+
   // loop over first particle 
   for (auto iPart1 = ParticleSE->begin(); iPart1 != ParticleSE->end(); ++iPart1) {
     // loop over second particle ...
@@ -1376,6 +1439,29 @@ void AliAnalysisTaskThreeBodyFemtoAOD::FillTripletDistributionSE2ME1(std::vector
   unsigned int DoThisPair23 = DaughterPart2*10+DaughterPart3;
   unsigned int DoThisPair31 = DaughterPart3*10+DaughterPart1;
 
+  if(fTripletQ3Limit>0){
+    // triplets below the Q3 limit from the triplet engine, one engine list per event of the buffer
+    fTripletEngine.ClearLists();
+    int listSE1 = fTripletEngine.AddList(*ParticleSE1, massParticleSE1);
+    int listSE2 = fTripletEngine.AddList(*ParticleSE2, massParticleSE2);
+    for ( int iDepth1 = 0; iDepth1 < (int) MixedEventContainer->GetMixingDepth(); ++iDepth1) {
+      std::vector<AliFemtoDreamBasePart> &iEvent3 = MixedEventContainer->GetEvent(iDepth1);
+      int listME = fTripletEngine.AddList(iEvent3, massParticleME);
+      fTripletEngine.BuildTriplets(listSE1, listSE2, listME, speciesSE1==speciesSE2, false, false);
+      for (unsigned int iTriplet = 0; iTriplet < fTripletEngine.GetNTriplets(); ++iTriplet) {
+        const AliFemtoDreamTriplet &triplet = fTripletEngine.GetTriplet(iTriplet);
+        auto iPart1 = ParticleSE1->begin()+triplet.fPart1;
+        auto iPart2 = ParticleSE2->begin()+triplet.fPart2;
+        auto iPart3 = iEvent3.begin()+triplet.fPart3;
+        if(!TripletPassesCloseRejection(*iPart1,*iPart2,*iPart3,false,DoThisPair12,DoThisPair23,DoThisPair31,fEventTripletPhiThetaArray[phiEtaHistNo],fEventTripletPhiThetaArray[20+phiEtaHistNo],Config)) {continue;}
+        float Q3 = triplet.fQ3;
+        hist->Fill(Q3);
+        hist2d->Fill(Q3,mult+1);
+      }
+    }
+    return;
+  }
+
   // loop over first particle 
   for (auto iPart1 = ParticleSE1->begin(); iPart1 != ParticleSE1->end(); ++iPart1) {
     auto iPart2 = ParticleSE2->begin();
@@ -1428,6 +1514,28 @@ void AliAnalysisTaskThreeBodyFemtoAOD::FillTripletDistributionSE2ME1(std::vector
 
 }
 
+bool AliAnalysisTaskThreeBodyFemtoAOD::TripletPassesCloseRejection(
+    AliFemtoDreamBasePart &part1, AliFemtoDreamBasePart &part2, AliFemtoDreamBasePart &part3,
+    bool SEorME, unsigned int DoThisPair12, unsigned int DoThisPair23, unsigned int DoThisPair31,
+    TH2F* beforeHist, TH2F* afterHist, AliFemtoDreamCollConfig &Config) {
+  // Close pair rejection of a triplet from the triplet engine, as in the
+  // triplet loops: the proton-proton pairs (11) are checked and filled in
+  // the QA histograms
+  bool Pair12 = true;
+  bool Pair23 = true;
+  bool Pair31 = true;
+  if(DoThisPair12==11){
+    Pair12 = DeltaEtaDeltaPhi(part1,part2,SEorME,  DoThisPair12, beforeHist,afterHist,Config);
+  }
+  if(DoThisPair23==11){
+    Pair23 = DeltaEtaDeltaPhi(part2,part3,SEorME,  DoThisPair23, beforeHist,afterHist,Config);
+  }
+  if(DoThisPair31==11){
+    Pair31 = DeltaEtaDeltaPhi(part3,part1,SEorME,  DoThisPair31, beforeHist,afterHist,Config);
+  }
+  return Pair12 && Pair23 && Pair31;
+}
+
 bool AliAnalysisTaskThreeBodyFemtoAOD::DeltaEtaDeltaPhi(
                                                    AliFemtoDreamBasePart &part1,
                                                    AliFemtoDreamBasePart &part2,
@@ -18,6 +18,7 @@
 #include "AliFemtoDreamPairCleaner.h"
 #include "AliFemtoDreamPartCollection.h"
 #include "AliFemtoDreamControlSample.h"
+#include "AliFemtoDreamTripletEngine.h"
 
 class AliAnalysisTaskThreeBodyFemtoAOD : public AliAnalysisTaskSE {
  public:
@@ -44,6 +45,7 @@ class AliAnalysisTaskThreeBodyFemtoAOD : public AliAnalysisTaskSE {
   void FillTripletDistributionSE2ME1(std::vector<std::vector<AliFemtoDreamBasePart>> &ParticleVector, std::vector<AliFemtoDreamPartContainer> &fPartContainer, int speciesSE1, int speciesSE2, int speciesME, TH1F* hist, std::vector<int> PDGCodes, int mult, TH2F* hist2d, TH2F **fEventTripletPhiThetaArray, int phiEtaHistNo, AliFemtoDreamCollConfig Config);
   // Add the close pair cut
   bool DeltaEtaDeltaPhi(AliFemtoDreamBasePart &part1,AliFemtoDreamBasePart &part2, bool SEorME,  unsigned int DoThisPair, TH2F* beforeHist,TH2F* afterHist, AliFemtoDreamCollConfig Config);
+  bool TripletPassesCloseRejection(AliFemtoDreamBasePart &part1,AliFemtoDreamBasePart &part2,AliFemtoDreamBasePart &part3, bool SEorME, unsigned int DoThisPair12, unsigned int DoThisPair23, unsigned int DoThisPair31, TH2F* beforeHist,TH2F* afterHist, AliFemtoDreamCollConfig &Config);
   bool MyLovely3BodyTrigger(AliAODEvent *evt ,  bool isMC, std::vector<int> PDGCodes);
   double CalculatePPLTriggerQ3Min(std::vector<std::vector<AliFemtoDreamBasePart>> &ParticleVector, int firstSpecies,int secondSpecies,int thirdSpecies, std::vector<int> PDGCodes );
 
@@ -105,6 +107,12 @@ class AliAnalysisTaskThreeBodyFemtoAOD : public AliAnalysisTaskSE {
   void SetTriggerOnSample(bool triggerOnSample) {
     fTriggerOnSample=triggerOnSample;
   } 
+  // Build the triplets with AliFemtoDreamTripletEngine, only up to this Q3
+  // (typically the upper edge of the Q3 histograms). Triplets above are not
+  // built, hence not in the overflow bins nor in the close pair QA plots
+  void SetTripletQ3Limit(float limit) {
+    fTripletQ3Limit=limit;
+  }
   
   static TLorentzVector RelativePairMomentum(TLorentzVector &PartOne, TLorentzVector &PartTwo);
  private:
@@ -181,7 +189,9 @@ class AliAnalysisTaskThreeBodyFemtoAOD : public AliAnalysisTaskSE {
   TList *fResultsSampleQA;//!
   int fTrackBufferSize;//
   AliAODTrack **fGTI;  //!
-  ClassDef(AliAnalysisTaskThreeBodyFemtoAOD,2)
+  float fTripletQ3Limit;//
+  AliFemtoDreamTripletEngine fTripletEngine;//!
+  ClassDef(AliAnalysisTaskThreeBodyFemtoAOD,3)
 };
 
 #endif /* PWGCF_FEMTOSCOPY_FEMTODREAM_AliAnalysisTaskThreeBodyFemtoAOD_H_ */
@@ -49,7 +49,8 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig()
       fDoDeltaEtaDeltaPhiCut(false),
       fCoutVariables(false),
       fSummedPtLimit1(0.0),
-      fSummedPtLimit2(999.0) {
+      fSummedPtLimit2(999.0),
+      fUseCompactPairing(false) {
   //should not be used, since we need a name to deal with root objects
 }
 
@@ -96,7 +97,8 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(
       fDoDeltaEtaDeltaPhiCut(config.fDoDeltaEtaDeltaPhiCut),
       fCoutVariables(config.fCoutVariables),
       fSummedPtLimit1(config.fSummedPtLimit1),
-      fSummedPtLimit2(config.fSummedPtLimit2) {
+      fSummedPtLimit2(config.fSummedPtLimit2),
+      fUseCompactPairing(config.fUseCompactPairing) {
 }
 
 AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(const char *name,
@@ -143,7 +145,8 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(const char *name,
       fDoDeltaEtaDeltaPhiCut(false),
       fCoutVariables(QACouts),
       fSummedPtLimit1(0.0),
-      fSummedPtLimit2(999.0) {
+      fSummedPtLimit2(999.0),
+      fUseCompactPairing(false) {
 }
 AliFemtoDreamCollConfig& AliFemtoDreamCollConfig::operator=(
     const AliFemtoDreamCollConfig& config) {
@@ -190,6 +193,7 @@ AliFemtoDreamCollConfig& AliFemtoDreamCollConfig::operator=(
     this->fCoutVariables = config.fCoutVariables;
     this->fSummedPtLimit1 = config.fSummedPtLimit1;
     this->fSummedPtLimit2 = config.fSummedPtLimit2;
+    this->fUseCompactPairing = config.fUseCompactPairing;
   }
   return *this;
 }
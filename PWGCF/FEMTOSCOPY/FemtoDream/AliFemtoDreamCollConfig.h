@@ -288,6 +288,16 @@ class AliFemtoDreamCollConfig : public TNamed {
   float GetSummedPtLimit2(){
     return fSummedPtLimit2;
   }
+  //Pairing on compact particle arrays (AliFemtoDreamCompactParticles), the
+  //mixing buffer then holds only the compact arrays. Not available with the
+  //QA plots that need the full particles
+  void SetUseCompactPairing(bool use) {
+    fUseCompactPairing = use;
+  }
+  bool GetUseCompactPairing() const {
+    return fUseCompactPairing && !fMassQA && !fMomentumResolution
+        && !fPhiEtaBinning && !fdPhidEtaPlots && !fAncestors;
+  }
   static std::vector<float> GetDefaultZbins();
   static std::vector<int> GetHMMultBins();
   static std::vector<int> GetMBMultBins();
@@ -335,7 +345,8 @@ class AliFemtoDreamCollConfig : public TNamed {
   bool fCoutVariables;
   float fSummedPtLimit1;
   float fSummedPtLimit2;
-  ClassDef(AliFemtoDreamCollConfig,17);
+  bool fUseCompactPairing;      //
+  ClassDef(AliFemtoDreamCollConfig,18);
 };
 
 #endif /* ALIFEMTODREAMCOLLCONFIG_H_ */
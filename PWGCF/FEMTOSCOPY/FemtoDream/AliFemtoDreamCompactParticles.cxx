@@ -0,0 +1,115 @@
+/*
+ * AliFemtoDreamCompactParticles.cxx
+ */
+#include "AliFemtoDreamCompactParticles.h"
+#include "TMath.h"
+
+ClassImp(AliFemtoDreamCompactParticles)
+AliFemtoDreamCompactParticles::AliFemtoDreamCompactParticles()
+    : fMass(0.f),
+      fPx(),
+      fPy(),
+      fPz(),
+      fE(),
+      fPt(),
+      fEtaOffset(1, 0),
+      fEta(),
+      fDaugOffset(1, 0),
+      fRadOffset(1, 0),
+      fPhiAtRad() {
+}
+
+AliFemtoDreamCompactParticles::~AliFemtoDreamCompactParticles() {
+}
+
+void AliFemtoDreamCompactParticles::SetParticles(
+    std::vector<AliFemtoDreamBasePart> &Particles, float mass,
+    bool closePairRejection) {
+  //The vectors keep their capacity from one event to the next, the particles
+  //are only read once per event
+  fMass = mass;
+  const unsigned int nPart = Particles.size();
+  fPx.resize(nPart);
+  fPy.resize(nPart);
+  fPz.resize(nPart);
+  fE.resize(nPart);
+  fPt.resize(nPart);
+  fEtaOffset.resize(1);
+  fEta.clear();
+  fDaugOffset.resize(1);
+  fRadOffset.resize(1);
+  fPhiAtRad.clear();
+  const double mass2 = (double) mass * (double) mass;
+  for (unsigned int i = 0; i < nPart; ++i) {
+    AliFemtoDreamBasePart &part = Particles[i];
+    TVector3 mom = part.GetMomentum();
+    fPx[i] = mom.X();
+    fPy[i] = mom.Y();
+    fPz[i] = mom.Z();
+    fE[i] = TMath::Sqrt(mom.Mag2() + mass2);
+    fPt[i] = mom.Pt();
+    if (closePairRejection) {
+      std::vector<float> eta = part.GetEta();
+      fEta.insert(fEta.end(), eta.begin(), eta.end());
+      std::vector<std::vector<float>> phiAtRad = part.GetPhiAtRaidius();
+      for (auto itDaug = phiAtRad.begin(); itDaug != phiAtRad.end(); ++itDaug) {
+        fPhiAtRad.insert(fPhiAtRad.end(), itDaug->begin(), itDaug->end());
+        fRadOffset.push_back(fPhiAtRad.size());
+      }
+    }
+    fEtaOffset.push_back(fEta.size());
+    fDaugOffset.push_back(fRadOffset.size() - 1);
+  }
+}
+
+void AliFemtoDreamCompactParticles::PairKinematics(
+    const AliFemtoDreamCompactParticles &one, unsigned int iPart,
+    const AliFemtoDreamCompactParticles &two, unsigned int first,
+    AliFemtoDreamPairBatch &batch) {
+  //k* from the invariants of the pair: with q = p1 - p2 and P = p1 + p2,
+  //k*^2 = ((q.P)^2 / P^2 - q^2) / 4 and q.P = m1^2 - m2^2. Same result as
+  //the boost to the pair rest frame of RelativePairMomentum, up to rounding
+  const unsigned int nPart = two.GetSize();
+  const unsigned int nPairs = (first < nPart) ? nPart - first : 0;
+  batch.fFirst = first;
+  batch.fRelK.resize(nPairs);
+  batch.fkT.resize(nPairs);
+  batch.fmT.resize(nPairs);
+  batch.fPairPt.resize(nPairs);
+
+  const double px1 = one.fPx[iPart];
+  const double py1 = one.fPy[iPart];
+  const double pz1 = one.fPz[iPart];
+  const double e1 = one.fE[iPart];
+  const double m1 = one.fMass;
+  const double m2 = two.fMass;
+  const double qP = m1 * m1 - m2 * m2;
+  const double avgMass2 = 0.25 * (m1 + m2) * (m1 + m2);
+  const double *px2 = two.fPx.data() + first;
+  const double *py2 = two.fPy.data() + first;
+  const double *pz2 = two.fPz.data() + first;
+  const double *e2 = two.fE.data() + first;
+  float *relK = batch.fRelK.data();
+  float *kT = batch.fkT.data();
+  float *mT = batch.fmT.data();
+  float *pairPt = batch.fPairPt.data();
+  for (unsigned int j = 0; j < nPairs; ++j) {
+    const double sumPx = px1 + px2[j];
+    const double sumPy = py1 + py2[j];
+    const double sumPz = pz1 + pz2[j];
+    const double sumE = e1 + e2[j];
+    const double qx = px1 - px2[j];
+    const double qy = py1 - py2[j];
+    const double qz = pz1 - pz2[j];
+    const double qE = e1 - e2[j];
+    const double sumPt2 = sumPx * sumPx + sumPy * sumPy;
+    const double s = sumE * sumE - sumPt2 - sumPz * sumPz;
+    const double q2 = qE * qE - qx * qx - qy * qy - qz * qz;
+    const double relK2 = (s > 0.) ? qP * qP / s - q2 : -q2;
+    const double pt = TMath::Sqrt(sumPt2);
+    relK[j] = 0.5 * TMath::Sqrt(relK2 > 0. ? relK2 : 0.);
+    pairPt[j] = pt;
+    kT[j] = 0.5 * pt;
+    mT[j] = TMath::Sqrt(0.25 * sumPt2 + avgMass2);
+  }
+}
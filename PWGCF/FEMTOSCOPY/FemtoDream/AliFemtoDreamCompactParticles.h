@@ -0,0 +1,80 @@
+/*
+ * AliFemtoDreamCompactParticles.h
+ *
+ * Compact representation of the particles of one species in one event, as
+ * used for the pairing: only the fields needed for the pair kinematics and
+ * the close pair rejection, each stored in one contiguous array.
+ */
+
+#ifndef ALIFEMTODREAMCOMPACTPARTICLES_H_
+#define ALIFEMTODREAMCOMPACTPARTICLES_H_
+#include <vector>
+#include "Rtypes.h"
+
+#include "AliFemtoDreamBasePart.h"
+
+//Pair kinematics of one particle with a range of partners, filled by
+//AliFemtoDreamCompactParticles::PairKinematics
+struct AliFemtoDreamPairBatch {
+  unsigned int fFirst;            // index of the first partner
+  std::vector<float> fRelK;       // k*
+  std::vector<float> fkT;         // kT
+  std::vector<float> fmT;         // mT
+  std::vector<float> fPairPt;     // pT of the pair
+};
+
+class AliFemtoDreamCompactParticles {
+ public:
+  AliFemtoDreamCompactParticles();
+  virtual ~AliFemtoDreamCompactParticles();
+  void SetParticles(std::vector<AliFemtoDreamBasePart> &Particles, float mass,
+                    bool closePairRejection);
+  unsigned int GetSize() const {
+    return fPx.size();
+  }
+  float GetMass() const {
+    return fMass;
+  }
+  float GetPt(unsigned int i) const {
+    return fPt[i];
+  }
+  //eta of the particle (iEta = 0) and of its daughters
+  unsigned int GetNEta(unsigned int i) const {
+    return fEtaOffset[i + 1] - fEtaOffset[i];
+  }
+  float GetEta(unsigned int i, unsigned int iEta) const {
+    return fEta[fEtaOffset[i] + iEta];
+  }
+  //phi at the TPC radii of the tracks of the particle
+  unsigned int GetNDaughters(unsigned int i) const {
+    return fDaugOffset[i + 1] - fDaugOffset[i];
+  }
+  unsigned int GetNRadii(unsigned int i, unsigned int iDaug) const {
+    return fRadOffset[fDaugOffset[i] + iDaug + 1]
+        - fRadOffset[fDaugOffset[i] + iDaug];
+  }
+  const float *GetPhiAtRadii(unsigned int i, unsigned int iDaug) const {
+    return &fPhiAtRad[fRadOffset[fDaugOffset[i] + iDaug]];
+  }
+  //k*, kT, mT and pair pT of particle iPart of one with the particles
+  //first, ..., two.GetSize()-1 of two
+  static void PairKinematics(const AliFemtoDreamCompactParticles &one,
+                             unsigned int iPart,
+                             const AliFemtoDreamCompactParticles &two,
+                             unsigned int first, AliFemtoDreamPairBatch &batch);
+ private:
+  float fMass;
+  std::vector<double> fPx;
+  std::vector<double> fPy;
+  std::vector<double> fPz;
+  std::vector<double> fE;
+  std::vector<float> fPt;
+  std::vector<unsigned int> fEtaOffset;
+  std::vector<float> fEta;
+  std::vector<unsigned int> fDaugOffset;
+  std::vector<unsigned int> fRadOffset;
+  std::vector<float> fPhiAtRad;
+ClassDef(AliFemtoDreamCompactParticles, 1)
+};
+
+#endif /* ALIFEMTODREAMCOMPACTPARTICLES_H_ */
@@ -83,6 +83,17 @@ bool AliFemtoDreamHigherPairMath::PassesPairSelection(
   return pass;
 }
 
+bool AliFemtoDreamHigherPairMath::PassesPairSelection(
+    int iHC, const AliFemtoDreamCompactParticles &one, unsigned int iPart1,
+    const AliFemtoDreamCompactParticles &two, unsigned int iPart2) {
+  //Close pair rejection on the compact particles. The eta-phi plots are not
+  //available in this mode
+  if (fRejPairs.at(iHC) && fDoDeltaEtaDeltaPhiCut) {
+    return DeltaEtaDeltaPhi(iHC, one, iPart1, two, iPart2);
+  }
+  return true;
+}
+
 bool AliFemtoDreamHigherPairMath::CommonAncestors(AliFemtoDreamBasePart& part1, AliFemtoDreamBasePart& part2) {
     bool IsCommon = false;
     if(part1.GetMotherID() == part2.GetMotherID()){
@@ -304,6 +315,121 @@ float AliFemtoDreamHigherPairMath::FillMixedEvent(
   return RelativeK;
 }
 
+void AliFemtoDreamHigherPairMath::FillSameEvent(
+    int iHC, int Mult, float cent, const AliFemtoDreamCompactParticles &one,
+    unsigned int iPart1, const AliFemtoDreamCompactParticles &two,
+    const AliFemtoDreamPairBatch &batch, float PartSumPtLimit1,
+    float PartSumPtLimit2) {
+  //Same histograms as FillSameEvent for the pairs of particle iPart1 of one
+  //with the partners of the batch passing the pair selection
+  const bool fillHists = fWhichPairs.at(iHC);
+  const bool CPR = fRejPairs.at(iHC) && fDoDeltaEtaDeltaPhiCut;
+  const bool multBinning = fHists->GetDoMultBinning();
+  const bool centBinning = fillHists && fHists->GetDoCentBinning();
+  const bool kTBinning = fillHists && fHists->GetDokTBinning();
+  const bool mTBinning = fillHists && fHists->GetDomTBinning();
+  const bool kTandMultBinning = fillHists && fHists->GetDokTandMultBinning();
+  const bool mTMultPlots = fillHists && fHists->GetDomTMultPlots();
+  const bool ptQA = fillHists && fHists->GetDoPtQA();
+  const float pt1 = one.GetPt(iPart1);
+  const unsigned int nPairs = batch.fRelK.size();
+  for (unsigned int iPair = 0; iPair < nPairs; ++iPair) {
+    const unsigned int iPart2 = batch.fFirst + iPair;
+    if (CPR && !DeltaEtaDeltaPhi(iHC, one, iPart1, two, iPart2)) {
+      continue;
+    }
+    const float PartSumPt = batch.fPairPt[iPair];
+    if (!((PartSumPt > PartSumPtLimit1) && (PartSumPt < PartSumPtLimit2))) {
+      continue;
+    }
+    const float RelativeK = batch.fRelK[iPair];
+    fHists->FillSameEventDist(iHC, RelativeK);
+    if (multBinning) {
+      fHists->FillSameEventMultDist(iHC, Mult + 1, RelativeK);
+    }
+    if (centBinning) {
+      fHists->FillSameEventCentDist(iHC, cent, RelativeK);
+    }
+    if (kTBinning) {
+      fHists->FillSameEventkTDist(iHC, batch.fkT[iPair], RelativeK, cent);
+    }
+    if (mTBinning) {
+      fHists->FillSameEventmTDist(iHC, batch.fmT[iPair], RelativeK);
+    }
+    if (kTandMultBinning) {
+      fHists->FillSameEventkTandMultDist(iHC, batch.fkT[iPair], RelativeK,
+                                         Mult + 1);
+    }
+    if (mTMultPlots) {
+      fHists->FillSameEventmTMultDist(iHC, batch.fmT[iPair], Mult + 1,
+                                      RelativeK);
+    }
+    if (ptQA) {
+      const float pt2 = two.GetPt(iPart2);
+      fHists->FillPtQADist(iHC, RelativeK, pt1, pt2);
+      fHists->FillPtSEOneQADist(iHC, pt1, Mult + 1);
+      fHists->FillPtSETwoQADist(iHC, pt2, Mult + 1);
+      fHists->FillKstarPtSEOneQADist(iHC, RelativeK, pt1);
+      fHists->FillKstarPtSETwoQADist(iHC, RelativeK, pt2);
+    }
+  }
+}
+
+void AliFemtoDreamHigherPairMath::FillMixedEvent(
+    int iHC, int Mult, float cent, const AliFemtoDreamCompactParticles &one,
+    unsigned int iPart1, const AliFemtoDreamCompactParticles &two,
+    const AliFemtoDreamPairBatch &batch) {
+  //Same histograms as FillMixedEvent (without randomisation) for the pairs of
+  //particle iPart1 of one with the partners of the batch passing the pair
+  //selection
+  const bool fillHists = fWhichPairs.at(iHC);
+  const bool CPR = fRejPairs.at(iHC) && fDoDeltaEtaDeltaPhiCut;
+  const bool multBinning = fHists->GetDoMultBinning();
+  const bool centBinning = fillHists && fHists->GetDoCentBinning();
+  const bool kTBinning = fillHists && fHists->GetDokTBinning();
+  const bool mTBinning = fillHists && fHists->GetDomTBinning();
+  const bool kTandMultBinning = fillHists && fHists->GetDokTandMultBinning();
+  const bool mTMultPlots = fillHists && fHists->GetDomTMultPlots();
+  const bool ptQA = fillHists && fHists->GetDoPtQA();
+  const float pt1 = one.GetPt(iPart1);
+  const unsigned int nPairs = batch.fRelK.size();
+  for (unsigned int iPair = 0; iPair < nPairs; ++iPair) {
+    const unsigned int iPart2 = batch.fFirst + iPair;
+    if (CPR && !DeltaEtaDeltaPhi(iHC, one, iPart1, two, iPart2)) {
+      continue;
+    }
+    const float RelativeK = batch.fRelK[iPair];
+    fHists->FillMixedEventDist(iHC, RelativeK);
+    if (multBinning) {
+      fHists->FillMixedEventMultDist(iHC, Mult + 1, RelativeK);
+    }
+    if (centBinning) {
+      fHists->FillMixedEventCentDist(iHC, cent, RelativeK);
+    }
+    if (kTBinning) {
+      fHists->FillMixedEventkTDist(iHC, batch.fkT[iPair], RelativeK, cent);
+    }
+    if (mTBinning) {
+      fHists->FillMixedEventmTDist(iHC, batch.fmT[iPair], RelativeK);
+    }
+    if (kTandMultBinning) {
+      fHists->FillMixedEventkTandMultDist(iHC, batch.fkT[iPair], RelativeK,
+                                          Mult + 1);
+    }
+    if (mTMultPlots) {
+      fHists->FillMixedEventmTMultDist(iHC, batch.fmT[iPair], Mult + 1,
+                                       RelativeK);
+    }
+    if (ptQA) {
+      const float pt2 = two.GetPt(iPart2);
+      fHists->FillPtMEOneQADist(iHC, pt1, Mult + 1);
+      fHists->FillPtMETwoQADist(iHC, pt2, Mult + 1);
+      fHists->FillKstarPtMEOneQADist(iHC, RelativeK, pt1);
+      fHists->FillKstarPtMETwoQADist(iHC, RelativeK, pt2);
+    }
+  }
+}
+
 void AliFemtoDreamHigherPairMath::SEDetaDPhiPlots(int iHC,
                                                   AliFemtoDreamBasePart &part1,
                                                   int PDGPart1,
@@ -615,3 +741,49 @@ bool AliFemtoDreamHigherPairMath::DeltaEtaDeltaPhi(int Hist,
   }
   return pass;
 }
+
+bool AliFemtoDreamHigherPairMath::DeltaEtaDeltaPhi(
+    int Hist, const AliFemtoDreamCompactParticles &one, unsigned int iPart1,
+    const AliFemtoDreamCompactParticles &two, unsigned int iPart2) {
+  //Same selection as the method for AliFemtoDreamBasePart, without the plots
+  unsigned int DoThisPair = fWhichPairs.at(Hist);
+  unsigned int nDaug1 = (unsigned int) DoThisPair / 10;
+  unsigned int nDaug2 = (unsigned int) DoThisPair % 10;
+  const unsigned int nDaugAv1 = one.GetNDaughters(iPart1);
+  const unsigned int nDaugAv2 = two.GetNDaughters(iPart2);
+  if (nDaug1 > nDaugAv1 || nDaug2 > nDaugAv2) {
+    AliWarning(TString::Format(
+        "For pair number %u the number of Daughters (%u, %u) and Radii (%u, %u) do not correspond \n",
+        Hist, nDaug1, nDaug2, nDaugAv1, nDaugAv2).Data());
+    nDaug1 = TMath::Min(nDaug1, nDaugAv1);
+    nDaug2 = TMath::Min(nDaug2, nDaugAv2);
+  }
+  for (unsigned int iDaug1 = 0; iDaug1 < nDaug1; ++iDaug1) {
+    const float *PhiAtRad1 = one.GetPhiAtRadii(iPart1, iDaug1);
+    const unsigned int nRad1 = one.GetNRadii(iPart1, iDaug1);
+    float etaPar1 = one.GetEta(iPart1, (nDaug1 == 1) ? 0 : iDaug1 + 1);
+    for (unsigned int iDaug2 = 0; iDaug2 < nDaug2; ++iDaug2) {
+      const float *phiAtRad2 = two.GetPhiAtRadii(iPart2, iDaug2);
+      const unsigned int nRad2 = two.GetNRadii(iPart2, iDaug2);
+      float etaPar2 = two.GetEta(iPart2, (nDaug2 == 1) ? 0 : iDaug2 + 1);
+      float deta = etaPar1 - etaPar2;
+      const int size = (nRad1 > nRad2) ? nRad2 : nRad1;
+      float dphiAvg = 0;
+      for (int iRad = 0; iRad < size; ++iRad) {
+        float dphi = PhiAtRad1[iRad] - phiAtRad2[iRad];
+        if (dphi > piHi) {
+          dphi += -piHi * 2;
+        } else if (dphi < -piHi) {
+          dphi += piHi * 2;
+        }
+        dphi = TVector2::Phi_mpi_pi(dphi);
+        dphiAvg += dphi;
+      }
+      if ((dphiAvg / (float) size) * (dphiAvg / (float) size) / fDeltaPhiSqMax
+          + deta * deta / fDeltaEtaSqMax < 1.) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
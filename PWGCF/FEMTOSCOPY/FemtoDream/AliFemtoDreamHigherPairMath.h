@@ -11,6 +11,7 @@
 #include "AliLog.h"
 #include "TRandom3.h"
 #include "AliFemtoDreamBasePart.h"
+#include "AliFemtoDreamCompactParticles.h"
 #include "AliFemtoDreamCollConfig.h"
 #include "AliFemtoDreamCorrHists.h"
 #include <vector>
@@ -68,6 +69,24 @@ class AliFemtoDreamHigherPairMath {
                          unsigned int sizePartTwo) {
     fHists->FillPartnersME(iHC, sizePartOne, sizePartTwo);
   }
+  //Pairing on compact particles (AliFemtoDreamCollConfig::SetUseCompactPairing):
+  //the pair kinematics of one particle with a batch of partners are
+  //computed by AliFemtoDreamCompactParticles::PairKinematics
+  bool PassesPairSelection(int iHC, const AliFemtoDreamCompactParticles &one,
+                           unsigned int iPart1,
+                           const AliFemtoDreamCompactParticles &two,
+                           unsigned int iPart2);
+  void FillSameEvent(int iHC, int Mult, float cent,
+                     const AliFemtoDreamCompactParticles &one,
+                     unsigned int iPart1,
+                     const AliFemtoDreamCompactParticles &two,
+                     const AliFemtoDreamPairBatch &batch,
+                     float PartSumPtLimit1, float PartSumPtLimit2);
+  void FillMixedEvent(int iHC, int Mult, float cent,
+                      const AliFemtoDreamCompactParticles &one,
+                      unsigned int iPart1,
+                      const AliFemtoDreamCompactParticles &two,
+                      const AliFemtoDreamPairBatch &batch);
   TList* GetHistList() {
     return fHists->GetHistList();
   }
@@ -95,6 +114,10 @@ class AliFemtoDreamHigherPairMath {
  private:
   bool DeltaEtaDeltaPhi(int Hist, AliFemtoDreamBasePart &part1,
                         AliFemtoDreamBasePart &part2, bool SEorME, float relk);
+  bool DeltaEtaDeltaPhi(int Hist, const AliFemtoDreamCompactParticles &one,
+                        unsigned int iPart1,
+                        const AliFemtoDreamCompactParticles &two,
+                        unsigned int iPart2);
   AliFemtoDreamCorrHists *fHists;
   std::vector<unsigned int> fWhichPairs;
   float fBField;
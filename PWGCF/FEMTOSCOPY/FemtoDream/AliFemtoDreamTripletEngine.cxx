@@ -0,0 +1,198 @@
+/*
+ * AliFemtoDreamTripletEngine.cxx
+ */
+#include <algorithm>
+#include "AliFemtoDreamTripletEngine.h"
+#include "TMath.h"
+
+ClassImp(AliFemtoDreamTripletEngine)
+AliFemtoDreamTripletEngine::AliFemtoDreamTripletEngine()
+    : fQ3Limit(0.f),
+      fNLists(0),
+      fLists(),
+      fPair23(),
+      fPair31(),
+      fTriplets() {
+}
+
+AliFemtoDreamTripletEngine::~AliFemtoDreamTripletEngine() {
+}
+
+int AliFemtoDreamTripletEngine::AddList(
+    const std::vector<AliFemtoDreamBasePart> &Particles, float mass) {
+  if (fNLists == fLists.size()) {
+    fLists.push_back(ParticleList());
+  }
+  ParticleList &list = fLists[fNLists];
+  const unsigned int nPart = Particles.size();
+  list.fMass = mass;
+  list.fPx.resize(nPart);
+  list.fPy.resize(nPart);
+  list.fPz.resize(nPart);
+  list.fE.resize(nPart);
+  list.fY.resize(nPart);
+  list.fSortedY.resize(nPart);
+  list.fSorted.resize(nPart);
+  const double mass2 = (double) mass * (double) mass;
+  for (unsigned int i = 0; i < nPart; ++i) {
+    TVector3 mom = Particles[i].GetMomentum();
+    list.fPx[i] = mom.X();
+    list.fPy[i] = mom.Y();
+    list.fPz[i] = mom.Z();
+    list.fE[i] = TMath::Sqrt(mom.Mag2() + mass2);
+    list.fY[i] = 0.5
+        * TMath::Log((list.fE[i] + list.fPz[i]) / (list.fE[i] - list.fPz[i]));
+    list.fSorted[i] = i;
+  }
+  const std::vector<double> &y = list.fY;
+  std::sort(list.fSorted.begin(), list.fSorted.end(),
+            [&y](unsigned int a, unsigned int b) {return y[a] < y[b];});
+  for (unsigned int i = 0; i < nPart; ++i) {
+    list.fSortedY[i] = y[list.fSorted[i]];
+  }
+  return fNLists++;
+}
+
+double AliFemtoDreamTripletEngine::MaxDeltaRapidity(double mass1,
+                                                    double mass2,
+                                                    double q2Max) {
+  //-q^2 = lambda(s, m1^2, m2^2) / s grows with s, and
+  //s >= m1^2 + m2^2 + 2 m1 m2 cosh(dy), see the mT of both particles. The
+  //largest dy follows from the s for which -q^2 = q2Max
+  if (mass1 <= 0. || mass2 <= 0.) {
+    return -1.;
+  }
+  if (q2Max < 0.) {
+    q2Max = 0.;
+  }
+  const double a = mass1 * mass1;
+  const double b = mass2 * mass2;
+  const double B = 2. * (a + b) + q2Max;
+  const double disc = B * B - 4. * (a - b) * (a - b);
+  const double s = 0.5 * (B + TMath::Sqrt(disc > 0. ? disc : 0.));
+  double coshMax = (s - a - b) / (2. * mass1 * mass2);
+  if (coshMax < 1.) {
+    coshMax = 1.;
+  }
+  //margin for the rounding of the momenta
+  return TMath::ACosH(coshMax) + 1e-6;
+}
+
+double AliFemtoDreamTripletEngine::PairQ2(const ParticleList &one,
+                                          unsigned int i,
+                                          const ParticleList &two,
+                                          unsigned int j) {
+  //-q^2 with q = (p1 - p2) - ((p1 - p2).P / P^2) P and P = p1 + p2, as
+  //in the RelativePairMomentum of the three-body tasks
+  const double dE = one.fE[i] - two.fE[j];
+  const double dx = one.fPx[i] - two.fPx[j];
+  const double dy = one.fPy[i] - two.fPy[j];
+  const double dz = one.fPz[i] - two.fPz[j];
+  const double sE = one.fE[i] + two.fE[j];
+  const double sx = one.fPx[i] + two.fPx[j];
+  const double sy = one.fPy[i] + two.fPy[j];
+  const double sz = one.fPz[i] + two.fPz[j];
+  const double dP = dE * sE - dx * sx - dy * sy - dz * sz;
+  const double PP = sE * sE - sx * sx - sy * sy - sz * sz;
+  const double dd = dE * dE - dx * dx - dy * dy - dz * dz;
+  //-q^2 >= 0, but can round to a tiny negative value for equal momenta
+  const double q2 = dP * dP / PP - dd;
+  return q2 > 0. ? q2 : 0.;
+}
+
+void AliFemtoDreamTripletEngine::Window(const ParticleList &list, double y,
+                                        double dyMax, unsigned int &first,
+                                        unsigned int &last) {
+  //range [first, last) of the sorted entries within dyMax of y
+  if (dyMax < 0.) {
+    first = 0;
+    last = list.fSortedY.size();
+    return;
+  }
+  first = std::lower_bound(list.fSortedY.begin(), list.fSortedY.end(),
+                           y - dyMax) - list.fSortedY.begin();
+  last = std::upper_bound(list.fSortedY.begin(), list.fSortedY.end(),
+                          y + dyMax) - list.fSortedY.begin();
+}
+
+void AliFemtoDreamTripletEngine::BuildTriplets(int list1, int list2,
+                                               int list3, bool same12,
+                                               bool same13, bool same23) {
+  fTriplets.clear();
+  const ParticleList &one = fLists[list1];
+  const ParticleList &two = fLists[list2];
+  const ParticleList &three = fLists[list3];
+  const unsigned int nPart1 = one.fE.size();
+  const unsigned int nPart2 = two.fE.size();
+  const unsigned int nPart3 = three.fE.size();
+  if (nPart1 == 0 || nPart2 == 0 || nPart3 == 0) {
+    return;
+  }
+  const bool prune = fQ3Limit > 0.;
+  const double q2Limit = (double) fQ3Limit * (double) fQ3Limit;
+  const double dyMax12 =
+      prune ? MaxDeltaRapidity(one.fMass, two.fMass, q2Limit) : -1.;
+  fPair23.assign(nPart2 * nPart3, -1.);
+  fPair31.resize(nPart3);
+
+  for (unsigned int i = 0; i < nPart1; ++i) {
+    const double y1 = one.fY[i];
+    unsigned int first2, last2;
+    Window(two, y1, dyMax12, first2, last2);
+    std::fill(fPair31.begin(), fPair31.end(), -1.);
+    for (unsigned int iSort2 = first2; iSort2 < last2; ++iSort2) {
+      const unsigned int j = two.fSorted[iSort2];
+      if (same12 && j <= i) {
+        continue;
+      }
+      const double q12 = PairQ2(one, i, two, j);
+      if (prune && q12 > q2Limit) {
+        continue;
+      }
+      //the third particle has to be close in rapidity to both
+      unsigned int first3 = 0;
+      unsigned int last3 = nPart3;
+      if (prune) {
+        const double budget = q2Limit - q12;
+        unsigned int first31, last31, first32, last32;
+        Window(three, y1, MaxDeltaRapidity(one.fMass, three.fMass, budget),
+               first31, last31);
+        Window(three, two.fY[j],
+               MaxDeltaRapidity(two.fMass, three.fMass, budget), first32,
+               last32);
+        first3 = TMath::Max(first31, first32);
+        last3 = TMath::Min(last31, last32);
+      }
+      for (unsigned int iSort3 = first3; iSort3 < last3; ++iSort3) {
+        const unsigned int k = three.fSorted[iSort3];
+        if ((same13 && k <= i) || (same23 && k <= j)) {
+          continue;
+        }
+        double &q23 = fPair23[j * nPart3 + k];
+        if (q23 == -1.) {
+          q23 = PairQ2(two, j, three, k);
+        }
+        if (prune && q12 + q23 > q2Limit) {
+          continue;
+        }
+        double &q31 = fPair31[k];
+        if (q31 == -1.) {
+          q31 = PairQ2(three, k, one, i);
+        }
+        const double Q32 = q12 + q23 + q31;
+        if (prune && Q32 > q2Limit) {
+          continue;
+        }
+        AliFemtoDreamTriplet triplet;
+        triplet.fPart1 = i;
+        triplet.fPart2 = j;
+        triplet.fPart3 = k;
+        triplet.fQ12 = TMath::Sqrt(q12);
+        triplet.fQ23 = TMath::Sqrt(q23);
+        triplet.fQ31 = TMath::Sqrt(q31);
+        triplet.fQ3 = TMath::Sqrt(Q32);
+        fTriplets.push_back(triplet);
+      }
+    }
+  }
+}
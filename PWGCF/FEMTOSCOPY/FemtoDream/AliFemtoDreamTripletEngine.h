@@ -0,0 +1,83 @@
+/*
+ * AliFemtoDreamTripletEngine.h
+ *
+ * Triplet building for the three-body femtoscopy: the particles of each list
+ * are sorted in rapidity, and only the partners within the rapidity window
+ * compatible with the Q3 limit are tried. The relative momenta of the pairs
+ * are computed once and reused by all triplets sharing the pair.
+ */
+
+#ifndef ALIFEMTODREAMTRIPLETENGINE_H_
+#define ALIFEMTODREAMTRIPLETENGINE_H_
+#include <vector>
+#include "Rtypes.h"
+
+#include "AliFemtoDreamBasePart.h"
+
+//Triplet found by AliFemtoDreamTripletEngine: indices of the particles in
+//their lists, relative momenta sqrt(-q_ij^2) of the pairs and Q3
+struct AliFemtoDreamTriplet {
+  unsigned int fPart1;
+  unsigned int fPart2;
+  unsigned int fPart3;
+  float fQ12;
+  float fQ23;
+  float fQ31;
+  float fQ3;
+};
+
+class AliFemtoDreamTripletEngine {
+ public:
+  AliFemtoDreamTripletEngine();
+  virtual ~AliFemtoDreamTripletEngine();
+  //Triplets with Q3 above the limit are not built, 0 means no limit
+  void SetQ3Limit(float limit) {
+    fQ3Limit = limit;
+  }
+  float GetQ3Limit() const {
+    return fQ3Limit;
+  }
+  //The lists keep their memory from one event to the next
+  void ClearLists() {
+    fNLists = 0;
+  }
+  int AddList(const std::vector<AliFemtoDreamBasePart> &Particles, float mass);
+  //Triplets of particle i of list1, j of list2 and k of list3. sameXY
+  //requires the index in list Y to be larger than the one in list X, as for
+  //the loops over the same particles
+  void BuildTriplets(int list1, int list2, int list3, bool same12, bool same13,
+                     bool same23);
+  unsigned int GetNTriplets() const {
+    return fTriplets.size();
+  }
+  const AliFemtoDreamTriplet &GetTriplet(unsigned int i) const {
+    return fTriplets[i];
+  }
+  //Largest rapidity difference of a pair with -q^2 below q2Max, negative if
+  //there is no bound (massless particle)
+  static double MaxDeltaRapidity(double mass1, double mass2, double q2Max);
+ private:
+  struct ParticleList {
+    double fMass;
+    std::vector<double> fPx;
+    std::vector<double> fPy;
+    std::vector<double> fPz;
+    std::vector<double> fE;
+    std::vector<double> fY;              // rapidity, in the original order
+    std::vector<double> fSortedY;        // rapidity, sorted
+    std::vector<unsigned int> fSorted;   // original index of the sorted entries
+  };
+  static double PairQ2(const ParticleList &one, unsigned int i,
+                       const ParticleList &two, unsigned int j);
+  static void Window(const ParticleList &list, double y, double dyMax,
+                     unsigned int &first, unsigned int &last);
+  float fQ3Limit;
+  unsigned int fNLists;
+  std::vector<ParticleList> fLists;
+  std::vector<double> fPair23;           // -q23^2, -1 if not yet computed
+  std::vector<double> fPair31;           // -q31^2 for the current particle 1
+  std::vector<AliFemtoDreamTriplet> fTriplets;
+ClassDef(AliFemtoDreamTripletEngine, 1)
+};
+
+#endif /* ALIFEMTODREAMTRIPLETENGINE_H_ */
@@ -6,6 +6,7 @@
  */
 //#include "AliLog.h"
 #include <iostream>
+#include <utility>
 #include "AliFemtoDreamZVtxMultContainer.h"
 #include "TLorentzVector.h"
 #include "TDatabasePDG.h"
@@ -17,7 +18,14 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer()
       fPDGParticleSpecies(0),
       fWhichPairs(),
       fSummedPtLimit1(0.0),
-      fSummedPtLimit2(999.0){
+      fSummedPtLimit2(999.0),
+      fUseCompactPairing(false),
+      fCompactCPR(false),
+      fMixingDepth(0),
+      fMasses(),
+      fCompactEvent(),
+      fCompactBuffer(),
+      fBatch(){
 }
 
 AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
@@ -27,10 +35,29 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
       fPDGParticleSpecies(conf->GetPDGCodes()),
       fWhichPairs(conf->GetWhichPairs()),
       fSummedPtLimit1(conf->GetSummedPtLimit1()),
-      fSummedPtLimit2(conf->GetSummedPtLimit2()){
+      fSummedPtLimit2(conf->GetSummedPtLimit2()),
+      fUseCompactPairing(conf->GetUseCompactPairing()),
+      fCompactCPR(conf->GetDoDeltaEtaDeltaPhiCut()),
+      fMixingDepth(conf->GetMixingDepth()),
+      fMasses(),
+      fCompactEvent(),
+      fCompactBuffer(),
+      fBatch(){
   TDatabasePDG::Instance()->AddParticle("deuteron", "deuteron", 1.8756134,
                                         kTRUE, 0.0, 1, "Nucleus", 1000010020);
   TDatabasePDG::Instance()->AddAntiParticle("anti-deuteron", -1000010020);
+  if (fUseCompactPairing) {
+    //The masses are looked up once instead of once per pair, the particles of
+    //the previous events are kept in the compact format only
+    for (auto itPDG = fPDGParticleSpecies.begin();
+        itPDG != fPDGParticleSpecies.end(); ++itPDG) {
+      TParticlePDG *pdg = TDatabasePDG::Instance()->GetParticle(*itPDG);
+      fMasses.push_back(pdg ? pdg->Mass() : 0.);
+    }
+    fCompactEvent.resize(fPDGParticleSpecies.size());
+    fCompactBuffer.resize(fPDGParticleSpecies.size());
+    fPartContainer.clear();
+  }
 }
 
 AliFemtoDreamZVtxMultContainer::~AliFemtoDreamZVtxMultContainer() {
@@ -47,6 +74,24 @@ void AliFemtoDreamZVtxMultContainer::SetEvent(
   //        fParticleSpecies);
   //    AliFatal(errMessage.Data());
   //  } else {
+  if (fUseCompactPairing) {
+    for (unsigned int iSpec = 0; iSpec < fCompactBuffer.size(); ++iSpec) {
+      if (Particles[iSpec].size() == 0) {
+        continue;
+      }
+      std::deque<AliFemtoDreamCompactParticles> &buffer = fCompactBuffer[iSpec];
+      if (buffer.size() < fMixingDepth) {
+        buffer.push_front(fCompactEvent[iSpec]);
+      } else {
+        //recycle the oldest event to keep the allocated memory
+        buffer.push_front(AliFemtoDreamCompactParticles());
+        std::swap(buffer.front(), buffer.back());
+        buffer.pop_back();
+        buffer.front() = fCompactEvent[iSpec];
+      }
+    }
+    return;
+  }
   std::vector<std::vector<AliFemtoDreamBasePart>>::iterator itInput = Particles
       .begin();
   std::vector<AliFemtoDreamPartContainer>::iterator itContainer = fPartContainer
@@ -63,6 +108,11 @@ void AliFemtoDreamZVtxMultContainer::SetEvent(
 void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  if (fUseCompactPairing) {
+    SetCompactEvent(Particles);
+    PairCompactSE(HigherMath, iMult, cent);
+    return;
+  }
   int HistCounter = 0;
   //First loop over all the different Species
   auto itPDGPar1 = fPDGParticleSpecies.begin();
@@ -126,6 +176,10 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
 void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  if (fUseCompactPairing) {
+    PairCompactME(HigherMath, iMult, cent);
+    return;
+  }
   int HistCounter = 0;
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   //First loop over all the different Species
@@ -186,3 +240,63 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     ++itPDGPar1;
   }
 }
+
+void AliFemtoDreamZVtxMultContainer::SetCompactEvent(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles) {
+  //The particles of the event are converted once and used for the same event,
+  //the mixed event and the buffer
+  for (unsigned int iSpec = 0; iSpec < fCompactEvent.size(); ++iSpec) {
+    fCompactEvent[iSpec].SetParticles(Particles[iSpec], fMasses[iSpec],
+                                      fCompactCPR);
+  }
+}
+
+void AliFemtoDreamZVtxMultContainer::PairCompactSE(
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  int HistCounter = 0;
+  const unsigned int nSpec = fCompactEvent.size();
+  for (unsigned int iSpec1 = 0; iSpec1 < nSpec; ++iSpec1) {
+    const AliFemtoDreamCompactParticles &one = fCompactEvent[iSpec1];
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < nSpec; ++iSpec2) {
+      const AliFemtoDreamCompactParticles &two = fCompactEvent[iSpec2];
+      HigherMath->FillPairCounterSE(HistCounter, one.GetSize(),
+                                    two.GetSize());
+      for (unsigned int iPart1 = 0; iPart1 < one.GetSize(); ++iPart1) {
+        const unsigned int first = (iSpec1 == iSpec2) ? iPart1 + 1 : 0;
+        AliFemtoDreamCompactParticles::PairKinematics(one, iPart1, two, first,
+                                                      fBatch);
+        HigherMath->FillSameEvent(HistCounter, iMult, cent, one, iPart1, two,
+                                  fBatch, fSummedPtLimit1, fSummedPtLimit2);
+      }
+      ++HistCounter;
+    }
+  }
+}
+
+void AliFemtoDreamZVtxMultContainer::PairCompactME(
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  int HistCounter = 0;
+  const unsigned int nSpec = fCompactEvent.size();
+  for (unsigned int iSpec1 = 0; iSpec1 < nSpec; ++iSpec1) {
+    const AliFemtoDreamCompactParticles &one = fCompactEvent[iSpec1];
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < nSpec; ++iSpec2) {
+      const std::deque<AliFemtoDreamCompactParticles> &buffer =
+          fCompactBuffer[iSpec2];
+      if (one.GetSize() > 0) {
+        HigherMath->FillEffectiveMixingDepth(HistCounter, (int) buffer.size());
+      }
+      for (auto itEvent = buffer.begin(); itEvent != buffer.end(); ++itEvent) {
+        const AliFemtoDreamCompactParticles &two = *itEvent;
+        HigherMath->FillPairCounterME(HistCounter, one.GetSize(),
+                                      two.GetSize());
+        for (unsigned int iPart1 = 0; iPart1 < one.GetSize(); ++iPart1) {
+          AliFemtoDreamCompactParticles::PairKinematics(one, iPart1, two, 0,
+                                                        fBatch);
+          HigherMath->FillMixedEvent(HistCounter, iMult, cent, one, iPart1,
+                                     two, fBatch);
+        }
+      }
+      ++HistCounter;
+    }
+  }
+}
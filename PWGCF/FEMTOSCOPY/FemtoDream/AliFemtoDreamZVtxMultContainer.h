@@ -7,10 +7,12 @@
 
 #ifndef ALIFEMTODREAMZVTXMULTCONTAINER_H_
 #define ALIFEMTODREAMZVTXMULTCONTAINER_H_
+#include <deque>
 #include <vector>
 #include "Rtypes.h"
 
 #include "AliFemtoDreamCollConfig.h"
+#include "AliFemtoDreamCompactParticles.h"
 #include "AliFemtoDreamCorrHists.h"
 #include "AliFemtoDreamPartContainer.h"
 #include "AliFemtoDreamHigherPairMath.h"
@@ -41,6 +43,12 @@ class AliFemtoDreamZVtxMultContainer {
   }
   ;
  private:
+  void SetCompactEvent(
+      std::vector<std::vector<AliFemtoDreamBasePart>> &Particles);
+  void PairCompactSE(AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+                     float cent);
+  void PairCompactME(AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+                     float cent);
   std::vector<AliFemtoDreamPartContainer> fPartContainer;
   std::vector<int> fPDGParticleSpecies;
   std::vector<unsigned int> fWhichPairs;
@@ -51,7 +59,14 @@ class AliFemtoDreamZVtxMultContainer {
 //  float fDeltaPhiEtaMax;
   float fSummedPtLimit1;
   float fSummedPtLimit2;
-ClassDef(AliFemtoDreamZVtxMultContainer, 4)
+  bool fUseCompactPairing;                                              //!
+  bool fCompactCPR;                                                     //!
+  unsigned int fMixingDepth;                                            //!
+  std::vector<float> fMasses;                                           //!
+  std::vector<AliFemtoDreamCompactParticles> fCompactEvent;             //!
+  std::vector<std::deque<AliFemtoDreamCompactParticles>> fCompactBuffer;//!
+  AliFemtoDreamPairBatch fBatch;                                        //!
+ClassDef(AliFemtoDreamZVtxMultContainer, 5)
   ;
 };
 
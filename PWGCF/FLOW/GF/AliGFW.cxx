@@ -7,7 +7,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 need to add flags to have control over what is added, e.g. what happens, when I have several overlapping regions of different types: reference, pT-diff unID and pT-diff. ID?
 */
 AliGFW::AliGFW():
-  fInitialized(kFALSE)
+  fInitialized(kFALSE),
+  fMaxHar(0)
 {
 };
 
@@ -78,113 +79,142 @@ Int_t AliGFW::CreateRegions() {
   //for(auto pitr = fRegions.begin(); pitr!=fRegions.end(); pitr++) pitr->PrintStructure();
   Int_t nRegions=0;
   for(auto pItr=fRegions.begin(); pItr!=fRegions.end(); pItr++) {
-    AliGFWCumulant *lCumulant = new AliGFWCumulant();
+    fCumulants.push_back(AliGFWCumulant());
+    AliGFWCumulant *lCumulant = &fCumulants.back();
     if(pItr->NparVec.size()) {
       lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     } else {
       lCumulant->CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
     };
-    fCumulants.push_back(*lCumulant);
+    if(pItr->Nhar>fMaxHar) fMaxHar = pItr->Nhar;
     ++nRegions;
   };
   if(nRegions) fInitialized=kTRUE;
   return nRegions;
 };
+void AliGFW::FillPhases(Double_t phi, std::complex<Double_t> *phases) {
+  //Harmonics by complex multiplication: exp(i*n*phi) = exp(i*(n-1)*phi)*exp(i*phi)
+  for(Int_t lN=0; lN<fMaxHar; lN++) {
+    if(lN==0) phases[lN] = 1;
+    else if(lN==1) phases[lN] = std::complex<Double_t>(TMath::Cos(phi),TMath::Sin(phi));
+    else phases[lN] = phases[lN-1]*phases[1];
+  };
+};
 void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask, Double_t SecondWeight) {
   if(!fInitialized) CreateRegions();
   if(!fInitialized) return;
+  if((Int_t)fPhases.size()<fMaxHar) fPhases.resize(fMaxHar);
+  Bool_t lPhasesFilled=kFALSE; //The phases are the same for all regions, so calculate them once per track
   for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
-    if(fRegions.at(i).EtaMin<eta && fRegions.at(i).EtaMax>eta && (fRegions.at(i).BitMask&mask))
-      fCumulants.at(i).FillArray(eta,ptin,phi,weight,SecondWeight);
+    const Region &lRegion = fRegions[i];
+    if(lRegion.EtaMin<eta && lRegion.EtaMax>eta && (lRegion.BitMask&mask)) {
+      if(!lPhasesFilled) { FillPhases(phi,fPhases.data()); lPhasesFilled=kTRUE; };
+      fCumulants[i].FillArray(ptin,fPhases.data(),weight,SecondWeight);
+    };
   };
 };
-TComplex AliGFW::TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant *r1, AliGFWCumulant *r2, AliGFWCumulant *r3) {
-  TComplex part1 = r1->Vec(n1,p1,ptbin);
-  TComplex part2 = r2->Vec(n2,p2,ptbin);
-  TComplex part3 = r3?r3->Vec(n1+n2,p1+p2,ptbin):TComplex(0,0);
-  TComplex formula = part1*part2-part3;
+void AliGFW::Fill(Int_t nTracks, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, Int_t mask, const Double_t *secondWeight) {
+  if(!fInitialized) CreateRegions();
+  if(!fInitialized) return;
+  //Tracks are processed in chunks: the phases of the chunk are calculated first, then each region is filled with all the tracks of the chunk.
+  //The order of the tracks in each Q-vector is the same as when filling them one by one.
+  const Int_t lChunk = 256;
+  if((Int_t)fPhases.size()<lChunk*fMaxHar) fPhases.resize(lChunk*fMaxHar);
+  for(Int_t lFirst=0; lFirst<nTracks; lFirst+=lChunk) {
+    const Int_t lLast = TMath::Min(lFirst+lChunk,nTracks);
+    for(Int_t j=lFirst; j<lLast; j++) FillPhases(phi[j],&fPhases[(j-lFirst)*fMaxHar]);
+    for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
+      const Region &lRegion = fRegions[i];
+      if(!(lRegion.BitMask&mask)) continue;
+      AliGFWCumulant &lCumulant = fCumulants[i];
+      for(Int_t j=lFirst; j<lLast; j++) {
+        if(lRegion.EtaMin<eta[j] && lRegion.EtaMax>eta[j])
+          lCumulant.FillArray(ptin?ptin[j]:0,&fPhases[(j-lFirst)*fMaxHar],weight?weight[j]:1,secondWeight?secondWeight[j]:-1);
+      };
+    };
+  };
+};
+std::complex<Double_t> AliGFW::TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant *r1, AliGFWCumulant *r2, AliGFWCumulant *r3) {
+  std::complex<Double_t> part1 = r1->QVec(n1,p1,ptbin);
+  std::complex<Double_t> part2 = r2->QVec(n2,p2,ptbin);
+  std::complex<Double_t> part3 = r3?r3->QVec(n1+n2,p1+p2,ptbin):std::complex<Double_t>(0,0);
+  std::complex<Double_t> formula = part1*part2-part3;
   return formula;
 };
-TComplex AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> &hars) {
-  vector<Int_t> pows;
+void AliGFW::LoadHarmonics(const vector<Int_t> &hars, Bool_t SetHarmsToZero) {
+  //Harmonics to the work buffers, with all powers set to unity
+  fHarBuffer.resize(hars.size());
+  fPowBuffer.assign(hars.size(),1);
   for(Int_t i=0; i<(Int_t)hars.size(); i++)
-    pows.push_back(1);
-  return RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows);
+    fHarBuffer[i] = SetHarmsToZero?0:hars[i];
 };
-
-TComplex AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> &hars, vector<Int_t> &pows) {
-  if((pows.at(0)!=1) && qol) qpoi=qol; //if the power of POI is not unity, then always use overlap (if defined).
+std::complex<Double_t> AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, Int_t *hars, Int_t *pows, Int_t nhars) {
+  //The last nhars-1 harmonics are left unchanged on return, so that the same buffer is used all along the recursion
+  if((pows[0]!=1) && qol) qpoi=qol; //if the power of POI is not unity, then always use overlap (if defined).
   //Only valid for 1 particle of interest though!
-  if(hars.size()<2) return qpoi->Vec(hars.at(0),pows.at(0),ptbin);
-  if(hars.size()<3) return TwoRec(hars.at(0), hars.at(1),pows.at(0),pows.at(1), ptbin, qpoi, qref, qol);
-  Int_t harlast=hars.at(hars.size()-1);
-  Int_t powlast=pows.at(pows.size()-1);
-  hars.erase(hars.end()-1);
-  pows.erase(pows.end()-1);
-  TComplex formula = RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows)*qref->Vec(harlast,powlast);
+  if(nhars<2) return qpoi->QVec(hars[0],pows[0],ptbin);
+  if(nhars<3) return TwoRec(hars[0], hars[1],pows[0],pows[1], ptbin, qpoi, qref, qol);
+  Int_t harlast=hars[nhars-1];
+  Int_t powlast=pows[nhars-1];
+  Int_t harSize = nhars-1;
+  std::complex<Double_t> formula = RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows, harSize)*qref->QVec(harlast,powlast);
   Int_t lDegeneracy=1;
-  Int_t harSize = (Int_t)hars.size();
   for(Int_t i=harSize-1;i>=0;i--) {
   //checking if current configuration is a permutation of the next one.
   //Need to have more than 2 harmonics though, otherwise it doesn't make sense.
     if(i>2) { //only makes sense when we have more than two harmonics remaining
-      if(hars.at(i) == hars.at(i-1) && pows.at(i) == pows.at(i-1)) {//if it is a permutation, then increase degeneracy and continue;
+      if(hars[i] == hars[i-1] && pows[i] == pows[i-1]) {//if it is a permutation, then increase degeneracy and continue;
         lDegeneracy++;
         continue;
       };
     }
-    hars.at(i)+=harlast;
-    pows.at(i)+=powlast;
-    //The issue is here. In principle, if i=0 (dif), then the overlap is only qpoi (0, if no overlap);
-    //Otherwise, if we are not working with the 1st entry (dif.), then overlap will always be from qref
-    //One should thus (probably) make a check if i=0, then qovl=qpoi, otherwise qovl=qref. But need to think more
-    //-- This is not aplicable anymore, since the overlap is explicitly specified
-    TComplex subtractVal = RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows);
-    if(lDegeneracy>1) { subtractVal *= lDegeneracy; lDegeneracy=1; };
+    hars[i]+=harlast;
+    pows[i]+=powlast;
+    //The overlap is explicitly specified, so qol is used as is
+    std::complex<Double_t> subtractVal = RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows, harSize);
+    if(lDegeneracy>1) { subtractVal *= (Double_t)lDegeneracy; lDegeneracy=1; };
     formula-=subtractVal;
-    hars.at(i)-=harlast;
-    pows.at(i)-=powlast;
+    hars[i]-=harlast;
+    pows[i]-=powlast;
 
   };
-  hars.push_back(harlast);
-  pows.push_back(powlast);
   return formula;
 };
 void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
-  fCalculatedNames.clear();
-  fCalculatedQs.clear();
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
     printf("Configuration empty!\n");
     return TComplex(0,0);
   };
+  //The string is parsed only the first time it is seen
+  const vector<SinglePlan> &plans = GetStringPlan(config,SetHarmsToZero);
+  std::complex<Double_t> ret(1,0);
+  for(auto &plan : plans) ret*=CalculateSingle(plan);
+  return TComplex(ret.real(),ret.imag());
+};
+const vector<AliGFW::SinglePlan> &AliGFW::GetStringPlan(const TString &config, Bool_t SetHarmsToZero) {
+  std::map<TString, vector<SinglePlan>> &lPlans = fStringPlans[SetHarmsToZero?1:0];
+  auto lFound = lPlans.find(config);
+  if(lFound!=lPlans.end()) return lFound->second;
+  vector<SinglePlan> &lNew = lPlans[config];
   TString tmp;
   Ssiz_t sz1=0;
-  TComplex ret(1,0);
   while(config.Tokenize(tmp,sz1,"}")) {
     if(SetHarmsToZero) SetHarmonicsToZero(tmp);
-    /*Int_t ind=FindCalculated(tmp);
-    if(ind>=0) {
-      ret*=fCalculatedQs.at(ind);
-      continue;
-    };*/
-    TComplex val=CalculateSingle(tmp);
-    ret*=val;
-    fCalculatedQs.push_back(val);
-    fCalculatedNames.push_back(tmp);
+    lNew.push_back(CompileSingle(tmp));
   };
-  return ret;
+  return lNew;
 };
-TComplex AliGFW::CalculateSingle(TString config) {
+AliGFW::SinglePlan AliGFW::CompileSingle(TString config) {
+  SinglePlan lPlan;
   //First remove all ; and ,:
   config.ReplaceAll(","," ");
   config.ReplaceAll(";"," ");
   //Then make sure we don't have any double-spaces:
   while(config.Index("  ")>-1) config.ReplaceAll("  "," ");
   vector<Int_t> regs;
-  vector<Int_t> hars;
   Int_t ptbin=0;
   Ssiz_t sz1=0;
   Ssiz_t szend=0;
@@ -198,7 +228,7 @@ TComplex AliGFW::CalculateSingle(TString config) {
   if(sz1<0) sz1=0;
   if(!config.Tokenize(ts,szend,"{")) {
     printf("Could not find harmonics!\n");
-    return TComplex(0,0);
+    return lPlan;
   };
   //Fetch regions
   while(ts.Tokenize(ts2,sz1," ")) {
@@ -212,9 +242,28 @@ TComplex AliGFW::CalculateSingle(TString config) {
     regs.push_back(ind);
   };
   //Fetch harmonics
-  while(config.Tokenize(ts,szend," ")) hars.push_back(ts.Atoi());
-  if(regs.size()==1) return Calculate(regs.at(0),hars);
-  return Calculate(regs.at(0),regs.at(1),hars,ptbin);
+  while(config.Tokenize(ts,szend," ")) lPlan.Hars.push_back(ts.Atoi());
+  if(regs.empty() || lPlan.Hars.empty()) {
+    printf("No regions or harmonics in %s!\n",config.Data());
+    return lPlan;
+  };
+  lPlan.Poi = regs.at(0);
+  if(regs.size()>1) {
+    lPlan.Ref = regs.at(1);
+    lPlan.PtBin = ptbin;
+  };
+  lPlan.Valid = kTRUE;
+  return lPlan;
+};
+std::complex<Double_t> AliGFW::CalculateSingle(const SinglePlan &plan) {
+  if(!plan.Valid) return std::complex<Double_t>(0,0);
+  LoadHarmonics(plan.Hars,kFALSE);
+  AliGFWCumulant *qpoi = &fCumulants.at(plan.Poi);
+  if(plan.Ref<0) //For integrated case
+    return RecursiveCorr(qpoi, qpoi, qpoi, 0, fHarBuffer.data(), fPowBuffer.data(), (Int_t)fHarBuffer.size());
+  //For differential, need POI and reference
+  AliGFWCumulant *qref = &fCumulants.at(plan.Ref);
+  return RecursiveCorr(qpoi, qref, qpoi, plan.PtBin, fHarBuffer.data(), fPowBuffer.data(), (Int_t)fHarBuffer.size());
 };
 AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Bool_t ptdif) {
   //First remove all ; and ,:
@@ -289,15 +338,9 @@ AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Boo
   return ReturnConfig;
 };
 
-TComplex AliGFW::Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin) {
-  AliGFWCumulant *qref = &fCumulants.at(ref);
-  AliGFWCumulant *qpoi = &fCumulants.at(poi);
-  AliGFWCumulant *qovl = qpoi;
-  return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
-};
-TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+TComplex AliGFW::Calculate(const CorrConfig &corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
   if(corconf.Regs.size()==0) return TComplex(0,0); //Check if we have any regions at all
-  TComplex retval(1,1);
+  std::complex<Double_t> retval(1,1);
   for(Int_t i=0;i<(Int_t)corconf.Regs.size();i++) { //looping over all regions
     if(corconf.Regs.at(i).size()==0)  return TComplex(0,0); //again, if no regions in the current subevent, then quit immediatelly
     //picking up the indecies of regions...
@@ -318,10 +361,11 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
     if(ovl > -1) //if overlap is defined, then (unless it's explicitly disabled)
       qovl = DisableOverlap?0:&fCumulants.at(ovl);
     else if(ref==poi) qovl = qref; //If ref and poi are the same, then the same is for overlap. Only, when OL not explicitly defined
-    if(SetHarmsToZero) for(Int_t j=0;j<(Int_t)corconf.Hars.at(i).size();j++) corconf.Hars.at(i).at(j) = 0;
-    retval *= RecursiveCorr(qpoi, qref, qovl, ptbin, corconf.Hars.at(i));
+    if(corconf.Hars.at(i).empty()) return TComplex(0,0);
+    LoadHarmonics(corconf.Hars.at(i),SetHarmsToZero);
+    retval *= RecursiveCorr(qpoi, qref, qovl, ptbin, fHarBuffer.data(), fPowBuffer.data(), (Int_t)fHarBuffer.size());
   }
-  return retval;
+  return TComplex(retval.real(),retval.imag());
 
 
   //Old implementation (2 subevents only)
@@ -360,21 +404,10 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
   // return retval;
 };
 
-TComplex AliGFW::Calculate(Int_t poi, vector<Int_t> hars) {
-  AliGFWCumulant *qpoi = &fCumulants.at(poi);
-  return RecursiveCorr(qpoi, qpoi, qpoi, 0, hars);
-};
 Int_t AliGFW::FindRegionByName(TString refName) {
   for(Int_t i=0;i<(Int_t)fRegions.size();i++) if(fRegions.at(i).rName.EqualTo(refName)) return i;
   return -1;
 };
-Int_t AliGFW::FindCalculated(TString identifier) {
-  if(fCalculatedNames.size()==0) return -1;
-  for(Int_t i=0;i<(Int_t)fCalculatedNames.size();i++) {
-    if(fCalculatedNames.at(i).EqualTo(identifier)) return i;
-  };
-  return -1;
-};
 Bool_t AliGFW::SetHarmonicsToZero(TString &instr) {
   TString tmp;
   Ssiz_t sz1=0, sz2;
@@ -8,6 +8,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <complex>
+#include <map>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -59,30 +61,42 @@ class AliGFW {
   void AddRegion(TString refName, Int_t lNhar, Int_t *lNparVec, Double_t lEtaMin, Double_t lEtaMax, Int_t lNpT=1, Int_t BitMask=1);
   Int_t CreateRegions();
   void Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask, Double_t secondWeight=-1);
+  //Fill a batch of tracks with the same mask. ptin, weight and secondWeight are optional (bin 0, 1 and -1 if NULL)
+  void Fill(Int_t nTracks, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, Int_t mask, const Double_t *secondWeight=0);
   void Clear();// { for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs(); };
-  AliGFWCumulant GetCumulant(Int_t index) { return fCumulants.at(index); };
+  AliGFWCumulant &GetCumulant(Int_t index) { return fCumulants.at(index); };
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
   CorrConfig GetCorrelatorConfig(TString config, TString head = "", Bool_t ptdif=kFALSE);
-  TComplex Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  TComplex Calculate(const CorrConfig &corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
  private:
+  //One "{...}" block of a string configuration, with the regions resolved
+  struct SinglePlan {
+    Bool_t Valid=kFALSE;
+    Int_t Poi=-1;
+    Int_t Ref=-1; //-1 for the integrated case
+    Int_t PtBin=0;
+    vector<Int_t> Hars {};
+  };
   Bool_t fInitialized;
   void SplitRegions();
   AliGFWCumulant fEmptyCumulant;
-  TComplex TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant*, AliGFWCumulant*, AliGFWCumulant*);
-  TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> &hars, vector<Int_t> &pows); //POI, Ref. flow, overlapping region
-  TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> &hars); //POI, Ref. flow, overlapping region
+  Int_t fMaxHar; //! Largest number of harmonics of all regions
+  vector<std::complex<Double_t>> fPhases; //! exp(i*n*phi) of the tracks being filled
+  vector<Int_t> fHarBuffer; //! Harmonics and powers of the correlator being calculated
+  vector<Int_t> fPowBuffer; //!
+  std::map<TString, vector<SinglePlan>> fStringPlans[2]; //! String configurations parsed so far, without and with harmonics set to zero
+  void FillPhases(Double_t phi, std::complex<Double_t> *phases);
+  void LoadHarmonics(const vector<Int_t> &hars, Bool_t SetHarmsToZero);
+  std::complex<Double_t> TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant*, AliGFWCumulant*, AliGFWCumulant*);
+  std::complex<Double_t> RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, Int_t *hars, Int_t *pows, Int_t nhars); //POI, Ref. flow, overlapping region
   //Deprecated and not used (for now):
-  void AddRegion(Region inreg) { fRegions.push_back(inreg); };
+  void AddRegion(Region inreg) { fRegions.push_back(inreg); fStringPlans[0].clear(); fStringPlans[1].clear(); };
   Region GetRegion(Int_t index) { return fRegions.at(index); };
   Int_t FindRegionByName(TString refName);
-  vector<TString> fCalculatedNames;
-  vector<TComplex> fCalculatedQs;
-  Int_t FindCalculated(TString identifier);
-  //Calculateing functions:
-  TComplex Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin=0); //For differential, need POI and reference
-  TComplex Calculate(Int_t poi, vector<Int_t> hars); //For integrated case
   //Process one string (= one region)
-  TComplex CalculateSingle(TString config);
+  const vector<SinglePlan> &GetStringPlan(const TString &config, Bool_t SetHarmsToZero);
+  SinglePlan CompileSingle(TString config);
+  std::complex<Double_t> CalculateSingle(const SinglePlan &plan);
 
   Bool_t SetHarmonicsToZero(TString &instr);
 
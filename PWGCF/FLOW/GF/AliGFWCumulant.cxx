@@ -3,15 +3,22 @@ Author: Vytautas Vislavicius
 Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 */
 #include "AliGFWCumulant.h"
+#include <algorithm>
 
 AliGFWCumulant::AliGFWCumulant():
-  fQvector(0),
+  fQvector(),
+  fHarOffset(),
+  fPtStride(0),
   fUsed(kBlank),
   fNEntries(-1),
   fN(1),
   fPow(1),
+  fPowVec(),
+  fMaxPow(0),
+  fPrefactors(),
+  fPhases(),
   fPt(1),
-  fFilledPts(0),
+  fFilledPts(),
   fInitialized(kFALSE)
 {
 };
@@ -22,52 +29,51 @@ AliGFWCumulant::~AliGFWCumulant()
   //DestroyComplexVectorArray();
 };
 void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Double_t SecondWeight) {
+  if(!fInitialized)
+    CreateComplexVectorArray(1,1,1);
+  //Harmonics by complex multiplication: exp(i*n*phi) = exp(i*(n-1)*phi)*exp(i*phi)
+  for(Int_t lN=0; lN<fN; lN++) {
+    if(lN==0) fPhases[lN] = 1;
+    else if(lN==1) fPhases[lN] = std::complex<Double_t>(TMath::Cos(phi),TMath::Sin(phi));
+    else fPhases[lN] = fPhases[lN-1]*fPhases[1];
+  };
+  FillArray(ptin,fPhases.data(),weight,SecondWeight);
+};
+void AliGFWCumulant::FillArray(Int_t ptin, const std::complex<Double_t> *phases, Double_t weight, Double_t SecondWeight) {
   if(!fInitialized)
     CreateComplexVectorArray(1,1,1);
   if(fPt==1) ptin=0; //If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
   else if(ptin<0 || ptin>=fPt) return;
   fFilledPts[ptin] = kTRUE;
+  //Weight prefactors are the same for all harmonics; multiplication is cheaper that power
+  //Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
+  //this is important when POIs are a subset of REFs and have different weights than REFs
+  Double_t *lPrefactor = fPrefactors.data();
+  const Double_t lHigherWeight = (SecondWeight>0)?SecondWeight:weight;
+  lPrefactor[0] = 1;
+  if(fMaxPow>1) lPrefactor[1] = weight;
+  for(Int_t lPow=2; lPow<fMaxPow; lPow++) lPrefactor[lPow] = lPrefactor[lPow-1]*lHigherWeight;
+  std::complex<Double_t> *lQ = fQvector.data()+ptin*fPtStride;
   for(Int_t lN = 0; lN<fN; lN++) {
-    Double_t lSin = TMath::Sin(lN*phi); //No need to recalculate for each power
-    Double_t lCos = TMath::Cos(lN*phi); //No need to recalculate for each power
-    for(Int_t lPow=0; lPow<PW(lN); lPow++) {
-      Double_t lPrefactor = 0;
-      //Dont calculate it twice; multiplication is cheaper that power
-      //Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      //this is important when POIs are a subset of REFs and have different weights than REFs
-      if(SecondWeight>0 && lPow>1) lPrefactor = TMath::Power(SecondWeight, lPow-1)*weight;
-      else lPrefactor = TMath::Power(weight,lPow);
-      Double_t qsin = lPrefactor * lSin;
-      Double_t qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow](fQvector[ptin][lN][lPow].Re()+qcos,fQvector[ptin][lN][lPow].Im()+qsin);//+=TComplex(qcos,qsin);
-    };
+    const Double_t lCos = phases[lN].real();
+    const Double_t lSin = phases[lN].imag();
+    const Int_t lNPow = fPowVec[lN];
+    for(Int_t lPow=0; lPow<lNPow; lPow++, lQ++)
+      *lQ += std::complex<Double_t>(lPrefactor[lPow]*lCos, lPrefactor[lPow]*lSin);
   };
   Inc();
 };
 void AliGFWCumulant::ResetQs() {
   if(!fNEntries) return; //If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for(Int_t i=0; i<fPt; i++) {
-    fFilledPts[i] = kFALSE;
-    for(Int_t lN=0;lN<fN;lN++) {
-      for(Int_t lPow=0;lPow<PW(lN);lPow++) {
-  	       fQvector[i][lN][lPow](0.,0.);
-      };
-    };
-  };
+  std::fill(fFilledPts.begin(),fFilledPts.end(),kFALSE);
+  std::fill(fQvector.begin(),fQvector.end(),std::complex<Double_t>(0.,0.));
   fNEntries=0;
 };
 void AliGFWCumulant::DestroyComplexVectorArray() {
   if(!fInitialized) return;
-  for(Int_t l_n = 0; l_n<fN; l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      delete [] fQvector[i][l_n];
-    };
-  };
-  for(Int_t i=0;i<fPt;i++) {
-    delete [] fQvector[i];
-  };
-  delete [] fQvector;
-  delete [] fFilledPts;
+  vector<std::complex<Double_t>>().swap(fQvector);
+  fHarOffset.clear();
+  fFilledPts.clear();
   fInitialized=kFALSE;
   fNEntries=-1;
 };
@@ -83,23 +89,24 @@ void AliGFWCumulant::CreateComplexVectorArrayVarPower(Int_t N, vector<Int_t> Pow
   fN=N;
   fPow=0;
   fPt=Pt;
-  fFilledPts = new Bool_t[Pt];
   fPowVec = PowVec;
-  fQvector = new TComplex**[fPt];
-  for(Int_t i=0;i<fPt;i++) {
-    fQvector[i] = new TComplex*[fN];
-  };
+  //All Q-vectors of one pt bin are stored next to each other, harmonic by harmonic
+  fHarOffset.resize(fN);
+  fPtStride=0;
+  fMaxPow=1;
   for(Int_t l_n=0;l_n<fN;l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      fQvector[i][l_n] = new TComplex[PW(l_n)];
-    };
+    fHarOffset[l_n] = fPtStride;
+    fPtStride += PW(l_n);
+    if(PW(l_n)>fMaxPow) fMaxPow = PW(l_n);
   };
+  fQvector.assign(fPt*fPtStride,std::complex<Double_t>(0.,0.));
+  fFilledPts.assign(fPt,kFALSE);
+  fPrefactors.resize(fMaxPow);
+  fPhases.resize(fN);
   ResetQs();
   fInitialized=kTRUE;
 };
 TComplex AliGFWCumulant::Vec(Int_t n, Int_t p, Int_t ptbin) {
-  if(!fInitialized) return 0;
-  if(ptbin>=fPt || ptbin<0) ptbin=0;
-  if(n>=0) return fQvector[ptbin][n][p];
-  return TComplex::Conjugate(fQvector[ptbin][-n][p]);
+  std::complex<Double_t> q = QVec(n,p,ptbin);
+  return TComplex(q.real(),q.imag());
 };
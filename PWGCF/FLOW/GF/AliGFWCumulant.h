@@ -8,6 +8,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include "TNamed.h"
 #include "TMath.h"
 #include "TAxis.h"
+#include <complex>
+#include <vector>
 using std::vector;
 class AliGFWCumulant {
  public:
@@ -15,27 +17,41 @@ class AliGFWCumulant {
   ~AliGFWCumulant();
   void ResetQs();
   void FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t weight=1, Double_t SecondWeight=-1);
+  //Same, with the phases exp(i*n*phi) for n=0..fN-1 precomputed by the caller, so that one track is not recalculated for each region
+  void FillArray(Int_t ptin, const std::complex<Double_t> *phases, Double_t weight=1, Double_t SecondWeight=-1);
   enum UsedFlags_t {kBlank = 0, kFull=1, kPt=2};
   void SetType(UInt_t infl) { DestroyComplexVectorArray(); fUsed = infl; };
   void Inc() { fNEntries++; };
   Int_t GetN() { return fNEntries; };
   // protected:
-  TComplex ***fQvector;
+  vector<std::complex<Double_t>> fQvector; //! Q-vectors, contiguous in [pt bin][harmonic][power]
+  vector<Int_t> fHarOffset; //! Index of the first power of each harmonic within a pt bin
+  Int_t fPtStride; //! Number of Q-vectors per pt bin
   UInt_t fUsed;
   Int_t fNEntries;
   //Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
   TComplex Vec(Int_t, Int_t, Int_t ptbin=0); //envelope class to summarize pt-dif. Q-vec getter
+  std::complex<Double_t> QVec(Int_t n, Int_t p, Int_t ptbin=0) const; //Same as Vec(), without the conversion to TComplex
   Int_t fN; //! Harmonics
   Int_t fPow; //! Power
   vector<Int_t> fPowVec; //! Powers array
+  Int_t fMaxPow; //! Largest power
+  vector<Double_t> fPrefactors; //! Weight prefactor for each power of the current track
+  vector<std::complex<Double_t>> fPhases; //! exp(i*n*phi) of the current track, when not provided by the caller
   Int_t fPt; //!fPt bins
-  Bool_t *fFilledPts;
+  vector<Bool_t> fFilledPts; //!
   Bool_t fInitialized; //Arrays are initialized
   void CreateComplexVectorArray(Int_t N=1, Int_t P=1, Int_t Pt=1);
   void CreateComplexVectorArrayVarPower(Int_t N=1, vector<Int_t> Pvec={1}, Int_t Pt=1);
   Int_t PW(Int_t ind) { return fPowVec.at(ind); }; //No checks to speed up, be carefull!!!
   void DestroyComplexVectorArray();
-  Bool_t IsPtBinFilled(Int_t ptb) { if(!fFilledPts) return kFALSE; return fFilledPts[ptb]; };
+  Bool_t IsPtBinFilled(Int_t ptb) { if(fFilledPts.empty()) return kFALSE; if(ptb>=fPt || ptb<0) ptb=0; return fFilledPts[ptb]; }; //same bin as used by Vec()
 };
 
+inline std::complex<Double_t> AliGFWCumulant::QVec(Int_t n, Int_t p, Int_t ptbin) const {
+  if(!fInitialized) return 0;
+  if(ptbin>=fPt || ptbin<0) ptbin=0;
+  if(n>=0) return fQvector[ptbin*fPtStride+fHarOffset[n]+p];
+  return std::conj(fQvector[ptbin*fPtStride+fHarOffset[-n]+p]);
+};
 #endif
@@ -49,7 +49,9 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillPlans(),
+  fFillPlansCompiled(kFALSE)
 {
   //
   // Constructor
@@ -71,7 +73,9 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillPlans(),
+  fFillPlansCompiled(kFALSE)
 {
   //
   // Constructor
@@ -131,6 +135,7 @@ void AliHistogramManager::AddHistClass(const Char_t* histClass) {
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList.Add(hList);
+  fFillPlansCompiled = kFALSE;
 }
 
 //_________________________________________________________________
@@ -144,6 +149,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a histogram
   //
+  fFillPlansCompiled = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -286,6 +292,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a histogram
   //
+  fFillPlansCompiled = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -431,6 +438,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a multi-dimensional histogram THnF or THnFSparseF
   //
+  fFillPlansCompiled = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -484,6 +492,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
   //
   // add a multi-dimensional histogram THnF or THnSparseF with equal or variable bin widths
   //
+  fFillPlansCompiled = kFALSE;
   THashList* hList = (THashList*)fMainList.FindObject(histClass);
   if(!hList) {
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram list " << histClass << " not found!" << endl;
@@ -619,153 +628,178 @@ THnF* AliHistogramManager::CreateHistogram( const Char_t* name, const Char_t* ti
 
 
 
-//__________________________________________________________________
-void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values) {
+namespace {
   //
-  //  fill a class of histograms
+  // Typed fill functions used in the fill plans. For profiles the averaged variable is the last one in vars.
   //
-  THashList* hList = (THashList*)fMainList.FindObject(className);
-  if(!hList) {
-    /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
-    cout << "         Histogram list not filled" << endl; */
-    return;
+  template <Bool_t kWeighted>
+  void FillTH1(TObject* h, const Int_t* vars, Int_t, Int_t varW, const Float_t* values) {
+    if(kWeighted) ((TH1*)h)->Fill(values[vars[0]], values[varW]);
+    else          ((TH1*)h)->Fill(values[vars[0]]);
   }
-  if(!hList) {
-    return;
+  template <Bool_t kWeighted>
+  void FillTProfile(TObject* h, const Int_t* vars, Int_t, Int_t varW, const Float_t* values) {
+    if(kWeighted) ((TProfile*)h)->Fill(values[vars[0]], values[vars[1]], values[varW]);
+    else          ((TProfile*)h)->Fill(values[vars[0]], values[vars[1]]);
+  }
+  template <Bool_t kWeighted>
+  void FillTH2(TObject* h, const Int_t* vars, Int_t, Int_t varW, const Float_t* values) {
+    if(kWeighted) ((TH2*)h)->Fill(values[vars[0]], values[vars[1]], values[varW]);
+    else          ((TH2*)h)->Fill(values[vars[0]], values[vars[1]]);
+  }
+  template <Bool_t kWeighted>
+  void FillTProfile2D(TObject* h, const Int_t* vars, Int_t, Int_t varW, const Float_t* values) {
+    if(kWeighted) ((TProfile2D*)h)->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+    else          ((TProfile2D*)h)->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+  }
+  template <Bool_t kWeighted>
+  void FillTH3(TObject* h, const Int_t* vars, Int_t, Int_t varW, const Float_t* values) {
+    if(kWeighted) ((TH3*)h)->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+    else          ((TH3*)h)->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
   }
+  template <Bool_t kWeighted>
+  void FillTProfile3D(TObject* h, const Int_t* vars, Int_t, Int_t varW, const Float_t* values) {
+    if(kWeighted) ((TProfile3D*)h)->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]], values[varW]);
+    else          ((TProfile3D*)h)->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]]);
+  }
+  template <Bool_t kWeighted>
+  void FillTHn(TObject* h, const Int_t* vars, Int_t nVars, Int_t varW, const Float_t* values) {
+    Double_t fillValues[AliHistogramManager::kMaxFillVars];
+    for(Int_t idim=0;idim<nVars;++idim) fillValues[idim] = values[vars[idim]];
+    if(kWeighted) ((THnBase*)h)->Fill(fillValues, values[varW]);
+    else          ((THnBase*)h)->Fill(fillValues);
+  }
+}
+
+//__________________________________________________________________
+void AliHistogramManager::CompileFillPlans() {
+  //
+  // Compile the fill plan of each histogram class: the histogram type and variables are decoded
+  // from the unique IDs once here instead of at every FillHistClass() call.
+  // The class handle is the position of the class in fMainList and is also stored as UniqueID-1 of the class list.
+  //
+  fFillPlans.clear();
+  fFillPlans.resize(fMainList.GetEntries());
+  
+  TIter nextClass(&fMainList);
+  THashList* hList=0x0;
+  Int_t handle=0;
+  while((hList=(THashList*)nextClass())) {
+    hList->SetUniqueID(handle+1);
+    std::vector<FillPlanEntry>& plan = fFillPlans[handle++];
     
-  TIter next(hList);
-  TObject* h=0x0;
-  Bool_t isProfile;
-  Bool_t isTHn;
-  Int_t thnDim=0;
-  Bool_t isSparse=kFALSE;
-  Double_t fillValues[20]={0.0};
-  Int_t uid = 0;
-  Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
-  Int_t dimension=0;
-  while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
-    uid = h->GetUniqueID();
-    isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
-    isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
-    if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
-    if(isTHn && ((TString)h->ClassName()).Contains("Sparse")) isSparse = kTRUE;
-    dimension = 0;
-    if(!isTHn) dimension = ((TH1*)h)->GetDimension();
-        
-    uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
-    varT = -1;
-    varW = -1;
-    if(uid>0) {
-      varW = uid%(fNVars+1)-1;
-      if(varW==0) varW=AliReducedVarManager::kNothing;
-      uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
-      if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
-    }
-        
-    if(!isTHn) {
-      varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
+    TIter next(hList);
+    TObject* h=0x0;
+    while((h=next())) {
+      Int_t uid = h->GetUniqueID();
+      Bool_t isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
+      Bool_t isTHn = ((uid%100)>10 ? kTRUE : kFALSE);
+      Int_t thnDim = 0;
+      if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
+      
+      uid = (uid-(uid%100))/100;
+      Int_t varT = -1;
+      Int_t varW = -1;
+      if(uid>0) {
+        varW = uid%(fNVars+1)-1;
+        if(varW==0) varW=AliReducedVarManager::kNothing;
+        uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
+        if(uid>0) varT = uid - 1;
+      }
+      Bool_t weighted = (varW>AliReducedVarManager::kNothing);
+      
+      FillPlanEntry entry;
+      entry.fFill = 0x0;
+      entry.fHist = h;
+      entry.fNFillVars = 0;
+      entry.fVarW = (weighted ? varW : Int_t(AliReducedVarManager::kNothing));
+      if(!isTHn) {
+        TH1* h1 = (TH1*)h;
+        Int_t dimension = h1->GetDimension();
+        entry.fVars[entry.fNFillVars++] = h1->GetXaxis()->GetUniqueID();
+        if(dimension>1 || isProfile) entry.fVars[entry.fNFillVars++] = h1->GetYaxis()->GetUniqueID();
+        if(dimension>2 || (dimension==2 && isProfile)) entry.fVars[entry.fNFillVars++] = h1->GetZaxis()->GetUniqueID();
+        if(dimension==3 && isProfile) entry.fVars[entry.fNFillVars++] = varT;
         switch(dimension) {
           case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
+            if(isProfile) entry.fFill = (weighted ? &FillTProfile<kTRUE> : &FillTProfile<kFALSE>);
+            else          entry.fFill = (weighted ? &FillTH1<kTRUE> : &FillTH1<kFALSE>);
           break;
           case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
+            if(isProfile) entry.fFill = (weighted ? &FillTProfile2D<kTRUE> : &FillTProfile2D<kFALSE>);
+            else          entry.fFill = (weighted ? &FillTH2<kTRUE> : &FillTH2<kFALSE>);
           break;
           case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
-            if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
-            }
+            if(isProfile) entry.fFill = (weighted ? &FillTProfile3D<kTRUE> : &FillTProfile3D<kFALSE>);
+            else          entry.fFill = (weighted ? &FillTH3<kTRUE> : &FillTH3<kFALSE>);
           break;
           default:
           break;
-        }  // end switch
-      }
-    }  // end if(!isTHn)
-    else {
-      for(Int_t idim=0;idim<thnDim;++idim) {
-        if (isSparse) {
-          allVarsGood &= fUsedVars[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-        } else {
-          allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
         }
       }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW]) {
-            if (isSparse) ((THnSparseF*)h)->Fill(fillValues,values[varW]);
-            else          ((THnF*)h)->Fill(fillValues,values[varW]);
-          }
-        }
-        else {
-          if (isSparse) ((THnSparseF*)h)->Fill(fillValues);
-          else          ((THnF*)h)->Fill(fillValues);
+      else {
+        if(thnDim>kMaxFillVars) {
+          cout << "Warning in AliHistogramManager::CompileFillPlans(): Histogram " << h->GetName() << " has more than "
+               << kMaxFillVars << " dimensions and will not be filled" << endl;
+          continue;
         }
+        for(Int_t idim=0;idim<thnDim;++idim)
+          entry.fVars[entry.fNFillVars++] = ((THnBase*)h)->GetAxis(idim)->GetUniqueID();
+        entry.fFill = (weighted ? &FillTHn<kTRUE> : &FillTHn<kFALSE>);
       }
+      if(!entry.fFill) continue;
+      
+      // histograms using variables which are not flagged as used are never filled
+      Bool_t allVarsGood = kTRUE;
+      for(Int_t iv=0;iv<entry.fNFillVars;++iv)
+        allVarsGood &= (entry.fVars[iv]>=0 && entry.fVars[iv]<AliReducedVarManager::kNVars && fUsedVars[entry.fVars[iv]]);
+      if(weighted) allVarsGood &= fUsedVars[varW];
+      if(!allVarsGood) continue;
+      
+      plan.push_back(entry);
     }
   }
+  fFillPlansCompiled = kTRUE;
+}
+
+//__________________________________________________________________
+Int_t AliHistogramManager::GetHistClassHandle(const Char_t* className) {
+  //
+  // Get the handle of a histogram class, to be used with FillHistClass(Int_t handle, Float_t* values)
+  // The handle stays valid as long as no new histogram class is added
+  //
+  if(!fFillPlansCompiled) CompileFillPlans();
+  THashList* hList = (THashList*)fMainList.FindObject(className);
+  if(!hList) return -1;
+  return Int_t(hList->GetUniqueID())-1;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t handle, Float_t* values) {
+  //
+  //  fill a class of histograms using its fill plan
+  //
+  if(!fFillPlansCompiled) CompileFillPlans();
+  if(handle<0 || handle>=Int_t(fFillPlans.size())) return;
+  
+  const std::vector<FillPlanEntry>& plan = fFillPlans[handle];
+  for(std::vector<FillPlanEntry>::const_iterator entry=plan.begin(); entry!=plan.end(); ++entry)
+    entry->fFill(entry->fHist, entry->fVars, entry->fNFillVars, entry->fVarW, values);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values) {
+  //
+  //  fill a class of histograms
+  //
+  if(!fFillPlansCompiled) CompileFillPlans();
+  THashList* hList = (THashList*)fMainList.FindObject(className);
+  if(!hList) {
+    /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
+    cout << "         Histogram list not filled" << endl; */
+    return;
+  }
+  FillHistClass(Int_t(hList->GetUniqueID())-1, values);
 }
 
 //__________________________________________________________________
@@ -14,6 +14,8 @@
 #include <TList.h>
 #include <THashList.h>
 
+#include <vector>
+
 #include "AliReducedVarManager.h"
 
 class TAxis;
@@ -26,6 +28,10 @@ class TFile;
 class AliHistogramManager : public TObject {
 
  public:
+  enum Constants {
+    kMaxFillVars=20               // maximum number of variables (THn dimensions) of a filled histogram
+  };
+  
   AliHistogramManager();
   AliHistogramManager(const Char_t* name, Int_t nvars);
   virtual ~AliHistogramManager();
@@ -68,6 +74,11 @@ class AliHistogramManager : public TObject {
                         Int_t nDimensions,
                         TAxis* axis);
   
+  // Filling goes through fill plans, compiled once from the histogram classes (lazily, or by calling CompileFillPlans()
+  // after the last AddHistogram). Hot loops should get the class handle once and fill by handle.
+  void CompileFillPlans();
+  Int_t GetHistClassHandle(const Char_t* className);   // -1 if the class does not exist
+  void FillHistClass(Int_t handle, Float_t* values);
   void FillHistClass(const Char_t* className, Float_t* values);
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
@@ -106,6 +117,18 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // Fill plan of one histogram: typed fill function with the variable indices resolved from the unique IDs
+  typedef void (*FillFunction)(TObject* h, const Int_t* vars, Int_t nVars, Int_t varW, const Float_t* values);
+  struct FillPlanEntry {
+    FillFunction fFill;           // fill function for the histogram type, with or without weight
+    TObject* fHist;               // histogram
+    Int_t fVars[kMaxFillVars];    // variable per axis (for profiles, the averaged variable comes last)
+    Int_t fNFillVars;             // number of variables in fVars
+    Int_t fVarW;                  // weight variable, AliReducedVarManager::kNothing if not weighted
+  };
+  std::vector<std::vector<FillPlanEntry> > fFillPlans;   //! fill plans, indexed by the histogram class handle
+  Bool_t fFillPlansCompiled;                             //! fill plans are up to date with the histogram classes
+  
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
   
   ClassDef(AliHistogramManager, 4)
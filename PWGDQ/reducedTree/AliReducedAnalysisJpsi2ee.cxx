@@ -664,6 +664,14 @@ void AliReducedAnalysisJpsi2ee::LoopOverTracks(Int_t arrayOption /*=1*/) {
    TClonesArray* trackList = (arrayOption==1 ? fEvent->GetTracks() : fEvent->GetTracks2());
    if (!trackList) return;
 
+   // resolve the histogram classes once, the flag loops below fill them O(100) times per track
+   Int_t hTrack = fHistosManager->GetHistClassHandle("Track_BeforeCuts");
+   Int_t hStatusFlags = fHistosManager->GetHistClassHandle("TrackStatusFlags_BeforeCuts");
+   Int_t hQualityFlags = fHistosManager->GetHistClassHandle("TrackQualityFlags_BeforeCuts");
+   Int_t hITSclusterMap = fHistosManager->GetHistClassHandle("TrackITSclusterMap_BeforeCuts");
+   Int_t hITSsharedClusterMap = fHistosManager->GetHistClassHandle("TrackITSsharedClusterMap_BeforeCuts");
+   Int_t hTPCclusterMap = fHistosManager->GetHistClassHandle("TrackTPCclusterMap_BeforeCuts");
+
    TIter nextTrack(trackList);
    for(Int_t it=0; it<trackList->GetEntries(); ++it) {
       track = (AliReducedBaseTrack*)nextTrack();
@@ -676,28 +684,28 @@ void AliReducedAnalysisJpsi2ee::LoopOverTracks(Int_t arrayOption /*=1*/) {
       AliReducedVarManager::FillTrackInfo(track, fValues);
       if (fClusterCuts.GetEntries())  AliReducedVarManager::FillClusterMatchedTrackInfo(track, fValues, &fClusters, fClusterTrackMatcher);
       else                            AliReducedVarManager::FillClusterMatchedTrackInfo(track, fValues, NULL, fClusterTrackMatcher);
-      fHistosManager->FillHistClass("Track_BeforeCuts", fValues);
+      fHistosManager->FillHistClass(hTrack, fValues);
       
       if(track->IsA() == AliReducedTrackInfo::Class()) {
          AliReducedTrackInfo* trackInfo = dynamic_cast<AliReducedTrackInfo*>(track);
          if(trackInfo) {
             for(UInt_t iflag=0; iflag<AliReducedVarManager::kNTrackingStatus; ++iflag) {
                AliReducedVarManager::FillTrackingFlag(trackInfo, iflag, fValues);
-               fHistosManager->FillHistClass("TrackStatusFlags_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(hStatusFlags, fValues);
             }
             for(UInt_t iflag=0; iflag<64; ++iflag) {
                AliReducedVarManager::FillTrackQualityFlag(trackInfo, iflag, fValues);
-               fHistosManager->FillHistClass("TrackQualityFlags_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(hQualityFlags, fValues);
             }
             for(Int_t iLayer=0; iLayer<6; ++iLayer) {
                AliReducedVarManager::FillITSlayerFlag(trackInfo, iLayer, fValues);
-               fHistosManager->FillHistClass("TrackITSclusterMap_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(hITSclusterMap, fValues);
                AliReducedVarManager::FillITSsharedLayerFlag(trackInfo, iLayer, fValues);
-               fHistosManager->FillHistClass("TrackITSsharedClusterMap_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(hITSsharedClusterMap, fValues);
             }
             for(Int_t iLayer=0; iLayer<8; ++iLayer) {
                AliReducedVarManager::FillTPCclusterBitFlag(trackInfo, iLayer, fValues);
-               fHistosManager->FillHistClass("TrackTPCclusterMap_BeforeCuts", fValues);
+               fHistosManager->FillHistClass(hTPCclusterMap, fValues);
             }
          }
       }
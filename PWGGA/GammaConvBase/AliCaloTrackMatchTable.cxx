@@ -0,0 +1,155 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+////////////////////////////////////////////////
+//---------------------------------------------
+// Track <-> cluster match table of one event
+// for AliCaloTrackMatcher
+//---------------------------------------------
+////////////////////////////////////////////////
+
+#include "AliCaloTrackMatchTable.h"
+
+ClassImp(AliCaloTrackMatchTable)
+
+//________________________________________________________________________
+AliCaloTrackMatchTable::AliCaloTrackMatchTable() :
+  fEntries(),
+  fNextForCluster(),
+  fLastForCluster(),
+  fRowsValid(kFALSE),
+  fTrackOffset(0),
+  fTrackRow(),
+  fByTrack(),
+  fClusterOffset(0),
+  fClusterRow(),
+  fByCluster()
+{
+}
+
+//________________________________________________________________________
+AliCaloTrackMatchTable::~AliCaloTrackMatchTable(){
+}
+
+//________________________________________________________________________
+void AliCaloTrackMatchTable::Reset(){
+  // clear() keeps the capacity of the vectors for the next event
+  fEntries.clear();
+  fNextForCluster.clear();
+  fLastForCluster.clear();
+  fRowsValid = kFALSE;
+  fTrackRow.clear();
+  fByTrack.clear();
+  fClusterRow.clear();
+  fByCluster.clear();
+}
+
+//________________________________________________________________________
+void AliCaloTrackMatchTable::AddEntry(Int_t track, Int_t trackID, Int_t clusterID, Float_t dEta, Float_t dPhi, Bool_t matched){
+  Entry entry;
+  entry.fTrack     = track;
+  entry.fTrackID   = trackID;
+  entry.fClusterID = clusterID;
+  entry.fDEta      = dEta;
+  entry.fDPhi      = dPhi;
+  entry.fMatched   = matched;
+
+  Int_t slot = GetClusterSlot(clusterID);
+  if(slot >= (Int_t)fLastForCluster.size()) fLastForCluster.resize(slot+1,-1);
+  fNextForCluster.push_back(fLastForCluster[slot]);
+  fLastForCluster[slot] = fEntries.size();
+  fEntries.push_back(entry);
+  fRowsValid = kFALSE;
+}
+
+//________________________________________________________________________
+const AliCaloTrackMatchTable::Entry* AliCaloTrackMatchTable::FindEntry(Int_t trackID, Int_t clusterID){
+  // contiguous row if available, otherwise the chain of the cluster (newest entry first);
+  // only a few tracks are associated to one cluster
+  if(fRowsValid){
+    Int_t row = clusterID - fClusterOffset;
+    if(row < 0 || row + 1 >= (Int_t)fClusterRow.size()) return NULL;
+    for(Int_t i = fClusterRow[row+1]-1; i >= fClusterRow[row]; i--){
+      if(fByCluster[i].fTrackID == trackID) return &fByCluster[i];
+    }
+    return NULL;
+  }
+  Int_t slot = GetClusterSlot(clusterID);
+  if(slot >= (Int_t)fLastForCluster.size()) return NULL;
+  for(Int_t i = fLastForCluster[slot]; i >= 0; i = fNextForCluster[i]){
+    if(fEntries[i].fTrackID == trackID && fEntries[i].fClusterID == clusterID) return &fEntries[i];
+  }
+  return NULL;
+}
+
+//________________________________________________________________________
+Int_t AliCaloTrackMatchTable::GetEntriesForTrack(Int_t track, const Entry *&entries){
+  if(!fRowsValid) BuildRows();
+  entries = NULL;
+  Int_t row = track - fTrackOffset;
+  if(row < 0 || row + 1 >= (Int_t)fTrackRow.size()) return 0;
+  entries = fByTrack.data() + fTrackRow[row];
+  return fTrackRow[row+1] - fTrackRow[row];
+}
+
+//________________________________________________________________________
+Int_t AliCaloTrackMatchTable::GetEntriesForCluster(Int_t clusterID, const Entry *&entries){
+  if(!fRowsValid) BuildRows();
+  entries = NULL;
+  Int_t row = clusterID - fClusterOffset;
+  if(row < 0 || row + 1 >= (Int_t)fClusterRow.size()) return 0;
+  entries = fByCluster.data() + fClusterRow[row];
+  return fClusterRow[row+1] - fClusterRow[row];
+}
+
+//________________________________________________________________________
+void AliCaloTrackMatchTable::BuildRows(){
+  // counting sort of the entries by track key and by cluster ID, stable so that the entries
+  // of one row keep the order in which they were added
+  fRowsValid = kTRUE;
+  fTrackRow.clear();
+  fByTrack.resize(fEntries.size());
+  fClusterRow.clear();
+  fByCluster.resize(fEntries.size());
+  if(fEntries.empty()) return;
+
+  Int_t minTrack = fEntries[0].fTrack, maxTrack = fEntries[0].fTrack;
+  Int_t minCluster = fEntries[0].fClusterID, maxCluster = fEntries[0].fClusterID;
+  for(UInt_t i = 1; i < fEntries.size(); i++){
+    if(fEntries[i].fTrack < minTrack) minTrack = fEntries[i].fTrack;
+    if(fEntries[i].fTrack > maxTrack) maxTrack = fEntries[i].fTrack;
+    if(fEntries[i].fClusterID < minCluster) minCluster = fEntries[i].fClusterID;
+    if(fEntries[i].fClusterID > maxCluster) maxCluster = fEntries[i].fClusterID;
+  }
+  fTrackOffset   = minTrack;
+  fClusterOffset = minCluster;
+  fTrackRow.assign(maxTrack - minTrack + 2, 0);
+  fClusterRow.assign(maxCluster - minCluster + 2, 0);
+
+  for(UInt_t i = 0; i < fEntries.size(); i++){
+    fTrackRow[fEntries[i].fTrack - fTrackOffset + 1]++;
+    fClusterRow[fEntries[i].fClusterID - fClusterOffset + 1]++;
+  }
+  for(UInt_t i = 1; i < fTrackRow.size(); i++) fTrackRow[i] += fTrackRow[i-1];
+  for(UInt_t i = 1; i < fClusterRow.size(); i++) fClusterRow[i] += fClusterRow[i-1];
+
+  // fill with the row starts as insertion points, afterwards each of them points to the start of
+  // the next row and they are shifted back by one
+  for(UInt_t i = 0; i < fEntries.size(); i++){
+    fByTrack[fTrackRow[fEntries[i].fTrack - fTrackOffset]++]             = fEntries[i];
+    fByCluster[fClusterRow[fEntries[i].fClusterID - fClusterOffset]++]   = fEntries[i];
+  }
+  for(Int_t i = fTrackRow.size()-1; i > 0; i--) fTrackRow[i] = fTrackRow[i-1];
+  fTrackRow[0] = 0;
+  for(Int_t i = fClusterRow.size()-1; i > 0; i--) fClusterRow[i] = fClusterRow[i-1];
+  fClusterRow[0] = 0;
+}
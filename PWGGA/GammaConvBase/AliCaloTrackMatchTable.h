@@ -0,0 +1,61 @@
+#ifndef ALICALOTRACKMATCHTABLE_H
+#define ALICALOTRACKMATCHTABLE_H
+
+#include "Rtypes.h"
+#include <vector>
+
+using namespace std;
+
+// Track <-> cluster associations of one event for AliCaloTrackMatcher, in flat arrays.
+// The entries are appended while matching; for the lookups by track or by cluster they are
+// copied once into compressed sparse rows (entries grouped by track resp. cluster, with the
+// residuals inline), which are rebuilt only if entries were added in between.
+// Reset() keeps the memory for the next event.
+class AliCaloTrackMatchTable {
+
+  public:
+    struct Entry {
+      Int_t    fTrack;      // track key: ID (ESD) or position of the track in the event (AOD)
+      Int_t    fTrackID;    // track ID
+      Int_t    fClusterID;  // cluster ID
+      Float_t  fDEta;       // matching residual in eta
+      Float_t  fDPhi;       // matching residual in phi
+      Bool_t   fMatched;    // kFALSE if the matching was tried and failed
+    };
+
+    AliCaloTrackMatchTable();
+    virtual ~AliCaloTrackMatchTable();
+
+    void          Reset();
+    void          AddEntry(Int_t track, Int_t trackID, Int_t clusterID, Float_t dEta, Float_t dPhi, Bool_t matched = kTRUE);
+
+    // last entry added for a track ID and a cluster ID, NULL if there is none
+    const Entry*  FindEntry(Int_t trackID, Int_t clusterID);
+
+    // entries of a track key resp. cluster ID in the order they were added, returns their number
+    Int_t         GetEntriesForTrack(Int_t track, const Entry *&entries);
+    Int_t         GetEntriesForCluster(Int_t clusterID, const Entry *&entries);
+
+    Int_t         GetNEntries() const                     { return fEntries.size()           ;}
+    const Entry&  GetEntry(Int_t i) const                 { return fEntries[i]               ;}
+
+  private:
+    void          BuildRows();
+    Int_t         GetClusterSlot(Int_t clusterID) const   { return clusterID >= 0 ? clusterID + 1 : 0 ;}
+
+    vector<Entry>  fEntries;             //! entries in the order they were added
+    vector<Int_t>  fNextForCluster;      //! previous entry with the same cluster slot, -1 at the end
+    vector<Int_t>  fLastForCluster;      //! last entry for each cluster slot (ID+1, 0 for negative IDs)
+
+    Bool_t         fRowsValid;           //! rows up to date with fEntries
+    Int_t          fTrackOffset;         //! smallest track key
+    vector<Int_t>  fTrackRow;            //! first entry of each track key in fByTrack, one more for the end
+    vector<Entry>  fByTrack;             //! entries grouped by track key
+    Int_t          fClusterOffset;       //! smallest cluster ID
+    vector<Int_t>  fClusterRow;          //! first entry of each cluster ID in fByCluster, one more for the end
+    vector<Entry>  fByCluster;           //! entries grouped by cluster ID
+
+    ClassDef(AliCaloTrackMatchTable,1)
+};
+
+#endif
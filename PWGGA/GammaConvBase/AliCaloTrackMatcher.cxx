@@ -61,17 +61,12 @@ AliCaloTrackMatcher::AliCaloTrackMatcher(const char *name, Int_t clusterType, In
   fGeomEMCAL(NULL),
   fGeomPHOS(NULL),
   fArrClusters(NULL),
-  fMapTrackToCluster(),
-  fMapClusterToTrack(),
-  fNEntries(1),
-  fVectorDeltaEtaDeltaPhi(0),
-  fMap_TrID_ClID_ToIndex(),
-  fSecMapTrackToCluster(),
-  fSecMapClusterToTrack(),
-  fSecNEntries(1),
-  fSecVectorDeltaEtaDeltaPhi(0),
-  fSecMap_TrID_ClID_ToIndex(),
-  fSecMap_TrID_ClID_AlreadyTried(),
+  fMatchTable(),
+  fSecMatchTable(),
+  fTrackPositionFilled(kFALSE),
+  fTrackIDOffset(0),
+  fTrackPosition(),
+  fSecTrackPosition(),
   fListHistos(NULL),
   fHistControlMatches(NULL),
   fSecHistControlMatches(NULL),
@@ -88,16 +83,8 @@ AliCaloTrackMatcher::AliCaloTrackMatcher(const char *name, Int_t clusterType, In
 //________________________________________________________________________
 AliCaloTrackMatcher::~AliCaloTrackMatcher(){
     // default deconstructor
-    fMapTrackToCluster.clear();
-    fMapClusterToTrack.clear();
-    fVectorDeltaEtaDeltaPhi.clear();
-    fMap_TrID_ClID_ToIndex.clear();
-
-    fSecMapTrackToCluster.clear();
-    fSecMapClusterToTrack.clear();
-    fSecVectorDeltaEtaDeltaPhi.clear();
-    fSecMap_TrID_ClID_ToIndex.clear();
-    fSecMap_TrID_ClID_AlreadyTried.clear();
+    fMatchTable.Reset();
+    fSecMatchTable.Reset();
 
     if(fHistControlMatches) delete fHistControlMatches;
     if(fSecHistControlMatches) delete fSecHistControlMatches;
@@ -110,16 +97,8 @@ AliCaloTrackMatcher::~AliCaloTrackMatcher(){
 
 //________________________________________________________________________
 void AliCaloTrackMatcher::Terminate(Option_t *){
-  fMapTrackToCluster.clear();
-  fMapClusterToTrack.clear();
-  fVectorDeltaEtaDeltaPhi.clear();
-  fMap_TrID_ClID_ToIndex.clear();
-
-  fSecMapTrackToCluster.clear();
-  fSecMapClusterToTrack.clear();
-  fSecVectorDeltaEtaDeltaPhi.clear();
-  fSecMap_TrID_ClID_ToIndex.clear();
-  fSecMap_TrID_ClID_AlreadyTried.clear();
+  fMatchTable.Reset();
+  fSecMatchTable.Reset();
 }
 
 //________________________________________________________________________
@@ -181,18 +160,9 @@ void AliCaloTrackMatcher::UserCreateOutputObjects(){
 //________________________________________________________________________
 void AliCaloTrackMatcher::Initialize(Int_t runNumber){
   // Initialize function to be called once before analysis
-  fMapTrackToCluster.clear();
-  fMapClusterToTrack.clear();
-  fNEntries = 1;
-  fVectorDeltaEtaDeltaPhi.clear();
-  fMap_TrID_ClID_ToIndex.clear();
-
-  fSecMapTrackToCluster.clear();
-  fSecMapClusterToTrack.clear();
-  fSecNEntries = 1;
-  fSecVectorDeltaEtaDeltaPhi.clear();
-  fSecMap_TrID_ClID_ToIndex.clear();
-  fSecMap_TrID_ClID_AlreadyTried.clear();
+  fMatchTable.Reset();
+  fSecMatchTable.Reset();
+  fTrackPositionFilled = kFALSE;
 
   if(fRunNumber == -1 || fRunNumber != runNumber){
     if(fClusterType == 1 || fClusterType == 3 || fClusterType == 4){
@@ -517,16 +487,8 @@ void AliCaloTrackMatcher::ProcessEvent(AliVEvent *event){
         continue;
       }
       nClusterMatchesToTrack++;
-      if(aodev){
-        fMapTrackToCluster.insert(make_pair(itr,cluster->GetID()));
-        fMapClusterToTrack.insert(make_pair(cluster->GetID(),itr));
-      }else{
-        fMapTrackToCluster.insert(make_pair(inTrack->GetID(),cluster->GetID()));
-        fMapClusterToTrack.insert(make_pair(cluster->GetID(),inTrack->GetID()));
-      }
-      fVectorDeltaEtaDeltaPhi.push_back(make_pair(dEta,dPhi));
-      fMap_TrID_ClID_ToIndex[make_pair(inTrack->GetID(),cluster->GetID())] = fNEntries++;
-      if( (Int_t)fVectorDeltaEtaDeltaPhi.size() != (fNEntries-1)) AliFatal("Fatal error in AliCaloTrackMatcher, vector and map are not in sync!");
+      if(aodev) fMatchTable.AddEntry(itr,inTrack->GetID(),cluster->GetID(),dEta,dPhi);
+      else fMatchTable.AddEntry(inTrack->GetID(),inTrack->GetID(),cluster->GetID(),dEta,dPhi);
       if(fArrClusters) delete cluster;
     }
     if(nClusterMatchesToTrack == 0) FillfHistControlMatches(5.,inTrack->Pt());
@@ -579,7 +541,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
 
   if (inSecTrack->Pt() < 0.3 ) {
     FillfSecHistControlMatches(1.,inSecTrack->Pt());
-    fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+    fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
     return kFALSE;
   }
 
@@ -589,7 +551,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
     aodt = dynamic_cast<AliAODTrack*>(inSecTrack);
     if (!aodt){
       AliError("Track is neither ESD nor AOD, continue");
-      fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+      fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
       return kFALSE;
     }
   }
@@ -600,7 +562,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
     if (!in){
       AliDebug(2, "Could not get InnerParam of Track, continue");
       FillfSecHistControlMatches(1.,inSecTrack->Pt());
-      fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+      fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
       return kFALSE;
     }
     trackParam = new AliExternalTrackParam(*in);
@@ -609,42 +571,42 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
     if (fClusterType == 1 || fClusterType == 3 || fClusterType == 4){
       if (TMath::Abs(aodt->GetTrackEtaOnEMCal()) > 0.8){
         FillfSecHistControlMatches(1.,inSecTrack->Pt());
-        fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+        fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
         return kFALSE;
       }
       if( nModules < 13 ){
         if (( aodt->GetTrackPhiOnEMCal() < 60*TMath::DegToRad() || aodt->GetTrackPhiOnEMCal() > 200*TMath::DegToRad())){
           FillfSecHistControlMatches(1.,inSecTrack->Pt());
-          fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+          fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
           return kFALSE;
         }
       } else if( nModules > 12 ){
         if (fClusterType == 3 && ( aodt->GetTrackPhiOnEMCal() < 250*TMath::DegToRad() || aodt->GetTrackPhiOnEMCal() > 340*TMath::DegToRad())){
           FillfSecHistControlMatches(1.,inSecTrack->Pt());
-          fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+          fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
           return kFALSE;
         }
         if( fClusterType == 1 && ( aodt->GetTrackPhiOnEMCal() < 60*TMath::DegToRad() || aodt->GetTrackPhiOnEMCal() > 200*TMath::DegToRad())){
           FillfSecHistControlMatches(1.,inSecTrack->Pt());
-          fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+          fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
           return kFALSE;
         }
         if( fClusterType == 4 && ( aodt->GetTrackPhiOnEMCal() < 60*TMath::DegToRad() || aodt->GetTrackPhiOnEMCal() > 200*TMath::DegToRad())
                               && ( aodt->GetTrackPhiOnEMCal() < 250*TMath::DegToRad() || aodt->GetTrackPhiOnEMCal() > 340*TMath::DegToRad()) ){
           FillfSecHistControlMatches(1.,inSecTrack->Pt());
-          fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+          fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
           return kFALSE;
         }
       }
     } else {
       if ( aodt->Phi() < 230*TMath::DegToRad() || aodt->Phi() > 350*TMath::DegToRad()){
         FillfSecHistControlMatches(1.,inSecTrack->Pt());
-        fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+        fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
         return kFALSE;
       }
       if (TMath::Abs(aodt->Eta()) > 0.3 ){
         FillfSecHistControlMatches(1.,inSecTrack->Pt());
-        fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+        fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
         return kFALSE;
       }
     }
@@ -658,7 +620,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
   if(!trackParam){
     AliError("Could not get TrackParameters, continue");
     FillfSecHistControlMatches(1.,inSecTrack->Pt());
-    fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+    fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
     return kFALSE;
   }
 
@@ -674,14 +636,14 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
       if( TMath::Abs(eta) > 0.8 ) {
         delete trackParam;
         FillfSecHistControlMatches(3.,inSecTrack->Pt());
-        fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+        fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
         return kFALSE;
       }
       // Save some time and memory in case of no DCal present
       if( nModules < 13 && ( phi < 60*TMath::DegToRad() || phi > 200*TMath::DegToRad())){
         delete trackParam;
         FillfSecHistControlMatches(3.,inSecTrack->Pt());
-        fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+        fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
         return kFALSE;
       }
 
@@ -689,13 +651,13 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
       if(!propagated){
         delete trackParam;
         FillfSecHistControlMatches(4.,inSecTrack->Pt());
-        fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+        fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
         return kFALSE;
       }
     }else{
       delete trackParam;
       FillfSecHistControlMatches(2.,inSecTrack->Pt());
-      fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+      fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
       return kFALSE;
     }
 
@@ -711,7 +673,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
     }else{
       delete trackParam;
       FillfSecHistControlMatches(2.,inSecTrack->Pt());
-      fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+      fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
       return kFALSE;}
   }
 
@@ -720,7 +682,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
     //cout << dEtaTemp << " - " << dPhiTemp << " - " << dR2 << endl;
     if(dR2 > fMatchingResidual){
       FillfSecHistControlMatches(5.,inSecTrack->Pt());
-      fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+      fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
       //cout << "NO MATCH! - " << inSecTrack->GetID() << "/" << cluster->GetID() << endl;
       delete trackParam;
       return kFALSE;
@@ -729,24 +691,12 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
 
     if(aodev){
       //need to search for position in case of AOD
-      Int_t TrackPos = -1;
-      for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-        AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-        if(currTrack->GetID() == inSecTrack->GetID()){
-          TrackPos = iTrack;
-          break;
-        }
-      }
+      Int_t TrackPos = GetTrackPosition(event, inSecTrack->GetID(), kFALSE);
       if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: PropagateV0TrackToClusterAndGetMatchingResidual - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",inSecTrack->GetID()));
-      fSecMapTrackToCluster.insert(make_pair(TrackPos,cluster->GetID()));
-      fSecMapClusterToTrack.insert(make_pair(cluster->GetID(),TrackPos));
+      fSecMatchTable.AddEntry(TrackPos,inSecTrack->GetID(),cluster->GetID(),dEtaTemp,dPhiTemp);
     }else{
-      fSecMapTrackToCluster.insert(make_pair(inSecTrack->GetID(),cluster->GetID()));
-      fSecMapClusterToTrack.insert(make_pair(cluster->GetID(),inSecTrack->GetID()));
+      fSecMatchTable.AddEntry(inSecTrack->GetID(),inSecTrack->GetID(),cluster->GetID(),dEtaTemp,dPhiTemp);
     }
-    fSecVectorDeltaEtaDeltaPhi.push_back(make_pair(dEtaTemp,dPhiTemp));
-    fSecMap_TrID_ClID_ToIndex[make_pair(inSecTrack->GetID(),cluster->GetID())] = fSecNEntries++;
-    if( (Int_t)fSecVectorDeltaEtaDeltaPhi.size() != (fSecNEntries-1)) AliFatal("Fatal error in AliCaloTrackMatcher, vector and map are not in sync!");
 
     FillfSecHistControlMatches(6.,inSecTrack->Pt());
     dEta = dEtaTemp;
@@ -755,7 +705,7 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
     return kTRUE;
   }else AliFatal("Fatal error in AliCaloTrackMatcher, track is labeled as sucessfully propagated although this should be impossible!");
 
-  fSecMap_TrID_ClID_AlreadyTried[make_pair(inSecTrack->GetID(),cluster->GetID())] = 1.;
+  fSecMatchTable.AddEntry(-1,inSecTrack->GetID(),cluster->GetID(),0.,0.,kFALSE);
   delete trackParam;
   return kFALSE;
 }
@@ -766,30 +716,27 @@ Bool_t AliCaloTrackMatcher::PropagateV0TrackToClusterAndGetMatchingResidual(AliV
 //________________________________________________________________________
 //________________________________________________________________________
 Bool_t AliCaloTrackMatcher::GetTrackClusterMatchingResidual(Int_t trackID, Int_t clusterID, Float_t &dEta, Float_t &dPhi){
-  Int_t position = fMap_TrID_ClID_ToIndex[make_pair(trackID,clusterID)];
-  if(position == 0) return kFALSE;
+  const AliCaloTrackMatchTable::Entry *entry = fMatchTable.FindEntry(trackID,clusterID);
+  if(!entry) return kFALSE;
 
-  pairFloat tempEtaPhi = fVectorDeltaEtaDeltaPhi.at(position-1);
-  dEta = tempEtaPhi.first;
-  dPhi = tempEtaPhi.second;
+  dEta = entry->fDEta;
+  dPhi = entry->fDPhi;
   return kTRUE;
 }
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
     }
   }
 
@@ -799,24 +746,22 @@ Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )matched++;
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )matched++;
   }
   return matched;
 }
@@ -824,16 +769,14 @@ Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR){
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
   }
   return matched;
 }
@@ -841,35 +784,21 @@ Int_t AliCaloTrackMatcher::GetNMatchedTrackIDsForCluster(AliVEvent *event, Int_t
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
 
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        // even though hybrid tracks don't contain dublicates
-        // the hybrid track can share an ID with another copy if it is a copy
-        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kTRUE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return matched;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
     }
   }
   return matched;
@@ -877,73 +806,45 @@ Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t
 
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        // even though hybrid tracks don't contain dublicates
-        // the hybrid track can share an ID with another copy if it is a copy
-        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kTRUE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return matched;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
 
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
 
-        if (match_dPhi && match_dEta )matched++;
+    if (match_dPhi && match_dEta )matched++;
 
-      }
-    }
   }
   return matched;
 }
 
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-       AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        // even though hybrid tracks don't contain dublicates
-        // the hybrid track can share an ID with another copy if it is a copy
-        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kTRUE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return matched;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
   }
   return matched;
 }
@@ -951,19 +852,17 @@ Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForTrack(AliVEvent *event, Int_t
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
   vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){ 
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedTracks.push_back(it->second);
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedTracks.push_back(it->second);
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedTracks.push_back(entries[i].fTrack);
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedTracks.push_back(entries[i].fTrack);
     }
   }
   return tempMatchedTracks;
@@ -972,25 +871,23 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID,  TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
   vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )tempMatchedTracks.push_back(it->second);
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )tempMatchedTracks.push_back(entries[i].fTrack);
 
-      }
-    }
   }
   return tempMatchedTracks;
 }
@@ -998,51 +895,35 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedTrackIDsForCluster(AliVEvent *event, Int_t clusterID,  Float_t dR){
   vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedTracks.push_back(it->second);
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedTracks.push_back(entries[i].fTrack);
   }
   return tempMatchedTracks;
 }
 
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        // even though hybrid tracks don't contain dublicates
-        // the hybrid track can share an ID with another copy if it is a copy
-        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kTRUE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return tempMatchedClusters;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedClusters.push_back(it->second);
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedClusters.push_back(it->second);
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedClusters.push_back(entries[i].fClusterID);
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedClusters.push_back(entries[i].fClusterID);
     }
   }
 
@@ -1051,71 +932,43 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event
 
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-       AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        // even though hybrid tracks don't contain dublicates
-        // the hybrid track can share an ID with another copy if it is a copy
-        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kTRUE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return tempMatchedClusters;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )tempMatchedClusters.push_back(it->second);
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )tempMatchedClusters.push_back(entries[i].fClusterID);
   }
   return tempMatchedClusters;
 }
 
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event, Int_t trackID, Float_t dR){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        // even though hybrid tracks don't contain dublicates
-        // the hybrid track can share an ID with another copy if it is a copy
-        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kTRUE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
   vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return tempMatchedClusters;
-  for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedClusters.push_back(it->second);
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    Float_t tempDEta = entries[i].fDEta;
+    Float_t tempDPhi = entries[i].fDPhi;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedClusters.push_back(entries[i].fClusterID);
   }
   return tempMatchedClusters;
 }
@@ -1126,36 +979,34 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForTrack(AliVEvent *event
 //________________________________________________________________________
 //________________________________________________________________________
 Bool_t AliCaloTrackMatcher::GetSecTrackClusterMatchingResidual(Int_t trackID, Int_t clusterID, Float_t &dEta, Float_t &dPhi){
-  Int_t position = fSecMap_TrID_ClID_ToIndex[make_pair(trackID,clusterID)];
-  if(position == 0) return kFALSE;
+  const AliCaloTrackMatchTable::Entry *entry = fSecMatchTable.FindEntry(trackID,clusterID);
+  if(!entry || !entry->fMatched) return kFALSE;
 
-  pairFloat tempEtaPhi = fSecVectorDeltaEtaDeltaPhi.at(position-1);
-  dEta = tempEtaPhi.first;
-  dPhi = tempEtaPhi.second;
+  dEta = entry->fDEta;
+  dPhi = entry->fDPhi;
   return kTRUE;
 }
 //________________________________________________________________________
 Bool_t AliCaloTrackMatcher::IsSecTrackClusterAlreadyTried(Int_t trackID, Int_t clusterID){
-  Int_t position = fSecMap_TrID_ClID_AlreadyTried[make_pair(trackID,clusterID)];
-  if(position == 0) return kFALSE;
+  const AliCaloTrackMatchTable::Entry *entry = fSecMatchTable.FindEntry(trackID,clusterID);
+  if(!entry || entry->fMatched) return kFALSE;
   else return kTRUE;
 }
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedSecTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
     }
   }
 
@@ -1165,24 +1016,23 @@ Int_t AliCaloTrackMatcher::GetNMatchedSecTrackIDsForCluster(AliVEvent *event, In
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedSecTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )matched++;
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )matched++;
   }
 
   return matched;
@@ -1191,16 +1041,15 @@ Int_t AliCaloTrackMatcher::GetNMatchedSecTrackIDsForCluster(AliVEvent *event, In
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedSecTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR){
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
   }
 
   return matched;
@@ -1208,32 +1057,22 @@ Int_t AliCaloTrackMatcher::GetNMatchedSecTrackIDsForCluster(AliVEvent *event, In
 
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForSecTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kFALSE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return matched;
-  for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) matched++;
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) matched++;
     }
   }
 
@@ -1242,38 +1081,28 @@ Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForSecTrack(AliVEvent *event, In
 
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForSecTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kFALSE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return matched;
-  for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )matched++;
 
-        if (match_dPhi && match_dEta )matched++;
-
-      }
-    }
   }
 
   return matched;
@@ -1281,29 +1110,19 @@ Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForSecTrack(AliVEvent *event, In
 
 //________________________________________________________________________
 Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForSecTrack(AliVEvent *event, Int_t trackID, Float_t dR){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kFALSE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   Int_t matched = 0;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return matched;
-  for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) matched++;
   }
 
   return matched;
@@ -1312,19 +1131,18 @@ Int_t AliCaloTrackMatcher::GetNMatchedClusterIDsForSecTrack(AliVEvent *event, In
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedSecTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
   vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedTracks.push_back(it->second);
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedTracks.push_back(it->second);
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedTracks.push_back(entries[i].fTrack);
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedTracks.push_back(entries[i].fTrack);
     }
   }
 
@@ -1334,24 +1152,23 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedSecTrackIDsForCluster(AliVEvent *ev
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedSecTrackIDsForCluster(AliVEvent *event, Int_t clusterID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
   vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )tempMatchedTracks.push_back(it->second);
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )tempMatchedTracks.push_back(entries[i].fTrack);
   }
 
   return tempMatchedTracks;
@@ -1360,16 +1177,15 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedSecTrackIDsForCluster(AliVEvent *ev
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedSecTrackIDsForCluster(AliVEvent *event, Int_t clusterID, Float_t dR){
   vector<Int_t> tempMatchedTracks;
-  multimap<Int_t,Int_t>::iterator it;
-  for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it){
-    if(it->first == clusterID){
-      Float_t tempDEta, tempDPhi;
-      AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(it->second));
-      if(!tempTrack) continue;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->first,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedTracks.push_back(it->second);
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForCluster(clusterID, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(entries[i].fTrack));
+    if(!tempTrack) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedTracks.push_back(entries[i].fTrack);
   }
 
   return tempMatchedTracks;
@@ -1377,32 +1193,22 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedSecTrackIDsForCluster(AliVEvent *ev
 
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForSecTrack(AliVEvent *event, Int_t trackID, Float_t dEtaMax, Float_t dEtaMin, Float_t dPhiMax, Float_t dPhiMin){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kFALSE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return tempMatchedClusters;
-  for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if(tempTrack->Charge()>0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedClusters.push_back(it->second);
-        }else if(tempTrack->Charge()<0){
-          if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedClusters.push_back(it->second);
-        }
-      }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if(tempTrack->Charge()>0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (dPhiMin < tempDPhi) && (tempDPhi < dPhiMax) ) tempMatchedClusters.push_back(entries[i].fClusterID);
+    }else if(tempTrack->Charge()<0){
+      if( (dEtaMin < tempDEta) && (tempDEta < dEtaMax) && (-dPhiMin > tempDPhi) && (tempDPhi > -dPhiMax) ) tempMatchedClusters.push_back(entries[i].fClusterID);
     }
   }
 
@@ -1411,37 +1217,27 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForSecTrack(AliVEvent *ev
 
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForSecTrack(AliVEvent *event, Int_t trackID, TF1* fFuncPtDepEta, TF1* fFuncPtDepPhi){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kFALSE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return tempMatchedClusters;
-  for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        Bool_t match_dEta = kFALSE;
-        Bool_t match_dPhi = kFALSE;
-        if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
-        else match_dEta = kFALSE;
-
-        if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
-        else match_dPhi = kFALSE;
-
-        if (match_dPhi && match_dEta )tempMatchedClusters.push_back(it->second);
-      }
-    }
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    Bool_t match_dEta = kFALSE;
+    Bool_t match_dPhi = kFALSE;
+    if( TMath::Abs(tempDEta) < fFuncPtDepEta->Eval(tempTrack->Pt())) match_dEta = kTRUE;
+    else match_dEta = kFALSE;
+
+    if( TMath::Abs(tempDPhi) < fFuncPtDepPhi->Eval(tempTrack->Pt())) match_dPhi = kTRUE;
+    else match_dPhi = kFALSE;
+
+    if (match_dPhi && match_dEta )tempMatchedClusters.push_back(entries[i].fClusterID);
   }
 
   return tempMatchedClusters;
@@ -1449,32 +1245,61 @@ vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForSecTrack(AliVEvent *ev
 
 //________________________________________________________________________
 vector<Int_t> AliCaloTrackMatcher::GetMatchedClusterIDsForSecTrack(AliVEvent *event, Int_t trackID, Float_t dR){
-  Int_t TrackPos = -1;
-  if(event->IsA()==AliAODEvent::Class()){ // for AOD, we have to look for position of track in the event
-    for (Int_t iTrack = 0; iTrack < event->GetNumberOfTracks(); iTrack++){
-      AliVTrack* currTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(iTrack));
-      if(currTrack->GetID() == trackID){
-        TrackPos = iTrack;
-        break;
-      }
-    }
-    if(TrackPos == -1) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
-  }else TrackPos = trackID; // for ESD just take trackID
+  Int_t TrackPos = GetTrackPosition(event, trackID, kFALSE); // for AOD position of the track in the event, for ESD trackID
+  if(TrackPos == -1 && event->IsA()==AliAODEvent::Class()) AliFatal(Form("AliCaloTrackMatcher: GetNMatchedClusterIDsForTrack - track (ID: '%i') cannot be retrieved from event, should be impossible as it has been used in maim task before!",trackID));
 
   vector<Int_t> tempMatchedClusters;
-  multimap<Int_t,Int_t>::iterator it;
   AliVTrack* tempTrack  = dynamic_cast<AliVTrack*>(event->GetTrack(TrackPos));
   if(!tempTrack) return tempMatchedClusters;
-  for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it){
-    if(it->first == TrackPos){
-      Float_t tempDEta, tempDPhi;
-      if(GetTrackClusterMatchingResidual(tempTrack->GetID(),it->second,tempDEta,tempDPhi)){
-        if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedClusters.push_back(it->second);
+  const AliCaloTrackMatchTable::Entry *entries = NULL;
+  Int_t nEntries = fSecMatchTable.GetEntriesForTrack(TrackPos, entries);
+  for (Int_t i = 0; i < nEntries; i++){
+    if(!entries[i].fMatched) continue;
+    Float_t tempDEta, tempDPhi;
+    if(!GetTrackClusterMatchingResidual(tempTrack->GetID(),entries[i].fClusterID,tempDEta,tempDPhi)) continue;
+    if (TMath::Sqrt(tempDEta*tempDEta + tempDPhi*tempDPhi) < dR ) tempMatchedClusters.push_back(entries[i].fClusterID);
+  }
+
+  return tempMatchedClusters;
+}
+
+//________________________________________________________________________
+Int_t AliCaloTrackMatcher::GetTrackPosition(AliVEvent *event, Int_t trackID, Bool_t hybridOnly){
+  // for AOD, position of the first track with the given ID in the event (for running mode 7 only
+  // hybrid tracks are considered if hybridOnly is set), -1 if there is none; for ESD trackID.
+  // The positions of all IDs are filled once per event.
+  if(event->IsA()!=AliAODEvent::Class()) return trackID;
+
+  if(!fTrackPositionFilled){
+    fTrackPositionFilled = kTRUE;
+    fTrackPosition.clear();
+    fSecTrackPosition.clear();
+    Int_t nTracks = event->GetNumberOfTracks();
+    if(nTracks > 0){
+      Int_t minID = event->GetTrack(0)->GetID(), maxID = minID;
+      for (Int_t iTrack = 1; iTrack < nTracks; iTrack++){
+        Int_t currID = event->GetTrack(iTrack)->GetID();
+        if(currID < minID) minID = currID;
+        if(currID > maxID) maxID = currID;
+      }
+      fTrackIDOffset = minID;
+      fTrackPosition.assign(maxID - minID + 1, -1);
+      fSecTrackPosition.assign(maxID - minID + 1, -1);
+      for (Int_t iTrack = 0; iTrack < nTracks; iTrack++){
+        AliAODTrack* currTrack  = static_cast<AliAODTrack*>(event->GetTrack(iTrack));
+        Int_t index = currTrack->GetID() - fTrackIDOffset;
+        if(fSecTrackPosition[index] == -1) fSecTrackPosition[index] = iTrack;
+        // even though hybrid tracks don't contain dublicates
+        // the hybrid track can share an ID with another copy if it is a copy
+        if(fRunningMode==7 &&!currTrack->IsHybridGlobalConstrainedGlobal()) continue;
+        if(fTrackPosition[index] == -1) fTrackPosition[index] = iTrack;
       }
     }
   }
 
-  return tempMatchedClusters;
+  Int_t index = trackID - fTrackIDOffset;
+  if(index < 0 || index >= (Int_t)fSecTrackPosition.size()) return -1;
+  return hybridOnly ? fTrackPosition[index] : fSecTrackPosition[index];
 }
 
 //________________________________________________________________________
@@ -1511,18 +1336,16 @@ void AliCaloTrackMatcher::SetLogBinningYTH2(TH2* histoRebin){
 
 //________________________________________________________________________
 void AliCaloTrackMatcher::DebugV0Matching(){
-  if(fSecVectorDeltaEtaDeltaPhi.size()>0){
+  if(fSecMatchTable.GetNEntries()>0){
     cout << "******************************" << endl;
     cout << "******************************" << endl;
     cout << "NEW EVENT !" << endl;
-    cout << "vector etaphi:" << endl;
-    cout << fSecVectorDeltaEtaDeltaPhi.size() << endl;
-    cout << "multimap" << endl;
-    mapT::iterator iter = fSecMap_TrID_ClID_ToIndex.begin();
-    for (iter = fSecMap_TrID_ClID_ToIndex.begin(); iter != fSecMap_TrID_ClID_ToIndex.end(); ++iter){
-      Float_t dEta, dPhi = 0;
-      if(!GetSecTrackClusterMatchingResidual(iter->first.first,iter->first.second,dEta,dPhi)) continue;
-      cout << "  [" << iter->first.first << "/" << iter->first.second << ", " << iter->second << "] - (" << dEta << "/" << dPhi << ")" << endl;
+    cout << "match table:" << endl;
+    cout << fSecMatchTable.GetNEntries() << endl;
+    for (Int_t i = 0; i < fSecMatchTable.GetNEntries(); i++){
+      const AliCaloTrackMatchTable::Entry &entry = fSecMatchTable.GetEntry(i);
+      if(!entry.fMatched) continue;
+      cout << "  [" << entry.fTrackID << "/" << entry.fClusterID << ", " << i << "] - (" << entry.fDEta << "/" << entry.fDPhi << ")" << endl;
     }
     cout << "mapTrackToCluster" << endl;
     AliESDEvent *esdev = dynamic_cast<AliESDEvent*>(fInputEvent);
@@ -1535,11 +1358,13 @@ void AliCaloTrackMatcher::DebugV0Matching(){
       cout << itr << " (" << tCharge << ") - " << GetNMatchedClusterIDsForSecTrack(fInputEvent,inTrack->GetID(),5,-5,0.2,-0.4) << "\t\t";
     }
     cout << endl;
-    multimap<Int_t,Int_t>::iterator it;
-    for (it=fSecMapTrackToCluster.begin(); it!=fSecMapTrackToCluster.end(); ++it) cout << it->first << " => " << it->second << '\n';
-    cout << "mapClusterToTrack" << endl;
-    Int_t tempClus = it->second;
-    for (it=fSecMapClusterToTrack.begin(); it!=fSecMapClusterToTrack.end(); ++it) cout << it->first << " => " << it->second << '\n';
+    Int_t tempClus = -1;
+    for (Int_t i = 0; i < fSecMatchTable.GetNEntries(); i++){
+      const AliCaloTrackMatchTable::Entry &entry = fSecMatchTable.GetEntry(i);
+      if(!entry.fMatched) continue;
+      cout << entry.fTrack << " => " << entry.fClusterID << '\n';
+      tempClus = entry.fClusterID;
+    }
     vector<Int_t> tempTracks = GetMatchedSecTrackIDsForCluster(fInputEvent,tempClus, 5, -5, 0.2, -0.4);
     for(UInt_t iJ=0; iJ<tempTracks.size();iJ++){
       cout << tempClus << " - " << tempTracks.at(iJ) << endl;
@@ -1550,18 +1375,16 @@ void AliCaloTrackMatcher::DebugV0Matching(){
 
 //________________________________________________________________________
 void AliCaloTrackMatcher::DebugMatching(){
-  if(fVectorDeltaEtaDeltaPhi.size()>0){
+  if(fMatchTable.GetNEntries()>0){
     cout << "******************************" << endl;
     cout << "******************************" << endl;
     cout << "NEW EVENT !" << endl;
-    cout << "vector etaphi:" << endl;
-    cout << fVectorDeltaEtaDeltaPhi.size() << endl;
-    cout << "multimap" << endl;
-    mapT::iterator iter = fMap_TrID_ClID_ToIndex.begin();
-    for (iter = fMap_TrID_ClID_ToIndex.begin(); iter != fMap_TrID_ClID_ToIndex.end(); ++iter){
-      Float_t dEta, dPhi = 0;
-      if(!GetTrackClusterMatchingResidual(iter->first.first,iter->first.second,dEta,dPhi)) continue;
-      cout << "  [" << iter->first.first << "/" << iter->first.second << ", " << iter->second << "] - (" << dEta << "/" << dPhi << ")" << endl;
+    cout << "match table:" << endl;
+    cout << fMatchTable.GetNEntries() << endl;
+    for (Int_t i = 0; i < fMatchTable.GetNEntries(); i++){
+      const AliCaloTrackMatchTable::Entry &entry = fMatchTable.GetEntry(i);
+      if(!entry.fMatched) continue;
+      cout << "  [" << entry.fTrackID << "/" << entry.fClusterID << ", " << i << "] - (" << entry.fDEta << "/" << entry.fDPhi << ")" << endl;
     }
     cout << "mapTrackToCluster" << endl;
     AliESDEvent *esdev = dynamic_cast<AliESDEvent*>(fInputEvent);
@@ -1574,11 +1397,13 @@ void AliCaloTrackMatcher::DebugMatching(){
       cout << itr << " (" << tCharge << ") - " << GetNMatchedClusterIDsForTrack(fInputEvent,inTrack->GetID(),5,-5,0.2,-0.4) << "\t\t";
     }
     cout << endl;
-    multimap<Int_t,Int_t>::iterator it;
-    for (it=fMapTrackToCluster.begin(); it!=fMapTrackToCluster.end(); ++it) cout << it->first << " => " << it->second << '\n';
-    cout << "mapClusterToTrack" << endl;
-    Int_t tempClus = it->second;
-    for (it=fMapClusterToTrack.begin(); it!=fMapClusterToTrack.end(); ++it) cout << it->first << " => " << it->second << '\n';
+    Int_t tempClus = -1;
+    for (Int_t i = 0; i < fMatchTable.GetNEntries(); i++){
+      const AliCaloTrackMatchTable::Entry &entry = fMatchTable.GetEntry(i);
+      if(!entry.fMatched) continue;
+      cout << entry.fTrack << " => " << entry.fClusterID << '\n';
+      tempClus = entry.fClusterID;
+    }
     vector<Int_t> tempTracks = GetMatchedTrackIDsForCluster(fInputEvent,tempClus, 5, -5, 0.2, -0.4);
     for(UInt_t iJ=0; iJ<tempTracks.size();iJ++){
       cout << tempClus << " - " << tempTracks.at(iJ) << endl;
@@ -4,6 +4,7 @@
 #include "AliAnalysisTaskSE.h"
 #include "AliEMCALGeometry.h"
 #include "AliPHOSGeometry.h"
+#include "AliCaloTrackMatchTable.h"
 #include <vector>
 #include <map>
 #include <utility>
@@ -80,11 +81,6 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     Int_t              GetRunningMode() {return fRunningMode;}
     Bool_t             GetNegativeIDAllowed() {return fNegativeTrackIDAllowed;}
   private:
-    //typedefs
-    typedef pair<Int_t, Int_t> pairInt;
-    typedef pair<Float_t, Float_t> pairFloat;
-    typedef map<pairInt, Int_t> mapT;
-
     AliCaloTrackMatcher (const AliCaloTrackMatcher&); // not implemented
     AliCaloTrackMatcher & operator=(const AliCaloTrackMatcher&); // not implemented
 
@@ -92,6 +88,7 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     void Initialize(Int_t runNumber);
     void ProcessEvent(AliVEvent *event);
     void SetLogBinningYTH2(TH2* histoRebin);
+    Int_t GetTrackPosition(AliVEvent *event, Int_t trackID, Bool_t hybridOnly);
 
     // debug methods
     void DebugMatching();
@@ -120,21 +117,16 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
 
     TClonesArray*         fArrClusters;            //! array with clusters
 
-    multimap<Int_t,Int_t> fMapTrackToCluster;      //! connects a given track ID with all associated cluster IDs
-    multimap<Int_t,Int_t> fMapClusterToTrack;      //! connects a given cluster ID with all associated track IDs
-
-    Int_t                 fNEntries;               //! number of current TrackID/ClusterID -> Eta/Phi connections
-    vector<pairFloat>     fVectorDeltaEtaDeltaPhi; //! vector of all matching residuals for a specific TrackID/ClusterID
-    mapT                  fMap_TrID_ClID_ToIndex;  //! map tuple of (trackID,clusterID) to index in vector fVectorDeltaEtaDeltaPhi
+    AliCaloTrackMatchTable fMatchTable;            //! track <-> cluster associations with their matching residuals
 
     // for cluster <-> V0-track matching (running with different mass hypthesis)
-    multimap<Int_t,Int_t> fSecMapTrackToCluster;      //! connects a given secondary track ID with all associated cluster IDs
-    multimap<Int_t,Int_t> fSecMapClusterToTrack;      //! connects a given cluster ID with all associated secondary track IDs
+    AliCaloTrackMatchTable fSecMatchTable;         //! V0-track <-> cluster associations with their matching residuals, and failed matchings
 
-    Int_t                 fSecNEntries;               //! number of current V0-trackIDs/clusterID -> Eta/Phi connections
-    vector<pairFloat>     fSecVectorDeltaEtaDeltaPhi; //! vector of all matching residuals for a specific V0-trackIDs/clusterID
-    mapT                  fSecMap_TrID_ClID_ToIndex;  //! map tuple of (V0-trackID,clusterID) to index in vector fSecVectorDeltaEtaDeltaPhi
-    mapT                  fSecMap_TrID_ClID_AlreadyTried; //! map tuple of (V0-trackID,clusterID) to matching outcome, successful or not
+    // for AOD, position in the event of each track ID
+    Bool_t                fTrackPositionFilled;    //! positions filled for the current event
+    Int_t                 fTrackIDOffset;          //! smallest track ID in the event
+    vector<Int_t>         fTrackPosition;          //! position of the first track with ID (fTrackIDOffset + index), only hybrid tracks for running mode 7
+    vector<Int_t>         fSecTrackPosition;       //! position of the first track with ID (fTrackIDOffset + index)
 
     //histos
     TList*                fListHistos;             //! list with histogram(s)
@@ -69,6 +69,12 @@ ClassImp(AliConvEventCuts)
 /// \endcond
 
 
+AliVEvent*         AliConvEventCuts::fgHeaderLookupEvent  = 0x0;
+Long64_t           AliConvEventCuts::fgHeaderLookupEntry  = -1;
+Long64_t           AliConvEventCuts::fgHeaderLookupSerial = 0;
+std::vector<Int_t> AliConvEventCuts::fgHeaderLookupLabel;
+std::vector<Int_t> AliConvEventCuts::fgHeaderLookupChain;
+
 const char* AliConvEventCuts::fgkCutNames[AliConvEventCuts::kNCuts] = {
   "HeavyIon",                     //0
   "CentralityMin",                //1
@@ -211,7 +217,9 @@ AliConvEventCuts::AliConvEventCuts(const char *name,const char *title) :
   hReweightMultData(NULL),
   hReweightMultMC(NULL),
   fPHOSTrigger(kPHOSAny),
-  fDebugLevel(0)
+  fDebugLevel(0),
+  fParticleHeaderClass(),
+  fParticleHeaderClassSerial(-1)
 {
   for(Int_t jj=0;jj<kNCuts;jj++){fCuts[jj]=0;}
   fCutString=new TObjString((GetCutNumber()).Data());
@@ -353,7 +361,9 @@ AliConvEventCuts::AliConvEventCuts(const AliConvEventCuts &ref) :
   hReweightMultData(ref.hReweightMultData),
   hReweightMultMC(ref.hReweightMultMC),
   fPHOSTrigger(kPHOSAny),
-  fDebugLevel(ref.fDebugLevel)
+  fDebugLevel(ref.fDebugLevel),
+  fParticleHeaderClass(),
+  fParticleHeaderClassSerial(-1)
 {
   // Copy Constructor
   for(Int_t jj=0;jj<kNCuts;jj++){fCuts[jj]=ref.fCuts[jj];}
@@ -6098,6 +6108,9 @@ void AliConvEventCuts::GetNotRejectedParticles(Int_t rejection, TList *HeaderLis
     return;
   }
 
+  // the header ranges change, the classes of the particles have to be looked up again
+  fParticleHeaderClassSerial  = -1;
+
   if(fNotRejectedStart){
     delete[] fNotRejectedStart;
     fNotRejectedStart         = NULL;
@@ -6436,6 +6449,29 @@ Int_t AliConvEventCuts::IsParticleFromBGEvent(Int_t index, AliMCEvent *mcEvent,
   //   if (debug > 2 ) cout << index << endl;
   if(index < 0) return 0; // No Particle
 
+  // class of the particle from the per event lookup, the loop below is only used for the debug
+  // output or if the lookup is not available
+  if(debug < 2){
+    Int_t lookupLabel = GetHeaderLookupLabel(index, mcEvent, InputEvent);
+    if(lookupLabel > -2){
+      if(fParticleHeaderClassSerial != fgHeaderLookupSerial){
+        fParticleHeaderClass.assign(fgHeaderLookupLabel.size(), -1);
+        fParticleHeaderClassSerial  = fgHeaderLookupSerial;
+      }
+      Char_t &headerClass = fParticleHeaderClass[index];
+      if(headerClass < 0){
+        headerClass = 0;
+        for(Int_t i = 0;i<fnHeaders;i++){
+          if(lookupLabel >= fNotRejectedStart[i] && lookupLabel <= fNotRejectedEnd[i]){
+            headerClass = 1;
+            if(i == 0) headerClass = 2; // MB Header
+          }
+        }
+      }
+      return headerClass;
+    }
+  }
+
   Int_t accepted = 0;
   if(!InputEvent || InputEvent->IsA()==AliESDEvent::Class()){
     if(!mcEvent) return 0; // no mcEvent available, return 0
@@ -6503,7 +6539,10 @@ TString AliConvEventCuts::GetParticleHeaderName(Int_t index, AliMCEvent *mcEvent
     AliGenEventHeader* gh     = 0;
     if(!InputEvent || InputEvent->IsA()==AliESDEvent::Class()){
       if(!mcEvent) return headername; // no mcEvent available, return 0
-      if(index >= mcEvent->GetNumberOfPrimaries()){ // initial particle is secondary particle
+      Int_t lookupLabel = GetHeaderLookupLabel(index, mcEvent, InputEvent);
+      if(lookupLabel == -1) return headername; // material particle
+      if(lookupLabel >= 0) index = lookupLabel;
+      else if(index >= mcEvent->GetNumberOfPrimaries()){ // initial particle is secondary particle
         if( ((TParticle*)mcEvent->Particle(index))->GetMother(0) < 0) return headername; // material particle, return 0
         return GetParticleHeaderName(((TParticle*)mcEvent->Particle(index))->GetMother(0),mcEvent,InputEvent, debug);
       }
@@ -6550,6 +6589,75 @@ TString AliConvEventCuts::GetParticleHeaderName(Int_t index, AliMCEvent *mcEvent
   return headername;
 }
 
+// returns the label of the primary a particle comes from, the one compared to the header ranges:
+// the label itself for ESD primaries, the MC label for AOD primaries, -1 for particles from the
+// material. The labels are kept in a table per event shared by all instances of the cuts, each
+// mother chain is only followed once per event.
+// Returns -2 if there is no table (no analysis manager, no MC particles, label out of range).
+//_________________________________________________________________________
+Int_t AliConvEventCuts::GetHeaderLookupLabel(Int_t index, AliMCEvent *mcEvent, AliVEvent *InputEvent){
+
+  AliAnalysisManager *mgr     = AliAnalysisManager::GetAnalysisManager();
+  if(!mgr || index < 0) return -2;
+
+  Bool_t isAOD                = kFALSE;
+  AliVEvent *event            = 0x0;
+  Int_t nParticles            = 0;
+  if(!InputEvent || InputEvent->IsA()==AliESDEvent::Class()){
+    if(!mcEvent) return -2;
+    event                     = mcEvent;
+    nParticles                = mcEvent->GetNumberOfTracks();
+  } else if(InputEvent->IsA()==AliAODEvent::Class()){
+    if(!fAODMCTrackArray) fAODMCTrackArray = dynamic_cast<TClonesArray*>(InputEvent->FindListObject(AliAODMCParticle::StdBranchName()));
+    if(!fAODMCTrackArray) return -2;
+    isAOD                     = kTRUE;
+    event                     = InputEvent;
+    nParticles                = fAODMCTrackArray->GetEntriesFast();
+  } else {
+    return -2;
+  }
+  if(index >= nParticles) return -2;
+
+  // new event: the table is filled again while the particles are looked up
+  if(event != fgHeaderLookupEvent || mgr->GetCurrentEntry() != fgHeaderLookupEntry || nParticles != (Int_t)fgHeaderLookupLabel.size()){
+    fgHeaderLookupEvent       = event;
+    fgHeaderLookupEntry       = mgr->GetCurrentEntry();
+    fgHeaderLookupLabel.assign(nParticles, -2);
+    fgHeaderLookupSerial++;
+  }
+  if(fgHeaderLookupLabel[index] > -2) return fgHeaderLookupLabel[index];
+
+  Int_t nPrimaries            = isAOD ? 0 : mcEvent->GetNumberOfPrimaries();
+  Int_t label                 = index;
+  Int_t lookupLabel           = -1;
+  fgHeaderLookupChain.clear();
+  while(label >= 0 && label < nParticles){
+    if(fgHeaderLookupLabel[label] > -2){
+      lookupLabel             = fgHeaderLookupLabel[label];
+      break;
+    }
+    fgHeaderLookupChain.push_back(label);
+    if((Int_t)fgHeaderLookupChain.size() > nParticles) break; // broken mother chain
+    if(isAOD){
+      AliAODMCParticle *aodMCParticle = static_cast<AliAODMCParticle*>(fAODMCTrackArray->At(label));
+      if(!aodMCParticle) break; // no particle
+      if(aodMCParticle->IsPrimary()){
+        lookupLabel           = TMath::Abs(aodMCParticle->GetLabel());
+        break;
+      }
+      label                   = aodMCParticle->GetMother();
+    } else {
+      if(label < nPrimaries){
+        lookupLabel           = label;
+        break;
+      }
+      label                   = ((TParticle*)mcEvent->Particle(label))->GetMother(0);
+    }
+  }
+  for(UInt_t i = 0; i < fgHeaderLookupChain.size(); i++) fgHeaderLookupLabel[fgHeaderLookupChain[i]] = lookupLabel;
+  return lookupLabel;
+}
+
 //_________________________________________________________________________
 Int_t AliConvEventCuts::IsEventAcceptedByCut(AliConvEventCuts *ReaderCuts, AliVEvent *event, AliMCEvent *mcEvent, Int_t isHeavyIon, Bool_t isEMCALAnalysis){
 
@@ -3,6 +3,7 @@
 
 // Class handling all kinds of selection cuts for Gamma Conversion analysis
 // Authors: Friederike Bock, Daniel Muehlheim
+#include <vector>
 #include <TObjString.h>
 #include "AliAODTrack.h"
 #include "AliESDtrack.h"
@@ -604,6 +605,10 @@ class AliConvEventCuts : public AliAnalysisCuts {
                                       AliVEvent *event = 0x0,
                                       Int_t debug = 0
                                    );
+      Int_t   GetHeaderLookupLabel(   Int_t index,
+                                      AliMCEvent *mcEvent,
+                                      AliVEvent *event = 0x0
+                                   );
 
       Bool_t PhotonPassesAddedParticlesCriterion(AliMCEvent             *theMCEvent,
                                                  AliVEvent              *theInputEvent,
@@ -796,6 +801,15 @@ class AliConvEventCuts : public AliAnalysisCuts {
       TH1D*                       hReweightMultMC;                        ///< histogram input for reweighting Pi0
       phosTriggerType             fPHOSTrigger;                           // Kind of PHOS trigger: L0,L1
       Int_t                       fDebugLevel;                            ///< debug level for interactive debugging
+      // per event lookup of the header of the MC particles
+      std::vector<Char_t>         fParticleHeaderClass;                   //! IsParticleFromBGEvent for each label, -1 if not yet known
+      Long64_t                    fParticleHeaderClassSerial;             //! fgHeaderLookupSerial the classes belong to
+
+      static AliVEvent*           fgHeaderLookupEvent;                    //! event of the label table
+      static Long64_t             fgHeaderLookupEntry;                    //! entry of the analysis manager of the label table
+      static Long64_t             fgHeaderLookupSerial;                   //! incremented for each new label table
+      static std::vector<Int_t>   fgHeaderLookupLabel;                    //! label looked up in the header ranges for each label, -1 for none, -2 if not yet known
+      static std::vector<Int_t>   fgHeaderLookupChain;                    //! mother chain being resolved
   private:
 
       /// \cond CLASSIMP
@@ -22,6 +22,7 @@
 #pragma link C++ class AliConversionMesonCuts+;
 #pragma link C++ class AliDalitzElectronCuts+;
 #pragma link C++ class AliDalitzElectronSelector+;
+#pragma link C++ class AliCaloTrackMatchTable+;
 #pragma link C++ class AliCaloTrackMatcher+;
 #pragma link C++ class AliPhotonIsolation+;
 
@@ -69,7 +69,11 @@
 #include "AliAODv0.h"
 #include "AliCodeTimer.h"
 #include "AliMultSelection.h"
+#include <TROOT.h>
 #include <cstring>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 /// \cond CLASSIMP
 ClassImp(AliAnalysisVertexingHF);
@@ -154,6 +158,20 @@ fOKInvMassLctoV0(kFALSE),
 fnTrksTotal(0),
 fnSeleTrksTotal(0),
 fMakeReducedRHF(kFALSE),
+fNThreads(0),
+fWorkers(0x0),
+fIsWorker(kFALSE),
+fTrkTableSize(0),
+fTrkTableCapacity(0),
+fTrkTable(0x0),
+fTrkTablePx(0x0),
+fTrkTablePy(0x0),
+fTrkTablePz(0x0),
+fTrkTableEPi(0x0),
+fTrkTableEK(0x0),
+fTrkTableEP(0x0),
+fUse3ProngPresel(kFALSE),
+f3ProngPreselMinPt2(0.),
 fMassDzero(0.),
 fMassDplus(0.),
 fMassDs(0.),
@@ -165,6 +183,8 @@ fMassK(0.)
 {
   /// Default constructor
 
+  for(Int_t i=0; i<6; i++) f3ProngPreselMass2[i]=0.;
+  Reset3ProngCounters();
   Double_t d02[2]={0.,0.};
   Double_t d03[3]={0.,0.,0.};
   Double_t d04[4]={0.,0.,0.,0.};
@@ -253,6 +273,20 @@ fOKInvMassLctoV0(source.fOKInvMassLctoV0),
 fnTrksTotal(0),
 fnSeleTrksTotal(0),
 fMakeReducedRHF(kFALSE),
+fNThreads(source.fNThreads),
+fWorkers(0x0),
+fIsWorker(kFALSE),
+fTrkTableSize(0),
+fTrkTableCapacity(0),
+fTrkTable(0x0),
+fTrkTablePx(0x0),
+fTrkTablePy(0x0),
+fTrkTablePz(0x0),
+fTrkTableEPi(0x0),
+fTrkTableEK(0x0),
+fTrkTableEP(0x0),
+fUse3ProngPresel(kFALSE),
+f3ProngPreselMinPt2(0.),
 fMassDzero(source.fMassDzero),
 fMassDplus(source.fMassDplus),
 fMassDs(source.fMassDs),
@@ -265,6 +299,8 @@ fMassK(source.fMassK)
   ///
   /// Copy constructor
   ///
+  for(Int_t i=0; i<6; i++) f3ProngPreselMass2[i]=0.;
+  Reset3ProngCounters();
 }
 //--------------------------------------------------------------------------
 AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVertexingHF &source)
@@ -348,6 +384,7 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fOKInvMassDstar = source.fOKInvMassDstar;
   fOKInvMassD0to4p = source.fOKInvMassD0to4p;
   fOKInvMassLctoV0 = source.fOKInvMassLctoV0;
+  fNThreads = source.fNThreads;
   fMassDzero = source.fMassDzero;
   fMassDplus = source.fMassDplus;
   fMassDs = source.fMassDs;
@@ -362,6 +399,14 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
 //----------------------------------------------------------------------------
 AliAnalysisVertexingHF::~AliAnalysisVertexingHF() {
   /// Destructor
+  if(fIsWorker) {
+    // event data and track filters belong to the parent object
+    fV1=0; fV1AOD=0; fAODMap=0; fTrkTable=0;
+    fTrackFilter=0; fTrackFilter2prongCentral=0; fTrackFilter3prongCentral=0;
+    fTrackFilterSoftPi=0; fTrackFilterBachelor=0;
+  }
+  if(fWorkers) { delete fWorkers; fWorkers=0; }
+  if(fTrkTable) { delete [] fTrkTable; fTrkTable=0; }
   if(fV1) { delete fV1; fV1=0; }
   if(fV1AOD) { delete fV1AOD; fV1AOD=0; }
   delete fVertexerTracks;
@@ -512,7 +557,6 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   Int_t iVerticesHF=0,iD0toKpi=0,iJPSItoEle=0,i3Prong=0,i4Prong=0,iDstar=0,iCascades=0,iLikeSign2Prong=0,iLikeSign3Prong=0;
   aodVerticesHFTClArr->Delete();
   iVerticesHF = aodVerticesHFTClArr->GetEntriesFast();
-  TClonesArray &verticesHFRef = *aodVerticesHFTClArr;
   if(fD0toKpi || fDstar)   {
     aodD0toKpiTClArr->Delete();
     iD0toKpi = aodD0toKpiTClArr->GetEntriesFast();
@@ -546,32 +590,6 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     iLikeSign3Prong = aodLikeSign3ProngTClArr->GetEntriesFast();
   }
 
-  TClonesArray &aodD0toKpiRef        = *aodD0toKpiTClArr;
-  TClonesArray &aodJPSItoEleRef      = *aodJPSItoEleTClArr;
-  TClonesArray &aodCharm3ProngRef    = *aodCharm3ProngTClArr;
-  TClonesArray &aodCharm4ProngRef    = *aodCharm4ProngTClArr;
-  TClonesArray &aodDstarRef          = *aodDstarTClArr;
-  TClonesArray &aodCascadesRef       = *aodCascadesTClArr;
-  TClonesArray &aodLikeSign2ProngRef = *aodLikeSign2ProngTClArr;
-  TClonesArray &aodLikeSign3ProngRef = *aodLikeSign3ProngTClArr;
-
-
-  AliAODRecoDecayHF2Prong *io2Prong  = 0;
-  AliAODRecoDecayHF3Prong *io3Prong  = 0;
-  AliAODRecoDecayHF4Prong *io4Prong  = 0;
-  AliAODRecoCascadeHF     *ioCascade = 0;
-
-  Int_t    iTrkP1,iTrkP2,iTrkN1,iTrkN2,iTrkSoftPi,trkEntries,iv0,nv0;
-  Double_t xdummy,ydummy,dcap1n1,dcap1n2,dcap2n1,dcap1p2,dcan1n2,dcap2n2,dcaCasc;
-  Bool_t   okD0=kFALSE,okJPSI=kFALSE,ok3Prong=kFALSE,ok4Prong=kFALSE;
-  Bool_t   okDstar=kFALSE,okD0fromDstar=kFALSE;
-  Bool_t   okCascades=kFALSE;
-  AliESDtrack *postrack1 = 0;
-  AliESDtrack *postrack2 = 0;
-  AliESDtrack *negtrack1 = 0;
-  AliESDtrack *negtrack2 = 0;
-  AliESDtrack *trackPi   = 0;
-  Double_t mompos1[3],mompos2[3],momneg1[3],momneg2[3];
   Float_t dcaMax = fCutsD0toKpi->GetDCACut();
   if(fCutsJpsitoee) dcaMax=TMath::Max(dcaMax,fCutsJpsitoee->GetDCACut());
   if(fCutsDplustoKpipi) dcaMax=TMath::Max(dcaMax,fCutsDplustoKpipi->GetDCACut());
@@ -583,6 +601,8 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   AliDebug(2,Form(" dca cut set to %f cm",dcaMax));
 
 
+  Int_t    trkEntries,nv0;
+
   // get Bz
   fBzkG = (Double_t)event->GetMagneticField();
   if(!fVertexerTracks){
@@ -630,27 +650,14 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   fnSeleTrksTotal += nSeleTrks;
 
 
-  TObjArray *twoTrackArray1    = new TObjArray(2);
-  TObjArray *twoTrackArray2    = new TObjArray(2);
-  TObjArray *twoTrackArrayV0   = new TObjArray(2);
-  TObjArray *twoTrackArrayCasc = new TObjArray(2);
-  TObjArray *threeTrackArray   = new TObjArray(3);
-  TObjArray *fourTrackArray    = new TObjArray(4);
-
-  Double_t dispersion;
-  Bool_t isLikeSign2Prong=kFALSE,isLikeSign3Prong=kFALSE;
-
-  AliAODRecoDecayHF   *rd = 0;
-  AliAODRecoCascadeHF *rc = 0;
-  AliAODv0            *v0 = 0;
-  AliESDv0         *esdV0 = 0;
-
-  Bool_t massCutOK=kTRUE;
-  
   fMinPt3Prong=0.;
   fMinPt3Prong=TMath::Min(fCutsDplustoKpipi->GetMinPtCandidate(),fCutsDstoKKpi->GetMinPtCandidate());
   fMinPt3Prong=TMath::Min(fMinPt3Prong,fCutsLctopKpi->GetMinPtCandidate());
 
+  // momenta at the primary vertex of the selected tracks, for the
+  // preselection of the triplets
+  FillTrackTable(tracksAtVertex,nSeleTrks);
+
   Double_t minPtV0=0.;
   if(fCutsLctoV0) minPtV0=fCutsLctoV0->GetMinV0PtCut();
   if(fCutsDstoK0sK){
@@ -662,892 +669,1357 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     if(minPtV0fromDp<minPtV0) minPtV0=minPtV0fromDp;
   }
    
-  // LOOP ON  POSITIVE  TRACKS
-  for(iTrkP1=0; iTrkP1<nSeleTrks; iTrkP1++) {
 
-    //if(iTrkP1%1==0) AliDebug(1,Form("  1st loop on pos: track number %d of %d",iTrkP1,nSeleTrks));
-    //if(iTrkP1%1==0) printf("  1st loop on pos: track number %d of %d\n",iTrkP1,nSeleTrks);
+  TClonesArray *candArrays[kNCandArrays]={aodVerticesHFTClArr,aodD0toKpiTClArr,aodJPSItoEleTClArr,
+					  aodCharm3ProngTClArr,aodCharm4ProngTClArr,aodDstarTClArr,
+					  aodCascadesTClArr,aodLikeSign2ProngTClArr,aodLikeSign3ProngTClArr};
+  Int_t nCand[kNCandArrays]={iVerticesHF,iD0toKpi,iJPSItoEle,i3Prong,i4Prong,iDstar,
+			     iCascades,iLikeSign2Prong,iLikeSign3Prong};
 
-    // get track from tracks array
-    postrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP1);
-    postrack1->GetPxPyPz(mompos1);
+  Int_t nThreads=fNThreads;
+  if(nThreads>1 && !CanRunInThreads()) {
+    AliWarning("Candidate finding in threads needs reduced RHF output, no event mixing, no primary vertex recomputation and no KF vertexing: running serially");
+    nThreads=0;
+  }
 
-    // Make cascades with V0+track
-    //
-    if(fCascades) {
-      // loop on V0's
-      for(iv0=0; iv0<nv0; iv0++){
+  if(nThreads>1) {
+    FindCandidatesInThreads(event,seleTrksArray,tracksAtVertex,seleFlags,evtNumber,
+			    nSeleTrks,trkEntries,nv0,dcaMax,minPtV0,candArrays,nCand);
+  } else {
+    // LOOP ON  POSITIVE  TRACKS
+    for(Int_t iTrkP1=0; iTrkP1<nSeleTrks; iTrkP1++) {
+      FindCandidatesForPosTrack(iTrkP1,event,seleTrksArray,tracksAtVertex,seleFlags,evtNumber,
+				nSeleTrks,trkEntries,nv0,dcaMax,minPtV0,candArrays,nCand);
+    }
+  }
 
-	//AliDebug(1,Form("   loop on v0s for track number %d and v0 number %d",iTrkP1,iv0));
-	if ( !TESTBIT(seleFlags[iTrkP1],kBitBachelor) ) continue;
 
-	if ( fUsePIDforLc2V0 && !TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) ) continue; //clm
-        
-        // Get the V0
-        if(fInputAOD) {
-          v0 = ((AliAODEvent*)event)->GetV0(iv0);
-        } else {
-          esdV0 = ((AliESDEvent*)event)->GetV0(iv0);
-        }
-        if ( (!v0 || !v0->IsA()->InheritsFrom("AliAODv0") ) &&
-            (!esdV0 || !esdV0->IsA()->InheritsFrom("AliESDv0") ) ) continue;
-
-        if ( v0 && ((v0->GetOnFlyStatus() == kTRUE  && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOfflineV0s) ||
-                    (v0->GetOnFlyStatus() == kFALSE && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOnTheFlyV0s)) ) continue;
-
-        if ( esdV0 && ((esdV0->GetOnFlyStatus() == kTRUE  && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOfflineV0s) ||
-                       ( esdV0->GetOnFlyStatus() == kFALSE && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOnTheFlyV0s)) ) continue;
-
-	if(v0->Pt()<minPtV0) continue;
-        // Get the tracks that form the V0
-        //  ( parameters at primary vertex )
-        //   and define an AliExternalTrackParam out of them
-
-        if(fInputAOD){
-          AliAODTrack *posVV0track = (AliAODTrack*)(v0->GetDaughter(0));
-          AliAODTrack *negVV0track = (AliAODTrack*)(v0->GetDaughter(1));
-          if( !posVV0track || !negVV0track ) continue;
-          //
-          // Apply some basic V0 daughter criteria
-          //
-          // bachelor must not be a v0-track
-          if (posVV0track->GetID() == postrack1->GetID() ||
-              negVV0track->GetID() == postrack1->GetID()) continue;
-          // reject like-sign v0
-          if ( posVV0track->Charge() == negVV0track->Charge() ) continue;
-          // avoid ghost TPC tracks
-          if(!(posVV0track->GetStatus() & AliESDtrack::kTPCrefit) ||
-             !(negVV0track->GetStatus() & AliESDtrack::kTPCrefit)) continue;
-        }  else {
-          AliESDtrack *posVV0track = (AliESDtrack*)(event->GetTrack( esdV0->GetPindex() ));
-          AliESDtrack *negVV0track = (AliESDtrack*)(event->GetTrack( esdV0->GetNindex() ));
-          if( !posVV0track || !negVV0track ) continue;
-          //
-          // Apply some basic V0 daughter criteria
-          //
-          // bachelor must not be a v0-track
-          if (posVV0track->GetID() == postrack1->GetID() ||
-              negVV0track->GetID() == postrack1->GetID()) continue;
-          // reject like-sign v0
-          if ( posVV0track->Charge() == negVV0track->Charge() ) continue;
-          // avoid ghost TPC tracks
-          if(!(posVV0track->GetStatus() & AliESDtrack::kTPCrefit) ||
-             !(negVV0track->GetStatus() & AliESDtrack::kTPCrefit)) continue;
-          //  reject kinks (only necessary on AliESDtracks)
-          if (posVV0track->GetKinkIndex(0)>0  || negVV0track->GetKinkIndex(0)>0) continue;
-
-          // Define the AODv0 from ESDv0 if reading ESDs
-	  twoTrackArrayV0->AddAt(posVV0track,0);
-	  twoTrackArrayV0->AddAt(negVV0track,1);
-          v0 = TransformESDv0toAODv0(esdV0,twoTrackArrayV0);
-	  twoTrackArrayV0->Clear();
-        }
+  //  AliDebug(1,Form(" Total HF vertices in event = %d;",
+  //		  (Int_t)aodVerticesHFTClArr->GetEntriesFast()));
+  if(fD0toKpi) {
+    AliDebug(1,Form(" D0->Kpi in event = %d;",
+		    (Int_t)aodD0toKpiTClArr->GetEntriesFast()));
+  }
+  if(fJPSItoEle) {
+    AliDebug(1,Form(" JPSI->ee in event = %d;",
+		    (Int_t)aodJPSItoEleTClArr->GetEntriesFast()));
+  }
+  if(f3Prong) {
+    AliDebug(1,Form(" Charm->3Prong in event = %d;",
+		    (Int_t)aodCharm3ProngTClArr->GetEntriesFast()));
+  }
+  if(f4Prong) {
+    AliDebug(1,Form(" Charm->4Prong in event = %d;\n",
+		    (Int_t)aodCharm4ProngTClArr->GetEntriesFast()));
+  }
+  if(fDstar) {
+    AliDebug(1,Form(" D*->D0pi in event = %d;\n",
+		    (Int_t)aodDstarTClArr->GetEntriesFast()));
+  }
+  if(fCascades){
+    AliDebug(1,Form(" cascades -> v0 + track in event = %d;\n",
+		    (Int_t)aodCascadesTClArr->GetEntriesFast()));
+  }
+  if(fLikeSign) {
+    AliDebug(1,Form(" Like-sign 2Prong in event = %d;\n",
+		    (Int_t)aodLikeSign2ProngTClArr->GetEntriesFast()));
+  }
+  if(fLikeSign3prong && f3Prong) {
+    AliDebug(1,Form(" Like-sign 3Prong in event = %d;\n",
+		    (Int_t)aodLikeSign3ProngTClArr->GetEntriesFast()));
+  }
 
-        // Define the V0 (neutral) track
-        AliNeutralTrackParam *trackV0=NULL;
-        if(fInputAOD) {
-          const AliVTrack *trackVV0 = dynamic_cast<const AliVTrack*>(v0);
-          if(trackVV0)  trackV0 = new AliNeutralTrackParam(trackVV0);
-        } else {
-          Double_t xyz[3], pxpypz[3];
-          esdV0->XvYvZv(xyz);
-          esdV0->PxPyPz(pxpypz);
-          Double_t cv[21]; for(int i=0; i<21; i++) cv[i]=0;
-          trackV0 = new AliNeutralTrackParam(xyz,pxpypz,cv,0);
-        }
 
+  delete [] seleFlags; seleFlags=NULL;
+  if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
+  tracksAtVertex.Delete();
 
-        // Fill in the object array to create the cascade
-        twoTrackArrayCasc->AddAt(postrack1,0);
-        twoTrackArrayCasc->AddAt(trackV0,1);
-        if(fMassCutBeforeVertexing){
-          Bool_t passMassCut = SelectInvMassAndPtCascade(twoTrackArrayCasc);
-          if(!passMassCut){
-            delete trackV0; trackV0=NULL;
-            if(!fInputAOD) {delete v0; v0=NULL;}
-            twoTrackArrayCasc->Clear();
-            continue;
-          }
-        }
-	// Compute the cascade vertex
-        AliAODVertex *vertexCasc = 0;
-        if(fFindVertexForCascades) {
-          // DCA between the two tracks
-          dcaCasc = postrack1->GetDCA(trackV0,fBzkG,xdummy,ydummy);
-          // Vertexing+
-          vertexCasc = ReconstructSecondaryVertex(twoTrackArrayCasc,dispersion,kFALSE);
-        } else {
-          // assume Cascade decays at the primary vertex
-          Double_t pos[3],cov[6],chi2perNDF;
-          fV1->GetXYZ(pos);
-          fV1->GetCovMatrix(cov);
-          chi2perNDF = fV1->GetChi2toNDF();
-          vertexCasc = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,2);
-          dcaCasc = 0.;
-        }
-        if(!vertexCasc) {
+  if(fInputAOD) {
+    seleTrksArray.Delete();
+    if(fAODMap) { delete [] fAODMap; fAODMap=NULL; }
+  }
+
+
+  //printf("Trks: total %d  sele %d\n",fnTrksTotal,fnSeleTrksTotal);
+
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FindCandidatesForPosTrack(Int_t iTrkP1,AliVEvent *event,
+						       TObjArray &seleTrksArray,
+						       const TObjArray &tracksAtVertex,
+						       const UChar_t *seleFlags,
+						       const Int_t *evtNumber,
+						       Int_t nSeleTrks,Int_t trkEntries,Int_t nv0,
+						       Float_t dcaMax,Double_t minPtV0,
+						       TClonesArray **candArrays,Int_t *nCand)
+{
+  /// Build the candidates whose first positive track is the selected track
+  /// iTrkP1 (one iteration of the loop on positive tracks of FindCandidates).
+  /// The candidates are appended to candArrays, nCand holds the number of
+  /// entries of each array.
+  /// In the worker threads the result depends only on iTrkP1 and on the
+  /// event, not on the tracks processed before: the first positive track is
+  /// set back to the primary vertex and the ESD V0 daughters are copied.
+  /// The serial loop keeps working on the tracks as they are
+  //AliCodeTimerAuto("",0);
+
+  TClonesArray &verticesHFRef        = *candArrays[kArrVerticesHF];
+  TClonesArray &aodD0toKpiRef        = *candArrays[kArrD0toKpi];
+  TClonesArray &aodJPSItoEleRef      = *candArrays[kArrJPSItoEle];
+  TClonesArray &aodCharm3ProngRef    = *candArrays[kArrCharm3Prong];
+  TClonesArray &aodCharm4ProngRef    = *candArrays[kArrCharm4Prong];
+  TClonesArray &aodDstarRef          = *candArrays[kArrDstar];
+  TClonesArray &aodCascadesRef       = *candArrays[kArrCascades];
+  TClonesArray &aodLikeSign2ProngRef = *candArrays[kArrLikeSign2Prong];
+  TClonesArray &aodLikeSign3ProngRef = *candArrays[kArrLikeSign3Prong];
+  Int_t &iVerticesHF     = nCand[kArrVerticesHF];
+  Int_t &iD0toKpi        = nCand[kArrD0toKpi];
+  Int_t &iJPSItoEle      = nCand[kArrJPSItoEle];
+  Int_t &i3Prong         = nCand[kArrCharm3Prong];
+  Int_t &i4Prong         = nCand[kArrCharm4Prong];
+  Int_t &iDstar          = nCand[kArrDstar];
+  Int_t &iCascades       = nCand[kArrCascades];
+  Int_t &iLikeSign2Prong = nCand[kArrLikeSign2Prong];
+  Int_t &iLikeSign3Prong = nCand[kArrLikeSign3Prong];
+
+  AliAODRecoDecayHF2Prong *io2Prong  = 0;
+  AliAODRecoDecayHF3Prong *io3Prong  = 0;
+  AliAODRecoDecayHF4Prong *io4Prong  = 0;
+  AliAODRecoCascadeHF     *ioCascade = 0;
+
+  Int_t    iTrkP2,iTrkN1,iTrkN2,iTrkSoftPi,iv0;
+  Double_t xdummy,ydummy,dcap1n1,dcap1n2,dcap2n1,dcap1p2,dcan1n2,dcap2n2,dcaCasc;
+  Bool_t   okD0=kFALSE,okJPSI=kFALSE,ok3Prong=kFALSE,ok4Prong=kFALSE;
+  Bool_t   okDstar=kFALSE,okD0fromDstar=kFALSE;
+  Bool_t   okCascades=kFALSE;
+  AliESDtrack *postrack1 = 0;
+  AliESDtrack *postrack2 = 0;
+  AliESDtrack *negtrack1 = 0;
+  AliESDtrack *negtrack2 = 0;
+  AliESDtrack *trackPi   = 0;
+  Double_t mompos1[3],mompos2[3],momneg1[3],momneg2[3];
+
+  TObjArray *twoTrackArrayV0   = new TObjArray(2);
+  TObjArray *twoTrackArrayCasc = new TObjArray(2);
+
+  Double_t dispersion;
+  Bool_t isLikeSign2Prong=kFALSE,isLikeSign3Prong=kFALSE;
+
+  AliAODRecoDecayHF   *rd = 0;
+  AliAODRecoCascadeHF *rc = 0;
+  AliAODv0            *v0 = 0;
+  AliESDv0         *esdV0 = 0;
+
+  Bool_t massCutOK=kTRUE;
+
+  //if(iTrkP1%1==0) AliDebug(1,Form("  1st loop on pos: track number %d of %d",iTrkP1,nSeleTrks));
+  //if(iTrkP1%1==0) printf("  1st loop on pos: track number %d of %d\n",iTrkP1,nSeleTrks);
+
+  // get track from tracks array
+  postrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP1);
+  // set it back to the primary vertex (it may have been propagated as a
+  // daughter of the candidates of previous positive tracks), so that the
+  // result does not depend on the order in which the tracks are processed
+  SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+  postrack1->GetPxPyPz(mompos1);
+
+  // Make cascades with V0+track
+  //
+  if(fCascades) {
+    // loop on V0's
+    for(iv0=0; iv0<nv0; iv0++){
+
+      //AliDebug(1,Form("   loop on v0s for track number %d and v0 number %d",iTrkP1,iv0));
+      if ( !TESTBIT(seleFlags[iTrkP1],kBitBachelor) ) continue;
+
+      if ( fUsePIDforLc2V0 && !TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) ) continue; //clm
+      
+      // Get the V0
+      if(fInputAOD) {
+        v0 = ((AliAODEvent*)event)->GetV0(iv0);
+      } else {
+        esdV0 = ((AliESDEvent*)event)->GetV0(iv0);
+      }
+      if ( (!v0 || !v0->IsA()->InheritsFrom("AliAODv0") ) &&
+          (!esdV0 || !esdV0->IsA()->InheritsFrom("AliESDv0") ) ) continue;
+
+      if ( v0 && ((v0->GetOnFlyStatus() == kTRUE  && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOfflineV0s) ||
+                  (v0->GetOnFlyStatus() == kFALSE && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOnTheFlyV0s)) ) continue;
+
+      if ( esdV0 && ((esdV0->GetOnFlyStatus() == kTRUE  && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOfflineV0s) ||
+                     ( esdV0->GetOnFlyStatus() == kFALSE && fV0TypeForCascadeVertex == AliRDHFCuts::kOnlyOnTheFlyV0s)) ) continue;
+
+      if(v0->Pt()<minPtV0) continue;
+      // Get the tracks that form the V0
+      //  ( parameters at primary vertex )
+      //   and define an AliExternalTrackParam out of them
+
+      if(fInputAOD){
+        AliAODTrack *posVV0track = (AliAODTrack*)(v0->GetDaughter(0));
+        AliAODTrack *negVV0track = (AliAODTrack*)(v0->GetDaughter(1));
+        if( !posVV0track || !negVV0track ) continue;
+        //
+        // Apply some basic V0 daughter criteria
+        //
+        // bachelor must not be a v0-track
+        if (posVV0track->GetID() == postrack1->GetID() ||
+            negVV0track->GetID() == postrack1->GetID()) continue;
+        // reject like-sign v0
+        if ( posVV0track->Charge() == negVV0track->Charge() ) continue;
+        // avoid ghost TPC tracks
+        if(!(posVV0track->GetStatus() & AliESDtrack::kTPCrefit) ||
+           !(negVV0track->GetStatus() & AliESDtrack::kTPCrefit)) continue;
+      }  else {
+        AliESDtrack *posVV0track = (AliESDtrack*)(event->GetTrack( esdV0->GetPindex() ));
+        AliESDtrack *negVV0track = (AliESDtrack*)(event->GetTrack( esdV0->GetNindex() ));
+        if( !posVV0track || !negVV0track ) continue;
+        //
+        // Apply some basic V0 daughter criteria
+        //
+        // bachelor must not be a v0-track
+        if (posVV0track->GetID() == postrack1->GetID() ||
+            negVV0track->GetID() == postrack1->GetID()) continue;
+        // reject like-sign v0
+        if ( posVV0track->Charge() == negVV0track->Charge() ) continue;
+        // avoid ghost TPC tracks
+        if(!(posVV0track->GetStatus() & AliESDtrack::kTPCrefit) ||
+           !(negVV0track->GetStatus() & AliESDtrack::kTPCrefit)) continue;
+        //  reject kinks (only necessary on AliESDtracks)
+        if (posVV0track->GetKinkIndex(0)>0  || negVV0track->GetKinkIndex(0)>0) continue;
+
+        // Define the AODv0 from ESDv0 if reading ESDs
+        // (the daughters are propagated: use copies, since the event tracks
+        // are also the selected tracks and are shared among the threads)
+        AliExternalTrackParam posV0par(*posVV0track);
+        AliExternalTrackParam negV0par(*negVV0track);
+        twoTrackArrayV0->AddAt(&posV0par,0);
+        twoTrackArrayV0->AddAt(&negV0par,1);
+        v0 = TransformESDv0toAODv0(esdV0,twoTrackArrayV0);
+        twoTrackArrayV0->Clear();
+      }
+
+      // Define the V0 (neutral) track
+      AliNeutralTrackParam *trackV0=NULL;
+      if(fInputAOD) {
+        const AliVTrack *trackVV0 = dynamic_cast<const AliVTrack*>(v0);
+        if(trackVV0)  trackV0 = new AliNeutralTrackParam(trackVV0);
+      } else {
+        Double_t xyz[3], pxpypz[3];
+        esdV0->XvYvZv(xyz);
+        esdV0->PxPyPz(pxpypz);
+        Double_t cv[21]; for(int i=0; i<21; i++) cv[i]=0;
+        trackV0 = new AliNeutralTrackParam(xyz,pxpypz,cv,0);
+      }
+
+
+      // Fill in the object array to create the cascade
+      twoTrackArrayCasc->AddAt(postrack1,0);
+      twoTrackArrayCasc->AddAt(trackV0,1);
+      if(fMassCutBeforeVertexing){
+        Bool_t passMassCut = SelectInvMassAndPtCascade(twoTrackArrayCasc);
+        if(!passMassCut){
           delete trackV0; trackV0=NULL;
           if(!fInputAOD) {delete v0; v0=NULL;}
           twoTrackArrayCasc->Clear();
           continue;
         }
+      }
+      // Compute the cascade vertex
+      AliAODVertex *vertexCasc = 0;
+      if(fFindVertexForCascades) {
+        // DCA between the two tracks
+        dcaCasc = postrack1->GetDCA(trackV0,fBzkG,xdummy,ydummy);
+        // Vertexing+
+        vertexCasc = ReconstructSecondaryVertex(twoTrackArrayCasc,dispersion,kFALSE);
+      } else {
+        // assume Cascade decays at the primary vertex
+        Double_t pos[3],cov[6],chi2perNDF;
+        fV1->GetXYZ(pos);
+        fV1->GetCovMatrix(cov);
+        chi2perNDF = fV1->GetChi2toNDF();
+        vertexCasc = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,2);
+        dcaCasc = 0.;
+      }
+      if(!vertexCasc) {
+        delete trackV0; trackV0=NULL;
+        if(!fInputAOD) {delete v0; v0=NULL;}
+        twoTrackArrayCasc->Clear();
+        continue;
+      }
 
-        // Create and store the Cascade if passed the cuts
-        ioCascade = MakeCascade(twoTrackArrayCasc,event,vertexCasc,v0,dcaCasc,okCascades);
-        if(okCascades && ioCascade) {
-          //AliDebug(1,Form("Storing a cascade object... "));
-          // add the vertex and the cascade to the AOD
-          rc = new(aodCascadesRef[iCascades++])AliAODRecoCascadeHF(*ioCascade);
-          if(fMakeReducedRHF){
-            UShort_t id[2]={(UShort_t)postrack1->GetID(),(UShort_t)iv0};
-            rc->SetProngIDs(2,id);
-            rc->DeleteRecoD();
-          }else{
-            AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexCasc);
-            rc->SetSecondaryVtx(vCasc);
-            vCasc->SetParent(rc);
-            if(!fInputAOD) vCasc->AddDaughter(v0); // just to fill ref #0 ??
-            AddRefs(vCasc,rc,event,twoTrackArrayCasc); // add the track (proton)
-            vCasc->AddDaughter(v0); // fill the 2prong V0
-          }
-          rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+      // Create and store the Cascade if passed the cuts
+      ioCascade = MakeCascade(twoTrackArrayCasc,event,vertexCasc,v0,dcaCasc,okCascades);
+      if(okCascades && ioCascade) {
+        //AliDebug(1,Form("Storing a cascade object... "));
+        // add the vertex and the cascade to the AOD
+        rc = new(aodCascadesRef[iCascades++])AliAODRecoCascadeHF(*ioCascade);
+        if(fMakeReducedRHF){
+          UShort_t id[2]={(UShort_t)postrack1->GetID(),(UShort_t)iv0};
+          rc->SetProngIDs(2,id);
+          rc->DeleteRecoD();
+        }else{
+          AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexCasc);
+          rc->SetSecondaryVtx(vCasc);
+          vCasc->SetParent(rc);
+          if(!fInputAOD) vCasc->AddDaughter(v0); // just to fill ref #0 ??
+          AddRefs(vCasc,rc,event,twoTrackArrayCasc); // add the track (proton)
+          vCasc->AddDaughter(v0); // fill the 2prong V0
         }
+        rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+      }
 
 
-        // Clean up
-        delete trackV0; trackV0=NULL;
-        twoTrackArrayCasc->Clear();
-        if(ioCascade) { delete ioCascade; ioCascade=NULL; }
-        if(vertexCasc) { delete vertexCasc; vertexCasc=NULL; }
-        if(!fInputAOD) {delete v0; v0=NULL;}
+      // Clean up
+      delete trackV0; trackV0=NULL;
+      twoTrackArrayCasc->Clear();
+      if(ioCascade) { delete ioCascade; ioCascade=NULL; }
+      if(vertexCasc) { delete vertexCasc; vertexCasc=NULL; }
+      if(!fInputAOD) {delete v0; v0=NULL;}
 
-      } // end loop on V0's
-      
-      // re-set parameters at vertex
-      SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
-    } // end fCascades
+    } // end loop on V0's
+    
+    // re-set parameters at vertex
+    SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+  } // end fCascades
+
+  // If there is less than 2 particles or the track is not a displaced
+  // track candidate, there is nothing more to do
+  if(trkEntries<2 || !TESTBIT(seleFlags[iTrkP1],kBitDispl) ||
+     (postrack1->Charge()<0 && !fLikeSign)) {
+    if(trkEntries<2) AliDebug(1,Form(" Not enough tracks: %d",trkEntries));
+    delete twoTrackArrayV0;
+    delete twoTrackArrayCasc;
+    return;
+  }
 
-    // If there is less than 2 particles continue
-    if(trkEntries<2) {
-      AliDebug(1,Form(" Not enough tracks: %d",trkEntries));
-      continue;
-    }
+  TObjArray *twoTrackArray1    = new TObjArray(2);
+  TObjArray *twoTrackArray2    = new TObjArray(2);
+  TObjArray *threeTrackArray   = new TObjArray(3);
+  TObjArray *fourTrackArray    = new TObjArray(4);
+  UChar_t   *okPresel3Prong    = fUse3ProngPresel ? new UChar_t[nSeleTrks] : 0x0;
 
-    if(!TESTBIT(seleFlags[iTrkP1],kBitDispl)) continue;
-    if(postrack1->Charge()<0 && !fLikeSign) continue;
+  // LOOP ON  NEGATIVE  TRACKS
+  for(iTrkN1=0; iTrkN1<nSeleTrks; iTrkN1++) {
 
-    // LOOP ON  NEGATIVE  TRACKS
-    for(iTrkN1=0; iTrkN1<nSeleTrks; iTrkN1++) {
+    //if(iTrkN1%1==0) AliDebug(1,Form("    1st loop on neg: track number %d of %d",iTrkN1,nSeleTrks));
+    //if(iTrkN1%1==0) printf("    1st loop on neg: track number %d of %d\n",iTrkN1,nSeleTrks);
 
-      //if(iTrkN1%1==0) AliDebug(1,Form("    1st loop on neg: track number %d of %d",iTrkN1,nSeleTrks));
-      //if(iTrkN1%1==0) printf("    1st loop on neg: track number %d of %d\n",iTrkN1,nSeleTrks);
+    if(iTrkN1==iTrkP1) continue;
 
-      if(iTrkN1==iTrkP1) continue;
+    // get track from tracks array
+    negtrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN1);
 
-      // get track from tracks array
-      negtrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN1);
+    if(negtrack1->Charge()>0 && !fLikeSign) continue;
 
-      if(negtrack1->Charge()>0 && !fLikeSign) continue;
+    if(!TESTBIT(seleFlags[iTrkN1],kBitDispl)) continue;
 
-      if(!TESTBIT(seleFlags[iTrkN1],kBitDispl)) continue;
+    if(fMixEvent) {
+      if(evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+    }
 
+    if(postrack1->Charge()==negtrack1->Charge()) { // like-sign
+      isLikeSign2Prong=kTRUE;
+      if(!fLikeSign)    continue;
+      if(iTrkN1<iTrkP1) continue; // this is needed to avoid double-counting of like-sign
+    } else { // unlike-sign
+      isLikeSign2Prong=kFALSE;
+      if(postrack1->Charge()<0 || negtrack1->Charge()>0) continue;  // this is needed to avoid double-counting of unlike-sign
       if(fMixEvent) {
-	if(evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+        if(evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
       }
 
-      if(postrack1->Charge()==negtrack1->Charge()) { // like-sign
-	isLikeSign2Prong=kTRUE;
-	if(!fLikeSign)    continue;
-	if(iTrkN1<iTrkP1) continue; // this is needed to avoid double-counting of like-sign
-      } else { // unlike-sign
-	isLikeSign2Prong=kFALSE;
-	if(postrack1->Charge()<0 || negtrack1->Charge()>0) continue;  // this is needed to avoid double-counting of unlike-sign
-	if(fMixEvent) {
-	  if(evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
-	}
+    }
 
+    // back to primary vertex
+    //      postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+    //      negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+    SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+    SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+    negtrack1->GetPxPyPz(momneg1);
+
+    // DCA between the two tracks
+    dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+    if(dcap1n1>dcaMax) { negtrack1=0; continue; }
+
+    // Vertexing
+    twoTrackArray1->AddAt(postrack1,0);
+    twoTrackArray1->AddAt(negtrack1,1);
+    AliAODVertex *vertexp1n1 = ReconstructSecondaryVertex(twoTrackArray1,dispersion);
+    if(!vertexp1n1) {
+      twoTrackArray1->Clear();
+      negtrack1=0;
+      continue;
+    }
+    // 2 prong candidate
+    if(fD0toKpi || fJPSItoEle || fDstar || fLikeSign) {
+
+      io2Prong = Make2Prong(twoTrackArray1,event,vertexp1n1,dcap1n1,okD0,okJPSI,okD0fromDstar);
+
+      if((fD0toKpi && okD0) || (fJPSItoEle && okJPSI) || (isLikeSign2Prong && (okD0 || okJPSI))) {
+        // add the vertex and the decay to the AOD
+        AliAODVertex *v2Prong =0x0;
+        if(!fMakeReducedRHF)v2Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexp1n1);
+        if(!isLikeSign2Prong) {
+          if(okD0) {
+            rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
+            SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
+
+            if(fMakeReducedRHF){
+      	rd->DeleteRecoD();
+      	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+            }else{
+      	rd->SetSecondaryVtx(v2Prong);
+      	v2Prong->SetParent(rd);
+      	AddRefs(v2Prong,rd,event,twoTrackArray1);
+            }
+          }
+          if(okJPSI) {
+            rd = new(aodJPSItoEleRef[iJPSItoEle++])AliAODRecoDecayHF2Prong(*io2Prong);
+            if(fMakeReducedRHF){
+      	rd->DeleteRecoD();
+      	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+            }else{
+      	if(!okD0) v2Prong->SetParent(rd); // it cannot have two mothers ...
+      	AddRefs(v2Prong,rd,event,twoTrackArray1);
+            }
+          }
+        } else { // isLikeSign2Prong
+          rd = new(aodLikeSign2ProngRef[iLikeSign2Prong++])AliAODRecoDecayHF2Prong(*io2Prong);
+          //Set selection bit for PID
+          if(okD0) SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
+          if(fMakeReducedRHF){
+            rd->DeleteRecoD();
+            rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+          }else{
+            rd->SetSecondaryVtx(v2Prong);
+            v2Prong->SetParent(rd);
+            AddRefs(v2Prong,rd,event,twoTrackArray1);
+          }
+        }
       }
+      // D* candidates
+      if(fDstar && okD0fromDstar && !isLikeSign2Prong) {
+        // write references in io2Prong
+        if(fInputAOD) {
+          AddDaughterRefs(vertexp1n1,event,twoTrackArray1);
+        } else {
+          vertexp1n1->AddDaughter(postrack1);
+          vertexp1n1->AddDaughter(negtrack1);
+        }
+        io2Prong->SetSecondaryVtx(vertexp1n1);
+        //printf("--->  %d %d %d %d %d\n",vertexp1n1->GetNDaughters(),iTrkP1,iTrkN1,postrack1->Charge(),negtrack1->Charge());
+        // create a track from the D0
+        AliNeutralTrackParam *trackD0 = new AliNeutralTrackParam(io2Prong);
 
-      // back to primary vertex
-      //      postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-      //      negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-      SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
-      SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
-      negtrack1->GetPxPyPz(momneg1);
+        // LOOP ON TRACKS THAT PASSED THE SOFT PION CUTS
+        for(iTrkSoftPi=0; iTrkSoftPi<nSeleTrks; iTrkSoftPi++) {
 
-      // DCA between the two tracks
-      dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
-      if(dcap1n1>dcaMax) { negtrack1=0; continue; }
+          if(iTrkSoftPi==iTrkP1 || iTrkSoftPi==iTrkN1) continue;
 
-      // Vertexing
-      twoTrackArray1->AddAt(postrack1,0);
-      twoTrackArray1->AddAt(negtrack1,1);
-      AliAODVertex *vertexp1n1 = ReconstructSecondaryVertex(twoTrackArray1,dispersion);
-      if(!vertexp1n1) {
-	twoTrackArray1->Clear();
-	negtrack1=0;
-	continue;
-      }
-      // 2 prong candidate
-      if(fD0toKpi || fJPSItoEle || fDstar || fLikeSign) {
+          if(!TESTBIT(seleFlags[iTrkSoftPi],kBitSoftPi)) continue;
 
-	io2Prong = Make2Prong(twoTrackArray1,event,vertexp1n1,dcap1n1,okD0,okJPSI,okD0fromDstar);
+          if(fMixEvent) {
+            if(evtNumber[iTrkP1]==evtNumber[iTrkSoftPi] ||
+      	 evtNumber[iTrkN1]==evtNumber[iTrkSoftPi] ||
+      	 evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+          }
 
-	if((fD0toKpi && okD0) || (fJPSItoEle && okJPSI) || (isLikeSign2Prong && (okD0 || okJPSI))) {
-	  // add the vertex and the decay to the AOD
-          AliAODVertex *v2Prong =0x0;
-          if(!fMakeReducedRHF)v2Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexp1n1);
-	  if(!isLikeSign2Prong) {
-	    if(okD0) {
-	      rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
-	      SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
+          //if(iTrkSoftPi%1==0) AliDebug(1,Form("    1st loop on pi_s: track number %d of %d",iTrkSoftPi,nSeleTrks));
 
-              if(fMakeReducedRHF){
-		rd->DeleteRecoD();
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-              }else{
-		rd->SetSecondaryVtx(v2Prong);
-		v2Prong->SetParent(rd);
-		AddRefs(v2Prong,rd,event,twoTrackArray1);
-              }
-	    }
-	    if(okJPSI) {
-	      rd = new(aodJPSItoEleRef[iJPSItoEle++])AliAODRecoDecayHF2Prong(*io2Prong);
-	      if(fMakeReducedRHF){
-		rd->DeleteRecoD();
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	      }else{
-		if(!okD0) v2Prong->SetParent(rd); // it cannot have two mothers ...
-		AddRefs(v2Prong,rd,event,twoTrackArray1);
-              }
-	    }
-	  } else { // isLikeSign2Prong
-	    rd = new(aodLikeSign2ProngRef[iLikeSign2Prong++])AliAODRecoDecayHF2Prong(*io2Prong);
-	    //Set selection bit for PID
-	    if(okD0) SetSelectionBitForPID(fCutsD0toKpi,rd,AliRDHFCuts::kD0toKpiPID);
-	    if(fMakeReducedRHF){
-	      rd->DeleteRecoD();
-	      rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	    }else{
-	      rd->SetSecondaryVtx(v2Prong);
-	      v2Prong->SetParent(rd);
-	      AddRefs(v2Prong,rd,event,twoTrackArray1);
-	    }
-	  }
-	}
-	// D* candidates
-	if(fDstar && okD0fromDstar && !isLikeSign2Prong) {
-	  // write references in io2Prong
-	  if(fInputAOD) {
-	    AddDaughterRefs(vertexp1n1,event,twoTrackArray1);
-	  } else {
-	    vertexp1n1->AddDaughter(postrack1);
-	    vertexp1n1->AddDaughter(negtrack1);
-	  }
-	  io2Prong->SetSecondaryVtx(vertexp1n1);
-          //printf("--->  %d %d %d %d %d\n",vertexp1n1->GetNDaughters(),iTrkP1,iTrkN1,postrack1->Charge(),negtrack1->Charge());
-	  // create a track from the D0
-	  AliNeutralTrackParam *trackD0 = new AliNeutralTrackParam(io2Prong);
-
-	  // LOOP ON TRACKS THAT PASSED THE SOFT PION CUTS
-	  for(iTrkSoftPi=0; iTrkSoftPi<nSeleTrks; iTrkSoftPi++) {
-
-	    if(iTrkSoftPi==iTrkP1 || iTrkSoftPi==iTrkN1) continue;
-
-	    if(!TESTBIT(seleFlags[iTrkSoftPi],kBitSoftPi)) continue;
-
-	    if(fMixEvent) {
-	      if(evtNumber[iTrkP1]==evtNumber[iTrkSoftPi] ||
-		 evtNumber[iTrkN1]==evtNumber[iTrkSoftPi] ||
-		 evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
-	    }
-
-	    //if(iTrkSoftPi%1==0) AliDebug(1,Form("    1st loop on pi_s: track number %d of %d",iTrkSoftPi,nSeleTrks));
-
-	    trackD0->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	    if(trackD0->GetSigmaY2()<0. || trackD0->GetSigmaZ2()<0.) continue; // this is insipired by the AliITStrackV2::Invariant() checks
-
-	    // get track from tracks array
-	    trackPi = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkSoftPi);
-	    //	    trackPi->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	    SetParametersAtVertex(trackPi,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkSoftPi));
-	    twoTrackArrayCasc->AddAt(trackPi,0);
-	    twoTrackArrayCasc->AddAt(trackD0,1);
-	    if(!SelectInvMassAndPtDstarD0pi(twoTrackArrayCasc)){
-	      twoTrackArrayCasc->Clear();
-	      trackPi=0;
-	      continue;
-	    }
-
-	    AliAODVertex *vertexCasc = 0;
-
-	    if(fFindVertexForDstar) {
-	      // DCA between the two tracks
-	      dcaCasc = trackPi->GetDCA(trackD0,fBzkG,xdummy,ydummy);
-	      // Vertexing
-	      vertexCasc = ReconstructSecondaryVertex(twoTrackArrayCasc,dispersion,kFALSE);
-	    } else {
-	      // assume Dstar decays at the primary vertex
-	      Double_t pos[3],cov[6],chi2perNDF;
-	      fV1->GetXYZ(pos);
-	      fV1->GetCovMatrix(cov);
-	      chi2perNDF = fV1->GetChi2toNDF();
-	      vertexCasc = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,2);
-	      dcaCasc = 0.;
-	    }
-	    if(!vertexCasc) {
-	      twoTrackArrayCasc->Clear();
-	      trackPi=0;
-	      continue;
-	    }
-
-            ioCascade = MakeCascade(twoTrackArrayCasc,event,vertexCasc,io2Prong,dcaCasc,okDstar);
-            if(okDstar) {
-	      // add the D0 to the AOD (if not already done)
-	      if(!okD0) {
-	        rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
-                 if(fMakeReducedRHF){
-		   rd->DeleteRecoD();
-		   rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	         }else{
-		   AliAODVertex *v2Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*vertexp1n1);
-		   rd->SetSecondaryVtx(v2Prong);
-		   v2Prong->SetParent(rd);
-		   AddRefs(v2Prong,rd,event,twoTrackArray1);
-                 }
-        	okD0=kTRUE; // this is done to add it only once
-	      }
-	      // add the vertex and the cascade to the AOD
-	      rc = new(aodDstarRef[iDstar++])AliAODRecoCascadeHF(*ioCascade);
-	      // Set selection bit for PID
-	      SetSelectionBitForPID(fCutsDStartoKpipi,rc,AliRDHFCuts::kDstarPID);
-	      if(fMakeReducedRHF){
-		//assign a ID to the D0 candidate, daughter of the Cascade. ID = position in the D0toKpi array
-		UShort_t idCasc[2]={(UShort_t)trackPi->GetID(),(UShort_t)(iD0toKpi-1)};
-		rc->SetProngIDs(2,idCasc);
-		rc->DeleteRecoD();
-		rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	      }else{
-		AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexCasc);
-		rc->SetSecondaryVtx(vCasc);
-		vCasc->SetParent(rc);
-		if(!fInputAOD) vCasc->AddDaughter(rd); // just to fill ref #0
-		AddRefs(vCasc,rc,event,twoTrackArrayCasc);
-		vCasc->AddDaughter(rd); // add the D0 (in ref #1)
-	      }
+          trackD0->PropagateToDCA(fV1,fBzkG,kVeryBig);
+          if(trackD0->GetSigmaY2()<0. || trackD0->GetSigmaZ2()<0.) continue; // this is insipired by the AliITStrackV2::Invariant() checks
+
+          // get track from tracks array
+          trackPi = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkSoftPi);
+          //	    trackPi->PropagateToDCA(fV1,fBzkG,kVeryBig);
+          SetParametersAtVertex(trackPi,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkSoftPi));
+          twoTrackArrayCasc->AddAt(trackPi,0);
+          twoTrackArrayCasc->AddAt(trackD0,1);
+          if(!SelectInvMassAndPtDstarD0pi(twoTrackArrayCasc)){
+            twoTrackArrayCasc->Clear();
+            trackPi=0;
+            continue;
+          }
+
+          AliAODVertex *vertexCasc = 0;
+
+          if(fFindVertexForDstar) {
+            // DCA between the two tracks
+            dcaCasc = trackPi->GetDCA(trackD0,fBzkG,xdummy,ydummy);
+            // Vertexing
+            vertexCasc = ReconstructSecondaryVertex(twoTrackArrayCasc,dispersion,kFALSE);
+          } else {
+            // assume Dstar decays at the primary vertex
+            Double_t pos[3],cov[6],chi2perNDF;
+            fV1->GetXYZ(pos);
+            fV1->GetCovMatrix(cov);
+            chi2perNDF = fV1->GetChi2toNDF();
+            vertexCasc = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,2);
+            dcaCasc = 0.;
+          }
+          if(!vertexCasc) {
+            twoTrackArrayCasc->Clear();
+            trackPi=0;
+            continue;
+          }
+
+          ioCascade = MakeCascade(twoTrackArrayCasc,event,vertexCasc,io2Prong,dcaCasc,okDstar);
+          if(okDstar) {
+            // add the D0 to the AOD (if not already done)
+            if(!okD0) {
+              rd = new(aodD0toKpiRef[iD0toKpi++])AliAODRecoDecayHF2Prong(*io2Prong);
+               if(fMakeReducedRHF){
+      	   rd->DeleteRecoD();
+      	   rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+               }else{
+      	   AliAODVertex *v2Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*vertexp1n1);
+      	   rd->SetSecondaryVtx(v2Prong);
+      	   v2Prong->SetParent(rd);
+      	   AddRefs(v2Prong,rd,event,twoTrackArray1);
+               }
+      	okD0=kTRUE; // this is done to add it only once
             }
-	    twoTrackArrayCasc->Clear();
-	    trackPi=0;
-	    if(ioCascade) {delete ioCascade; ioCascade=NULL;}
-	    delete vertexCasc; vertexCasc=NULL;
-	  } // end loop on soft pi tracks
+            // add the vertex and the cascade to the AOD
+            rc = new(aodDstarRef[iDstar++])AliAODRecoCascadeHF(*ioCascade);
+            // Set selection bit for PID
+            SetSelectionBitForPID(fCutsDStartoKpipi,rc,AliRDHFCuts::kDstarPID);
+            if(fMakeReducedRHF){
+      	//assign a ID to the D0 candidate, daughter of the Cascade. ID = position in the D0toKpi array
+      	UShort_t idCasc[2]={(UShort_t)trackPi->GetID(),(UShort_t)(iD0toKpi-1)};
+      	rc->SetProngIDs(2,idCasc);
+      	rc->DeleteRecoD();
+      	rc->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+            }else{
+      	AliAODVertex *vCasc = new(verticesHFRef[iVerticesHF++])AliAODVertex(*vertexCasc);
+      	rc->SetSecondaryVtx(vCasc);
+      	vCasc->SetParent(rc);
+      	if(!fInputAOD) vCasc->AddDaughter(rd); // just to fill ref #0
+      	AddRefs(vCasc,rc,event,twoTrackArrayCasc);
+      	vCasc->AddDaughter(rd); // add the D0 (in ref #1)
+            }
+          }
+          twoTrackArrayCasc->Clear();
+          trackPi=0;
+          if(ioCascade) {delete ioCascade; ioCascade=NULL;}
+          delete vertexCasc; vertexCasc=NULL;
+        } // end loop on soft pi tracks
 
-	  if(trackD0) {delete trackD0; trackD0=NULL;}
+        if(trackD0) {delete trackD0; trackD0=NULL;}
 
-	}
-	if(io2Prong) {delete io2Prong; io2Prong=NULL;}
       }
+      if(io2Prong) {delete io2Prong; io2Prong=NULL;}
+    }
 
-      twoTrackArray1->Clear();
-      if( (!f3Prong && !f4Prong) ||
-	  (isLikeSign2Prong && !f3Prong) ) {
-	negtrack1=0;
-	delete vertexp1n1;
-	continue;
-      }
+    twoTrackArray1->Clear();
+    if( (!f3Prong && !f4Prong) ||
+        (isLikeSign2Prong && !f3Prong) ) {
+      negtrack1=0;
+      delete vertexp1n1;
+      continue;
+    }
 
+    // kinematic preselection of all the triplets (P1,N1,P2) at once. With
+    // 4 prongs on, the triplets failing the 3 prong mass cuts are still needed
+    Bool_t usePreselP2 = fUse3ProngPresel && !f4Prong &&
+      TESTBIT(seleFlags[iTrkP1],kBit3Prong) && TESTBIT(seleFlags[iTrkN1],kBit3Prong);
+    if(usePreselP2) Preselect3Prong(mompos1,momneg1,iTrkP1+1,okPresel3Prong);
 
-      // 2nd LOOP  ON  POSITIVE  TRACKS
-      for(iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
+    // 2nd LOOP  ON  POSITIVE  TRACKS
+    for(iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
 
-	if(iTrkP2==iTrkP1 || iTrkP2==iTrkN1) continue;
+      if(iTrkP2==iTrkP1 || iTrkP2==iTrkN1) continue;
 
-	//if(iTrkP2%1==0) AliDebug(1,Form("    2nd loop on pos: track number %d of %d",iTrkP2,nSeleTrks));
+      //if(iTrkP2%1==0) AliDebug(1,Form("    2nd loop on pos: track number %d of %d",iTrkP2,nSeleTrks));
 
-	// get track from tracks array
-	postrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP2);
+      // get track from tracks array
+      postrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP2);
 
-	if(postrack2->Charge()<0) continue;
+      if(postrack2->Charge()<0) continue;
 
-	if(!TESTBIT(seleFlags[iTrkP2],kBitDispl)) continue;
+      if(!TESTBIT(seleFlags[iTrkP2],kBitDispl)) continue;
 
-	// Check single tracks cuts specific for 3 prongs
-	if(!TESTBIT(seleFlags[iTrkP2],kBit3Prong)) continue;
-	if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) continue;
-	if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
+      // Check single tracks cuts specific for 3 prongs
+      if(!TESTBIT(seleFlags[iTrkP2],kBit3Prong)) continue;
+      if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) continue;
+      if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
 
-	if(fMixEvent) {
-	  if(evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
-	     evtNumber[iTrkN1]==evtNumber[iTrkP2] ||
-	     evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
-	}
+      if(fMixEvent) {
+        if(evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
+           evtNumber[iTrkN1]==evtNumber[iTrkP2] ||
+           evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+      }
 
-	if(isLikeSign2Prong) { // like-sign pair -> have to build only like-sign triplet
-	  if(!fLikeSign3prong) continue;
-	  if(postrack1->Charge()>0) { // ok: like-sign triplet (+++)
-	    isLikeSign3Prong=kTRUE;
-	  } else { // not ok
-	    continue;
-	  }
-	} else { // normal triplet (+-+)
-	  isLikeSign3Prong=kFALSE;
-	  if(fMixEvent) {
-	    if(evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
-	       evtNumber[iTrkN1]==evtNumber[iTrkP2] ||
-	       evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
-	  }
-	}
+      if(isLikeSign2Prong) { // like-sign pair -> have to build only like-sign triplet
+        if(!fLikeSign3prong) continue;
+        if(postrack1->Charge()>0) { // ok: like-sign triplet (+++)
+          isLikeSign3Prong=kTRUE;
+        } else { // not ok
+          continue;
+        }
+      } else { // normal triplet (+-+)
+        isLikeSign3Prong=kFALSE;
+        if(fMixEvent) {
+          if(evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
+             evtNumber[iTrkN1]==evtNumber[iTrkP2] ||
+             evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+        }
+      }
 
-	if(fUseKaonPIDfor3Prong){
-	  if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat)) continue;
-	}
-	Bool_t okForLcTopKpi=kTRUE;
-	Int_t pidLcStatus=3; // 3= OK as pKpi and Kpipi
-	if(fUsePIDforLc>0){
-	  if(!TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
-	     !TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) ){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	  }
-	  if(okForLcTopKpi && fUsePIDforLc>1){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	    if(TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkP2],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=1; // 1= OK as pKpi
-	    }
-	    if(TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkP1],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=2; // 2= OK as piKp
-	    }
-	  }
-	}
-	Bool_t okForDsToKKpi=kTRUE;
-	if(fUseKaonPIDforDs){
-	  if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat) &&
-	     !TESTBIT(seleFlags[iTrkP2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
-	}
-	// back to primary vertex
-	//	postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	//	postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	//	negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
-	SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
-	SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
-
-	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
-
-	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
-	if(dcap2n1>dcaMax) { postrack2=0; continue; }
-	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
-	if(dcap1p2>dcaMax) { postrack2=0; continue; }
-
-	// check invariant mass cuts for D+,Ds,Lc
-        massCutOK=kTRUE;
-	if(f3Prong) {
-	  if(postrack2->Charge()>0) {
-	    threeTrackArray->AddAt(postrack1,0);
-	    threeTrackArray->AddAt(negtrack1,1);
-	    threeTrackArray->AddAt(postrack2,2);
-	  } else {
-	    threeTrackArray->AddAt(negtrack1,0);
-	    threeTrackArray->AddAt(postrack1,1);
-	    threeTrackArray->AddAt(postrack2,2);
-	  }
-	  if(fMassCutBeforeVertexing){
-	    postrack2->GetPxPyPz(mompos2);
-	    Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
-	    Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
-	    Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
-	    //	    massCutOK = SelectInvMassAndPt3prong(threeTrackArray);
-	    massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
-	  }
-	}
+      if(fUseKaonPIDfor3Prong){
+        if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat)) continue;
+      }
+      Bool_t okForLcTopKpi=kTRUE;
+      Int_t pidLcStatus=3; // 3= OK as pKpi and Kpipi
+      if(fUsePIDforLc>0){
+        if(!TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
+           !TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) ){
+          okForLcTopKpi=kFALSE;
+          pidLcStatus=0;
+        }
+        if(okForLcTopKpi && fUsePIDforLc>1){
+          okForLcTopKpi=kFALSE;
+          pidLcStatus=0;
+          if(TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
+             TESTBIT(seleFlags[iTrkP2],kBitPionCompat) ){
+            okForLcTopKpi=kTRUE;
+            pidLcStatus+=1; // 1= OK as pKpi
+          }
+          if(TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) &&
+             TESTBIT(seleFlags[iTrkP1],kBitPionCompat) ){
+            okForLcTopKpi=kTRUE;
+            pidLcStatus+=2; // 2= OK as piKp
+          }
+        }
+      }
+      Bool_t okForDsToKKpi=kTRUE;
+      if(fUseKaonPIDforDs){
+        if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat) &&
+           !TESTBIT(seleFlags[iTrkP2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
+      }
 
-	if(f3Prong && !massCutOK) {
-	  threeTrackArray->Clear();
-	  if(!f4Prong) {
-	    postrack2=0;
-	    continue;
-	  }
-	}
+      if(f3Prong) f3ProngCounters[k3ProngTested]++;
+      if(usePreselP2 && !okPresel3Prong[iTrkP2]) { postrack2=0; continue; }
+      if(f3Prong) f3ProngCounters[k3ProngPassPresel]++;
 
-	// Vertexing
-	twoTrackArray2->AddAt(postrack2,0);
-	twoTrackArray2->AddAt(negtrack1,1);
-
-	// 3 prong candidates
-	if(f3Prong && massCutOK) {
-	  
-	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
-	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
-	  if(ok3Prong) {
-            AliAODVertex *v3Prong=0x0;
-	    if(!fMakeReducedRHF)v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
-	    if(!isLikeSign3Prong) {
-	      rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	      // Set selection bit for PID
-	      SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	      SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	      SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-	      if(fMakeReducedRHF){
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-	      }else{
-                v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
-		rd->SetSecondaryVtx(v3Prong);
-		v3Prong->SetParent(rd);
-		AddRefs(v3Prong,rd,event,threeTrackArray);
-	      }
-	    } else { // isLikeSign3Prong
-	      if(fLikeSign3prong){
-		rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	        // Set selection bit for PID
-	        SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	        SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	        SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-                if(fMakeReducedRHF){
-		  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                  ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-		}else{
-		  rd->SetSecondaryVtx(v3Prong);
-		  v3Prong->SetParent(rd);
-		  AddRefs(v3Prong,rd,event,threeTrackArray);
-                }
-	      }
-	    }
+      // back to primary vertex
+      //	postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+      //	postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
+      //	negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+      SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+      SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+      SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
 
-	  }
-	  if(io3Prong) {delete io3Prong; io3Prong=NULL;}
-	  if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
-	}
+      //printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
+
+      dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+      if(dcap2n1>dcaMax) { postrack2=0; continue; }
+      dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
+      if(dcap1p2>dcaMax) { postrack2=0; continue; }
 
-	// 4 prong candidates
-	if(f4Prong
-	   // don't make 4 prong with like-sign pairs and triplets
-	   && !isLikeSign2Prong && !isLikeSign3Prong
-	   // track-to-track dca cuts already now
-	   && dcap1n1 < fCutsD0toKpipipi->GetDCACut()
-	   && dcap2n1 < fCutsD0toKpipipi->GetDCACut()) {
-	  // back to primary vertex
-	  //	  postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	  //	  postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	  //	  negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	  SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
-	  SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
-	  SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
-
-	  // Vertexing for these 3 (can be taken from above?)
+      // check invariant mass cuts for D+,Ds,Lc
+      massCutOK=kTRUE;
+      if(f3Prong) {
+        f3ProngCounters[k3ProngPassDCA]++;
+        if(postrack2->Charge()>0) {
           threeTrackArray->AddAt(postrack1,0);
           threeTrackArray->AddAt(negtrack1,1);
-	  threeTrackArray->AddAt(postrack2,2);
-          AliAODVertex* vertexp1n1p2 = ReconstructSecondaryVertex(threeTrackArray,dispersion);
-
-	  // 3rd LOOP  ON  NEGATIVE  TRACKS (for 4 prong)
-	  for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
-
-	    if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
-
-	    //if(iTrkN2%1==0) AliDebug(1,Form("    3rd loop on neg: track number %d of %d",iTrkN2,nSeleTrks));
-
-	    // get track from tracks array
-	    negtrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN2);
-
-	    if(negtrack2->Charge()>0) continue;
-
-	    if(!TESTBIT(seleFlags[iTrkN2],kBitDispl)) continue;
-	    if(fMixEvent){
-	      if(evtNumber[iTrkP1]==evtNumber[iTrkN2] ||
-		 evtNumber[iTrkN1]==evtNumber[iTrkN2] ||
-		 evtNumber[iTrkP2]==evtNumber[iTrkN2] ||
-		 evtNumber[iTrkP1]==evtNumber[iTrkN1] ||
-		 evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
-		 evtNumber[iTrkN1]==evtNumber[iTrkP2]) continue;
-	    }
-
-	    // back to primary vertex
-	    // postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	    // postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	    // negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	    // negtrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	    SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
-	    SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
-	    SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
-	    SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
-
-	    dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	    if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
-            dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-            if(dcap2n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
-
-
-	    fourTrackArray->AddAt(postrack1,0);
-	    fourTrackArray->AddAt(negtrack1,1);
-	    fourTrackArray->AddAt(postrack2,2);
-	    fourTrackArray->AddAt(negtrack2,3);
-
-	    // check invariant mass cuts for D0
-	    massCutOK=kTRUE;
-	    if(fMassCutBeforeVertexing)
-	      massCutOK = SelectInvMassAndPt4prong(fourTrackArray);
-
-	    if(!massCutOK) {
-	      fourTrackArray->Clear();
-	      negtrack2=0;
-	      continue;
-	    }
-
-	    // Vertexing
-	    AliAODVertex* secVert4PrAOD = ReconstructSecondaryVertex(fourTrackArray,dispersion);
-	    io4Prong = Make4Prong(fourTrackArray,event,secVert4PrAOD,vertexp1n1,vertexp1n1p2,dcap1n1,dcap1n2,dcap2n1,dcap2n2,ok4Prong);
-	    if(ok4Prong) {
-	      rd = new(aodCharm4ProngRef[i4Prong++])AliAODRecoDecayHF4Prong(*io4Prong);
-	      if(fMakeReducedRHF){
-		rd->DeleteRecoD();
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-	      }else{
-                AliAODVertex *v4Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert4PrAOD);
-		rd->SetSecondaryVtx(v4Prong);
-		v4Prong->SetParent(rd);
-		AddRefs(v4Prong,rd,event,fourTrackArray);
-	      }
+          threeTrackArray->AddAt(postrack2,2);
+        } else {
+          threeTrackArray->AddAt(negtrack1,0);
+          threeTrackArray->AddAt(postrack1,1);
+          threeTrackArray->AddAt(postrack2,2);
+        }
+        if(fMassCutBeforeVertexing){
+          postrack2->GetPxPyPz(mompos2);
+          Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
+          Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
+          Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
+          //	    massCutOK = SelectInvMassAndPt3prong(threeTrackArray);
+          massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
+        }
+      }
+
+      if(f3Prong && !massCutOK) {
+        threeTrackArray->Clear();
+        if(!f4Prong) {
+          postrack2=0;
+          continue;
+        }
+      }
+
+      // Vertexing
+      twoTrackArray2->AddAt(postrack2,0);
+      twoTrackArray2->AddAt(negtrack1,1);
+
+      // 3 prong candidates
+      if(f3Prong && massCutOK) {
+        f3ProngCounters[k3ProngPassMass]++;
+        AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
+        io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
+        if(ok3Prong) {
+          f3ProngCounters[k3ProngCandidates]++;
+          AliAODVertex *v3Prong=0x0;
+          if(!fMakeReducedRHF)v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
+          if(!isLikeSign3Prong) {
+            rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
+            // Set selection bit for PID
+            SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
+            SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
+            SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
+            if(fMakeReducedRHF){
+      	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+              ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
+            }else{
+              v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
+      	rd->SetSecondaryVtx(v3Prong);
+      	v3Prong->SetParent(rd);
+      	AddRefs(v3Prong,rd,event,threeTrackArray);
             }
+          } else { // isLikeSign3Prong
+            if(fLikeSign3prong){
+      	rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
+              // Set selection bit for PID
+              SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
+              SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
+              SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
+              if(fMakeReducedRHF){
+      	  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+                ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
+      	}else{
+      	  rd->SetSecondaryVtx(v3Prong);
+      	  v3Prong->SetParent(rd);
+      	  AddRefs(v3Prong,rd,event,threeTrackArray);
+              }
+            }
+          }
 
-	    if(io4Prong) {delete io4Prong; io4Prong=NULL;}
-	    if(secVert4PrAOD) {delete secVert4PrAOD; secVert4PrAOD=NULL;}
-	    fourTrackArray->Clear();
-	    negtrack2 = 0;
+        }
+        if(io3Prong) {delete io3Prong; io3Prong=NULL;}
+        if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
+      }
 
-	  } // end loop on negative tracks
+      // 4 prong candidates
+      if(f4Prong
+         // don't make 4 prong with like-sign pairs and triplets
+         && !isLikeSign2Prong && !isLikeSign3Prong
+         // track-to-track dca cuts already now
+         && dcap1n1 < fCutsD0toKpipipi->GetDCACut()
+         && dcap2n1 < fCutsD0toKpipipi->GetDCACut()) {
+        // back to primary vertex
+        //	  postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+        //	  postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
+        //	  negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+        SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+        SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+        SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
+
+        // Vertexing for these 3 (can be taken from above?)
+        threeTrackArray->AddAt(postrack1,0);
+        threeTrackArray->AddAt(negtrack1,1);
+        threeTrackArray->AddAt(postrack2,2);
+        AliAODVertex* vertexp1n1p2 = ReconstructSecondaryVertex(threeTrackArray,dispersion);
+
+        // 3rd LOOP  ON  NEGATIVE  TRACKS (for 4 prong)
+        for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
+
+          if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
+
+          //if(iTrkN2%1==0) AliDebug(1,Form("    3rd loop on neg: track number %d of %d",iTrkN2,nSeleTrks));
+
+          // get track from tracks array
+          negtrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN2);
+
+          if(negtrack2->Charge()>0) continue;
+
+          if(!TESTBIT(seleFlags[iTrkN2],kBitDispl)) continue;
+          if(fMixEvent){
+            if(evtNumber[iTrkP1]==evtNumber[iTrkN2] ||
+      	 evtNumber[iTrkN1]==evtNumber[iTrkN2] ||
+      	 evtNumber[iTrkP2]==evtNumber[iTrkN2] ||
+      	 evtNumber[iTrkP1]==evtNumber[iTrkN1] ||
+      	 evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
+      	 evtNumber[iTrkN1]==evtNumber[iTrkP2]) continue;
+          }
 
-          threeTrackArray->Clear();
-	  delete vertexp1n1p2;
+          // back to primary vertex
+          // postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+          // postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
+          // negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+          // negtrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
+          SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+          SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+          SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
+          SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
+
+          dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+          if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
+          dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+          if(dcap2n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
+
+
+          fourTrackArray->AddAt(postrack1,0);
+          fourTrackArray->AddAt(negtrack1,1);
+          fourTrackArray->AddAt(postrack2,2);
+          fourTrackArray->AddAt(negtrack2,3);
+
+          // check invariant mass cuts for D0
+          massCutOK=kTRUE;
+          if(fMassCutBeforeVertexing)
+            massCutOK = SelectInvMassAndPt4prong(fourTrackArray);
+
+          if(!massCutOK) {
+            fourTrackArray->Clear();
+            negtrack2=0;
+            continue;
+          }
 
-	}
+          // Vertexing
+          AliAODVertex* secVert4PrAOD = ReconstructSecondaryVertex(fourTrackArray,dispersion);
+          io4Prong = Make4Prong(fourTrackArray,event,secVert4PrAOD,vertexp1n1,vertexp1n1p2,dcap1n1,dcap1n2,dcap2n1,dcap2n2,ok4Prong);
+          if(ok4Prong) {
+            rd = new(aodCharm4ProngRef[i4Prong++])AliAODRecoDecayHF4Prong(*io4Prong);
+            if(fMakeReducedRHF){
+      	rd->DeleteRecoD();
+      	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+            }else{
+              AliAODVertex *v4Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert4PrAOD);
+      	rd->SetSecondaryVtx(v4Prong);
+      	v4Prong->SetParent(rd);
+      	AddRefs(v4Prong,rd,event,fourTrackArray);
+            }
+          }
 
-	postrack2 = 0;
+          if(io4Prong) {delete io4Prong; io4Prong=NULL;}
+          if(secVert4PrAOD) {delete secVert4PrAOD; secVert4PrAOD=NULL;}
+          fourTrackArray->Clear();
+          negtrack2 = 0;
 
-      } // end 2nd loop on positive tracks
+        } // end loop on negative tracks
 
-      twoTrackArray2->Clear();
+        threeTrackArray->Clear();
+        delete vertexp1n1p2;
 
-      // 2nd LOOP  ON  NEGATIVE  TRACKS (for 3 prong -+-)
-      for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
+      }
 
-	if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
+      postrack2 = 0;
 
-	//if(iTrkN2%1==0) AliDebug(1,Form("    2nd loop on neg: track number %d of %d",iTrkN2,nSeleTrks));
+    } // end 2nd loop on positive tracks
 
-	// get track from tracks array
-	negtrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN2);
+    twoTrackArray2->Clear();
 
-	if(negtrack2->Charge()>0) continue;
+    // kinematic preselection of all the triplets (N1,P1,N2) at once
+    Bool_t usePreselN2 = fUse3ProngPresel &&
+      TESTBIT(seleFlags[iTrkP1],kBit3Prong) && TESTBIT(seleFlags[iTrkN1],kBit3Prong);
+    if(usePreselN2) Preselect3Prong(momneg1,mompos1,iTrkN1+1,okPresel3Prong);
 
-	if(!TESTBIT(seleFlags[iTrkN2],kBitDispl)) continue;
+    // 2nd LOOP  ON  NEGATIVE  TRACKS (for 3 prong -+-)
+    for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
 
-	// Check single tracks cuts specific for 3 prongs
-	if(!TESTBIT(seleFlags[iTrkN2],kBit3Prong)) continue;
-	if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) continue;
-	if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
+      if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
 
-	if(fMixEvent) {
-	  if(evtNumber[iTrkP1]==evtNumber[iTrkN2] ||
-	     evtNumber[iTrkN1]==evtNumber[iTrkN2] ||
-	     evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
-	}
+      //if(iTrkN2%1==0) AliDebug(1,Form("    2nd loop on neg: track number %d of %d",iTrkN2,nSeleTrks));
 
-	if(isLikeSign2Prong) { // like-sign pair -> have to build only like-sign triplet
-	  if(!fLikeSign3prong) continue;
-	  if(postrack1->Charge()<0) { // ok: like-sign triplet (---)
-	    isLikeSign3Prong=kTRUE;
-	  } else { // not ok
-	    continue;
-	  }
-	} else { // normal triplet (-+-)
-	  isLikeSign3Prong=kFALSE;
-	}
+      // get track from tracks array
+      negtrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN2);
 
-	if(fUseKaonPIDfor3Prong){
-	  if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat)) continue;
-	}
-	Bool_t okForLcTopKpi=kTRUE;
-	Int_t pidLcStatus=3; // 3= OK as pKpi and Kpipi
-	if(fUsePIDforLc>0){
-	  if(!TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
-	     !TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) ){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	  }
-	  if(okForLcTopKpi && fUsePIDforLc>1){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	    if(TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkN2],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=1; // 1= OK as pKpi
-	    }
-	    if(TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkN1],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=2; // 2= OK as piKp
-	    }
-	  }
-	}
-	Bool_t okForDsToKKpi=kTRUE;
-	if(fUseKaonPIDforDs){
-	  if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat) &&
-	     !TESTBIT(seleFlags[iTrkN2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
-	}
+      if(negtrack2->Charge()>0) continue;
 
-	// back to primary vertex
-	// postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	// negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	// negtrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
-	SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
-	SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
-	SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
-	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
-
-	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
-	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
-
-	threeTrackArray->AddAt(negtrack1,0);
-	threeTrackArray->AddAt(postrack1,1);
-	threeTrackArray->AddAt(negtrack2,2);
-
-	// check invariant mass cuts for D+,Ds,Lc
-        massCutOK=kTRUE;
-	if(fMassCutBeforeVertexing && f3Prong){
-	  negtrack2->GetPxPyPz(momneg2);
-	  Double_t pxDau[3]={momneg1[0],mompos1[0],momneg2[0]};
-	  Double_t pyDau[3]={momneg1[1],mompos1[1],momneg2[1]};
-	  Double_t pzDau[3]={momneg1[2],mompos1[2],momneg2[2]};
-	  //	  massCutOK = SelectInvMassAndPt3prong(threeTrackArray);
-	  massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
-	}
-	if(!massCutOK) {
-	  threeTrackArray->Clear();
-	  negtrack2=0;
-	  continue;
-	}
+      if(!TESTBIT(seleFlags[iTrkN2],kBitDispl)) continue;
+
+      // Check single tracks cuts specific for 3 prongs
+      if(!TESTBIT(seleFlags[iTrkN2],kBit3Prong)) continue;
+      if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) continue;
+      if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
+
+      if(fMixEvent) {
+        if(evtNumber[iTrkP1]==evtNumber[iTrkN2] ||
+           evtNumber[iTrkN1]==evtNumber[iTrkN2] ||
+           evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+      }
+
+      if(isLikeSign2Prong) { // like-sign pair -> have to build only like-sign triplet
+        if(!fLikeSign3prong) continue;
+        if(postrack1->Charge()<0) { // ok: like-sign triplet (---)
+          isLikeSign3Prong=kTRUE;
+        } else { // not ok
+          continue;
+        }
+      } else { // normal triplet (-+-)
+        isLikeSign3Prong=kFALSE;
+      }
+
+      if(fUseKaonPIDfor3Prong){
+        if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat)) continue;
+      }
+      Bool_t okForLcTopKpi=kTRUE;
+      Int_t pidLcStatus=3; // 3= OK as pKpi and Kpipi
+      if(fUsePIDforLc>0){
+        if(!TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
+           !TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) ){
+          okForLcTopKpi=kFALSE;
+          pidLcStatus=0;
+        }
+        if(okForLcTopKpi && fUsePIDforLc>1){
+          okForLcTopKpi=kFALSE;
+          pidLcStatus=0;
+          if(TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
+             TESTBIT(seleFlags[iTrkN2],kBitPionCompat) ){
+            okForLcTopKpi=kTRUE;
+            pidLcStatus+=1; // 1= OK as pKpi
+          }
+          if(TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) &&
+             TESTBIT(seleFlags[iTrkN1],kBitPionCompat) ){
+            okForLcTopKpi=kTRUE;
+            pidLcStatus+=2; // 2= OK as piKp
+          }
+        }
+      }
+      Bool_t okForDsToKKpi=kTRUE;
+      if(fUseKaonPIDforDs){
+        if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat) &&
+           !TESTBIT(seleFlags[iTrkN2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
+      }
+
+      if(f3Prong) f3ProngCounters[k3ProngTested]++;
+      if(usePreselN2 && !okPresel3Prong[iTrkN2]) { negtrack2=0; continue; }
+      if(f3Prong) f3ProngCounters[k3ProngPassPresel]++;
 
-	// Vertexing
-	twoTrackArray2->AddAt(postrack1,0);
-	twoTrackArray2->AddAt(negtrack2,1);
-
-	if(f3Prong) {
-	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
-	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
-	  if(ok3Prong) {
-	    AliAODVertex *v3Prong = 0x0;
-            if(!fMakeReducedRHF) v3Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
-	    if(!isLikeSign3Prong) {
-	      rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	      SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	      SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	      SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-	      if(fMakeReducedRHF){
-		rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+      // back to primary vertex
+      // postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+      // negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
+      // negtrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
+      SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+      SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+      SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
+      //printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
+
+      dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+      if(dcap1n2>dcaMax) { negtrack2=0; continue; }
+      dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+      if(dcan1n2>dcaMax) { negtrack2=0; continue; }
+      if(f3Prong) f3ProngCounters[k3ProngPassDCA]++;
+
+      threeTrackArray->AddAt(negtrack1,0);
+      threeTrackArray->AddAt(postrack1,1);
+      threeTrackArray->AddAt(negtrack2,2);
+
+      // check invariant mass cuts for D+,Ds,Lc
+      massCutOK=kTRUE;
+      if(fMassCutBeforeVertexing && f3Prong){
+        negtrack2->GetPxPyPz(momneg2);
+        Double_t pxDau[3]={momneg1[0],mompos1[0],momneg2[0]};
+        Double_t pyDau[3]={momneg1[1],mompos1[1],momneg2[1]};
+        Double_t pzDau[3]={momneg1[2],mompos1[2],momneg2[2]};
+        //	  massCutOK = SelectInvMassAndPt3prong(threeTrackArray);
+        massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
+      }
+      if(!massCutOK) {
+        threeTrackArray->Clear();
+        negtrack2=0;
+        continue;
+      }
+
+      // Vertexing
+      twoTrackArray2->AddAt(postrack1,0);
+      twoTrackArray2->AddAt(negtrack2,1);
+
+      if(f3Prong) {
+        f3ProngCounters[k3ProngPassMass]++;
+        AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
+        io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
+        if(ok3Prong) {
+          f3ProngCounters[k3ProngCandidates]++;
+          AliAODVertex *v3Prong = 0x0;
+          if(!fMakeReducedRHF) v3Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
+          if(!isLikeSign3Prong) {
+            rd = new(aodCharm3ProngRef[i3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
+            SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
+            SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
+            SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
+            if(fMakeReducedRHF){
+      	rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
+              ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
+            }else{
+      	rd->SetSecondaryVtx(v3Prong);
+      	v3Prong->SetParent(rd);
+      	AddRefs(v3Prong,rd,event,threeTrackArray);
+            }
+          } else { // isLikeSign3Prong
+            if(fLikeSign3prong){
+      	rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
+              SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
+              SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
+              SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
+              if(fMakeReducedRHF){
+      	  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
                 ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-	      }else{
-		rd->SetSecondaryVtx(v3Prong);
-		v3Prong->SetParent(rd);
-		AddRefs(v3Prong,rd,event,threeTrackArray);
-              }
-	    } else { // isLikeSign3Prong
-	      if(fLikeSign3prong){
-		rd = new(aodLikeSign3ProngRef[iLikeSign3Prong++])AliAODRecoDecayHF3Prong(*io3Prong);
-	        SetSelectionBitForPID(fCutsDplustoKpipi,rd,AliRDHFCuts::kDplusPID);
-	        SetSelectionBitForPID(fCutsDstoKKpi,rd,AliRDHFCuts::kDsPID);
-	        SetSelectionBitForPID(fCutsLctopKpi,rd,AliRDHFCuts::kLcPID);
-	        if(fMakeReducedRHF){
-		  rd->SetPrimaryVtxRef((AliAODVertex*)event->GetPrimaryVertex());
-                  ((AliAODRecoDecayHF3Prong*)rd)->DeleteRecoD();
-	        }else{
-                  rd->SetSecondaryVtx(v3Prong);
-                  v3Prong->SetParent(rd);
-                  AddRefs(v3Prong,rd,event,threeTrackArray);
-		}
-	      }
-
-	    }
-	  }
-	  if(io3Prong) {delete io3Prong; io3Prong=NULL;}
-	  if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
-	}
-	threeTrackArray->Clear();
-	negtrack2 = 0;
+              }else{
+                rd->SetSecondaryVtx(v3Prong);
+                v3Prong->SetParent(rd);
+                AddRefs(v3Prong,rd,event,threeTrackArray);
+      	}
+            }
 
-      } // end 2nd loop on negative tracks
+          }
+        }
+        if(io3Prong) {delete io3Prong; io3Prong=NULL;}
+        if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
+      }
+      threeTrackArray->Clear();
+      negtrack2 = 0;
 
-      twoTrackArray2->Clear();
+    } // end 2nd loop on negative tracks
 
-      negtrack1 = 0;
-      delete vertexp1n1;
-    } // end 1st loop on negative tracks
+    twoTrackArray2->Clear();
 
-    postrack1 = 0;
- }  // end 1st loop on positive tracks
+    negtrack1 = 0;
+    delete vertexp1n1;
+  } // end 1st loop on negative tracks
 
+  postrack1 = 0;
+  delete twoTrackArray1;
+  delete twoTrackArray2;
+  delete twoTrackArrayV0;
+  delete twoTrackArrayCasc;
+  delete threeTrackArray;
+  delete fourTrackArray;
+  delete [] okPresel3Prong;
+}
+//----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::CanRunInThreads() const
+{
+  /// The loop on positive tracks can be shared among threads only if the
+  /// stored candidates do not point to objects built in the loop (reduced
+  /// RHF) and if the track-to-vertex operations use only the event primary vertex
+
+  if(!fMakeReducedRHF) return kFALSE;
+  if(fMixEvent) return kFALSE;
+  if(fRecoPrimVtxSkippingTrks || fRmTrksFromPrimVtx) return kFALSE;
+  if(fSecVtxWithKF) return kFALSE; // AliKFParticle field is static
+  return kTRUE;
+}
+//----------------------------------------------------------------------------
+AliAnalysisVertexingHF* AliAnalysisVertexingHF::MakeWorker() const
+{
+  /// Copy of this object used by a worker thread. Vertexer, mass calculators
+  /// and candidate cuts are owned by the copy, the event data (primary vertex,
+  /// AOD track map) and the track filters are shared with this object
 
-  //  AliDebug(1,Form(" Total HF vertices in event = %d;",
-  //		  (Int_t)aodVerticesHFTClArr->GetEntriesFast()));
-  if(fD0toKpi) {
-    AliDebug(1,Form(" D0->Kpi in event = %d;",
-		    (Int_t)aodD0toKpiTClArr->GetEntriesFast()));
-  }
-  if(fJPSItoEle) {
-    AliDebug(1,Form(" JPSI->ee in event = %d;",
-		    (Int_t)aodJPSItoEleTClArr->GetEntriesFast()));
-  }
-  if(f3Prong) {
-    AliDebug(1,Form(" Charm->3Prong in event = %d;",
-		    (Int_t)aodCharm3ProngTClArr->GetEntriesFast()));
-  }
-  if(f4Prong) {
-    AliDebug(1,Form(" Charm->4Prong in event = %d;\n",
-		    (Int_t)aodCharm4ProngTClArr->GetEntriesFast()));
+  AliAnalysisVertexingHF *worker = new AliAnalysisVertexingHF(*this);
+  worker->fIsWorker = kTRUE;
+  worker->fMakeReducedRHF = fMakeReducedRHF;
+  worker->fNThreads = 0;
+  worker->fListOfCuts = 0x0;
+  worker->fVertexerTracks = new AliVertexerTracks(fBzkG);
+
+  Double_t d02[2]={0.,0.};
+  Double_t d03[3]={0.,0.,0.};
+  Double_t d04[4]={0.,0.,0.,0.};
+  worker->fMassCalc2 = new AliAODRecoDecay(0x0,2,0,d02);
+  worker->fMassCalc3 = new AliAODRecoDecay(0x0,3,1,d03);
+  worker->fMassCalc4 = new AliAODRecoDecay(0x0,4,0,d04);
+
+  worker->fCutsD0toKpi      = fCutsD0toKpi      ? (AliRDHFCutsD0toKpi*)fCutsD0toKpi->Clone()           : 0x0;
+  worker->fCutsJpsitoee     = fCutsJpsitoee     ? (AliRDHFCutsJpsitoee*)fCutsJpsitoee->Clone()         : 0x0;
+  worker->fCutsDplustoK0spi = fCutsDplustoK0spi ? (AliRDHFCutsDplustoK0spi*)fCutsDplustoK0spi->Clone() : 0x0;
+  worker->fCutsDplustoKpipi = fCutsDplustoKpipi ? (AliRDHFCutsDplustoKpipi*)fCutsDplustoKpipi->Clone() : 0x0;
+  worker->fCutsDstoK0sK     = fCutsDstoK0sK     ? (AliRDHFCutsDstoK0sK*)fCutsDstoK0sK->Clone()         : 0x0;
+  worker->fCutsDstoKKpi     = fCutsDstoKKpi     ? (AliRDHFCutsDstoKKpi*)fCutsDstoKKpi->Clone()         : 0x0;
+  worker->fCutsLctopKpi     = fCutsLctopKpi     ? (AliRDHFCutsLctopKpi*)fCutsLctopKpi->Clone()         : 0x0;
+  worker->fCutsLctoV0       = fCutsLctoV0       ? (AliRDHFCutsLctoV0*)fCutsLctoV0->Clone()             : 0x0;
+  worker->fCutsD0toKpipipi  = fCutsD0toKpipipi  ? (AliRDHFCutsD0toKpipipi*)fCutsD0toKpipipi->Clone()   : 0x0;
+  worker->fCutsDStartoKpipi = fCutsDStartoKpipi ? (AliRDHFCutsDStartoKpipi*)fCutsDStartoKpipi->Clone() : 0x0;
+
+  return worker;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::SetupWorker(AliAnalysisVertexingHF *worker,AliVEvent *event) const
+{
+  /// Pass the event data of this object to a worker and configure its
+  /// cuts for the event as done for the cuts of this object in FindCandidates
+
+  worker->fInputAOD = fInputAOD;
+  worker->fBzkG = fBzkG;
+  worker->fVertexerTracks->SetFieldkG(fBzkG);
+  worker->fV1 = fV1;
+  worker->fV1AOD = fV1AOD;
+  worker->fAODMapSize = fAODMapSize;
+  worker->fAODMap = fAODMap;
+  worker->fPidResponse = fPidResponse;
+  worker->fMinPt3Prong = fMinPt3Prong;
+  worker->fTrkTableSize = fTrkTableSize;
+  worker->fTrkTable = fTrkTable;
+  worker->fTrkTablePx = fTrkTablePx;
+  worker->fTrkTablePy = fTrkTablePy;
+  worker->fTrkTablePz = fTrkTablePz;
+  worker->fTrkTableEPi = fTrkTableEPi;
+  worker->fTrkTableEK = fTrkTableEK;
+  worker->fTrkTableEP = fTrkTableEP;
+  worker->fUse3ProngPresel = fUse3ProngPresel;
+  worker->f3ProngPreselMinPt2 = f3ProngPreselMinPt2;
+  for(Int_t i=0; i<6; i++) worker->f3ProngPreselMass2[i] = f3ProngPreselMass2[i];
+
+  worker->fCutsD0toKpi->IsEventSelected(event);
+  if(worker->fCutsJpsitoee) worker->fCutsJpsitoee->SetupPID(event);
+  if(worker->fCutsDplustoK0spi) worker->fCutsDplustoK0spi->SetupPID(event);
+  if(worker->fCutsDplustoKpipi) worker->fCutsDplustoKpipi->SetupPID(event);
+  if(worker->fCutsDstoK0sK) worker->fCutsDstoK0sK->SetupPID(event);
+  if(worker->fCutsDstoKKpi) worker->fCutsDstoKKpi->SetupPID(event);
+  if(worker->fCutsLctopKpi) worker->fCutsLctopKpi->SetupPID(event);
+  if(worker->fCutsLctoV0) worker->fCutsLctoV0->SetupPID(event);
+  if(worker->fCutsD0toKpipipi) worker->fCutsD0toKpipipi->SetupPID(event);
+  if(worker->fCutsDStartoKpipi) worker->fCutsDStartoKpipi->SetupPID(event);
+
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FindCandidatesInThreads(AliVEvent *event,
+						     const TObjArray &seleTrksArray,
+						     const TObjArray &tracksAtVertex,
+						     const UChar_t *seleFlags,
+						     const Int_t *evtNumber,
+						     Int_t nSeleTrks,Int_t trkEntries,Int_t nv0,
+						     Float_t dcaMax,Double_t minPtV0,
+						     TClonesArray **candArrays,Int_t *nCand)
+{
+  /// Loop on positive tracks shared among fNThreads threads.
+  /// Each thread runs FindCandidatesForPosTrack with its own copy of this
+  /// object (vertexer, cuts, mass calculators), its own copies of the
+  /// selected tracks (they are propagated during the vertexing) and its
+  /// own candidate arrays. The positive tracks are handed out one at a time.
+  /// The candidates are then appended to the output arrays in the order
+  /// of the serial loop: the output is the same as the serial one and does
+  /// not depend on the number of threads nor on the scheduling
+  //AliCodeTimerAuto("",0);
+
+  Int_t nThreads = TMath::Min(fNThreads,nSeleTrks);
+  if(nThreads<1) return;
+
+  if(!fWorkers) {
+    // TRefs to the objects built in the loop are created by the workers
+    ROOT::EnableThreadSafety();
+    fWorkers = new TObjArray(fNThreads);
+    fWorkers->SetOwner(kTRUE);
   }
-  if(fDstar) {
-    AliDebug(1,Form(" D*->D0pi in event = %d;\n",
-		    (Int_t)aodDstarTClArr->GetEntriesFast()));
+  while(fWorkers->GetEntriesFast()<nThreads) fWorkers->AddLast(MakeWorker());
+  for(Int_t iw=0; iw<nThreads; iw++) SetupWorker((AliAnalysisVertexingHF*)fWorkers->UncheckedAt(iw),event);
+
+  // unique IDs of the event objects referenced by the candidates (primary
+  // vertex) or by the selection (AOD daughters) are assigned here, so that
+  // they do not depend on the scheduling
+  TProcessID::AssignID(const_cast<AliVVertex*>(event->GetPrimaryVertex()));
+  if(fInputAOD) {
+    for(Int_t i=0; i<nSeleTrks; i++) {
+      Int_t id = (Int_t)((AliESDtrack*)seleTrksArray.UncheckedAt(i))->GetID();
+      if(id>-1 && id<fAODMapSize) TProcessID::AssignID(event->GetTrack(fAODMap[id]));
+    }
+    for(Int_t iv0=0; iv0<nv0; iv0++) TProcessID::AssignID(((AliAODEvent*)event)->GetV0(iv0));
   }
-  if(fCascades){
-    AliDebug(1,Form(" cascades -> v0 + track in event = %d;\n",
-		    (Int_t)aodCascadesTClArr->GetEntriesFast()));
+
+  // candidate arrays of the workers
+  std::vector<TClonesArray*> workerArrays(nThreads*kNCandArrays,0x0);
+  std::vector<Int_t> workerCand(nThreads*kNCandArrays,0);
+  for(Int_t iw=0; iw<nThreads; iw++) {
+    for(Int_t ia=0; ia<kNCandArrays; ia++) {
+      if(candArrays[ia]) workerArrays[iw*kNCandArrays+ia] = new TClonesArray(candArrays[ia]->GetClass());
+    }
   }
-  if(fLikeSign) {
-    AliDebug(1,Form(" Like-sign 2Prong in event = %d;\n",
-		    (Int_t)aodLikeSign2ProngTClArr->GetEntriesFast()));
+
+  // range of the candidates of each positive track in the arrays of its worker
+  std::vector<Int_t> trkWorker(nSeleTrks,-1);
+  std::vector<Int_t> trkFirstCand(nSeleTrks*kNCandArrays,0);
+  std::vector<Int_t> trkLastCand(nSeleTrks*kNCandArrays,0);
+  std::atomic<Int_t> nextTrk(0);
+
+  auto work = [&](Int_t iw) {
+    AliAnalysisVertexingHF *worker = (AliAnalysisVertexingHF*)fWorkers->UncheckedAt(iw);
+    TObjArray trksArray(nSeleTrks);
+    trksArray.SetOwner(kTRUE);
+    for(Int_t i=0; i<nSeleTrks; i++) trksArray.AddLast(new AliESDtrack(*(AliESDtrack*)seleTrksArray.UncheckedAt(i)));
+    TClonesArray **arrays = &workerArrays[iw*kNCandArrays];
+    Int_t *nWorkerCand = &workerCand[iw*kNCandArrays];
+    Int_t iTrkP1;
+    while((iTrkP1 = nextTrk++)<nSeleTrks) {
+      trkWorker[iTrkP1] = iw;
+      for(Int_t ia=0; ia<kNCandArrays; ia++) trkFirstCand[iTrkP1*kNCandArrays+ia] = nWorkerCand[ia];
+      worker->FindCandidatesForPosTrack(iTrkP1,event,trksArray,tracksAtVertex,seleFlags,evtNumber,
+					nSeleTrks,trkEntries,nv0,dcaMax,minPtV0,arrays,nWorkerCand);
+      for(Int_t ia=0; ia<kNCandArrays; ia++) trkLastCand[iTrkP1*kNCandArrays+ia] = nWorkerCand[ia];
+    }
+  };
+  std::vector<std::thread> threads;
+  for(Int_t iw=1; iw<nThreads; iw++) threads.push_back(std::thread(work,iw));
+  work(0);
+  for(UInt_t it=0; it<threads.size(); it++) threads[it].join();
+
+  for(Int_t iw=0; iw<nThreads; iw++) {
+    AliAnalysisVertexingHF *worker = (AliAnalysisVertexingHF*)fWorkers->UncheckedAt(iw);
+    for(Int_t i=0; i<k3ProngNStages; i++) f3ProngCounters[i] += worker->f3ProngCounters[i];
+    worker->Reset3ProngCounters();
+  }
+
+  // merge in the order of the positive tracks. The candidates are moved,
+  // not copied (the momenta of the reduced candidates are already deleted)
+  for(Int_t iTrkP1=0; iTrkP1<nSeleTrks; iTrkP1++) {
+    Int_t iw = trkWorker[iTrkP1];
+    // D0 daughter of the D*: the ID is the position in the D0 array
+    Int_t shiftD0 = nCand[kArrD0toKpi]-trkFirstCand[iTrkP1*kNCandArrays+kArrD0toKpi];
+    for(Int_t ia=0; ia<kNCandArrays; ia++) {
+      Int_t nTrkCand = trkLastCand[iTrkP1*kNCandArrays+ia]-trkFirstCand[iTrkP1*kNCandArrays+ia];
+      if(nTrkCand==0) continue;
+      // the candidates of the previous tracks of this worker have already been moved
+      candArrays[ia]->AbsorbObjects(workerArrays[iw*kNCandArrays+ia],0,nTrkCand-1);
+      if(ia==kArrDstar) {
+	for(Int_t ic=nCand[ia]; ic<nCand[ia]+nTrkCand; ic++) {
+	  AliAODRecoCascadeHF *rc = (AliAODRecoCascadeHF*)candArrays[ia]->UncheckedAt(ic);
+	  UShort_t idCasc[2]={rc->GetProngID(0),(UShort_t)(rc->GetProngID(1)+shiftD0)};
+	  rc->SetProngIDs(2,idCasc);
+	}
+      }
+      nCand[ia] += nTrkCand;
+    }
   }
-  if(fLikeSign3prong && f3Prong) {
-    AliDebug(1,Form(" Like-sign 3Prong in event = %d;\n",
-		    (Int_t)aodLikeSign3ProngTClArr->GetEntriesFast()));
+
+  for(UInt_t ia=0; ia<workerArrays.size(); ia++) {
+    if(!workerArrays[ia]) continue;
+    workerArrays[ia]->Delete();
+    delete workerArrays[ia];
   }
 
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FillTrackTable(const TObjArray &tracksAtVertex,Int_t nSeleTrks)
+{
+  /// Store the momenta at the primary vertex of the selected tracks and their
+  /// energies in the pion, kaon and proton hypotheses, one array per quantity,
+  /// and set the limits of the 3 prong preselection (Preselect3Prong) for this event
+
+  // the buffer is kept across events and only grown
+  if(nSeleTrks>fTrkTableCapacity || !fTrkTable) {
+    if(fTrkTable) delete [] fTrkTable;
+    fTrkTableCapacity = TMath::Max(nSeleTrks,1);
+    fTrkTable = new Double_t[6*fTrkTableCapacity];
+  }
+  fTrkTableSize = nSeleTrks;
+  fTrkTablePx  = fTrkTable;
+  fTrkTablePy  = fTrkTable+nSeleTrks;
+  fTrkTablePz  = fTrkTable+2*nSeleTrks;
+  fTrkTableEPi = fTrkTable+3*nSeleTrks;
+  fTrkTableEK  = fTrkTable+4*nSeleTrks;
+  fTrkTableEP  = fTrkTable+5*nSeleTrks;
+
+  Double_t massPi = TDatabasePDG::Instance()->GetParticle(211)->Mass();
+  Double_t massP  = TDatabasePDG::Instance()->GetParticle(2212)->Mass();
+  Double_t mom[3];
+  for(Int_t i=0; i<nSeleTrks; i++) {
+    ((AliExternalTrackParam*)tracksAtVertex.UncheckedAt(i))->GetPxPyPz(mom);
+    Double_t p2 = mom[0]*mom[0]+mom[1]*mom[1]+mom[2]*mom[2];
+    fTrkTablePx[i]  = mom[0];
+    fTrkTablePy[i]  = mom[1];
+    fTrkTablePz[i]  = mom[2];
+    fTrkTableEPi[i] = TMath::Sqrt(massPi*massPi+p2);
+    fTrkTableEK[i]  = TMath::Sqrt(fMassK*fMassK+p2);
+    fTrkTableEP[i]  = TMath::Sqrt(massP*massP+p2);
+  }
+
+  // the preselection replaces the mass cut before vertexing only for the
+  // triplets that the cut would reject: the windows are the union of the
+  // ones of all pt bins (no phi mass check for the Ds, no PID and no minimum
+  // pt for the Lc), enlarged by a small relative tolerance for the rounding
+  fUse3ProngPresel = f3Prong && fMassCutBeforeVertexing;
+  if(!fUse3ProngPresel) return;
+
+  const Double_t tol = 1.e-6;
+  f3ProngPreselMinPt2 = fMinPt3Prong>0.1 ? fMinPt3Prong*fMinPt3Prong*(1.-tol) : -1.;
+  Double_t mass[3] = {fMassDplus,fMassDs,fMassLambdaC};
+  for(Int_t is=0; is<3; is++) {
+    Int_t nPtBins = 1;
+    if(is==0) nPtBins = fCutsDplustoKpipi->GetNPtBins();
+    else if(is==1) nPtBins = fCutsDstoKKpi->GetNPtBins();
+    else nPtBins = fCutsLctopKpi->GetNPtBins();
+    Double_t lo2 = 1.e30, hi2 = 0.;
+    for(Int_t ib=0; ib<TMath::Max(nPtBins,1); ib++) {
+      Double_t mrange = 0.;
+      if(is==0) mrange = fCutsDplustoKpipi->GetMassCut(ib);
+      else if(is==1) mrange = fCutsDstoKKpi->GetMassCut(ib);
+      else mrange = fCutsLctopKpi->GetMassCut(ib);
+      Double_t lolim = mass[is]-mrange;
+      Double_t hilim = mass[is]+mrange;
+      lo2 = TMath::Min(lo2,lolim*lolim);
+      hi2 = TMath::Max(hi2,hilim*hilim);
+    }
+    f3ProngPreselMass2[2*is]   = lo2*(1.-tol);
+    f3ProngPreselMass2[2*is+1] = hi2*(1.+tol);
+  }
 
-  twoTrackArray1->Delete();  delete twoTrackArray1;
-  twoTrackArray2->Delete();  delete twoTrackArray2;
-  twoTrackArrayCasc->Delete();  delete twoTrackArrayCasc;
-  twoTrackArrayV0->Delete();  delete twoTrackArrayV0;
-  threeTrackArray->Clear();
-  threeTrackArray->Delete(); delete threeTrackArray;
-  fourTrackArray->Delete();  delete fourTrackArray;
-  delete [] seleFlags; seleFlags=NULL;
-  if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
-  tracksAtVertex.Delete();
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::Preselect3Prong(const Double_t *mom0,const Double_t *mom1,Int_t iFirst,
+					     UChar_t *okPresel) const
+{
+  /// Loose pt and invariant mass preselection of the triplets (0,1,j), j>=iFirst,
+  /// with the third track from the track table. mom0 and mom1 are the momenta of
+  /// the first two tracks used by the mass cut before vertexing. The middle track
+  /// is the kaon in all hypotheses: pi K pi (D+), K K pi and pi K K (Ds), p K pi
+  /// and pi K p (Lc).
+  /// okPresel[j] is set to 0 only if SelectInvMassAndPt3prong rejects the triplet
+  //AliCodeTimerAuto("",0);
 
-  if(fInputAOD) {
-    seleTrksArray.Delete();
-    if(fAODMap) { delete [] fAODMap; fAODMap=NULL; }
+  const Double_t massPi = TDatabasePDG::Instance()->GetParticle(211)->Mass();
+  const Double_t massP  = TDatabasePDG::Instance()->GetParticle(2212)->Mass();
+  const Double_t p20 = mom0[0]*mom0[0]+mom0[1]*mom0[1]+mom0[2]*mom0[2];
+  const Double_t p21 = mom1[0]*mom1[0]+mom1[1]*mom1[1]+mom1[2]*mom1[2];
+  const Double_t eK1  = TMath::Sqrt(fMassK*fMassK+p21);
+  const Double_t px01 = mom0[0]+mom1[0];
+  const Double_t py01 = mom0[1]+mom1[1];
+  const Double_t pz01 = mom0[2]+mom1[2];
+  const Double_t ePiK = TMath::Sqrt(massPi*massPi+p20)+eK1;
+  const Double_t eKK  = TMath::Sqrt(fMassK*fMassK+p20)+eK1;
+  const Double_t ePK  = TMath::Sqrt(massP*massP+p20)+eK1;
+  const Double_t *lim = f3ProngPreselMass2;
+
+  for(Int_t j=iFirst; j<fTrkTableSize; j++) {
+    Double_t px = px01+fTrkTablePx[j];
+    Double_t py = py01+fTrkTablePy[j];
+    Double_t pz = pz01+fTrkTablePz[j];
+    Double_t pt2 = px*px+py*py;
+    Double_t p2 = pt2+pz*pz;
+    Double_t e = ePiK+fTrkTableEPi[j];
+    Double_t minv2 = e*e-p2;
+    Bool_t ok = (minv2>lim[0] && minv2<lim[1]);
+    e = eKK+fTrkTableEPi[j];
+    minv2 = e*e-p2;
+    ok |= (minv2>lim[2] && minv2<lim[3]);
+    e = ePiK+fTrkTableEK[j];
+    minv2 = e*e-p2;
+    ok |= (minv2>lim[2] && minv2<lim[3]);
+    e = ePK+fTrkTableEPi[j];
+    minv2 = e*e-p2;
+    ok |= (minv2>lim[4] && minv2<lim[5]);
+    e = ePiK+fTrkTableEP[j];
+    minv2 = e*e-p2;
+    ok |= (minv2>lim[4] && minv2<lim[5]);
+    okPresel[j] = (ok && pt2>=f3ProngPreselMinPt2);
   }
 
+  return;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::Print3ProngCounters() const
+{
+  /// Print the number of triplets removed by each stage of the 3 prong combinatorics
 
-  //printf("Trks: total %d  sele %d\n",fnTrksTotal,fnSeleTrksTotal);
+  const Long64_t *c = f3ProngCounters;
+  printf("3 prong triplets tested: %lld\n",c[k3ProngTested]);
+  printf("  rejected by preselection on track table: %lld%s\n",c[k3ProngTested]-c[k3ProngPassPresel],
+	 (f3Prong && fMassCutBeforeVertexing) ? "" : " (preselection off: needs mass cut before vertexing)");
+  printf("  rejected by DCA cuts:                    %lld\n",c[k3ProngPassPresel]-c[k3ProngPassDCA]);
+  printf("  rejected by mass cuts before vertexing:  %lld\n",c[k3ProngPassDCA]-c[k3ProngPassMass]);
+  printf("  rejected after vertexing:                %lld\n",c[k3ProngPassMass]-c[k3ProngCandidates]);
+  printf("  accepted:                                %lld\n",c[k3ProngCandidates]);
 
   return;
 }
@@ -2932,6 +3404,7 @@ void AliAnalysisVertexingHF::PrintStatus() const {
   }
   if(fRecoPrimVtxSkippingTrks) printf("RecoPrimVtxSkippingTrks\n");
   if(fRmTrksFromPrimVtx) printf("RmTrksFromPrimVtx\n");
+  if(fNThreads>1) printf("Candidate finding shared among %d threads\n",fNThreads);
   if(fD0toKpi) {
     printf("Reconstruct D0->Kpi candidates with cuts:\n");
     if(fCutsD0toKpi) fCutsD0toKpi->PrintAll();
@@ -94,6 +94,11 @@ class AliAnalysisVertexingHF : public TNamed {
   void SetMixEventOff() { fMixEvent=kFALSE; }
   void SetInputAOD() { fInputAOD=kTRUE; }
   void SetMakeReducedRHF(Bool_t makeredAOD=kFALSE) { fMakeReducedRHF=makeredAOD; }
+  /// number of threads sharing the loop on positive tracks in FindCandidates
+  /// (0 or 1: serial). Available only with reduced RHF output. The
+  /// candidates are the same as in the serial loop (see
+  /// macros/CheckVertexingHFThreads.C)
+  void SetNThreads(Int_t nthreads=0) { fNThreads=nthreads; }
   Bool_t GetD0toKpi() const { return fD0toKpi; }
   Bool_t GetJPSItoEle() const { return fJPSItoEle; }
   Bool_t Get3Prong() const { return f3Prong; }
@@ -107,6 +112,14 @@ class AliAnalysisVertexingHF : public TNamed {
   Bool_t GetRecoPrimVtxSkippingTrks() const {return fRecoPrimVtxSkippingTrks;}
   Bool_t GetRmTrksFromPrimVtx() const {return fRmTrksFromPrimVtx;}
   Bool_t GetMakeReducedRHF() const {return fMakeReducedRHF;}
+  Int_t  GetNThreads() const {return fNThreads;}
+  /// counters of the 3 prong combinatorics: triplets tested, passing the
+  /// preselection on the track table, the DCA cuts, the invariant mass cuts
+  /// and the candidate selection
+  enum E3ProngStage_t { k3ProngTested = 0, k3ProngPassPresel, k3ProngPassDCA, k3ProngPassMass, k3ProngCandidates, k3ProngNStages };
+  Long64_t Get3ProngCounter(Int_t stage) const {return (stage>=0 && stage<k3ProngNStages) ? f3ProngCounters[stage] : 0;}
+  void Reset3ProngCounters() { for(Int_t i=0; i<k3ProngNStages; i++) f3ProngCounters[i]=0; }
+  void Print3ProngCounters() const;
   void SetFindVertexForDstar(Bool_t vtx=kTRUE) { fFindVertexForDstar=vtx; }
   void SetFindVertexForCascades(Bool_t vtx=kTRUE) { fFindVertexForCascades=vtx; }
 
@@ -250,6 +263,8 @@ class AliAnalysisVertexingHF : public TNamed {
  private:
   //
   enum { kBitDispl = 0, kBitSoftPi = 1, kBit3Prong = 2, kBitPionCompat = 3, kBitKaonCompat = 4, kBitProtonCompat = 5, kBitBachelor = 6};
+  /// output arrays of FindCandidates
+  enum { kArrVerticesHF = 0, kArrD0toKpi, kArrJPSItoEle, kArrCharm3Prong, kArrCharm4Prong, kArrDstar, kArrCascades, kArrLikeSign2Prong, kArrLikeSign3Prong, kNCandArrays };
 
   Bool_t fInputAOD; /// input from AOD (kTRUE) or ESD (kFALSE)
   Int_t fAODMapSize; /// size of fAODMap
@@ -345,6 +360,25 @@ class AliAnalysisVertexingHF : public TNamed {
   Int_t  fnTrksTotal;
   Int_t  fnSeleTrksTotal;
   Bool_t fMakeReducedRHF;// switch the reduction of dAOD size on/off
+  Int_t  fNThreads; /// number of threads for the candidate finding (0 or 1: serial)
+  TObjArray *fWorkers; //! copies of this object used by the worker threads
+  Bool_t fIsWorker; //! this object is a worker copy (shares the event data of its parent)
+
+  /// momenta at the primary vertex and energies in the pi, K, p hypotheses
+  /// of the selected tracks (one array per quantity), filled once per event
+  Int_t     fTrkTableSize;  //! number of tracks in the table
+  Int_t     fTrkTableCapacity; //! number of tracks allocated in fTrkTable
+  Double_t *fTrkTable;      //! buffer of the table (owned by the parent object)
+  Double_t *fTrkTablePx;    //! px at the primary vertex
+  Double_t *fTrkTablePy;    //! py at the primary vertex
+  Double_t *fTrkTablePz;    //! pz at the primary vertex
+  Double_t *fTrkTableEPi;   //! energy, pion hypothesis
+  Double_t *fTrkTableEK;    //! energy, kaon hypothesis
+  Double_t *fTrkTableEP;    //! energy, proton hypothesis
+  Bool_t    fUse3ProngPresel;         //! 3 prong preselection on the track table active in this event
+  Double_t  f3ProngPreselMinPt2;      //! squared pt threshold of the preselection
+  Double_t  f3ProngPreselMass2[6];    //! squared mass windows (D+, Ds, Lc) of the preselection
+  Long64_t  f3ProngCounters[k3ProngNStages]; //! triplets reaching each stage of the 3 prong combinatorics
 
   Double_t fMassDzero;
   Double_t fMassDplus;
@@ -398,6 +432,24 @@ class AliAnalysisVertexingHF : public TNamed {
 				   Double_t dca,
 				   Bool_t &okCascades);
 
+  void FindCandidatesForPosTrack(Int_t iTrkP1,AliVEvent *event,
+				 TObjArray &seleTrksArray,const TObjArray &tracksAtVertex,
+				 const UChar_t *seleFlags,const Int_t *evtNumber,
+				 Int_t nSeleTrks,Int_t trkEntries,Int_t nv0,
+				 Float_t dcaMax,Double_t minPtV0,
+				 TClonesArray **candArrays,Int_t *nCand);
+  void FindCandidatesInThreads(AliVEvent *event,
+			       const TObjArray &seleTrksArray,const TObjArray &tracksAtVertex,
+			       const UChar_t *seleFlags,const Int_t *evtNumber,
+			       Int_t nSeleTrks,Int_t trkEntries,Int_t nv0,
+			       Float_t dcaMax,Double_t minPtV0,
+			       TClonesArray **candArrays,Int_t *nCand);
+  Bool_t CanRunInThreads() const;
+  AliAnalysisVertexingHF* MakeWorker() const;
+  void   SetupWorker(AliAnalysisVertexingHF *worker,AliVEvent *event) const;
+  void   FillTrackTable(const TObjArray &tracksAtVertex,Int_t nSeleTrks);
+  void   Preselect3Prong(const Double_t *mom0,const Double_t *mom1,Int_t iFirst,UChar_t *okPresel) const;
+
   void MapAODtracks(AliVEvent *aod);
   AliAODVertex* PrimaryVertex(const TObjArray *trkArray=0x0,AliVEvent *event=0x0) const;
   AliAODVertex* ReconstructSecondaryVertex(TObjArray *trkArray,Double_t &dispersion,Bool_t useTRefArray=kTRUE) const;
@@ -429,7 +481,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				  TObjArray *twoTrackArrayV0);
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,30);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,32);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
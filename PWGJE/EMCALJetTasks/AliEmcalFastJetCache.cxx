@@ -0,0 +1,377 @@
+/**************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                   *
+ * All rights reserved.                                                               *
+ *                                                                                    *
+ * Redistribution and use in source and binary forms, with or without                 *
+ * modification, are permitted provided that the following conditions are met:        *
+ *     * Redistributions of source code must retain the above copyright               *
+ *       notice, this list of conditions and the following disclaimer.                *
+ *     * Redistributions in binary form must reproduce the above copyright            *
+ *       notice, this list of conditions and the following disclaimer in the          *
+ *       documentation and/or other materials provided with the distribution.         *
+ *     * Neither the name of the <organization> nor the                               *
+ *       names of its contributors may be used to endorse or promote products         *
+ *       derived from this software without specific prior written permission.        *
+ *                                                                                    *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND    *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED      *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE             *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY                *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES         *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;       *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND        *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT         *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS      *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ **************************************************************************************/
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include <TMath.h>
+
+#include "AliLog.h"
+
+#include "AliEmcalFastJetCache.h"
+
+AliEmcalFastJetCache *AliEmcalFastJetCache::fgInstance = nullptr;
+
+/**
+ * Get instance of the cache. If called for the first time a new object is created
+ * @return Shared FastJet cache
+ */
+AliEmcalFastJetCache *AliEmcalFastJetCache::Instance()
+{
+  if (!fgInstance) {
+    fgInstance = new AliEmcalFastJetCache;
+  }
+  return fgInstance;
+}
+
+/**
+ * Default constructor (singleton)
+ */
+AliEmcalFastJetCache::AliEmcalFastJetCache() :
+  fDefinitions(),
+  fGroups(),
+  fGrids(),
+  fCurrentEvent(-1),
+  fTotalGhostTime(0.),
+  fWorkers(),
+  fQueue(),
+  fNPending(0),
+  fStop(kFALSE),
+  fMutex(),
+  fWorkCondition(),
+  fDoneCondition()
+{
+}
+
+/**
+ * Destructor: stops the workers and releases the cluster sequences
+ */
+AliEmcalFastJetCache::~AliEmcalFastJetCache()
+{
+  StopWorkers();
+  for (auto &def : fDefinitions) {
+    delete def.fClustSeq;
+    delete def.fJetDef;
+  }
+  for (auto &grid : fGrids) delete grid.fSpec;
+  if (fgInstance == this) fgInstance = nullptr;
+}
+
+/**
+ * Register a jet definition. Identical definitions on the same input group
+ * share the same ID, hence the same cluster sequence.
+ */
+Int_t AliEmcalFastJetCache::RegisterDefinition(const char *inputs, fastjet::JetAlgorithm algo, Double_t radius, fastjet::RecombinationScheme scheme,
+                                               Double_t ghostArea, Double_t maxRap, Bool_t legacy)
+{
+  if (algo == fastjet::plugin_algorithm || algo == fastjet::undefined_jet_algorithm) {
+    AliErrorGeneral("AliEmcalFastJetCache", "Plugin or undefined jet algorithms are not supported");
+    return -1;
+  }
+
+  // definitions must not move while workers are clustering
+  std::unique_lock<std::mutex> lock(fMutex);
+  fDoneCondition.wait(lock, [this] { return fNPending == 0; });
+
+  Int_t igroup = -1;
+  for (UInt_t i = 0; i < fGroups.size(); i++) {
+    if (fGroups[i].fName == inputs) { igroup = i; break; }
+  }
+
+  Int_t igrid = -1;
+  for (UInt_t i = 0; i < fGrids.size(); i++) {
+    if (TMath::Abs(fGrids[i].fGhostArea - ghostArea) < 1e-9 && TMath::Abs(fGrids[i].fMaxRap - maxRap) < 1e-9 && fGrids[i].fLegacy == legacy) {
+      igrid = i;
+      break;
+    }
+  }
+
+  if (igroup >= 0 && igrid >= 0) {
+    for (auto id : fGroups[igroup].fDefinitions) {
+      const Definition &def = fDefinitions[id];
+      if (def.fGrid == igrid && def.fJetDef->jet_algorithm() == algo && def.fJetDef->recombination_scheme() == scheme &&
+          TMath::Abs(def.fJetDef->R() - radius) < 1e-9) {
+        AliInfoGeneral("AliEmcalFastJetCache", Form("Sharing definition %d: %s", id, def.fName.Data()));
+        return id;
+      }
+    }
+  }
+
+  fastjet::JetDefinition *jetDef = 0;
+  try {
+    jetDef = new fastjet::JetDefinition(algo, radius, scheme, fastjet::Best);
+  } catch (fastjet::Error) {
+    AliErrorGeneral("AliEmcalFastJetCache", " [w] FJ Exception caught.");
+    return -1;
+  }
+
+  if (igroup < 0) {
+    InputGroup group;
+    group.fName = inputs;
+    group.fFilled = kFALSE;
+    fGroups.push_back(group);
+    igroup = fGroups.size() - 1;
+  }
+
+  if (igrid < 0) {
+    GhostGrid grid;
+    grid.fGhostArea = ghostArea;
+    grid.fMaxRap = maxRap;
+    grid.fLegacy = legacy;
+    // same settings as AliFJWrapper (one repetition, default scatter)
+    grid.fSpec = new fastjet::GhostedAreaSpec(maxRap, 1, ghostArea, 1.0, 0.1, 1e-100);
+#ifdef FASTJET_VERSION
+    if (legacy) grid.fSpec->set_fj2_placement(kTRUE);
+#endif
+    grid.fActualGhostArea = ghostArea;
+    grid.fFilled = kFALSE;
+    fGrids.push_back(grid);
+    igrid = fGrids.size() - 1;
+  }
+
+  Definition def;
+  def.fName = Form("%s, %s, ghost area %.3f", inputs, jetDef->description().c_str(), ghostArea);
+  def.fJetDef = jetDef;
+  def.fGroup = igroup;
+  def.fGrid = igrid;
+  def.fState = kIdle;
+  def.fClustSeq = 0;
+  def.fTime = -1;
+  def.fTotalTime = 0;
+  def.fNClustered = 0;
+  def.fNRequests = 0;
+  def.fNMismatches = 0;
+  fDefinitions.push_back(def);
+
+  Int_t id = fDefinitions.size() - 1;
+  fGroups[igroup].fDefinitions.push_back(id);
+  AliInfoGeneral("AliEmcalFastJetCache", Form("Registered definition %d: %s", id, def.fName.Data()));
+  return id;
+}
+
+/**
+ * Set the number of worker threads. Pending work is finished before
+ * the workers are replaced.
+ */
+void AliEmcalFastJetCache::SetNThreads(Int_t nthreads)
+{
+  StopWorkers();
+  if (nthreads <= 0) return;
+
+  // the banner is printed at the first clustering, not thread safe in older FastJet versions
+  fastjet::ClusterSequence::print_banner();
+
+  fStop = kFALSE;
+  for (Int_t i = 0; i < nthreads; i++) fWorkers.push_back(std::thread(&AliEmcalFastJetCache::WorkerLoop, this));
+}
+
+/**
+ * Get the cluster sequence of a definition for the current event. The first request
+ * of an input group in an event stores the inputs, generates the ghosts and (with
+ * worker threads) queues the clustering of all definitions of the group.
+ */
+fastjet::ClusterSequenceAreaBase *AliEmcalFastJetCache::GetClusterSequence(Int_t id, Long64_t event, const std::vector<fastjet::PseudoJet> &inputs)
+{
+  if (id < 0 || id >= (Int_t)fDefinitions.size()) return 0;
+
+  std::unique_lock<std::mutex> lock(fMutex);
+  if (event != fCurrentEvent) {
+    ResetEvent(lock);
+    fCurrentEvent = event;
+  }
+
+  Definition &def = fDefinitions[id];
+  InputGroup &group = fGroups[def.fGroup];
+  def.fNRequests++;
+
+  if (!group.fFilled) {
+    group.fInputs = inputs;
+    group.fFilled = kTRUE;
+    for (auto idef : group.fDefinitions) FillGhosts(fGrids[fDefinitions[idef].fGrid]);
+    if (!fWorkers.empty()) {
+      for (auto idef : group.fDefinitions) {
+        if (fDefinitions[idef].fState != kIdle) continue;
+        fDefinitions[idef].fState = kQueued;
+        fQueue.push_back(idef);
+        fNPending++;
+      }
+      fWorkCondition.notify_all();
+    }
+  }
+
+  if (!SameInputs(group.fInputs, inputs)) {
+    def.fNMismatches++;
+    return 0;
+  }
+
+  if (def.fState == kQueued) {
+    // not picked up by a worker yet: cluster it here rather than waiting
+    for (auto it = fQueue.begin(); it != fQueue.end(); ++it) {
+      if (*it == id) { fQueue.erase(it); break; }
+    }
+    fNPending--;
+    def.fState = kIdle;
+  }
+
+  if (def.fState == kIdle) {
+    def.fState = kRunning;
+    lock.unlock();
+    Cluster(id);
+    lock.lock();
+    def.fState = kDone;
+    fDoneCondition.notify_all();
+  }
+  else {
+    fDoneCondition.wait(lock, [&def] { return def.fState == kDone; });
+  }
+
+  return def.fClustSeq;
+}
+
+/**
+ * Release the cluster sequences of the previous event
+ */
+void AliEmcalFastJetCache::ResetEvent(std::unique_lock<std::mutex> &lock)
+{
+  fDoneCondition.wait(lock, [this] { return fNPending == 0; });
+
+  for (auto &def : fDefinitions) {
+    delete def.fClustSeq;
+    def.fClustSeq = 0;
+    def.fState = kIdle;
+    def.fTime = -1;
+  }
+  for (auto &group : fGroups) {
+    group.fInputs.clear();
+    group.fFilled = kFALSE;
+  }
+  for (auto &grid : fGrids) grid.fFilled = kFALSE;
+}
+
+/**
+ * Generate the ghosts of a grid for the current event (if not yet done)
+ */
+void AliEmcalFastJetCache::FillGhosts(GhostGrid &grid)
+{
+  if (grid.fFilled) return;
+
+  auto start = std::chrono::steady_clock::now();
+  grid.fGhosts.clear();
+  grid.fSpec->add_ghosts(grid.fGhosts);
+  grid.fActualGhostArea = grid.fSpec->actual_ghost_area();
+  grid.fFilled = kTRUE;
+  fTotalGhostTime += std::chrono::duration<Double_t, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Cluster a definition on the inputs of its group with the ghosts of its grid.
+ * Called without lock: inputs and ghosts are not modified while clustering is pending.
+ */
+void AliEmcalFastJetCache::Cluster(Int_t id)
+{
+  Definition &def = fDefinitions[id];
+  const InputGroup &group = fGroups[def.fGroup];
+  const GhostGrid &grid = fGrids[def.fGrid];
+
+  auto start = std::chrono::steady_clock::now();
+  try {
+    def.fClustSeq = new fastjet::ClusterSequenceActiveAreaExplicitGhosts(group.fInputs, *def.fJetDef, grid.fGhosts, grid.fActualGhostArea);
+  } catch (fastjet::Error) {
+    def.fClustSeq = 0;
+  }
+  def.fTime = std::chrono::duration<Double_t, std::milli>(std::chrono::steady_clock::now() - start).count();
+  def.fTotalTime += def.fTime;
+  def.fNClustered++;
+}
+
+/**
+ * Main loop of the worker threads
+ */
+void AliEmcalFastJetCache::WorkerLoop()
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  while (kTRUE) {
+    fWorkCondition.wait(lock, [this] { return fStop || !fQueue.empty(); });
+    if (fQueue.empty()) return;
+
+    Int_t id = fQueue.front();
+    fQueue.pop_front();
+    fDefinitions[id].fState = kRunning;
+
+    lock.unlock();
+    Cluster(id);
+    lock.lock();
+
+    fDefinitions[id].fState = kDone;
+    fNPending--;
+    fDoneCondition.notify_all();
+  }
+}
+
+/**
+ * Finish the queued work and join the worker threads
+ */
+void AliEmcalFastJetCache::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  fWorkCondition.notify_all();
+  for (auto &worker : fWorkers) worker.join();
+  fWorkers.clear();
+  fStop = kFALSE;
+}
+
+/**
+ * Compare two lists of input vectors (momentum and user index)
+ */
+Bool_t AliEmcalFastJetCache::SameInputs(const std::vector<fastjet::PseudoJet> &a, const std::vector<fastjet::PseudoJet> &b)
+{
+  if (a.size() != b.size()) return kFALSE;
+  for (UInt_t i = 0; i < a.size(); i++) {
+    if (a[i].user_index() != b[i].user_index() || a[i].px() != b[i].px() || a[i].py() != b[i].py() ||
+        a[i].pz() != b[i].pz() || a[i].E() != b[i].E()) return kFALSE;
+  }
+  return kTRUE;
+}
+
+/**
+ * Print the clustering time per definition
+ */
+void AliEmcalFastJetCache::PrintTimings() const
+{
+  std::cout << "AliEmcalFastJetCache: " << fWorkers.size() << " worker thread(s), ghost generation "
+            << std::fixed << std::setprecision(2) << fTotalGhostTime << " ms" << std::endl;
+  for (UInt_t i = 0; i < fDefinitions.size(); i++) {
+    const Definition &def = fDefinitions[i];
+    Double_t mean = def.fNClustered > 0 ? def.fTotalTime / def.fNClustered : 0.;
+    std::cout << "  [" << i << "] " << def.fName << std::endl
+              << "      events " << def.fNClustered << ", requests " << def.fNRequests << ", input mismatches " << def.fNMismatches
+              << ", total " << def.fTotalTime << " ms, mean " << mean << " ms/event" << std::endl;
+  }
+}
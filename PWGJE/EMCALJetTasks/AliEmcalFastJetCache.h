@@ -0,0 +1,201 @@
+/**************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                   *
+ * All rights reserved.                                                               *
+ *                                                                                    *
+ * Redistribution and use in source and binary forms, with or without                 *
+ * modification, are permitted provided that the following conditions are met:        *
+ *     * Redistributions of source code must retain the above copyright               *
+ *       notice, this list of conditions and the following disclaimer.                *
+ *     * Redistributions in binary form must reproduce the above copyright            *
+ *       notice, this list of conditions and the following disclaimer in the          *
+ *       documentation and/or other materials provided with the distribution.         *
+ *     * Neither the name of the <organization> nor the                               *
+ *       names of its contributors may be used to endorse or promote products         *
+ *       derived from this software without specific prior written permission.        *
+ *                                                                                    *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND    *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED      *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE             *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY                *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES         *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;       *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND        *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT         *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS      *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ **************************************************************************************/
+#ifndef ALIEMCALFASTJETCACHE_H
+#define ALIEMCALFASTJETCACHE_H
+
+#if !defined(__CINT__) && !defined(__MAKECINT__)
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <TString.h>
+
+#include "FJ_includes.h"
+
+/**
+ * @class AliEmcalFastJetCache
+ * @brief Event-level FastJet clustering service shared among jet finder tasks
+ * @ingroup PWGJEBASE
+ *
+ * A jet train typically runs several AliEmcalJetTask instances (different R,
+ * algorithms, kt for rho) on the same tracks and clusters. Each of them would
+ * otherwise generate its own ghosts and run its own cluster sequence. The
+ * cache, used as singleton, is shared among these tasks:
+ *
+ * - jet finders register their jet definition once (ExecOnce), together with
+ *   a key describing their input (containers). Identical registrations get the
+ *   same definition ID and share one cluster sequence per event;
+ * - the ghost grid is generated once per event for each ghost area / rapidity
+ *   range and reused by all definitions (explicit ghosts);
+ * - the first task of an input group submitting its input vectors in a new event
+ *   triggers the clustering of all definitions of the group, in parallel if worker
+ *   threads are enabled (SetNThreads). Tasks running later find their cluster
+ *   sequence ready. The input vectors submitted by each task are compared to the
+ *   ones of the group: in case of mismatch no cluster sequence is returned and the
+ *   task is expected to run the jet finder on its own;
+ * - the wall time spent in clustering is stored per definition and event.
+ *
+ * ~~~{.cxx}
+ * AliEmcalFastJetCache *cache = AliEmcalFastJetCache::Instance();
+ * cache->SetNThreads(4);
+ * // in the jet finder: once
+ * Int_t id = cache->RegisterDefinition("tracks", fastjet::antikt_algorithm, 0.4, fastjet::pt_scheme, 0.005, 1.);
+ * // each event
+ * fastjet::ClusterSequenceAreaBase *cs = cache->GetClusterSequence(id, entry, inputs);
+ * ~~~
+ *
+ * Running several cluster sequences concurrently requires FastJet built
+ * with (limited) thread safety. The cluster sequences are owned by the cache
+ * and are valid until the next event is requested.
+ */
+class AliEmcalFastJetCache {
+public:
+
+  /**
+   * Get instance of the cache. If called for the first time a new object is created
+   * @return Shared FastJet cache
+   */
+  static AliEmcalFastJetCache *Instance();
+
+  virtual ~AliEmcalFastJetCache();
+
+  /**
+   * Register a jet definition. Clustering uses active areas with explicit ghosts.
+   * @param inputs Key of the input group (tasks with the same key are expected to use the same input vectors)
+   * @param algo Jet algorithm (plugins not supported)
+   * @param radius Jet radius
+   * @param scheme Recombination scheme
+   * @param ghostArea Ghost area
+   * @param maxRap Maximum rapidity of the ghosts
+   * @param legacy FastJet 2.x ghost placement
+   * @return ID of the definition, -1 if not supported
+   */
+  Int_t RegisterDefinition(const char *inputs, fastjet::JetAlgorithm algo, Double_t radius, fastjet::RecombinationScheme scheme,
+                           Double_t ghostArea, Double_t maxRap, Bool_t legacy = kFALSE);
+
+  /**
+   * Set the number of worker threads clustering the definitions of an input group
+   * in parallel. 0 (default) means on demand clustering in the calling thread.
+   * @param nthreads Number of worker threads
+   */
+  void SetNThreads(Int_t nthreads);
+
+  /**
+   * Get the cluster sequence of a definition for the current event.
+   * @param id ID of the definition
+   * @param event Event identifier (e.g. entry of the analysis manager), must change from one event to the next
+   * @param inputs Input vectors of the calling task
+   * @return Cluster sequence (owned by the cache), 0 if the inputs differ from the ones of the input group or in case of FastJet error
+   */
+  fastjet::ClusterSequenceAreaBase *GetClusterSequence(Int_t id, Long64_t event, const std::vector<fastjet::PseudoJet> &inputs);
+
+  Int_t       GetNDefinitions() const                  { return fDefinitions.size()                    ; }
+  Int_t       GetNThreads() const                      { return fWorkers.size()                        ; }
+  const char *GetDefinitionName(Int_t id) const        { return fDefinitions[id].fName.Data()          ; }
+  /// Clustering time (ms) of a definition in the current event (-1 if not clustered)
+  Double_t    GetClusteringTime(Int_t id) const        { return fDefinitions[id].fTime                 ; }
+  /// Clustering time (ms) of a definition summed over all events
+  Double_t    GetTotalClusteringTime(Int_t id) const   { return fDefinitions[id].fTotalTime            ; }
+  Int_t       GetNClustered(Int_t id) const            { return fDefinitions[id].fNClustered           ; }
+  Int_t       GetNRequests(Int_t id) const             { return fDefinitions[id].fNRequests            ; }
+  Int_t       GetNMismatches(Int_t id) const           { return fDefinitions[id].fNMismatches          ; }
+  /// Time (ms) spent generating ghosts, summed over all events
+  Double_t    GetTotalGhostTime() const                { return fTotalGhostTime                        ; }
+
+  void        PrintTimings() const;
+
+protected:
+  /// Ghost grid shared by the definitions with the same ghost area and rapidity range
+  struct GhostGrid {
+    Double_t                         fGhostArea;       ///< requested ghost area
+    Double_t                         fMaxRap;          ///< maximum rapidity
+    Bool_t                           fLegacy;          ///< FastJet 2.x placement
+    fastjet::GhostedAreaSpec        *fSpec;            ///< generator of the ghosts
+    std::vector<fastjet::PseudoJet>  fGhosts;          ///< ghosts of the current event
+    Double_t                         fActualGhostArea; ///< ghost area after placement
+    Bool_t                           fFilled;          ///< ghosts generated for the current event
+  };
+
+  /// Definitions registered with the same input key
+  struct InputGroup {
+    TString                          fName;            ///< input key
+    std::vector<Int_t>               fDefinitions;     ///< IDs of the definitions
+    std::vector<fastjet::PseudoJet>  fInputs;          ///< input vectors of the current event
+    Bool_t                           fFilled;          ///< inputs submitted for the current event
+  };
+
+  enum EState_t { kIdle, kQueued, kRunning, kDone };
+
+  struct Definition {
+    TString                            fName;          ///< description of the definition
+    fastjet::JetDefinition            *fJetDef;        ///< FastJet jet definition
+    Int_t                              fGroup;         ///< index of the input group
+    Int_t                              fGrid;          ///< index of the ghost grid
+    EState_t                           fState;         ///< clustering state in the current event
+    fastjet::ClusterSequenceAreaBase  *fClustSeq;      ///< cluster sequence of the current event
+    Double_t                           fTime;          ///< clustering time (ms) in the current event
+    Double_t                           fTotalTime;     ///< clustering time (ms) summed over all events
+    Int_t                              fNClustered;    ///< number of clustered events
+    Int_t                              fNRequests;     ///< number of requests
+    Int_t                              fNMismatches;   ///< number of requests with inputs differing from the input group
+  };
+
+  AliEmcalFastJetCache();
+
+  void        ResetEvent(std::unique_lock<std::mutex> &lock);
+  void        FillGhosts(GhostGrid &grid);
+  void        Cluster(Int_t id);
+  void        WorkerLoop();
+  void        StopWorkers();
+  static Bool_t SameInputs(const std::vector<fastjet::PseudoJet> &a, const std::vector<fastjet::PseudoJet> &b);
+
+  std::vector<Definition>          fDefinitions;       ///< registered definitions
+  std::vector<InputGroup>          fGroups;            ///< input groups
+  std::vector<GhostGrid>           fGrids;             ///< ghost grids
+  Long64_t                         fCurrentEvent;      ///< identifier of the current event
+  Double_t                         fTotalGhostTime;    ///< ghost generation time (ms) summed over all events
+
+  std::vector<std::thread>         fWorkers;           ///< worker threads
+  std::deque<Int_t>                fQueue;             ///< definitions waiting for a worker
+  Int_t                            fNPending;          ///< definitions queued or being clustered by a worker
+  Bool_t                           fStop;              ///< stop the workers
+  std::mutex                       fMutex;             ///< protects the state of the definitions and the queue
+  std::condition_variable          fWorkCondition;     ///< signals new work to the workers
+  std::condition_variable          fDoneCondition;     ///< signals a finished clustering
+
+  static AliEmcalFastJetCache     *fgInstance;         ///< Singleton object
+
+private:
+  AliEmcalFastJetCache(const AliEmcalFastJetCache &);
+  AliEmcalFastJetCache &operator=(const AliEmcalFastJetCache &);
+};
+
+#endif
+#endif
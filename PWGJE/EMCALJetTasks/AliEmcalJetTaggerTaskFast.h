@@ -103,6 +103,7 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
   
   void SetTypeAcceptance(AcceptanceType type)                   { fTypeAcc = type; }
   void SetMaxDistance(Double_t dist)                            { fMaxDist = dist; }
+  void SetPeriodicPhiMatching(Bool_t b)                         { fPeriodicPhiMatching = b; }
   void SetSpecialParticleContainer(Int_t contnumb)              { fSpecPartContTag = contnumb; }
 
 
@@ -186,7 +187,8 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
    * in distance in the \$\eta\f$-\f$\phi\$ space, accepting only pairs
    * with a distance smaller maxDistance. True jet pairs are accepted only
    * if the base jet is the closest neighbor to the tag jet and vice versa
-   * at the same time.
+   * at the same time. The distance in \f$\phi\f$ is periodic only if
+   * enabled with SetPeriodicPhiMatching.
    *
    * @param[in] contBase Container with base jets
    * @param[in] contTag Container with jets to be tagged
@@ -212,6 +214,7 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
   Bool_t                              fMatchingDone;               ///< flag to indicate if matching is done or not
   AcceptanceType                      fTypeAcc;                    ///< acceptance cut for the jet containers, see method MatchJetsGeo in .cxx for possibilities
   Double_t                            fMaxDist;                    ///< distance allowed for two jets to match
+  Bool_t                              fPeriodicPhiMatching;        ///< distance periodic in phi in the matching (default: plain difference, as the kd-tree)
   Bool_t                              fInit;                       ///< true when the containers are initialized
   TH3            **fh3PtJet1VsDeltaEtaDeltaPhi;  //!<! \f$ p_{t}\f$ jet 1 vs deta vs dphi
   TH2            **fh2PtJet1VsDeltaR;            //!<! \f$ p_{t}\f$ jet 1 vs dR
@@ -226,16 +229,16 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
   TH3             *fh3PtJetAreaDRConst;          //!<! \f$ p_{t}\f$ jet vs Area vs delta R of constituents
   TH1             *fNAccJets;                    //!<! number of jets per event
 #ifdef JETTAGGERFAST_TEST
-  TH1             *fIndexErrorRateBase;          //!<! Monitoring number of errors between index in kd-tree and data block for base jets
-  TH1             *fIndexErrorRateTag;           //!<! Monitoring number of errors between index in kd-tree and data block for tag jets
-  TH1             *fContainerErrorRateBase;      //!<! Monitoring number of errors between index in kd-tree and jet vector for base jets
-  TH1             *fContainerErrorRateTag;       //!<! Monitoring number of errors between index in kd-tree and jet vector for tag jets
+  TH1             *fIndexErrorRateBase;          //!<! Monitoring number of errors between distance from the matcher and jet distance for base jets
+  TH1             *fIndexErrorRateTag;           //!<! Monitoring number of errors between distance from the matcher and jet distance for tag jets
+  TH1             *fContainerErrorRateBase;      //!<! Monitoring number of errors between index from the matcher and jet container for base jets
+  TH1             *fContainerErrorRateTag;       //!<! Monitoring number of errors between index from the matcher and jet container for tag jets
 #endif
   AliEmcalJetTaggerTaskFast(const AliEmcalJetTaggerTaskFast&);            // not implemented
   AliEmcalJetTaggerTaskFast &operator=(const AliEmcalJetTaggerTaskFast&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalJetTaggerTaskFast, 2);
+  ClassDef(AliEmcalJetTaggerTaskFast, 3);
   /// \endcond
 };
 }
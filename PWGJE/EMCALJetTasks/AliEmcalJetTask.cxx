@@ -45,6 +45,7 @@
 #include "AliEmcalJet.h"
 #include "AliEmcalParticle.h"
 #include "AliFJWrapper.h"
+#include "AliEmcalFastJetCache.h"
 #include "AliEmcalJetUtility.h"
 #include "AliParticleContainer.h"
 #include "AliClusterContainer.h"
@@ -98,8 +99,11 @@ AliEmcalJetTask::AliEmcalJetTask() :
   fEnableAliBasicParticleCompatibility(kFALSE),
   fLegacyMode(kFALSE),
   fFillGhost(kFALSE),
+  fUseClusterCache(kFALSE),
+  fUseFixedGhosts(kFALSE),
   fJets(0),
   fFastJetWrapper("AliEmcalJetTask","AliEmcalJetTask"),
+  fClusterCacheId(-1),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap()
 {
@@ -140,8 +144,11 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
   fEnableAliBasicParticleCompatibility(kFALSE),
   fLegacyMode(kFALSE),
   fFillGhost(kFALSE),
+  fUseClusterCache(kFALSE),
+  fUseFixedGhosts(kFALSE),
   fJets(0),
   fFastJetWrapper(name,name),
+  fClusterCacheId(-1),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap()
 {
@@ -322,6 +329,17 @@ Int_t AliEmcalJetTask::FindJets()
 
   if (fFastJetWrapper.GetInputVectors().size() == 0) return 0;
 
+  // take the jets from the shared cache if the inputs agree with the other jet finders
+  if (fClusterCacheId >= 0) {
+    Long64_t entry = AliAnalysisManager::GetAnalysisManager()->GetCurrentEntry();
+    fastjet::ClusterSequenceAreaBase *clustSeq = 0;
+    if (entry >= 0) clustSeq = AliEmcalFastJetCache::Instance()->GetClusterSequence(fClusterCacheId, entry, fFastJetWrapper.GetInputVectors());
+    if (clustSeq && fFastJetWrapper.RunWithClusterSequence(clustSeq) == 0) {
+      return fFastJetWrapper.GetInclusiveJets().size();
+    }
+    AliDebug(2, "Inputs not shared with the cluster cache, running the jet finder");
+  }
+
   // run jet finder
   fFastJetWrapper.Run();
 
@@ -474,6 +492,24 @@ void AliEmcalJetTask::ExecOnce()
     fFastJetWrapper.SetLegacyMode(kTRUE);
   }
 
+  if (fUseFixedGhosts) {
+    fFastJetWrapper.SetUseFixedGhosts(kTRUE);
+  }
+
+  // register the jet definition in the shared cache, keyed by the input containers
+  if (fUseClusterCache) {
+    TString inputs;
+    TIter nextPartColl(&fParticleCollArray);
+    AliEmcalContainer* cont = 0;
+    while ((cont = static_cast<AliEmcalContainer*>(nextPartColl()))) inputs += Form("%s:%s/%s;", cont->ClassName(), cont->GetArrayName().Data(), cont->GetName());
+    TIter nextClusColl(&fClusterCollArray);
+    while ((cont = static_cast<AliEmcalContainer*>(nextClusColl()))) inputs += Form("%s:%s/%s;", cont->ClassName(), cont->GetArrayName().Data(), cont->GetName());
+    // randomly rejected or shifted tracks cannot be shared
+    if (fApplyArtificialTrackingEfficiency || fApplyQoverPtShift) inputs += GetName();
+    fClusterCacheId = AliEmcalFastJetCache::Instance()->RegisterDefinition(inputs, ConvertToFJAlgo(fJetAlgo), fRadius, ConvertToFJRecoScheme(fRecombScheme),
+                                                                          fGhostArea, 1, fLegacyMode);
+  }
+
   InitUtilities();
 
   AliAnalysisTaskEmcal::ExecOnce();
@@ -134,6 +134,9 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   Int_t                  GetRecombScheme()                { return fRecombScheme      ; }
   Double_t               GetTrackEfficiency()             { return fTrackEfficiency   ; }
   Bool_t                 GetTrackEfficiencyOnlyForEmbedding() { return fTrackEfficiencyOnlyForEmbedding; }
+  Bool_t                 GetUseClusterCache()             { return fUseClusterCache   ; }
+  Bool_t                 GetUseFixedGhosts()              { return fUseFixedGhosts    ; }
+  Int_t                  GetClusterCacheId()              { return fClusterCacheId    ; }
 
   TClonesArray*          GetJets()                        { return fJets              ; }
   TObjArray*             GetUtilities()                   { return fUtilities         ; }
@@ -158,6 +161,29 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
    */
   void                   SetFillJetConsituents(Bool_t doFill) { fFillConstituents = doFill; }
 
+  /**
+   * @brief Switch for sharing the clustering with other jet finders via AliEmcalFastJetCache
+   *
+   * Jet finders with the same input containers share the input vectors and the ghosts,
+   * jet finders with identical jet definitions share the cluster sequence.
+   * Clustering times are available from AliEmcalFastJetCache::Instance()
+   * using the ID returned by GetClusterCacheId(). The task falls back to its own
+   * clustering if its input vectors differ from the ones of the other jet finders.
+   *
+   * @param b Switch for using the shared cache
+   */
+  void                   SetUseClusterCache(Bool_t b=kTRUE)   { if (IsLocked()) return; fUseClusterCache = b; }
+
+  /**
+   * @brief Switch for clustering with a fixed ghost set
+   *
+   * The ghosts are generated once from fixed seeds and reused in every event,
+   * together with the jet and area definitions (see AliFJWrapper::SetUseFixedGhosts).
+   *
+   * @param b Switch for using fixed ghosts
+   */
+  void                   SetUseFixedGhosts(Bool_t b=kTRUE)    { if (IsLocked()) return; fUseFixedGhosts = b; }
+
   static AliEmcalJetTask* AddTaskEmcalJet(
       const TString nTracks                      = "usedefault",
       const TString nClusters                    = "usedefault",
@@ -227,9 +253,12 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   Bool_t                 fEnableAliBasicParticleCompatibility; ///< Flag to allow compatibility with AliBasicParticle constituents
   Bool_t                 fLegacyMode;             //!<!=true to enable FJ 2.x behavior
   Bool_t                 fFillGhost;              ///< =true ghost particles will be filled in AliEmcalJet obj
+  Bool_t                 fUseClusterCache;        ///< =true share the clustering with other jet finders (AliEmcalFastJetCache)
+  Bool_t                 fUseFixedGhosts;         ///< =true use the same ghosts in every event
 
   TClonesArray          *fJets;                   //!<!jet collection
   AliFJWrapper           fFastJetWrapper;         //!<!fastjet wrapper
+  Int_t                  fClusterCacheId;         //!<!ID of the jet definition in the shared cache (-1 if not used)
 
   static const Int_t     fgkConstIndexShift;      //!<!contituent index shift
 
@@ -244,7 +273,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   AliEmcalJetTask &operator=(const AliEmcalJetTask&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalJetTask, 30);
+  ClassDef(AliEmcalJetTask, 32);
   /// \endcond
 };
 #endif
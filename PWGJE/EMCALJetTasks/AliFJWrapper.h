@@ -23,14 +23,17 @@ class AliFJWrapper
   virtual const char *ClassName()                            const { return "AliFJWrapper";              }
   virtual void  Clear(const Option_t* /*opt*/ = "");
   virtual void  ClearMemory();
+  virtual void  ClearEventMemory();
   virtual void  CopySettingsFrom (const AliFJWrapper& wrapper);
   virtual void  GetMedianAndSigma(Double_t& median, Double_t& sigma, Int_t remove = 0) const;
   fastjet::ClusterSequenceArea*           GetClusterSequence() const   { return fClustSeq;                 }
   fastjet::ClusterSequence*               GetClusterSequenceSA() const { return fClustSeqSA;               }
   fastjet::ClusterSequenceActiveAreaExplicitGhosts* GetClusterSequenceGhosts() const { return fClustSeqActGhosts; }
+  fastjet::ClusterSequenceAreaBase*       GetClusterSequenceShared() const { return fClustSeqShared;   }
   const std::vector<fastjet::PseudoJet>&  GetInputVectors()    const { return fInputVectors;               }
   const std::vector<fastjet::PseudoJet>&  GetEventSubInputVectors()    const { return fEventSubInputVectors;               }
   const std::vector<fastjet::PseudoJet>&  GetInputGhosts()     const { return fInputGhosts;                }
+  const std::vector<fastjet::PseudoJet>&  GetFixedGhosts()     const { return fFixedGhosts;                }
   const std::vector<fastjet::PseudoJet>&  GetInclusiveJets()   const { return fInclusiveJets;              }
   const std::vector<fastjet::PseudoJet>&  GetEventSubJets()   const { return fEventSubJets;              }
   const std::vector<fastjet::PseudoJet>&  GetFilteredJets()    const { return fFilteredJets;               }
@@ -50,6 +53,7 @@ class AliFJWrapper
   virtual std::vector<double>             GetSubtractedJetsPts(Double_t median_pt = -1, Bool_t sorted = kFALSE);
   Bool_t                                  GetLegacyMode()            { return fLegacyMode; }
   Bool_t                                  GetDoFilterArea()          { return fDoFilterArea; }
+  Bool_t                                  GetUseFixedGhosts()        { return fUseFixedGhosts; }
   Double_t                                NSubjettiness(Int_t N, Int_t Algorithm, Double_t Radius, Double_t Beta, Int_t Option=0, Int_t Measure=0, Double_t Beta_SD=0.0, Double_t ZCut=0.1, Int_t SoftDropOn=0);
   Double32_t                              NSubjettinessDerivativeSub(Int_t N, Int_t Algorithm, Double_t Radius, Double_t Beta, Double_t JetR, fastjet::PseudoJet jet, Int_t Option=0, Int_t Measure=0, Double_t Beta_SD=0.0, Double_t ZCut=0.1, Int_t SoftDropOn=0);
 #ifdef FASTJET_VERSION
@@ -88,6 +92,7 @@ class AliFJWrapper
   virtual void RemoveLastInputVector();
 
   virtual Int_t Run();
+  virtual Int_t RunWithClusterSequence(fastjet::ClusterSequenceAreaBase *clustSeq);
   virtual Int_t Filter();
   virtual void  DoGenericSubtraction(const fastjet::FunctionOfPseudoJet<Double32_t>& jetshape, std::vector<fastjet::contrib::GenericSubtractorInfo>& output);
   virtual Int_t DoGenericSubtractionJetMass();
@@ -143,6 +148,9 @@ class AliFJWrapper
   void SetEventSub(Bool_t b) {fEventSub = b;}
   void SetMaxDelR(Double_t r)  {fMaxDelR = r;}
   void SetAlpha(Double_t a)  {fAlpha = a;}
+  // Keep one ghost set, generated from the given seeds, and the jet/area definitions across events
+  // (active_area_explicit_ghosts only, without event-wise subtraction)
+  void SetUseFixedGhosts(Bool_t b, Int_t seed1 = 12345, Int_t seed2 = 67890) { fUseFixedGhosts = b; fGhostSeed.assign(1, seed1); fGhostSeed.push_back(seed2); fFixedGhosts.clear(); }
 
 
  protected:
@@ -172,6 +180,8 @@ class AliFJWrapper
   fastjet::ClusterSequenceArea          *fClustSeqES;           //!
   fastjet::ClusterSequence              *fClustSeqSA;                //!
   fastjet::ClusterSequenceActiveAreaExplicitGhosts *fClustSeqActGhosts; //!
+  fastjet::ClusterSequenceAreaBase      *fClustSeqShared;     //! external cluster sequence (not owned)
+  fastjet::ClusterSequenceActiveAreaExplicitGhosts *fClustSeqFixedGhosts; //! cluster sequence with the fixed ghosts
   fastjet::Strategy                      fStrategy;           //!
   fastjet::JetAlgorithm                  fAlgor;              //!
   fastjet::RecombinationScheme           fScheme;             //!
@@ -236,8 +246,16 @@ class AliFJWrapper
   std::vector<double>                      fGRDenominator;    //!
   std::vector<double>                      fGRNumeratorSub;   //!
   std::vector<double>                      fGRDenominatorSub; //!
+  Bool_t                                   fUseFixedGhosts;   //!
+  std::vector<int>                         fGhostSeed;        //! seeds of the fixed ghosts
+  std::vector<fastjet::PseudoJet>          fFixedGhosts;      //!
+  Double_t                                 fFixedGhostArea;   //! actual area of the fixed ghosts
 
   virtual void   SubtractBackground(const Double_t median_pt = -1);
+  virtual Int_t  RunWithFixedGhosts();
+  void           CreateJetDefinition();
+  Bool_t         IsFixedGhostsActive() const { return fUseFixedGhosts && fAreaType == fastjet::active_area_explicit_ghosts && !fEventSub; }
+  const fastjet::ClusterSequenceAreaBase *GetAreaSequence() const;
 
  private:
   AliFJWrapper();
@@ -281,6 +299,8 @@ AliFJWrapper::AliFJWrapper(const char *name, const char *title)
   , fClustSeqES        (0)
   , fClustSeqSA        (0)
   , fClustSeqActGhosts (0)
+  , fClustSeqShared    (0)
+  , fClustSeqFixedGhosts (0)
   , fStrategy          (fj::Best)
   , fAlgor             (fj::kt_algorithm)
   , fScheme            (fj::BIpt_scheme)
@@ -342,6 +362,10 @@ AliFJWrapper::AliFJWrapper(const char *name, const char *title)
   , fGRDenominator()
   , fGRNumeratorSub()
   , fGRDenominatorSub()
+  , fUseFixedGhosts    (kFALSE)
+  , fGhostSeed         ()
+  , fFixedGhosts       ()
+  , fFixedGhostArea    (0)
 {
   // Constructor.
 }
@@ -362,11 +386,21 @@ void AliFJWrapper::ClearMemory()
   if (fGhostedAreaSpec)   { delete fGhostedAreaSpec;   fGhostedAreaSpec = NULL; }
   if (fJetDef)            { delete fJetDef;            fJetDef          = NULL; }
   if (fPlugin)            { delete fPlugin;            fPlugin          = NULL; }
+  ClearEventMemory();
+}
+
+//_________________________________________________________________________________________________
+void AliFJWrapper::ClearEventMemory()
+{
+  // Delete the objects created for each event.
+  // Area and jet definitions are kept.
   if (fRange)             { delete fRange;             fRange           = NULL; }
   if (fClustSeq)          { delete fClustSeq;          fClustSeq        = NULL; }
   if (fClustSeqES)          { delete fClustSeqES;        fClustSeqES        = NULL; }
   if (fClustSeqSA)        { delete fClustSeqSA;        fClustSeqSA        = NULL; }
   if (fClustSeqActGhosts) { delete fClustSeqActGhosts; fClustSeqActGhosts = NULL; }
+  if (fClustSeqFixedGhosts) { delete fClustSeqFixedGhosts; fClustSeqFixedGhosts = NULL; }
+  fClustSeqShared = NULL; // owned by the caller of RunWithClusterSequence
   #ifdef FASTJET_VERSION
   if (fBkrdEstimator)          { delete fBkrdEstimator; fBkrdEstimator = NULL; }
   if (fGenSubtractor)          { delete fGenSubtractor; fGenSubtractor = NULL; }
@@ -416,7 +450,9 @@ void AliFJWrapper::Clear(const Option_t */*opt*/)
   fMedUsedForBgSub = 0;
 
   // for the moment brute force delete everything
-  ClearMemory();
+  // (with fixed ghosts the ghosts and the definitions are kept)
+  if (IsFixedGhostsActive()) ClearEventMemory();
+  else ClearMemory();
 }
 
 //_________________________________________________________________________________________________
@@ -516,7 +552,7 @@ Double_t AliFJWrapper::GetJetArea(UInt_t idx) const
 
   Double_t retval = -1; // really wrong area..
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->area(fInclusiveJets[idx]);
+    retval = GetAreaSequence()->area(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetArea wrong index: %d",idx));
   }
@@ -556,7 +592,7 @@ fastjet::PseudoJet AliFJWrapper::GetJetAreaVector(UInt_t idx) const
   // Get the jet area as vector.
   fastjet::PseudoJet retval;
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->area_4vector(fInclusiveJets[idx]);
+    retval = GetAreaSequence()->area_4vector(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetArea wrong index: %d",idx));
   }
@@ -623,7 +659,7 @@ AliFJWrapper::GetJetConstituents(UInt_t idx) const
   std::vector<fastjet::PseudoJet> retval;
 
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->constituents(fInclusiveJets[idx]);
+    retval = GetAreaSequence()->constituents(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetConstituents wrong index: %d",idx));
   }
@@ -672,7 +708,8 @@ void AliFJWrapper::GetMedianAndSigma(Double_t &median, Double_t &sigma, Int_t re
   // Get the median and sigma from fastjet.
   // User can also do it on his own because the cluster sequence is exposed (via a getter)
 
-  if (!fClustSeq) {
+  const fj::ClusterSequenceAreaBase *clustSeq = GetAreaSequence();
+  if (!clustSeq) {
     AliError("[e] Run the jfinder first.");
     return;
   }
@@ -680,11 +717,11 @@ void AliFJWrapper::GetMedianAndSigma(Double_t &median, Double_t &sigma, Int_t re
   Double_t mean_area = 0;
   try {
     if(0 == remove) {
-      fClustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
+      clustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
     }  else {
-      std::vector<fastjet::PseudoJet> input_jets = sorted_by_pt(fClustSeq->inclusive_jets());
+      std::vector<fastjet::PseudoJet> input_jets = sorted_by_pt(clustSeq->inclusive_jets());
       input_jets.erase(input_jets.begin(), input_jets.begin() + remove);
-      fClustSeq->get_median_rho_and_sigma(input_jets, *fRange, fUseArea4Vector, median, sigma, mean_area);
+      clustSeq->get_median_rho_and_sigma(input_jets, *fRange, fUseArea4Vector, median, sigma, mean_area);
       input_jets.clear();
     }
   } catch (fj::Error) {
@@ -699,6 +736,8 @@ Int_t AliFJWrapper::Run()
 {
   // Run the actual jet finder.
 
+  if (IsFixedGhostsActive()) return RunWithFixedGhosts();
+
   if (fAreaType == fj::voronoi_area) {
     // Rfact - check dependence - default is 1.
     // NOTE: hardcoded variable!
@@ -722,6 +761,40 @@ Int_t AliFJWrapper::Run()
   fRange = new fj::Selector(fj::SelectorAbsRapMax(fMaxRap - 0.95 * fR));
 #endif
 
+  CreateJetDefinition();
+
+  try {
+    fClustSeq = new fj::ClusterSequenceArea(fInputVectors, *fJetDef, *fAreaDef);
+    if(fEventSub){
+      DoEventConstituentSubtraction();
+      fClustSeqES = new fj::ClusterSequenceArea(fEventSubCorrectedVectors, *fJetDef, *fAreaDef);
+    }
+  } catch (fj::Error) {
+    AliError(" [w] FJ Exception caught.");
+    return -1;
+  }
+
+  // FJ3 :: Define an JetMedianBackgroundEstimator just in case it will be used
+#ifdef FASTJET_VERSION
+  fBkrdEstimator     = new fj::JetMedianBackgroundEstimator(fj::SelectorAbsRapMax(fMaxRap));
+#endif
+
+  if (fLegacyMode) { SetLegacyFJ(); } // for FJ 2.x even if fLegacyMode is set, SetLegacyFJ is dummy
+
+  // inclusive jets:
+  fInclusiveJets.clear();
+  fEventSubJets.clear();
+  fInclusiveJets = fClustSeq->inclusive_jets(0.0);
+  if(fEventSub) fEventSubJets  = fClustSeqES->inclusive_jets(0.0);
+
+  return 0;
+}
+
+//_________________________________________________________________________________________________
+void AliFJWrapper::CreateJetDefinition()
+{
+  // Create the jet definition (and plugin) from the current settings.
+
   if (fAlgor == fj::plugin_algorithm) {
     if (fPluginAlgor == 0) {
       // SIS CONE ALGOR
@@ -747,30 +820,113 @@ Int_t AliFJWrapper::Run()
   } else {
     fJetDef = new fj::JetDefinition(fAlgor, fR, fScheme, fStrategy);
   }
+}
+
+//_________________________________________________________________________________________________
+Int_t AliFJWrapper::RunWithFixedGhosts()
+{
+  // Run the jet finder with a fixed set of explicit ghosts (see SetUseFixedGhosts).
+  // The ghosts are generated once from fixed seeds; ghosts, area and jet definitions
+  // are kept across events and only rebuilt if the corresponding settings change.
+
+  if (!fGhostedAreaSpec || fFixedGhosts.empty() ||
+      fGhostedAreaSpec->ghost_maxrap() != fMaxRap || fGhostedAreaSpec->ghost_area() != fGhostArea) {
+    if (fAreaDef)         { delete fAreaDef;         fAreaDef         = NULL; }
+    if (fGhostedAreaSpec) { delete fGhostedAreaSpec; fGhostedAreaSpec = NULL; }
+    fGhostedAreaSpec = new fj::GhostedAreaSpec(fMaxRap,
+                                               fNGhostRepeats,
+                                               fGhostArea,
+                                               fGridScatter,
+                                               fKtScatter,
+                                               fMeanGhostKt);
+    // the ghost random generator of fastjet is shared: restore its state after drawing the fixed ghosts
+    std::vector<int> randomStatus;
+    fGhostedAreaSpec->get_random_status(randomStatus);
+    if (fGhostSeed.size() == 2) fGhostedAreaSpec->set_random_status(fGhostSeed);
+    fFixedGhosts.clear();
+    fGhostedAreaSpec->add_ghosts(fFixedGhosts);
+    fGhostedAreaSpec->set_random_status(randomStatus);
+    fFixedGhostArea = fGhostedAreaSpec->actual_ghost_area();
+    fAreaDef = new fj::AreaDefinition(*fGhostedAreaSpec, fAreaType);
+  }
+
+  // plugins are recreated every event as in Run()
+  if (fJetDef && (fAlgor == fj::plugin_algorithm || fJetDef->jet_algorithm() != fAlgor || fJetDef->R() != fR ||
+                  fJetDef->recombination_scheme() != fScheme || fJetDef->strategy() != fStrategy)) {
+    delete fJetDef;
+    fJetDef = NULL;
+    if (fPlugin) { delete fPlugin; fPlugin = NULL; }
+  }
+  if (!fJetDef) CreateJetDefinition();
+  if (!fJetDef) return -1;
+
+#ifndef FASTJET_VERSION
+  fRange = new fj::RangeDefinition(fMaxRap - 0.95 * fR);
+#else
+  fRange = new fj::Selector(fj::SelectorAbsRapMax(fMaxRap - 0.95 * fR));
+#endif
 
   try {
-    fClustSeq = new fj::ClusterSequenceArea(fInputVectors, *fJetDef, *fAreaDef);
-    if(fEventSub){
-      DoEventConstituentSubtraction();
-      fClustSeqES = new fj::ClusterSequenceArea(fEventSubCorrectedVectors, *fJetDef, *fAreaDef);
-    }
+    fClustSeqFixedGhosts = new fj::ClusterSequenceActiveAreaExplicitGhosts(fInputVectors, *fJetDef, fFixedGhosts, fFixedGhostArea);
   } catch (fj::Error) {
     AliError(" [w] FJ Exception caught.");
     return -1;
   }
 
-  // FJ3 :: Define an JetMedianBackgroundEstimator just in case it will be used
 #ifdef FASTJET_VERSION
   fBkrdEstimator     = new fj::JetMedianBackgroundEstimator(fj::SelectorAbsRapMax(fMaxRap));
 #endif
 
-  if (fLegacyMode) { SetLegacyFJ(); } // for FJ 2.x even if fLegacyMode is set, SetLegacyFJ is dummy
+  if (fLegacyMode) { SetLegacyFJ(); }
 
-  // inclusive jets:
   fInclusiveJets.clear();
   fEventSubJets.clear();
-  fInclusiveJets = fClustSeq->inclusive_jets(0.0);
-  if(fEventSub) fEventSubJets  = fClustSeqES->inclusive_jets(0.0);
+  fInclusiveJets = fClustSeqFixedGhosts->inclusive_jets(0.0);
+
+  return 0;
+}
+
+//_________________________________________________________________________________________________
+const fj::ClusterSequenceAreaBase *AliFJWrapper::GetAreaSequence() const
+{
+  // Cluster sequence providing the jets of the last Run().
+
+  if (fClustSeqShared)      return fClustSeqShared;
+  if (fClustSeqFixedGhosts) return fClustSeqFixedGhosts;
+  return fClustSeq;
+}
+
+//_________________________________________________________________________________________________
+Int_t AliFJWrapper::RunWithClusterSequence(fj::ClusterSequenceAreaBase *clustSeq)
+{
+  // Take the jets from a cluster sequence built outside the wrapper
+  // (e.g. shared among several jet finders, see AliEmcalFastJetCache).
+  // The cluster sequence is not owned and must live until the next Clear().
+  // The input vectors are expected to be the ones used to build it.
+
+  if (!clustSeq) {
+    AliError("[e] No cluster sequence provided.");
+    return -1;
+  }
+  if (fEventSub) {
+    AliError("[e] Event-wise constituent subtraction not supported with an external cluster sequence.");
+    return -1;
+  }
+
+  fClustSeqShared = clustSeq;
+
+#ifndef FASTJET_VERSION
+  fRange = new fj::RangeDefinition(fMaxRap - 0.95 * fR);
+#else
+  fRange = new fj::Selector(fj::SelectorAbsRapMax(fMaxRap - 0.95 * fR));
+  fBkrdEstimator     = new fj::JetMedianBackgroundEstimator(fj::SelectorAbsRapMax(fMaxRap));
+#endif
+
+  if (fLegacyMode) { SetLegacyFJ(); }
+
+  fInclusiveJets.clear();
+  fEventSubJets.clear();
+  fInclusiveJets = fClustSeqShared->inclusive_jets(0.0);
 
   return 0;
 }
@@ -848,7 +1004,7 @@ void AliFJWrapper::SubtractBackground(Double_t median_pt)
   // check what was specified (default is -1)
   if (median_pt < 0) {
     try {
-      fClustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
+      GetAreaSequence()->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
     }
 
     catch (fj::Error) {
@@ -874,13 +1030,13 @@ void AliFJWrapper::SubtractBackground(Double_t median_pt)
   for (unsigned i = 0; i < fInclusiveJets.size(); i++) {
     if ( fUseArea4Vector ) {
       // subtract the background using the area4vector
-      fj::PseudoJet area4v = fClustSeq->area_4vector(fInclusiveJets[i]);
+      fj::PseudoJet area4v = GetAreaSequence()->area_4vector(fInclusiveJets[i]);
       fj::PseudoJet jet_sub = fInclusiveJets[i] - area4v * fMedUsedForBgSub;
       fSubtractedJetsPt.push_back(jet_sub.perp()); // here we put only the pt of the jet - note: this can be negative
     } else {
       // subtract the background using scalars
       // fj::PseudoJet jet_sub = fInclusiveJets[i] - area * fMedUsedForBgSub_;
-      Double_t area = fClustSeq->area(fInclusiveJets[i]);
+      Double_t area = GetAreaSequence()->area(fInclusiveJets[i]);
       // standard subtraction
       Double_t pt_sub = fInclusiveJets[i].perp() - fMedUsedForBgSub * area;
       fSubtractedJetsPt.push_back(pt_sub); // here we put only the pt of the jet - note: this can be negative
@@ -112,6 +112,8 @@ class AliAODv0;
 #include "AliEventCuts.h"
 #include "AliV0Result.h"
 #include "AliCascadeResult.h"
+#include "AliV0CutTable.h"
+#include "AliCascadeCutTable.h"
 #include "AliAnalysisTaskStrangenessVsMultiplicityMCRun2.h"
 #include "AliAnalysisTaskWeakDecayVertexer.h"
 
@@ -133,7 +135,7 @@ ClassImp(AliAnalysisTaskStrangenessVsMultiplicityMCRun2)
 AliAnalysisTaskStrangenessVsMultiplicityMCRun2::AliAnalysisTaskStrangenessVsMultiplicityMCRun2()
 : AliAnalysisTaskSE(), fListHist(0), fListK0Short(0), fListLambda(0), fListAntiLambda(0),
 fListXiMinus(0), fListXiPlus(0), fListOmegaMinus(0), fListOmegaPlus(0),
-fTreeEvent(0), fTreeV0(0), fTreeCascade(0),
+fTreeEvent(0), fTreeV0(0), fTreeCascade(0), fV0CutTable(0), fCascadeCutTable(0),
 fPIDResponse(0), fESDtrackCuts(0), fESDtrackCutsITSsa2010(0), fESDtrackCutsGlobal2015(0), fUtils(0), fRand(0),
 
 //---> Flags controlling Event Tree output
@@ -709,7 +711,7 @@ fHistGeneratedPtVsYVsCentralityAntihypertriton(0)
 AliAnalysisTaskStrangenessVsMultiplicityMCRun2::AliAnalysisTaskStrangenessVsMultiplicityMCRun2(Bool_t lSaveEventTree, Bool_t lSaveV0Tree, Bool_t lSaveCascadeTree, const char *name, TString lExtraOptions)
 : AliAnalysisTaskSE(name), fListHist(0), fListK0Short(0), fListLambda(0), fListAntiLambda(0),
 fListXiMinus(0), fListXiPlus(0), fListOmegaMinus(0), fListOmegaPlus(0),
-fTreeEvent(0), fTreeV0(0), fTreeCascade(0),
+fTreeEvent(0), fTreeV0(0), fTreeCascade(0), fV0CutTable(0), fCascadeCutTable(0),
 fPIDResponse(0), fESDtrackCuts(0), fESDtrackCutsITSsa2010(0), fESDtrackCutsGlobal2015(0), fUtils(0), fRand(0),
 
 //---> Flags controlling Event Tree output
@@ -1406,6 +1408,14 @@ AliAnalysisTaskStrangenessVsMultiplicityMCRun2::~AliAnalysisTaskStrangenessVsMul
     delete fTreeCascade;
     fTreeCascade = 0x0;
   }
+  if (fV0CutTable) {
+    delete fV0CutTable;
+    fV0CutTable = 0x0;
+  }
+  if (fCascadeCutTable) {
+    delete fCascadeCutTable;
+    fCascadeCutTable = 0x0;
+  }
   if (fUtils) {
     delete fUtils;
     fUtils = 0x0;
@@ -2221,6 +2231,17 @@ void AliAnalysisTaskStrangenessVsMultiplicityMCRun2::UserCreateOutputObjects()
     lCscRslt->InitializeProtonProfile();
   }
   
+  //Compile all configurations for the selection in UserExec
+  if ( !fV0CutTable ) fV0CutTable = new AliV0CutTable();
+  if ( !fCascadeCutTable ) fCascadeCutTable = new AliCascadeCutTable();
+  fV0CutTable->SetUseMCRapidity();
+  fCascadeCutTable->SetUseMCRapidity();
+  fCascadeCutTable->SetUseSwapBachelorCharge(kFALSE);
+  TList *lV0Lists[3] = { fListK0Short, fListLambda, fListAntiLambda };
+  TList *lCascadeLists[4] = { fListXiMinus, fListXiPlus, fListOmegaMinus, fListOmegaPlus };
+  fV0CutTable->Build( lV0Lists, 3 );
+  fCascadeCutTable->Build( lCascadeLists, 4 );
+  
   //Regular Output: Slots 1-8
   PostData(1, fListHist       );
   PostData(2, fListK0Short    );
@@ -3137,231 +3158,106 @@ void AliAnalysisTaskStrangenessVsMultiplicityMCRun2::UserExec(Option_t *)
     // Superlight adaptive output mode
     //+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     
-    //AliWarning(Form("[V0 Analyses] Processing different configurations (%i detected)",lNumberOfConfigurations));
+    //All configurations are evaluated at once, see AliV0CutTable
+    AliV0CutTable::Candidate lV0Candidate;
+    lV0Candidate.fOnFlyStatus = lOnFlyStatus;
+    lV0Candidate.fPt = fTreeVariablePt;
+    lV0Candidate.fNegEta = fTreeVariableNegEta;
+    lV0Candidate.fPosEta = fTreeVariablePosEta;
+    lV0Candidate.fRapK0Short = fTreeVariableRapK0Short;
+    lV0Candidate.fRapLambda = fTreeVariableRapLambda;
+    lV0Candidate.fRapMC = fTreeVariableRapMC;
+    lV0Candidate.fInvMassK0s = fTreeVariableInvMassK0s;
+    lV0Candidate.fInvMassLambda = fTreeVariableInvMassLambda;
+    lV0Candidate.fInvMassAntiLambda = fTreeVariableInvMassAntiLambda;
+    lV0Candidate.fV0Radius = fTreeVariableV0Radius;
+    lV0Candidate.fDcaNegToPrimVertex = fTreeVariableDcaNegToPrimVertex;
+    lV0Candidate.fDcaPosToPrimVertex = fTreeVariableDcaPosToPrimVertex;
+    lV0Candidate.fDcaV0Daughters = fTreeVariableDcaV0Daughters;
+    lV0Candidate.fV0CosineOfPointingAngle = fTreeVariableV0CosineOfPointingAngle;
+    lV0Candidate.fDistOverTotMom = fTreeVariableDistOverTotMom;
+    lV0Candidate.fLeastNbrCrossedRows = fTreeVariableLeastNbrCrossedRows;
+    lV0Candidate.fLeastRatioCrossedRowsOverFindable = fTreeVariableLeastRatioCrossedRowsOverFindable;
+    lV0Candidate.fNSigmasPosProton = fTreeVariableNSigmasPosProton;
+    lV0Candidate.fNSigmasPosPion = fTreeVariableNSigmasPosPion;
+    lV0Candidate.fNSigmasNegProton = fTreeVariableNSigmasNegProton;
+    lV0Candidate.fNSigmasNegPion = fTreeVariableNSigmasNegPion;
+    lV0Candidate.fPosInnerP = fTreeVariablePosInnerP;
+    lV0Candidate.fNegInnerP = fTreeVariableNegInnerP;
+    lV0Candidate.fPosInnerPt = lThisPosInnerPt;
+    lV0Candidate.fNegInnerPt = lThisNegInnerPt;
+    lV0Candidate.fPtArmV0 = fTreeVariablePtArmV0;
+    lV0Candidate.fAlphaV0 = fTreeVariableAlphaV0;
+    lV0Candidate.fNegITSrefit = (fTreeVariableNegTrackStatus & AliESDtrack::kITSrefit) != 0;
+    lV0Candidate.fPosITSrefit = (fTreeVariablePosTrackStatus & AliESDtrack::kITSrefit) != 0;
+    lV0Candidate.fMaxChi2PerCluster = fTreeVariableMaxChi2PerCluster;
+    lV0Candidate.fMinTrackLength = fTreeVariableMinTrackLength;
+    lV0Candidate.fNegTOFSignal = fTreeVariableNegTOFSignal;
+    lV0Candidate.fPosTOFSignal = fTreeVariablePosTOFSignal;
+    lV0Candidate.fIsCowboy = fTreeVariableIsCowboy;
+    lV0Candidate.fLeastNcrOverLength = lLeastNcrOverLength;
+    lV0Candidate.fITSorTOFsatisfied = lITSorTOFsatisfied;
+    
+    const Int_t lNSelectedV0 = fV0CutTable->Select( lV0Candidate );
     TH3F *histoout                 = 0x0;
     TH3F *histooutfeeddown         = 0x0;
-    TProfile *histoProtonProfile         = 0x0;
-    AliV0Result *lV0Result = 0x0;
-    
-    //pointers to valid results
-    AliV0Result *lPointers[50000];
-    Long_t lValidConfigurations=0;
-    
-    for( Int_t icfg=0; icfg<fListK0Short->GetEntries(); icfg++ ){
-      lPointers[lValidConfigurations] = (AliV0Result*) fListK0Short->At(icfg);
-      lValidConfigurations++;
-    }
-    for( Int_t icfg=0; icfg<fListLambda->GetEntries(); icfg++ ){
-      lPointers[lValidConfigurations] = (AliV0Result*) fListLambda->At(icfg);
-      lValidConfigurations++;
-    }
-    for( Int_t icfg=0; icfg<fListAntiLambda->GetEntries(); icfg++ ){
-      lPointers[lValidConfigurations] = (AliV0Result*) fListAntiLambda->At(icfg);
-      lValidConfigurations++;
-    }
+    TProfile *histoProtonProfile   = 0x0;
     
-    for(Int_t lcfg=0; lcfg<lValidConfigurations; lcfg++){
-      histoout                 = 0x0;
-      histooutfeeddown         = 0x0;
-      histoProtonProfile       = 0x0;
-      
+    for(Int_t lsel=0; lsel<lNSelectedV0; lsel++){
       //Acquire result objects
-      lV0Result = lPointers[lcfg];
+      AliV0Result *lV0Result = fV0CutTable->GetSelected(lsel);
       histoout            = lV0Result->GetHistogram();
       histooutfeeddown    = lV0Result->GetHistogramFeeddown();
       histoProtonProfile  = lV0Result->GetProtonProfile();
       
-      Float_t lMass = 0;
-      Float_t lRap  = 0;
-      Float_t lPDGMass = -1;
-      Float_t lNegdEdx = 100;
-      Float_t lPosdEdx = 100;
+      Float_t lMass = fV0CutTable->GetMass( lV0Result->GetMassHypothesis() );
       Int_t lPDGCode = 0;
       Int_t lPDGCodeXiMother = 0;
-      Float_t lBaryonMomentum = -0.5;
-      Float_t lBaryonPt = -0.5;
-      Float_t lBaryondEdxFromProton = 0;
       Float_t lBaryonTransvMomMCForG3F = -0.5; //warning: MC perfect for Geant3/fluka
-      
-      //========================================================================
-      //Setting up: Variable V0 CosPA
-      Float_t lV0CosPACut = lV0Result -> GetCutV0CosPA();
-      Float_t lVarV0CosPApar[5];
-      lVarV0CosPApar[0] = lV0Result->GetCutVarV0CosPAExp0Const();
-      lVarV0CosPApar[1] = lV0Result->GetCutVarV0CosPAExp0Slope();
-      lVarV0CosPApar[2] = lV0Result->GetCutVarV0CosPAExp1Const();
-      lVarV0CosPApar[3] = lV0Result->GetCutVarV0CosPAExp1Slope();
-      lVarV0CosPApar[4] = lV0Result->GetCutVarV0CosPAConst();
-      Float_t lVarV0CosPA = TMath::Cos(
-                                       lVarV0CosPApar[0]*TMath::Exp(lVarV0CosPApar[1]*fTreeVariablePt) +
-                                       lVarV0CosPApar[2]*TMath::Exp(lVarV0CosPApar[3]*fTreeVariablePt) +
-                                       lVarV0CosPApar[4]);
-      if( lV0Result->GetCutUseVarV0CosPA() ){
-        //Only use if tighter than the non-variable cut
-        if( lVarV0CosPA > lV0CosPACut ) lV0CosPACut = lVarV0CosPA;
-      }
-      //========================================================================
-      
       if ( lV0Result->GetMassHypothesis() == AliV0Result::kK0Short     ){
-        lMass    = fTreeVariableInvMassK0s;
-        lRap     = fTreeVariableRapK0Short;
-        lPDGMass = 0.497;
-        lNegdEdx = fTreeVariableNSigmasNegPion;
-        lPosdEdx = fTreeVariableNSigmasPosPion;
         lPDGCode = 310;
         lBaryonTransvMomMCForG3F = 999; //nonsense (if you see this you should doubt it...)
       }
       if ( lV0Result->GetMassHypothesis() == AliV0Result::kLambda      ){
-        lMass = fTreeVariableInvMassLambda;
-        lRap = fTreeVariableRapLambda;
-        lPDGMass = 1.115683;
-        lNegdEdx = fTreeVariableNSigmasNegPion;
-        lPosdEdx = fTreeVariableNSigmasPosProton;
         lPDGCode = 3122;
         lPDGCodeXiMother = 3312;
-        lBaryonMomentum = fTreeVariablePosInnerP;
-        lBaryonPt = lThisPosInnerPt;
-        lBaryondEdxFromProton = fTreeVariableNSigmasPosProton;
         lBaryonTransvMomMCForG3F = lMCTransvMomPos; //proton
       }
       if ( lV0Result->GetMassHypothesis() == AliV0Result::kAntiLambda  ){
-        lMass = fTreeVariableInvMassAntiLambda;
-        lRap = fTreeVariableRapLambda;
-        lPDGMass = 1.115683;
-        lNegdEdx = fTreeVariableNSigmasNegProton;
-        lPosdEdx = fTreeVariableNSigmasPosPion;
         lPDGCode = -3122;
         lPDGCodeXiMother = -3312;
-        lBaryonMomentum = fTreeVariableNegInnerP;
-        lBaryonPt = lThisNegInnerPt;
-        lBaryondEdxFromProton = fTreeVariableNSigmasNegProton;
         lBaryonTransvMomMCForG3F = lMCTransvMomNeg; //antiproton
       }
       
-      //Override rapidity for true rapidity if requested to do so
-      if ( lV0Result -> GetCutMCUseMCProperties() ) {
-        lRap = fTreeVariableRapMC;
+      //Regular fill histogram here
+      if (
+          ( ! (lV0Result->GetCutMCPhysicalPrimary())    || fTreeVariablePrimaryStatus == 1 ) &&
+          ( ! (lV0Result->GetCutMCLambdaFromPrimaryXi())|| (fTreeVariablePrimaryStatusMother == 1 && fTreeVariablePIDMother == lPDGCodeXiMother) ) &&
+          ( ! (lV0Result->GetCutMCPDGCodeAssociation()) || fTreeVariablePID == lPDGCode     )
+          ){
+        //This satisfies all my conditionals! Fill histogram
+        if( !lV0Result -> GetCutMCUseMCProperties() ){
+          histoout -> Fill ( fCentrality, fTreeVariablePt, lMass );
+          if(histoProtonProfile)
+            histoProtonProfile -> Fill( fTreeVariablePt, lBaryonTransvMomMCForG3F );
+        }else{
+          histoout -> Fill ( fCentrality, fTreeVariablePtMC, lMass );
+          if(histoProtonProfile)
+            histoProtonProfile -> Fill( fTreeVariablePtMC, lBaryonTransvMomMCForG3F );
+        }
       }
       
+      //Fill feeddown matrix, please
       if (
-          //Check 1: Offline Vertexer
-          lOnFlyStatus == lV0Result->GetUseOnTheFly() &&
-          
-          //Check 2: Basic Acceptance cuts
-          lV0Result->GetCutMinEtaTracks() < fTreeVariableNegEta && fTreeVariableNegEta < lV0Result->GetCutMaxEtaTracks() &&
-          lV0Result->GetCutMinEtaTracks() < fTreeVariablePosEta && fTreeVariablePosEta < lV0Result->GetCutMaxEtaTracks() &&
-          lRap > lV0Result->GetCutMinRapidity() &&
-          lRap < lV0Result->GetCutMaxRapidity() &&
-          
-          //Check 3: Topological Variables
-          fTreeVariableV0Radius > lV0Result->GetCutV0Radius() &&
-          fTreeVariableV0Radius < lV0Result->GetCutMaxV0Radius() &&
-          fTreeVariableDcaNegToPrimVertex > lV0Result->GetCutDCANegToPV() &&
-          fTreeVariableDcaPosToPrimVertex > lV0Result->GetCutDCAPosToPV() &&
-          fTreeVariableDcaV0Daughters < lV0Result->GetCutDCAV0Daughters() &&
-          fTreeVariableV0CosineOfPointingAngle > lV0CosPACut &&
-          fTreeVariableDistOverTotMom*lPDGMass < lV0Result->GetCutProperLifetime() &&
-          fTreeVariableLeastNbrCrossedRows > lV0Result->GetCutLeastNumberOfCrossedRows() &&
-          fTreeVariableLeastRatioCrossedRowsOverFindable > lV0Result->GetCutLeastNumberOfCrossedRowsOverFindable() &&
-          
-          //Check 4: Minimum momentum of baryon daughter
-          ( lV0Result->GetMassHypothesis() == AliV0Result::kK0Short || lBaryonMomentum > lV0Result->GetCutMinBaryonMomentum() ) &&
-          
-          //Check 5: TPC dEdx selections
-          TMath::Abs(lNegdEdx)<lV0Result->GetCutTPCdEdx() &&
-          TMath::Abs(lPosdEdx)<lV0Result->GetCutTPCdEdx() &&
-          
-          //Check 6: Armenteros-Podolanski space cut (for K0Short analysis)
-          ( ( lV0Result->GetCutArmenteros() == kFALSE || lV0Result->GetMassHypothesis() != AliV0Result::kK0Short ) || ( fTreeVariablePtArmV0>lV0Result->GetCutArmenterosParameter()*TMath::Abs(fTreeVariableAlphaV0) ) ) &&
-          
-          //Check 7: kITSrefit track selection if requested
-          (
-           ( (fTreeVariableNegTrackStatus & AliESDtrack::kITSrefit) &&
-            (fTreeVariablePosTrackStatus & AliESDtrack::kITSrefit) )
-           ||
-           !lV0Result->GetCutUseITSRefitTracks()
-           )&&
-          
-          //Check 8: Max Chi2/Clusters if not absurd
-          ( lV0Result->GetCutMaxChi2PerCluster()>1e+3 ||
-           fTreeVariableMaxChi2PerCluster < lV0Result->GetCutMaxChi2PerCluster()
-           ) &&
-          
-          //Check 9: Min Track Length if positive
-          ( lV0Result->GetCutMinTrackLength()<0 || //this is a bit paranoid...
-           (fTreeVariableMinTrackLength > lV0Result->GetCutMinTrackLength()&& !lV0Result->GetCutUseParametricLength()) ||
-           (fTreeVariableMinTrackLength > lV0Result->GetCutMinTrackLength()
-            - (TMath::Power(1/(fTreeVariablePt+1e-6),1.5)) //rough parametrization, tune me!
-            - TMath::Max(fTreeVariableV0Radius-85., 0.) //rough parametrization, tune me!
-            && lV0Result->GetCutUseParametricLength())
-           )&&
-          
-          //Check 10: Special 2.76TeV-like dedx
-          // Logic: either not requested, or K0Short, or high-pT baryon daughter, or passes cut!
-          ( !lV0Result->GetCut276TeVLikedEdx() ||
-           ( lV0Result->GetMassHypothesis() == AliV0Result::kK0Short ||
-            ( lBaryonPt > 1.0 || TMath::Abs(lBaryondEdxFromProton)<3.0 )
-            )
-           )&&
-          
-          //Check 14: has at least one track with some TOF info, please (reject pileup)
-          //          warning: this is still to be studied in more detail!
-          (
-           lV0Result->GetCutAtLeastOneTOF() == kFALSE ||
-           (
-            TMath::Abs(fTreeVariableNegTOFSignal) < 100 ||
-            TMath::Abs(fTreeVariablePosTOFSignal) < 100
-            )
-           )&&
-          
-          //Check 15: cowboy/sailor for V0
-          (
-           lV0Result->GetCutIsCowboy()==0 ||
-           (lV0Result->GetCutIsCowboy()== 1 && fTreeVariableIsCowboy==kTRUE ) ||
-           (lV0Result->GetCutIsCowboy()==-1 && fTreeVariableIsCowboy==kFALSE)
-           )&&//end cowboy/sailor
-          
-          //Check 16: modern track quality selections
-          (
-           lV0Result->GetCutMinCrossedRowsOverLength()<0 ||
-           (lLeastNcrOverLength>lV0Result->GetCutMinCrossedRowsOverLength())
-           )&&
-          //Check 17: ITS or TOF required
-          (
-           lV0Result->GetCutITSorTOF()==kFALSE || lITSorTOFsatisfied==kTRUE
-           )
-          )//end major if
-      {
-        //Regular fill histogram here
-        if (
-            ( ! (lV0Result->GetCutMCPhysicalPrimary())    || fTreeVariablePrimaryStatus == 1 ) &&
-            ( ! (lV0Result->GetCutMCLambdaFromPrimaryXi())|| (fTreeVariablePrimaryStatusMother == 1 && fTreeVariablePIDMother == lPDGCodeXiMother) ) &&
-            ( ! (lV0Result->GetCutMCPDGCodeAssociation()) || fTreeVariablePID == lPDGCode     )
-            ){
-          //This satisfies all my conditionals! Fill histogram
-          if( !lV0Result -> GetCutMCUseMCProperties() ){
-            histoout -> Fill ( fCentrality, fTreeVariablePt, lMass );
-            if(histoProtonProfile)
-              histoProtonProfile -> Fill( fTreeVariablePt, lBaryonTransvMomMCForG3F );
-          }else{
-            histoout -> Fill ( fCentrality, fTreeVariablePtMC, lMass );
-            if(histoProtonProfile)
-              histoProtonProfile -> Fill( fTreeVariablePtMC, lBaryonTransvMomMCForG3F );
-          }
-        }
-        
-        //Fill feeddown matrix, please
-        if (
-            histooutfeeddown &&
-            (fTreeVariablePrimaryStatusMother == 1 && fTreeVariablePIDMother == lPDGCodeXiMother) &&
-            (  fTreeVariablePID == lPDGCode     )
-            ){
-          //Warning: has to be filled with perfect properties
-          //Rough invariant mass selection: could be better, but would be a correction
-          //of the correction -> left as further improvement
-          if( TMath::Abs(lMass-1.116) < 0.010 )
-            histooutfeeddown -> Fill ( fTreeVariablePt, fTreeVariablePtMother, fCentrality );
-        }
+          histooutfeeddown &&
+          (fTreeVariablePrimaryStatusMother == 1 && fTreeVariablePIDMother == lPDGCodeXiMother) &&
+          (  fTreeVariablePID == lPDGCode     )
+          ){
+        //Warning: has to be filled with perfect properties
+        //Rough invariant mass selection: could be better, but would be a correction
+        //of the correction -> left as further improvement
+        if( TMath::Abs(lMass-1.116) < 0.010 )
+          histooutfeeddown -> Fill ( fTreeVariablePt, fTreeVariablePtMother, fCentrality );
       }
     }
     //+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -5529,374 +5425,146 @@ void AliAnalysisTaskStrangenessVsMultiplicityMCRun2::UserExec(Option_t *)
     // Superlight adaptive output mode
     //+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     
-    //Step 1: Sweep members of the output object TLists and fill all of them as appropriate
+    //For parametric V0 Mass selection
+    Float_t lExpV0Mass =
+    fLambdaMassMean[0]+
+    fLambdaMassMean[1]*TMath::Exp(fLambdaMassMean[2]*lV0Pt)+
+    fLambdaMassMean[3]*TMath::Exp(fLambdaMassMean[4]*lV0Pt);
+    
+    Float_t lExpV0Sigma =
+    fLambdaMassSigma[0]+fLambdaMassSigma[1]*lV0Pt+
+    fLambdaMassSigma[2]*TMath::Exp(fLambdaMassSigma[3]*lV0Pt);
+    
+    //========================================================================
+    //For 2.76TeV-like parametric V0 CosPA
+    Float_t l276TeVV0CosPA = 0.998;
+    Float_t pThr=1.5;
+    if (lV0TotMomentum<pThr) {
+      //Below the threshold "pThr", try a momentum dependent cos(PA) cut
+      const Double_t bend=0.03; // approximate Xi bending angle
+      const Double_t qt=0.211;  // max Lambda pT in Omega decay
+      const Double_t cpaThr=TMath::Cos(TMath::ATan(qt/pThr) + bend);
+      Double_t
+      cpaCut=(0.998/cpaThr)*TMath::Cos(TMath::ATan(qt/lV0TotMomentum) + bend);
+      l276TeVV0CosPA = cpaCut;
+    }
+    //========================================================================
+    
+    //All configurations are evaluated at once, see AliCascadeCutTable
+    AliCascadeCutTable::Candidate lCascCandidate;
+    lCascCandidate.fCharge = fTreeCascVarCharge;
+    lCascCandidate.fPt = fTreeCascVarPt;
+    lCascCandidate.fNegEta = fTreeCascVarNegEta;
+    lCascCandidate.fPosEta = fTreeCascVarPosEta;
+    lCascCandidate.fBachEta = fTreeCascVarBachEta;
+    lCascCandidate.fRapXi = fTreeCascVarRapXi;
+    lCascCandidate.fRapOmega = fTreeCascVarRapOmega;
+    lCascCandidate.fRapMC = fTreeCascVarRapMC;
+    lCascCandidate.fMassAsXi = fTreeCascVarMassAsXi;
+    lCascCandidate.fMassAsOmega = fTreeCascVarMassAsOmega;
+    lCascCandidate.fV0MassLambda = fTreeCascVarV0Mass;
+    lCascCandidate.fV0MassAntiLambda = fTreeCascVarV0Mass;
+    lCascCandidate.fExpV0Mass = lExpV0Mass;
+    lCascCandidate.fExpV0Sigma = lExpV0Sigma;
+    lCascCandidate.fDCANegToPrimVtx = fTreeCascVarDCANegToPrimVtx;
+    lCascCandidate.fDCAPosToPrimVtx = fTreeCascVarDCAPosToPrimVtx;
+    lCascCandidate.fDCAV0Daughters = fTreeCascVarDCAV0Daughters;
+    lCascCandidate.fV0CosPointingAngle = fTreeCascVarV0CosPointingAngle;
+    lCascCandidate.fV0Radius = fTreeCascVarV0Radius;
+    lCascCandidate.fDCAV0ToPrimVtx = fTreeCascVarDCAV0ToPrimVtx;
+    lCascCandidate.fDCABachToPrimVtx = fTreeCascVarDCABachToPrimVtx;
+    lCascCandidate.fDCACascDaughters = fTreeCascVarDCACascDaughters;
+    lCascCandidate.fCascCosPointingAngle = fTreeCascVarCascCosPointingAngle;
+    lCascCandidate.fCascRadius = fTreeCascVarCascRadius;
+    lCascCandidate.fDistOverTotMom = fTreeCascVarDistOverTotMom;
+    lCascCandidate.fLeastNbrClusters = fTreeCascVarLeastNbrClusters;
+    lCascCandidate.fNegNSigmaPion = fTreeCascVarNegNSigmaPion;
+    lCascCandidate.fNegNSigmaProton = fTreeCascVarNegNSigmaProton;
+    lCascCandidate.fPosNSigmaPion = fTreeCascVarPosNSigmaPion;
+    lCascCandidate.fPosNSigmaProton = fTreeCascVarPosNSigmaProton;
+    lCascCandidate.fBachNSigmaPion = fTreeCascVarBachNSigmaPion;
+    lCascCandidate.fBachNSigmaKaon = fTreeCascVarBachNSigmaKaon;
+    lCascCandidate.fNegTOFNSigmaPion = 0; //no TOF selection in MC
+    lCascCandidate.fNegTOFNSigmaProton = 0; //no TOF selection in MC
+    lCascCandidate.fPosTOFNSigmaPion = 0; //no TOF selection in MC
+    lCascCandidate.fPosTOFNSigmaProton = 0; //no TOF selection in MC
+    lCascCandidate.fBachTOFNSigmaPion = 0; //no TOF selection in MC
+    lCascCandidate.fBachTOFNSigmaKaon = 0; //no TOF selection in MC
+    lCascCandidate.fDCABachToBaryon = fTreeCascVarDCABachToBaryon;
+    lCascCandidate.fWrongCosPA = fTreeCascVarWrongCosPA;
+    lCascCandidate.fV0Lifetime = fTreeCascVarV0Lifetime;
+    lCascCandidate.fNegITSrefit = (fTreeCascVarNegTrackStatus & AliESDtrack::kITSrefit) != 0;
+    lCascCandidate.fPosITSrefit = (fTreeCascVarPosTrackStatus & AliESDtrack::kITSrefit) != 0;
+    lCascCandidate.fBachITSrefit = (fTreeCascVarBachTrackStatus & AliESDtrack::kITSrefit) != 0;
+    lCascCandidate.fMaxChi2PerCluster = fTreeCascVarMaxChi2PerCluster;
+    lCascCandidate.fMinTrackLength = fTreeCascVarMinTrackLength;
+    lCascCandidate.f276TeVV0CosPA = l276TeVV0CosPA;
+    lCascCandidate.fCascDCAtoPVxy = fTreeCascVarCascDCAtoPVxy;
+    lCascCandidate.fCascDCAtoPVz = fTreeCascVarCascDCAtoPVz;
+    lCascCandidate.fNegTOFSignal = fTreeCascVarNegTOFSignal;
+    lCascCandidate.fPosTOFSignal = fTreeCascVarPosTOFSignal;
+    lCascCandidate.fBachTOFSignal = fTreeCascVarBachTOFSignal;
+    lCascCandidate.fIsCowboy = fTreeCascVarIsCowboy;
+    lCascCandidate.fIsCascadeCowboy = fTreeCascVarIsCascadeCowboy;
+    lCascCandidate.fLeastNcrOverLength = lLeastNcrOverLength;
+    lCascCandidate.fLeastNbrCrossedRows = lLeastNbrCrossedRows;
+    lCascCandidate.fITSorTOFsatisfied = lITSorTOFsatisfied;
+    
+    Bool_t lListEnabled[4] = { lValidXiMinus, lValidXiPlus, lValidOmegaMinus, lValidOmegaPlus };
+    const Int_t lNSelectedCascades = fCascadeCutTable->Select( lCascCandidate, lListEnabled );
     TH3F *histoout         = 0x0;
-    AliCascadeResult *lCascadeResult = 0x0;
     TProfile *histoProtonProfile         = 0x0;
-    
-    //pointers to valid results
-    AliCascadeResult *lPointers[50000];
-    Long_t lValidConfigurations=0;
-    
-    if( lValidXiMinus )
-      for( Int_t icfg=0; icfg<fListXiMinus->GetEntries(); icfg++ ){
-        lPointers[lValidConfigurations] = (AliCascadeResult*) fListXiMinus->At(icfg);
-        lValidConfigurations++;
-      }
-    if( lValidXiPlus )
-      for( Int_t icfg=0; icfg<fListXiPlus->GetEntries(); icfg++ ){
-        lPointers[lValidConfigurations] = (AliCascadeResult*) fListXiPlus->At(icfg);
-        lValidConfigurations++;
-      }
-    if( lValidOmegaMinus )
-      for( Int_t icfg=0; icfg<fListOmegaMinus->GetEntries(); icfg++ ){
-        lPointers[lValidConfigurations] = (AliCascadeResult*) fListOmegaMinus->At(icfg);
-        lValidConfigurations++;
-      }
-    if( lValidOmegaPlus )
-      for( Int_t icfg=0; icfg<fListOmegaPlus->GetEntries(); icfg++ ){
-        lPointers[lValidConfigurations] = (AliCascadeResult*) fListOmegaPlus->At(icfg);
-        lValidConfigurations++;
-      }
-    
-    for(Int_t lcfg=0; lcfg<lValidConfigurations; lcfg++){
-      lCascadeResult = lPointers[lcfg];
-      Bool_t lTheOne = fkConfigToSave.EqualTo( lCascadeResult->GetName() );
+    for(Int_t lsel=0; lsel<lNSelectedCascades; lsel++){
+      AliCascadeResult *lCascadeResult = fCascadeCutTable->GetSelected(lsel);
+      Float_t lMass = fCascadeCutTable->GetMass( lCascadeResult->GetMassHypothesis() );
       histoout  = lCascadeResult->GetHistogram();
       histoProtonProfile  = lCascadeResult->GetProtonProfile();
       
-      Float_t lMass = 0;
-      Float_t lRap  = 0;
-      Float_t lPDGMass = -1;
-      Float_t lNegdEdx = 100;
-      Float_t lPosdEdx = 100;
-      Float_t lBachdEdx = 100;
       Short_t  lCharge = -2;
       Int_t lPDGCode = 0;
-      Float_t lprpx, lprpy, lprpz, lpipx, lpipy, lpipz;
-      lpipx = fTreeCascVarBachPx;
-      lpipy = fTreeCascVarBachPy;
-      lpipz = fTreeCascVarBachPz;
-      Float_t lBaryonTransvMomMCForG3F;
-      
-      //For parametric V0 Mass selection
-      Float_t lExpV0Mass =
-      fLambdaMassMean[0]+
-      fLambdaMassMean[1]*TMath::Exp(fLambdaMassMean[2]*lV0Pt)+
-      fLambdaMassMean[3]*TMath::Exp(fLambdaMassMean[4]*lV0Pt);
-      
-      Float_t lExpV0Sigma =
-      fLambdaMassSigma[0]+fLambdaMassSigma[1]*lV0Pt+
-      fLambdaMassSigma[2]*TMath::Exp(fLambdaMassSigma[3]*lV0Pt);
-      
-      //========================================================================
-      //For 2.76TeV-like parametric V0 CosPA
-      Float_t l276TeVV0CosPA = 0.998;
-      Float_t pThr=1.5;
-      if (lV0TotMomentum<pThr) {
-        //Below the threshold "pThr", try a momentum dependent cos(PA) cut
-        const Double_t bend=0.03; // approximate Xi bending angle
-        const Double_t qt=0.211;  // max Lambda pT in Omega decay
-        const Double_t cpaThr=TMath::Cos(TMath::ATan(qt/pThr) + bend);
-        Double_t
-        cpaCut=(0.998/cpaThr)*TMath::Cos(TMath::ATan(qt/lV0TotMomentum) + bend);
-        l276TeVV0CosPA = cpaCut;
-      }
-      //========================================================================
-      
-      //========================================================================
-      //Setting up: Variable Cascade CosPA
-      Float_t lCascCosPACut = lCascadeResult -> GetCutCascCosPA();
-      Float_t lVarCascCosPApar[5];
-      lVarCascCosPApar[0] = lCascadeResult->GetCutVarCascCosPAExp0Const();
-      lVarCascCosPApar[1] = lCascadeResult->GetCutVarCascCosPAExp0Slope();
-      lVarCascCosPApar[2] = lCascadeResult->GetCutVarCascCosPAExp1Const();
-      lVarCascCosPApar[3] = lCascadeResult->GetCutVarCascCosPAExp1Slope();
-      lVarCascCosPApar[4] = lCascadeResult->GetCutVarCascCosPAConst();
-      Float_t lVarCascCosPA = TMath::Cos(
-                                         lVarCascCosPApar[0]*TMath::Exp(lVarCascCosPApar[1]*fTreeCascVarPt) +
-                                         lVarCascCosPApar[2]*TMath::Exp(lVarCascCosPApar[3]*fTreeCascVarPt) +
-                                         lVarCascCosPApar[4]);
-      if( lCascadeResult->GetCutUseVarCascCosPA() ){
-        //Only use if tighter than the non-variable cut
-        if( lVarCascCosPA > lCascCosPACut ) lCascCosPACut = lVarCascCosPA;
-      }
-      //========================================================================
-      
-      //========================================================================
-      //Setting up: Variable V0 CosPA
-      Float_t lV0CosPACut = lCascadeResult -> GetCutV0CosPA();
-      Float_t lVarV0CosPApar[5];
-      lVarV0CosPApar[0] = lCascadeResult->GetCutVarV0CosPAExp0Const();
-      lVarV0CosPApar[1] = lCascadeResult->GetCutVarV0CosPAExp0Slope();
-      lVarV0CosPApar[2] = lCascadeResult->GetCutVarV0CosPAExp1Const();
-      lVarV0CosPApar[3] = lCascadeResult->GetCutVarV0CosPAExp1Slope();
-      lVarV0CosPApar[4] = lCascadeResult->GetCutVarV0CosPAConst();
-      Float_t lVarV0CosPA = TMath::Cos(
-                                       lVarV0CosPApar[0]*TMath::Exp(lVarV0CosPApar[1]*fTreeCascVarPt) +
-                                       lVarV0CosPApar[2]*TMath::Exp(lVarV0CosPApar[3]*fTreeCascVarPt) +
-                                       lVarV0CosPApar[4]);
-      if( lCascadeResult->GetCutUseVarV0CosPA() ){
-        //Only use if tighter than the non-variable cut
-        if( lVarV0CosPA > lV0CosPACut ) lV0CosPACut = lVarV0CosPA;
-      }
-      //========================================================================
-      
-      //========================================================================
-      //Setting up: Variable BB CosPA
-      Float_t lBBCosPACut = lCascadeResult -> GetCutBachBaryonCosPA();
-      Float_t lVarBBCosPApar[5];
-      lVarBBCosPApar[0] = lCascadeResult->GetCutVarBBCosPAExp0Const();
-      lVarBBCosPApar[1] = lCascadeResult->GetCutVarBBCosPAExp0Slope();
-      lVarBBCosPApar[2] = lCascadeResult->GetCutVarBBCosPAExp1Const();
-      lVarBBCosPApar[3] = lCascadeResult->GetCutVarBBCosPAExp1Slope();
-      lVarBBCosPApar[4] = lCascadeResult->GetCutVarBBCosPAConst();
-      Float_t lVarBBCosPA = TMath::Cos(
-                                       lVarBBCosPApar[0]*TMath::Exp(lVarBBCosPApar[1]*fTreeCascVarPt) +
-                                       lVarBBCosPApar[2]*TMath::Exp(lVarBBCosPApar[3]*fTreeCascVarPt) +
-                                       lVarBBCosPApar[4]);
-      if( lCascadeResult->GetCutUseVarBBCosPA() ){
-        //Only use if looser than the non-variable cut (WARNING: BEWARE INVERSE LOGIC)
-        if( lVarBBCosPA > lBBCosPACut ) lBBCosPACut = lVarBBCosPA;
-      }
-      //========================================================================
-      
-      //========================================================================
-      //Setting up: Variable DCA Casc Dau
-      Float_t lDCACascDauCut = lCascadeResult -> GetCutDCACascDaughters();
-      Float_t lVarDCACascDaupar[5];
-      lVarDCACascDaupar[0] = lCascadeResult->GetCutVarDCACascDauExp0Const();
-      lVarDCACascDaupar[1] = lCascadeResult->GetCutVarDCACascDauExp0Slope();
-      lVarDCACascDaupar[2] = lCascadeResult->GetCutVarDCACascDauExp1Const();
-      lVarDCACascDaupar[3] = lCascadeResult->GetCutVarDCACascDauExp1Slope();
-      lVarDCACascDaupar[4] = lCascadeResult->GetCutVarDCACascDauConst();
-      Float_t lVarDCACascDau = lVarDCACascDaupar[0]*TMath::Exp(lVarDCACascDaupar[1]*fTreeCascVarPt) +
-      lVarDCACascDaupar[2]*TMath::Exp(lVarDCACascDaupar[3]*fTreeCascVarPt) +
-      lVarDCACascDaupar[4];
-      if( lCascadeResult->GetCutUseVarDCACascDau() ){
-        //Loosest: default cut, parametric can go tighter
-        if( lVarDCACascDau < lDCACascDauCut ) lDCACascDauCut = lVarDCACascDau;
-      }
-      //========================================================================
-      
-      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kXiMinus     ){
+      Float_t lBaryonTransvMomMCForG3F = -0.5;
+      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kXiMinus ){
         lCharge  = -1;
-        lMass    = fTreeCascVarMassAsXi;
-        lRap     = fTreeCascVarRapXi;
-        lPDGMass = 1.32171;
-        lNegdEdx = fTreeCascVarNegNSigmaPion;
-        lPosdEdx = fTreeCascVarPosNSigmaProton;
-        lBachdEdx= fTreeCascVarBachNSigmaPion;
         lPDGCode = 3312;
-        lprpx = fTreeCascVarPosPx;
-        lprpy = fTreeCascVarPosPy;
-        lprpz = fTreeCascVarPosPz;
         lBaryonTransvMomMCForG3F = fTreeCascVarPosTransvMomentumMC;
       }
-      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kXiPlus      ){
+      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kXiPlus ){
         lCharge  = +1;
-        lMass    = fTreeCascVarMassAsXi;
-        lRap     = fTreeCascVarRapXi;
-        lPDGMass = 1.32171;
-        lNegdEdx = fTreeCascVarNegNSigmaProton;
-        lPosdEdx = fTreeCascVarPosNSigmaPion;
-        lBachdEdx= fTreeCascVarBachNSigmaPion;
         lPDGCode = -3312;
-        lprpx = fTreeCascVarNegPx;
-        lprpy = fTreeCascVarNegPy;
-        lprpz = fTreeCascVarNegPz;
         lBaryonTransvMomMCForG3F = fTreeCascVarNegTransvMomentumMC;
       }
-      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kOmegaMinus     ){
+      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kOmegaMinus ){
         lCharge  = -1;
-        lMass    = fTreeCascVarMassAsOmega;
-        lRap     = fTreeCascVarRapOmega;
-        lPDGMass = 1.67245;
-        lNegdEdx = fTreeCascVarNegNSigmaPion;
-        lPosdEdx = fTreeCascVarPosNSigmaProton;
-        lBachdEdx= fTreeCascVarBachNSigmaKaon;
         lPDGCode = 3334;
-        lprpx = fTreeCascVarPosPx;
-        lprpy = fTreeCascVarPosPy;
-        lprpz = fTreeCascVarPosPz;
         lBaryonTransvMomMCForG3F = fTreeCascVarPosTransvMomentumMC;
       }
-      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kOmegaPlus      ){
+      if ( lCascadeResult->GetMassHypothesis() == AliCascadeResult::kOmegaPlus ){
         lCharge  = +1;
-        lMass    = fTreeCascVarMassAsOmega;
-        lRap     = fTreeCascVarRapOmega;
-        lPDGMass = 1.67245;
-        lNegdEdx = fTreeCascVarNegNSigmaProton;
-        lPosdEdx = fTreeCascVarPosNSigmaPion;
-        lBachdEdx= fTreeCascVarBachNSigmaKaon;
         lPDGCode = -3334;
-        lprpx = fTreeCascVarNegPx;
-        lprpy = fTreeCascVarNegPy;
-        lprpz = fTreeCascVarNegPz;
         lBaryonTransvMomMCForG3F = fTreeCascVarNegTransvMomentumMC;
       }
       
-      //Override rapidity for true rapidity if requested to do so
-      if ( lCascadeResult -> GetCutMCUseMCProperties() ) {
-        lRap = fTreeCascVarRapMC;
-      }
       if (
-          //Check 1: Charge consistent with expectations
-          fTreeCascVarCharge == lCharge &&
-          
-          //Check 2: Basic Acceptance cuts
-          lCascadeResult->GetCutMinEtaTracks() < fTreeCascVarPosEta && fTreeCascVarPosEta < lCascadeResult->GetCutMaxEtaTracks() &&
-          lCascadeResult->GetCutMinEtaTracks() < fTreeCascVarNegEta && fTreeCascVarNegEta < lCascadeResult->GetCutMaxEtaTracks() &&
-          lCascadeResult->GetCutMinEtaTracks() < fTreeCascVarBachEta && fTreeCascVarBachEta < lCascadeResult->GetCutMaxEtaTracks() &&
-          lRap > lCascadeResult->GetCutMinRapidity() &&
-          lRap < lCascadeResult->GetCutMaxRapidity() &&
-          
-          //Check 3: Topological Variables
-          // - V0 Selections
-          fTreeCascVarDCANegToPrimVtx > lCascadeResult->GetCutDCANegToPV() &&
-          fTreeCascVarDCAPosToPrimVtx > lCascadeResult->GetCutDCAPosToPV() &&
-          fTreeCascVarDCAV0Daughters < lCascadeResult->GetCutDCAV0Daughters() &&
-          fTreeCascVarV0CosPointingAngle > lV0CosPACut &&
-          fTreeCascVarV0Radius > lCascadeResult->GetCutV0Radius() &&
-          // - Cascade Selections
-          fTreeCascVarDCAV0ToPrimVtx > lCascadeResult->GetCutDCAV0ToPV() &&
-          TMath::Abs(fTreeCascVarV0Mass-1.116) < lCascadeResult->GetCutV0Mass() &&
-          fTreeCascVarDCABachToPrimVtx > lCascadeResult->GetCutDCABachToPV() &&
-          fTreeCascVarDCACascDaughters < lDCACascDauCut &&
-          fTreeCascVarCascCosPointingAngle > lCascCosPACut &&
-          fTreeCascVarCascRadius > lCascadeResult->GetCutCascRadius() &&
-          
-          // - Implementation of a parametric V0 Mass cut if requested
-          (
-           ( lCascadeResult->GetCutV0MassSigma() > 50 ) || //anything goes
-           (TMath::Abs( (fTreeCascVarV0Mass-lExpV0Mass) / lExpV0Sigma ) < lCascadeResult->GetCutV0MassSigma() )
-           ) &&
-          
-          // - Miscellaneous
-          fTreeCascVarDistOverTotMom*lPDGMass < lCascadeResult->GetCutProperLifetime() &&
-          fTreeCascVarLeastNbrClusters > lCascadeResult->GetCutLeastNumberOfClusters() &&
-          
-          // - MC specific: either don't associate (if not requested) or associate
-          ( ! (lCascadeResult->GetCutMCPhysicalPrimary())    || fTreeCascVarIsPhysicalPrimary == 1     ) &&
-          ( ! (lCascadeResult->GetCutMCPDGCodeAssociation()) || fTreeCascVarPID == lPDGCode            ) &&
-          
-          //Check 4: TPC dEdx selections
-          TMath::Abs(lNegdEdx )<lCascadeResult->GetCutTPCdEdx() &&
-          TMath::Abs(lPosdEdx )<lCascadeResult->GetCutTPCdEdx() &&
-          TMath::Abs(lBachdEdx)<lCascadeResult->GetCutTPCdEdx() &&
-          
-          //Check 5: Xi rejection for Omega analysis
-          ( ( lCascadeResult->GetMassHypothesis() != AliCascadeResult::kOmegaMinus && lCascadeResult->GetMassHypothesis() != AliCascadeResult::kOmegaPlus  ) || ( TMath::Abs( fTreeCascVarMassAsXi - 1.32171 ) > lCascadeResult->GetCutXiRejection() ) )&&
-          
-          //Check 6: Experimental DCA Bachelor to Baryon cut
-          ( fTreeCascVarDCABachToBaryon > lCascadeResult->GetCutDCABachToBaryon() ) &&
-          
-          //Check 7: Experimental Bach Baryon CosPA
-          ( fTreeCascVarWrongCosPA < lBBCosPACut  ) &&
-          
-          //Check 8: Min/Max V0 Lifetime cut
-          ( ( fTreeCascVarV0Lifetime > lCascadeResult->GetCutMinV0Lifetime() ) &&
-           ( fTreeCascVarV0Lifetime < lCascadeResult->GetCutMaxV0Lifetime() ||
-            lCascadeResult->GetCutMaxV0Lifetime() > 1e+3 ) ) &&
-          
-          //Check 9: kITSrefit track selection if requested
-          (
-           ( (fTreeCascVarPosTrackStatus & AliESDtrack::kITSrefit) &&
-            (fTreeCascVarNegTrackStatus & AliESDtrack::kITSrefit) &&
-            (fTreeCascVarBachTrackStatus & AliESDtrack::kITSrefit)
-            )
-           ||
-           !lCascadeResult->GetCutUseITSRefitTracks()
-           )  &&
-          
-          //Check 10: Max Chi2/Clusters if not absurd
-          ( lCascadeResult->GetCutMaxChi2PerCluster()>1e+3 ||
-           fTreeCascVarMaxChi2PerCluster < lCascadeResult->GetCutMaxChi2PerCluster()
-           ) &&
-          
-          //Check 11: Min Track Length if positive, [min - (1/pt)^1.5] if parametric requested
-          ( lCascadeResult->GetCutMinTrackLength()<0 || //this is a bit paranoid...
-           (fTreeCascVarMinTrackLength > lCascadeResult->GetCutMinTrackLength() && !lCascadeResult->GetCutUseParametricLength())||
-           (fTreeCascVarMinTrackLength > lCascadeResult->GetCutMinTrackLength()
-            - (TMath::Power(1/(fTreeCascVarPt+1e-6),1.5)) //rough parametrization, tune me!
-            - TMath::Max(fTreeCascVarV0Radius-85., 0.) //rough parametrization, tune me!
-            && lCascadeResult->GetCutUseParametricLength())
-           )&&
-          
-          //Check 12: Explicit associate-with-bump
-          ( ! (lCascadeResult->GetCutMCSelectBump())    || (//Start bump-selection
-                                                            //Case: XiMinus or OmegaMinus
-                                                            (lCharge == -1 &&
-                                                             fTreeCascVarPosLabelMother == fTreeCascVarBachLabelMother &&
-                                                             fTreeCascVarPIDBachelorMother ==  3122)||
-                                                            //Case: XiPlus or OmegaPlus
-                                                            (lCharge == +1 &&
-                                                             fTreeCascVarNegLabelMother == fTreeCascVarBachLabelMother &&
-                                                             fTreeCascVarPIDBachelorMother == -3122)
-                                                            )//End bump-selection
-           )&&
-          //Check 12: Check if special V0 CosPA cut used
-          //either don't use the cut at all, or make sure it's above threshold
-          ( lCascadeResult->GetCutUse276TeVV0CosPA()==kFALSE ||
-           fTreeCascVarV0CosPointingAngle>l276TeVV0CosPA
-           )&&
-          
-          //Check 13: 3D Cascade DCA to PV
-          ( lCascadeResult->GetCutDCACascadeToPV() > 999 ||
-           (TMath::Sqrt(fTreeCascVarCascDCAtoPVz*fTreeCascVarCascDCAtoPVz + fTreeCascVarCascDCAtoPVxy*fTreeCascVarCascDCAtoPVxy)<lCascadeResult->GetCutDCACascadeToPV() )
-           )&&
-          
-          //Check 14: has at least one track with some TOF info, please (reject pileup)
-          //          warning: this is still to be studied in more detail!
-          (
-           lCascadeResult->GetCutAtLeastOneTOF() == kFALSE ||
-           (
-            TMath::Abs(fTreeCascVarNegTOFSignal) < 100 ||
-            TMath::Abs(fTreeCascVarPosTOFSignal) < 100 ||
-            TMath::Abs(fTreeCascVarBachTOFSignal) < 100
-            )
-           )&&
-          
-          //Check 15: check each prong for ITS refit
-          (
-           ( lCascadeResult->GetCutUseITSRefitNegative()==kFALSE || fTreeCascVarNegTrackStatus & AliESDtrack::kITSrefit ) &&
-           ( lCascadeResult->GetCutUseITSRefitPositive()==kFALSE || fTreeCascVarPosTrackStatus & AliESDtrack::kITSrefit ) &&
-           ( lCascadeResult->GetCutUseITSRefitBachelor()==kFALSE || fTreeCascVarBachTrackStatus & AliESDtrack::kITSrefit )
-           )&&
-          
-          //Check 16: cowboy/sailor for V0
-          (
-           lCascadeResult->GetCutIsCowboy()==0 ||
-           (lCascadeResult->GetCutIsCowboy()== 1 && fTreeCascVarIsCowboy==kTRUE ) ||
-           (lCascadeResult->GetCutIsCowboy()==-1 && fTreeCascVarIsCowboy==kFALSE)
-           )&&//end cowboy/sailor
-          
-          //Check 17: cowboy/sailor for cascade
-          (
-           lCascadeResult->GetCutIsCascadeCowboy()==0 ||
-           (lCascadeResult->GetCutIsCascadeCowboy()== 1 && fTreeCascVarIsCascadeCowboy==kTRUE ) ||
-           (lCascadeResult->GetCutIsCascadeCowboy()==-1 && fTreeCascVarIsCascadeCowboy==kFALSE)
-           )&&//end cowboy/sailor
-          
-          //Check 18: modern track quality selections
-          (
-           lCascadeResult->GetCutMinCrossedRowsOverLength()<0 ||
-           (lLeastNcrOverLength>lCascadeResult->GetCutMinCrossedRowsOverLength())
-           )&&
-          //Check 19: modern track quality selections
-          (
-           lCascadeResult->GetCutLeastNumberOfCrossedRows()<0 ||
-           (lLeastNbrCrossedRows>lCascadeResult->GetCutLeastNumberOfCrossedRows())
-           )&&
-          //Check 20: ITS or TOF required
-          (
-           lCascadeResult->GetCutITSorTOF()==kFALSE || lITSorTOFsatisfied==kTRUE
-           )
-          )//end major if
-      {
+        // - MC specific: either don't associate (if not requested) or associate
+        ( ! (lCascadeResult->GetCutMCPhysicalPrimary())    || fTreeCascVarIsPhysicalPrimary == 1     ) &&
+        ( ! (lCascadeResult->GetCutMCPDGCodeAssociation()) || fTreeCascVarPID == lPDGCode            ) &&
         
+        //Check 12: Explicit associate-with-bump
+        ( ! (lCascadeResult->GetCutMCSelectBump())    || (//Start bump-selection
+                                                          //Case: XiMinus or OmegaMinus
+                                                          (lCharge == -1 &&
+                                                           fTreeCascVarPosLabelMother == fTreeCascVarBachLabelMother &&
+                                                           fTreeCascVarPIDBachelorMother ==  3122)||
+                                                          //Case: XiPlus or OmegaPlus
+                                                          (lCharge == +1 &&
+                                                           fTreeCascVarNegLabelMother == fTreeCascVarBachLabelMother &&
+                                                           fTreeCascVarPIDBachelorMother == -3122)
+                                                          )//End bump-selection
+         )
+        )//end MC association
+      {
         //This satisfies all my conditionals! Fill histogram
-        if( lTheOne && fkSaveSpecificConfig ) fTreeCascade->Fill();
+        if( fkSaveSpecificConfig && fkConfigToSave.EqualTo( lCascadeResult->GetName() ) ) fTreeCascade->Fill();
         
         if( !lCascadeResult -> GetCutMCUseMCProperties() ){
           histoout -> Fill ( fCentrality, fTreeCascVarPt, lMass );
@@ -42,6 +42,8 @@ class AliPhysicsSelection;
 class AliCFContainer;
 class AliV0Result;
 class AliCascadeResult;
+class AliV0CutTable;
+class AliCascadeCutTable;
 class AliExternalTrackParam;
 
 //#include "TString.h"
@@ -323,6 +325,8 @@ private:
   TTree  *fTreeEvent;              //! Output Tree, Events
   TTree  *fTreeV0;              //! Output Tree, V0s
   TTree  *fTreeCascade;              //! Output Tree, Cascades
+  AliV0CutTable      *fV0CutTable;      //! V0 configurations compiled for selection
+  AliCascadeCutTable *fCascadeCutTable; //! Cascade configurations compiled for selection
   
   AliPIDResponse *fPIDResponse;     // PID response object
   AliESDtrackCuts *fESDtrackCuts;   // ESD track cuts used for primary track definition
@@ -0,0 +1,530 @@
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Cut table to test one cascade candidate against all AliCascadeResult
+// configurations of a task in one go
+//
+// The selection reproduces the "superlight adaptive output mode"
+// of AliAnalysisTaskStrangenessVsMultiplicity(MC)Run2 and of the
+// AOD variants, check by check, with the same types in each comparison.
+// MC-only checks (association, bump selection) stay in the MC tasks.
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+#include "TList.h"
+#include "TMath.h"
+#include "AliCascadeResult.h"
+#include "AliCascadeCutTable.h"
+
+//________________________________________________________________
+AliCascadeCutTable::AliCascadeCutTable() :
+fUseMCRapidity(kFALSE),
+fUseSwapBachelorCharge(kTRUE)
+{
+    // Empty table: to be filled with Build()
+    fMass[0] = fMass[1] = fMass[2] = fMass[3] = 0;
+}
+
+//________________________________________________________________
+void AliCascadeCutTable::Clear()
+{
+    fResults.clear();
+    fGroupList.clear();
+    fGroupHypo.clear();
+    fGroupBegin.clear();
+    fGroupEnd.clear();
+
+    fCharge.clear();
+    fMinEtaTracks.clear();
+    fMaxEtaTracks.clear();
+    fMinRapidity.clear();
+    fMaxRapidity.clear();
+    fUseMCProperties.clear();
+    fDCANegToPV.clear();
+    fDCAPosToPV.clear();
+    fDCAV0Daughters.clear();
+    fV0Radius.clear();
+    fDCAV0ToPV.clear();
+    fV0Mass.clear();
+    fDCABachToPV.clear();
+    fCascRadius.clear();
+    fNoV0MassSigma.clear();
+    fV0MassSigma.clear();
+    fProperLifetime.clear();
+    fLeastNumberOfClusters.clear();
+    fTPCdEdx.clear();
+    fUseTOFUnchecked.clear();
+    fXiRejection.clear();
+    fDCABachToBaryon.clear();
+    fMinV0Lifetime.clear();
+    fMaxV0Lifetime.clear();
+    fNoMaxV0Lifetime.clear();
+    fUseITSRefitTracks.clear();
+    fNoMaxChi2PerCluster.clear();
+    fMaxChi2PerCluster.clear();
+    fNoMinTrackLength.clear();
+    fUseParametricLength.clear();
+    fMinTrackLength.clear();
+    fUse276TeVV0CosPA.clear();
+    fNoDCACascadeToPV.clear();
+    fDCACascadeToPV.clear();
+    fAtLeastOneTOF.clear();
+    fUseITSRefitNegative.clear();
+    fUseITSRefitPositive.clear();
+    fUseITSRefitBachelor.clear();
+    fAcceptCowboy.clear();
+    fAcceptSailor.clear();
+    fAcceptCascadeCowboy.clear();
+    fAcceptCascadeSailor.clear();
+    fNoMinCrossedRowsOverLength.clear();
+    fMinCrossedRowsOverLength.clear();
+    fNoLeastNumberOfCrossedRows.clear();
+    fLeastNumberOfCrossedRows.clear();
+    fITSorTOF.clear();
+
+    fCascCosPA = VariableCut();
+    fV0CosPA = VariableCut();
+    fBBCosPA = VariableCut();
+    fDCACascDaughters = VariableCut();
+}
+
+//________________________________________________________________
+void AliCascadeCutTable::AddVariableCut( VariableCut& lVarCut, Double_t lFixed, Bool_t lUseVar, const Double_t *lPars )
+{
+    //Fixed cut and parameters are stored as Float_t, as done in the tasks
+    lVarCut.fFixed.push_back( lFixed );
+    Int_t lIndex = -1;
+    if( lUseVar ){
+        std::vector<Float_t> lParsF( lPars, lPars+5 );
+        std::map<std::vector<Float_t>, Int_t>::iterator it = lVarCut.fParsMap.find(lParsF);
+        if( it == lVarCut.fParsMap.end() ){
+            lIndex = (Int_t) lVarCut.fParsMap.size();
+            lVarCut.fParsMap[lParsF] = lIndex;
+            lVarCut.fPars.insert( lVarCut.fPars.end(), lParsF.begin(), lParsF.end() );
+        }else{
+            lIndex = it->second;
+        }
+    }
+    lVarCut.fIndex.push_back( lIndex );
+}
+
+//________________________________________________________________
+void AliCascadeCutTable::EvaluateParametrizations( VariableCut& lVarCut, Float_t lPt, Bool_t lCosine )
+{
+    const Int_t lNPars = (Int_t) lVarCut.fValue.size();
+    for(Int_t ipar=0; ipar<lNPars; ipar++){
+        const Float_t *lPar = &lVarCut.fPars[5*ipar];
+        if( lCosine )
+            lVarCut.fValue[ipar] = TMath::Cos(
+                                              lPar[0]*TMath::Exp(lPar[1]*lPt) +
+                                              lPar[2]*TMath::Exp(lPar[3]*lPt) +
+                                              lPar[4]);
+        else
+            lVarCut.fValue[ipar] = lPar[0]*TMath::Exp(lPar[1]*lPt) +
+            lPar[2]*TMath::Exp(lPar[3]*lPt) +
+            lPar[4];
+    }
+}
+
+//________________________________________________________________
+const Float_t *AliCascadeCutTable::GetEffectiveCut( VariableCut& lVarCut, Bool_t lTighterIsLarger, Int_t lBegin, Int_t lEnd )
+{
+    //Parametric cut only used if tighter than the fixed one
+    if( lVarCut.fValue.empty() ) return lVarCut.fFixed.data();
+    for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+        Float_t lCut = lVarCut.fFixed[icfg];
+        Int_t lIndex = lVarCut.fIndex[icfg];
+        if( lIndex >= 0 ){
+            Float_t lVar = lVarCut.fValue[lIndex];
+            if( lTighterIsLarger ? lVar > lCut : lVar < lCut ) lCut = lVar;
+        }
+        lVarCut.fCut[icfg] = lCut;
+    }
+    return lVarCut.fCut.data();
+}
+
+//________________________________________________________________
+void AliCascadeCutTable::Build( TList **lLists, Int_t lNLists )
+{
+    Clear();
+
+    Double_t lPars[5];
+    for(Int_t ilist=0; ilist<lNLists; ilist++){
+        if( !lLists[ilist] ) continue;
+        for(Int_t ihypo=AliCascadeResult::kXiMinus; ihypo<=AliCascadeResult::kOmegaPlus; ihypo++){
+            Int_t lBegin = (Int_t) fResults.size();
+            for(Int_t icfg=0; icfg<lLists[ilist]->GetEntries(); icfg++){
+                AliCascadeResult *lCascadeResult = (AliCascadeResult*) lLists[ilist]->At(icfg);
+                if( lCascadeResult->GetMassHypothesis() != ihypo ) continue;
+                fResults.push_back( lCascadeResult );
+
+                Int_t lCharge = ( ihypo == AliCascadeResult::kXiMinus || ihypo == AliCascadeResult::kOmegaMinus ) ? -1 : +1;
+                if ( fUseSwapBachelorCharge && lCascadeResult->GetSwapBachelorCharge() ) lCharge *= -1;
+                fCharge.push_back( lCharge );
+                fMinEtaTracks.push_back( lCascadeResult->GetCutMinEtaTracks() );
+                fMaxEtaTracks.push_back( lCascadeResult->GetCutMaxEtaTracks() );
+                fMinRapidity.push_back( lCascadeResult->GetCutMinRapidity() );
+                fMaxRapidity.push_back( lCascadeResult->GetCutMaxRapidity() );
+                fUseMCProperties.push_back( fUseMCRapidity && lCascadeResult->GetCutMCUseMCProperties() );
+                fDCANegToPV.push_back( lCascadeResult->GetCutDCANegToPV() );
+                fDCAPosToPV.push_back( lCascadeResult->GetCutDCAPosToPV() );
+                fDCAV0Daughters.push_back( lCascadeResult->GetCutDCAV0Daughters() );
+                fV0Radius.push_back( lCascadeResult->GetCutV0Radius() );
+                fDCAV0ToPV.push_back( lCascadeResult->GetCutDCAV0ToPV() );
+                fV0Mass.push_back( lCascadeResult->GetCutV0Mass() );
+                fDCABachToPV.push_back( lCascadeResult->GetCutDCABachToPV() );
+                fCascRadius.push_back( lCascadeResult->GetCutCascRadius() );
+                fNoV0MassSigma.push_back( lCascadeResult->GetCutV0MassSigma() > 50 );
+                fV0MassSigma.push_back( lCascadeResult->GetCutV0MassSigma() );
+                fProperLifetime.push_back( lCascadeResult->GetCutProperLifetime() );
+                fLeastNumberOfClusters.push_back( lCascadeResult->GetCutLeastNumberOfClusters() );
+                fTPCdEdx.push_back( lCascadeResult->GetCutTPCdEdx() );
+                fUseTOFUnchecked.push_back( lCascadeResult->GetCutUseTOFUnchecked() );
+                fXiRejection.push_back( lCascadeResult->GetCutXiRejection() );
+                fDCABachToBaryon.push_back( lCascadeResult->GetCutDCABachToBaryon() );
+                fMinV0Lifetime.push_back( lCascadeResult->GetCutMinV0Lifetime() );
+                fMaxV0Lifetime.push_back( lCascadeResult->GetCutMaxV0Lifetime() );
+                fNoMaxV0Lifetime.push_back( lCascadeResult->GetCutMaxV0Lifetime() > 1e+3 );
+                fUseITSRefitTracks.push_back( lCascadeResult->GetCutUseITSRefitTracks() );
+                fNoMaxChi2PerCluster.push_back( lCascadeResult->GetCutMaxChi2PerCluster()>1e+3 );
+                fMaxChi2PerCluster.push_back( lCascadeResult->GetCutMaxChi2PerCluster() );
+                fNoMinTrackLength.push_back( lCascadeResult->GetCutMinTrackLength()<0 );
+                fUseParametricLength.push_back( lCascadeResult->GetCutUseParametricLength() );
+                fMinTrackLength.push_back( lCascadeResult->GetCutMinTrackLength() );
+                fUse276TeVV0CosPA.push_back( lCascadeResult->GetCutUse276TeVV0CosPA() );
+                fNoDCACascadeToPV.push_back( lCascadeResult->GetCutDCACascadeToPV() > 999 );
+                fDCACascadeToPV.push_back( lCascadeResult->GetCutDCACascadeToPV() );
+                fAtLeastOneTOF.push_back( lCascadeResult->GetCutAtLeastOneTOF() );
+                fUseITSRefitNegative.push_back( lCascadeResult->GetCutUseITSRefitNegative() );
+                fUseITSRefitPositive.push_back( lCascadeResult->GetCutUseITSRefitPositive() );
+                fUseITSRefitBachelor.push_back( lCascadeResult->GetCutUseITSRefitBachelor() );
+                fAcceptCowboy.push_back( lCascadeResult->GetCutIsCowboy()==0 || lCascadeResult->GetCutIsCowboy()== 1 );
+                fAcceptSailor.push_back( lCascadeResult->GetCutIsCowboy()==0 || lCascadeResult->GetCutIsCowboy()==-1 );
+                fAcceptCascadeCowboy.push_back( lCascadeResult->GetCutIsCascadeCowboy()==0 || lCascadeResult->GetCutIsCascadeCowboy()== 1 );
+                fAcceptCascadeSailor.push_back( lCascadeResult->GetCutIsCascadeCowboy()==0 || lCascadeResult->GetCutIsCascadeCowboy()==-1 );
+                fNoMinCrossedRowsOverLength.push_back( lCascadeResult->GetCutMinCrossedRowsOverLength()<0 );
+                fMinCrossedRowsOverLength.push_back( lCascadeResult->GetCutMinCrossedRowsOverLength() );
+                fNoLeastNumberOfCrossedRows.push_back( lCascadeResult->GetCutLeastNumberOfCrossedRows()<0 );
+                fLeastNumberOfCrossedRows.push_back( lCascadeResult->GetCutLeastNumberOfCrossedRows() );
+                fITSorTOF.push_back( lCascadeResult->GetCutITSorTOF() );
+
+                lPars[0] = lCascadeResult->GetCutVarCascCosPAExp0Const();
+                lPars[1] = lCascadeResult->GetCutVarCascCosPAExp0Slope();
+                lPars[2] = lCascadeResult->GetCutVarCascCosPAExp1Const();
+                lPars[3] = lCascadeResult->GetCutVarCascCosPAExp1Slope();
+                lPars[4] = lCascadeResult->GetCutVarCascCosPAConst();
+                AddVariableCut( fCascCosPA, lCascadeResult->GetCutCascCosPA(), lCascadeResult->GetCutUseVarCascCosPA(), lPars );
+
+                lPars[0] = lCascadeResult->GetCutVarV0CosPAExp0Const();
+                lPars[1] = lCascadeResult->GetCutVarV0CosPAExp0Slope();
+                lPars[2] = lCascadeResult->GetCutVarV0CosPAExp1Const();
+                lPars[3] = lCascadeResult->GetCutVarV0CosPAExp1Slope();
+                lPars[4] = lCascadeResult->GetCutVarV0CosPAConst();
+                AddVariableCut( fV0CosPA, lCascadeResult->GetCutV0CosPA(), lCascadeResult->GetCutUseVarV0CosPA(), lPars );
+
+                lPars[0] = lCascadeResult->GetCutVarBBCosPAExp0Const();
+                lPars[1] = lCascadeResult->GetCutVarBBCosPAExp0Slope();
+                lPars[2] = lCascadeResult->GetCutVarBBCosPAExp1Const();
+                lPars[3] = lCascadeResult->GetCutVarBBCosPAExp1Slope();
+                lPars[4] = lCascadeResult->GetCutVarBBCosPAConst();
+                AddVariableCut( fBBCosPA, lCascadeResult->GetCutBachBaryonCosPA(), lCascadeResult->GetCutUseVarBBCosPA(), lPars );
+
+                lPars[0] = lCascadeResult->GetCutVarDCACascDauExp0Const();
+                lPars[1] = lCascadeResult->GetCutVarDCACascDauExp0Slope();
+                lPars[2] = lCascadeResult->GetCutVarDCACascDauExp1Const();
+                lPars[3] = lCascadeResult->GetCutVarDCACascDauExp1Slope();
+                lPars[4] = lCascadeResult->GetCutVarDCACascDauConst();
+                AddVariableCut( fDCACascDaughters, lCascadeResult->GetCutDCACascDaughters(), lCascadeResult->GetCutUseVarDCACascDau(), lPars );
+            }
+            Int_t lEnd = (Int_t) fResults.size();
+            if( lEnd == lBegin ) continue;
+            fGroupList.push_back( ilist );
+            fGroupHypo.push_back( ihypo );
+            fGroupBegin.push_back( lBegin );
+            fGroupEnd.push_back( lEnd );
+        }
+    }
+
+    Int_t lNConfigs = (Int_t) fResults.size();
+    VariableCut *lVarCuts[4] = { &fCascCosPA, &fV0CosPA, &fBBCosPA, &fDCACascDaughters };
+    for(Int_t ivar=0; ivar<4; ivar++){
+        lVarCuts[ivar]->fValue.assign( lVarCuts[ivar]->fParsMap.size(), 0 );
+        lVarCuts[ivar]->fCut.assign( lNConfigs, 0 );
+        lVarCuts[ivar]->fParsMap.clear();
+    }
+    fPass.assign( lNConfigs, 0 );
+    fSelected.clear();
+    fSelected.reserve( lNConfigs );
+}
+
+//________________________________________________________________
+Int_t AliCascadeCutTable::Select( const Candidate& lCand, const Bool_t *lListEnabled )
+{
+    fSelected.clear();
+
+    fMass[AliCascadeResult::kXiMinus]    = lCand.fMassAsXi;
+    fMass[AliCascadeResult::kXiPlus]     = lCand.fMassAsXi;
+    fMass[AliCascadeResult::kOmegaMinus] = lCand.fMassAsOmega;
+    fMass[AliCascadeResult::kOmegaPlus]  = lCand.fMassAsOmega;
+
+    //Parametric cuts: one evaluation per distinct parametrization
+    EvaluateParametrizations( fCascCosPA, lCand.fPt, kTRUE );
+    EvaluateParametrizations( fV0CosPA, lCand.fPt, kTRUE );
+    EvaluateParametrizations( fBBCosPA, lCand.fPt, kTRUE );
+    EvaluateParametrizations( fDCACascDaughters, lCand.fPt, kFALSE );
+
+    //Candidate quantities common to all configurations
+    const Int_t    lCandCharge     = lCand.fCharge;
+    const Float_t  lNegEta         = lCand.fNegEta;
+    const Float_t  lPosEta         = lCand.fPosEta;
+    const Float_t  lBachEta        = lCand.fBachEta;
+    const Float_t  lRapMC          = lCand.fRapMC;
+    const Float_t  lDCANeg         = lCand.fDCANegToPrimVtx;
+    const Float_t  lDCAPos         = lCand.fDCAPosToPrimVtx;
+    const Float_t  lDCAV0Dau       = lCand.fDCAV0Daughters;
+    const Float_t  lV0CosPA        = lCand.fV0CosPointingAngle;
+    const Float_t  lV0Radius       = lCand.fV0Radius;
+    const Float_t  lDCAV0ToPV      = lCand.fDCAV0ToPrimVtx;
+    const Float_t  lDCABach        = lCand.fDCABachToPrimVtx;
+    const Float_t  lDCACascDau     = lCand.fDCACascDaughters;
+    const Float_t  lCascCosPA      = lCand.fCascCosPointingAngle;
+    const Float_t  lCascRadius     = lCand.fCascRadius;
+    const Int_t    lLeastNbrClusters = lCand.fLeastNbrClusters;
+    const Double_t lXiMassDeviation = TMath::Abs( lCand.fMassAsXi - 1.32171 );
+    const Float_t  lDCABachToBaryon = lCand.fDCABachToBaryon;
+    const Float_t  lWrongCosPA     = lCand.fWrongCosPA;
+    const Float_t  lV0Lifetime     = lCand.fV0Lifetime;
+    const Bool_t   lAllITSrefit    = lCand.fPosITSrefit && lCand.fNegITSrefit && lCand.fBachITSrefit;
+    const Bool_t   lNegITSrefit    = lCand.fNegITSrefit;
+    const Bool_t   lPosITSrefit    = lCand.fPosITSrefit;
+    const Bool_t   lBachITSrefit   = lCand.fBachITSrefit;
+    const Float_t  lMaxChi2        = lCand.fMaxChi2PerCluster;
+    const Float_t  lMinTrackLength = lCand.fMinTrackLength;
+    //Parametric track length: min - (1/pt)^1.5 - max(R(V0)-85,0)
+    const Double_t lLengthPtTerm   = TMath::Power(1/(lCand.fPt+1e-6),1.5);
+    const Double_t lLengthRTerm    = TMath::Max(lCand.fV0Radius-85., 0.);
+    const Bool_t   lPasses276TeVV0CosPA = lCand.fV0CosPointingAngle > lCand.f276TeVV0CosPA;
+    const Double_t lDCACascadeToPV = TMath::Sqrt(lCand.fCascDCAtoPVz*lCand.fCascDCAtoPVz + lCand.fCascDCAtoPVxy*lCand.fCascDCAtoPVxy);
+    const Bool_t   lHasTOF         =
+    TMath::Abs(lCand.fNegTOFSignal) < 100 ||
+    TMath::Abs(lCand.fPosTOFSignal) < 100 ||
+    TMath::Abs(lCand.fBachTOFSignal) < 100;
+    const Float_t  lNcrOverLength  = lCand.fLeastNcrOverLength;
+    const Int_t    lLeastNbrCrossedRows = lCand.fLeastNbrCrossedRows;
+    const Bool_t   lITSorTOF       = lCand.fITSorTOFsatisfied;
+
+    const Int_t lNGroups = (Int_t) fGroupBegin.size();
+    for(Int_t igroup=0; igroup<lNGroups; igroup++){
+        if( lListEnabled && !lListEnabled[fGroupList[igroup]] ) continue;
+        const Int_t lBegin = fGroupBegin[igroup];
+        const Int_t lEnd   = fGroupEnd[igroup];
+
+        //Mass hypothesis dependent quantities
+        Float_t lV0Mass = 0;
+        Float_t lRap  = 0;
+        Float_t lPDGMass = -1;
+        Float_t lNegdEdx = 100;
+        Float_t lPosdEdx = 100;
+        Float_t lBachdEdx = 100;
+        Float_t lNegTOFsigma = 100;
+        Float_t lPosTOFsigma = 100;
+        Float_t lBachTOFsigma = 100;
+        if ( fGroupHypo[igroup] == AliCascadeResult::kXiMinus     ){
+            lV0Mass  = lCand.fV0MassLambda;
+            lRap     = lCand.fRapXi;
+            lPDGMass = 1.32171;
+            lNegdEdx = lCand.fNegNSigmaPion;
+            lPosdEdx = lCand.fPosNSigmaProton;
+            lBachdEdx= lCand.fBachNSigmaPion;
+            lNegTOFsigma = lCand.fNegTOFNSigmaPion;
+            lPosTOFsigma = lCand.fPosTOFNSigmaProton;
+            lBachTOFsigma = lCand.fBachTOFNSigmaPion;
+        }
+        if ( fGroupHypo[igroup] == AliCascadeResult::kXiPlus      ){
+            lV0Mass  = lCand.fV0MassAntiLambda;
+            lRap     = lCand.fRapXi;
+            lPDGMass = 1.32171;
+            lNegdEdx = lCand.fNegNSigmaProton;
+            lPosdEdx = lCand.fPosNSigmaPion;
+            lBachdEdx= lCand.fBachNSigmaPion;
+            lNegTOFsigma = lCand.fNegTOFNSigmaProton;
+            lPosTOFsigma = lCand.fPosTOFNSigmaPion;
+            lBachTOFsigma = lCand.fBachTOFNSigmaPion;
+        }
+        if ( fGroupHypo[igroup] == AliCascadeResult::kOmegaMinus     ){
+            lV0Mass  = lCand.fV0MassLambda;
+            lRap     = lCand.fRapOmega;
+            lPDGMass = 1.67245;
+            lNegdEdx = lCand.fNegNSigmaPion;
+            lPosdEdx = lCand.fPosNSigmaProton;
+            lBachdEdx= lCand.fBachNSigmaKaon;
+            lNegTOFsigma = lCand.fNegTOFNSigmaPion;
+            lPosTOFsigma = lCand.fPosTOFNSigmaProton;
+            lBachTOFsigma = lCand.fBachTOFNSigmaKaon;
+        }
+        if ( fGroupHypo[igroup] == AliCascadeResult::kOmegaPlus      ){
+            lV0Mass  = lCand.fV0MassAntiLambda;
+            lRap     = lCand.fRapOmega;
+            lPDGMass = 1.67245;
+            lNegdEdx = lCand.fNegNSigmaProton;
+            lPosdEdx = lCand.fPosNSigmaPion;
+            lBachdEdx= lCand.fBachNSigmaKaon;
+            lNegTOFsigma = lCand.fNegTOFNSigmaProton;
+            lPosTOFsigma = lCand.fPosTOFNSigmaPion;
+            lBachTOFsigma = lCand.fBachTOFNSigmaKaon;
+        }
+        const Bool_t   lIsOmega        = fGroupHypo[igroup] == AliCascadeResult::kOmegaMinus || fGroupHypo[igroup] == AliCascadeResult::kOmegaPlus;
+        const Double_t lV0MassDeviation = TMath::Abs(lV0Mass-1.116);
+        const Float_t  lV0MassNSigma   = TMath::Abs( (lV0Mass-lCand.fExpV0Mass) / lCand.fExpV0Sigma );
+        const Float_t  lLifetime       = lCand.fDistOverTotMom*lPDGMass;
+        const Float_t  lAbsNegdEdx     = TMath::Abs(lNegdEdx);
+        const Float_t  lAbsPosdEdx     = TMath::Abs(lPosdEdx);
+        const Float_t  lAbsBachdEdx    = TMath::Abs(lBachdEdx);
+        //TOF selections only applied with GetCutUseTOFUnchecked()
+        const Bool_t   lPassesTOF      =
+        TMath::Abs(lNegTOFsigma )< 4 &&
+        TMath::Abs(lPosTOFsigma )< 4 &&
+        TMath::Abs(lBachTOFsigma)< 4;
+
+        //Effective parametric cuts
+        const Float_t *lCascCosPACut  = GetEffectiveCut( fCascCosPA, kTRUE, lBegin, lEnd );
+        const Float_t *lV0CosPACut    = GetEffectiveCut( fV0CosPA, kTRUE, lBegin, lEnd );
+        const Float_t *lBBCosPACut    = GetEffectiveCut( fBBCosPA, kTRUE, lBegin, lEnd );
+        const Float_t *lDCACascDauCut = GetEffectiveCut( fDCACascDaughters, kFALSE, lBegin, lEnd );
+
+        UChar_t *lPass = fPass.data();
+
+        //Check 1: Charge consistent with expectations / Check 2: Basic Acceptance cuts
+        const Int_t    *lCharge = fCharge.data();
+        const Double_t *lMinEta = fMinEtaTracks.data();
+        const Double_t *lMaxEta = fMaxEtaTracks.data();
+        const Double_t *lMinRap = fMinRapidity.data();
+        const Double_t *lMaxRap = fMaxRapidity.data();
+        const UChar_t  *lUseMC  = fUseMCProperties.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            const Float_t lRapCfg = lUseMC[icfg] ? lRapMC : lRap;
+            lPass[icfg] =
+            ( lCandCharge == lCharge[icfg] ) &
+            ( lMinEta[icfg] < lPosEta ) & ( lPosEta < lMaxEta[icfg] ) &
+            ( lMinEta[icfg] < lNegEta ) & ( lNegEta < lMaxEta[icfg] ) &
+            ( lMinEta[icfg] < lBachEta ) & ( lBachEta < lMaxEta[icfg] ) &
+            ( lRapCfg > lMinRap[icfg] ) & ( lRapCfg < lMaxRap[icfg] );
+        }
+
+        //Check 3: Topological Variables - V0 Selections
+        const Double_t *lMinDCANeg = fDCANegToPV.data();
+        const Double_t *lMinDCAPos = fDCAPosToPV.data();
+        const Double_t *lMaxDCAV0Dau = fDCAV0Daughters.data();
+        const Double_t *lMinV0Radius = fV0Radius.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lDCANeg > lMinDCANeg[icfg] ) & ( lDCAPos > lMinDCAPos[icfg] ) &
+            ( lDCAV0Dau < lMaxDCAV0Dau[icfg] ) & ( lV0CosPA > lV0CosPACut[icfg] ) &
+            ( lV0Radius > lMinV0Radius[icfg] );
+        }
+
+        //Check 3: Topological Variables - Cascade Selections
+        const Double_t *lMinDCAV0ToPV = fDCAV0ToPV.data();
+        const Double_t *lMaxV0MassDeviation = fV0Mass.data();
+        const Double_t *lMinDCABach = fDCABachToPV.data();
+        const Double_t *lMinCascRadius = fCascRadius.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lDCAV0ToPV > lMinDCAV0ToPV[icfg] ) & ( lV0MassDeviation < lMaxV0MassDeviation[icfg] ) &
+            ( lDCABach > lMinDCABach[icfg] ) & ( lDCACascDau < lDCACascDauCut[icfg] ) &
+            ( lCascCosPA > lCascCosPACut[icfg] ) & ( lCascRadius > lMinCascRadius[icfg] );
+        }
+
+        //Parametric V0 Mass cut if requested, Miscellaneous, Check 4: TPC dEdx selections
+        //Check 4bis: TOF selections (experimental)
+        const UChar_t  *lNoV0MassSigma = fNoV0MassSigma.data();
+        const Double_t *lMaxV0MassNSigma = fV0MassSigma.data();
+        const Double_t *lMaxLifetime = fProperLifetime.data();
+        const Double_t *lMinClusters = fLeastNumberOfClusters.data();
+        const Double_t *lMaxdEdx = fTPCdEdx.data();
+        const UChar_t  *lUseTOF = fUseTOFUnchecked.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lNoV0MassSigma[icfg] | ( lV0MassNSigma < lMaxV0MassNSigma[icfg] ) ) &
+            ( lLifetime < lMaxLifetime[icfg] ) & ( lLeastNbrClusters > lMinClusters[icfg] ) &
+            ( lAbsNegdEdx < lMaxdEdx[icfg] ) & ( lAbsPosdEdx < lMaxdEdx[icfg] ) & ( lAbsBachdEdx < lMaxdEdx[icfg] ) &
+            ( !lUseTOF[icfg] | lPassesTOF );
+        }
+
+        //Check 5: Xi rejection for Omega analysis
+        //Check 6: Experimental DCA Bachelor to Baryon cut
+        //Check 7: Experimental Bach Baryon CosPA
+        //Check 8: Min/Max V0 Lifetime cut
+        const Double_t *lMinXiRejection = fXiRejection.data();
+        const Double_t *lMinDCABachToBaryon = fDCABachToBaryon.data();
+        const Double_t *lMinV0Lifetime = fMinV0Lifetime.data();
+        const Double_t *lMaxV0Lifetime = fMaxV0Lifetime.data();
+        const UChar_t  *lNoMaxV0Lifetime = fNoMaxV0Lifetime.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( !lIsOmega | ( lXiMassDeviation > lMinXiRejection[icfg] ) ) &
+            ( lDCABachToBaryon > lMinDCABachToBaryon[icfg] ) &
+            ( lWrongCosPA < lBBCosPACut[icfg] ) &
+            ( lV0Lifetime > lMinV0Lifetime[icfg] ) & ( ( lV0Lifetime < lMaxV0Lifetime[icfg] ) | lNoMaxV0Lifetime[icfg] );
+        }
+
+        //Check 9: kITSrefit track selection if requested
+        //Check 10: Max Chi2/Clusters if not absurd
+        //Check 11: Min Track Length if positive, [min - (1/pt)^1.5 - max(R-85,0)] if parametric requested
+        const UChar_t  *lUseITSRefit = fUseITSRefitTracks.data();
+        const UChar_t  *lNoMaxChi2 = fNoMaxChi2PerCluster.data();
+        const Double_t *lMaxChi2Cut = fMaxChi2PerCluster.data();
+        const UChar_t  *lNoMinLength = fNoMinTrackLength.data();
+        const UChar_t  *lParametricLength = fUseParametricLength.data();
+        const Double_t *lMinLength = fMinTrackLength.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lAllITSrefit | !lUseITSRefit[icfg] ) &
+            ( lNoMaxChi2[icfg] | ( lMaxChi2 < lMaxChi2Cut[icfg] ) ) &
+            ( lNoMinLength[icfg] |
+             ( ( lMinTrackLength > lMinLength[icfg] ) & !lParametricLength[icfg] ) |
+             ( ( lMinTrackLength > lMinLength[icfg] - lLengthPtTerm - lLengthRTerm ) & lParametricLength[icfg] ) );
+        }
+
+        //Check 12: Check if special V0 CosPA cut used
+        //Check 13: 3D Cascade DCA to PV
+        //Check 14: has at least one track with some TOF info
+        //Check 15: check each prong for ITS refit
+        const UChar_t  *lUse276TeV = fUse276TeVV0CosPA.data();
+        const UChar_t  *lNoDCACascadeToPV = fNoDCACascadeToPV.data();
+        const Double_t *lMaxDCACascadeToPV = fDCACascadeToPV.data();
+        const UChar_t  *lAtLeastOneTOF = fAtLeastOneTOF.data();
+        const UChar_t  *lUseITSRefitNeg = fUseITSRefitNegative.data();
+        const UChar_t  *lUseITSRefitPos = fUseITSRefitPositive.data();
+        const UChar_t  *lUseITSRefitBach = fUseITSRefitBachelor.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( !lUse276TeV[icfg] | lPasses276TeVV0CosPA ) &
+            ( lNoDCACascadeToPV[icfg] | ( lDCACascadeToPV < lMaxDCACascadeToPV[icfg] ) ) &
+            ( !lAtLeastOneTOF[icfg] | lHasTOF ) &
+            ( !lUseITSRefitNeg[icfg] | lNegITSrefit ) &
+            ( !lUseITSRefitPos[icfg] | lPosITSrefit ) &
+            ( !lUseITSRefitBach[icfg] | lBachITSrefit );
+        }
+
+        //Check 16: cowboy/sailor for V0
+        //Check 17: cowboy/sailor for cascade
+        //Check 18, 19: modern track quality selections
+        //Check 20: ITS or TOF required
+        const UChar_t  *lAcceptV0 = lCand.fIsCowboy ? fAcceptCowboy.data() : fAcceptSailor.data();
+        const UChar_t  *lAcceptCascade = lCand.fIsCascadeCowboy ? fAcceptCascadeCowboy.data() : fAcceptCascadeSailor.data();
+        const UChar_t  *lNoNcrOverLength = fNoMinCrossedRowsOverLength.data();
+        const Double_t *lMinNcrOverLength = fMinCrossedRowsOverLength.data();
+        const UChar_t  *lNoCrossedRows = fNoLeastNumberOfCrossedRows.data();
+        const Double_t *lMinCrossedRows = fLeastNumberOfCrossedRows.data();
+        const UChar_t  *lRequireITSorTOF = fITSorTOF.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            lAcceptV0[icfg] & lAcceptCascade[icfg] &
+            ( lNoNcrOverLength[icfg] | ( lNcrOverLength > lMinNcrOverLength[icfg] ) ) &
+            ( lNoCrossedRows[icfg] | ( lLeastNbrCrossedRows > lMinCrossedRows[icfg] ) ) &
+            ( !lRequireITSorTOF[icfg] | lITSorTOF );
+        }
+
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++)
+            if( lPass[icfg] ) fSelected.push_back( icfg );
+    }
+    return (Int_t) fSelected.size();
+}
@@ -0,0 +1,195 @@
+#ifndef AliCascadeCutTable_H
+#define AliCascadeCutTable_H
+#include <map>
+#include <vector>
+#include <Rtypes.h>
+#include "AliCascadeResult.h"
+
+class TList;
+
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Cut table to test one cascade candidate against all AliCascadeResult
+// configurations of a task in one go (see AliV0CutTable).
+//
+// One column per cut, configurations grouped per output list and mass
+// hypothesis, branch-free loops over the configurations of a group
+// filling a byte mask. The pt-dependent cuts are evaluated once per
+// candidate for each distinct parametrization.
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+class AliCascadeCutTable {
+
+public:
+    //Candidate properties as computed in the cascade loop of the tasks
+    struct Candidate {
+        Int_t   fCharge;
+        Float_t fPt;
+        Float_t fNegEta;
+        Float_t fPosEta;
+        Float_t fBachEta;
+        Float_t fRapXi;
+        Float_t fRapOmega;
+        Float_t fRapMC; //only used if SetUseMCRapidity() was called
+        Float_t fMassAsXi;
+        Float_t fMassAsOmega;
+        Float_t fV0MassLambda;
+        Float_t fV0MassAntiLambda;
+        Float_t fExpV0Mass;  //parametric V0 mass: expected mean
+        Float_t fExpV0Sigma; //parametric V0 mass: expected width
+        Float_t fDCANegToPrimVtx;
+        Float_t fDCAPosToPrimVtx;
+        Float_t fDCAV0Daughters;
+        Float_t fV0CosPointingAngle;
+        Float_t fV0Radius;
+        Float_t fDCAV0ToPrimVtx;
+        Float_t fDCABachToPrimVtx;
+        Float_t fDCACascDaughters;
+        Float_t fCascCosPointingAngle;
+        Float_t fCascRadius;
+        Float_t fDistOverTotMom;
+        Int_t   fLeastNbrClusters;
+        Float_t fNegNSigmaPion;
+        Float_t fNegNSigmaProton;
+        Float_t fPosNSigmaPion;
+        Float_t fPosNSigmaProton;
+        Float_t fBachNSigmaPion;
+        Float_t fBachNSigmaKaon;
+        Float_t fNegTOFNSigmaPion;
+        Float_t fNegTOFNSigmaProton;
+        Float_t fPosTOFNSigmaPion;
+        Float_t fPosTOFNSigmaProton;
+        Float_t fBachTOFNSigmaPion;
+        Float_t fBachTOFNSigmaKaon;
+        Float_t fDCABachToBaryon;
+        Float_t fWrongCosPA;
+        Float_t fV0Lifetime;
+        Bool_t  fNegITSrefit;
+        Bool_t  fPosITSrefit;
+        Bool_t  fBachITSrefit;
+        Float_t fMaxChi2PerCluster;
+        Float_t fMinTrackLength;
+        Float_t f276TeVV0CosPA; //2.76TeV-like parametric V0 CosPA cut
+        Float_t fCascDCAtoPVxy;
+        Float_t fCascDCAtoPVz;
+        Float_t fNegTOFSignal;
+        Float_t fPosTOFSignal;
+        Float_t fBachTOFSignal;
+        Bool_t  fIsCowboy;
+        Bool_t  fIsCascadeCowboy;
+        Float_t fLeastNcrOverLength;
+        Int_t   fLeastNbrCrossedRows;
+        Bool_t  fITSorTOFsatisfied;
+    };
+
+    AliCascadeCutTable();
+
+    //Replace reconstructed rapidity by fRapMC for configurations with GetCutMCUseMCProperties()
+    //(to be set before Build)
+    void SetUseMCRapidity( Bool_t lOpt = kTRUE ) { fUseMCRapidity = lOpt; }
+    //Flip the expected charge for configurations with GetSwapBachelorCharge()
+    //(to be set before Build, default: kTRUE)
+    void SetUseSwapBachelorCharge( Bool_t lOpt = kTRUE ) { fUseSwapBachelorCharge = lOpt; }
+
+    //Compile the configurations of lNLists output lists (to be called once they are final)
+    void Build( TList **lLists, Int_t lNLists );
+
+    //Evaluate one candidate, returns the number of passing configurations
+    //lListEnabled (optional): one flag per list, configurations of disabled lists are skipped
+    Int_t Select( const Candidate& lCand, const Bool_t *lListEnabled = 0x0 );
+
+    Int_t GetNConfigurations() const { return (Int_t) fResults.size(); }
+    Int_t GetNSelected() const { return (Int_t) fSelected.size(); }
+    AliCascadeResult *GetSelected( Int_t lIdx ) const { return fResults[fSelected[lIdx]]; }
+    //Invariant mass of the last selected candidate under a given hypothesis
+    Float_t GetMass( AliCascadeResult::EMassHypo lHypo ) const { return fMass[lHypo]; }
+
+private:
+    //Cut with an optional pt-dependent parametrization
+    // p0*exp(p1*pt) + p2*exp(p3*pt) + p4, or its cosine for CosPA cuts
+    struct VariableCut {
+        std::vector<Float_t> fFixed; //fixed cut, one per configuration
+        std::vector<Int_t>   fIndex; //parametrization, one per configuration (-1: fixed cut only)
+        std::vector<Float_t> fPars;  //distinct parametrizations, 5 parameters each
+        std::vector<Float_t> fValue; //per candidate: one per parametrization
+        std::vector<Float_t> fCut;   //per candidate: effective cut, one per configuration
+        std::map<std::vector<Float_t>, Int_t> fParsMap; //only used while building
+    };
+    void Clear();
+    void AddVariableCut( VariableCut& lVarCut, Double_t lFixed, Bool_t lUseVar, const Double_t *lPars );
+    void EvaluateParametrizations( VariableCut& lVarCut, Float_t lPt, Bool_t lCosine );
+    const Float_t *GetEffectiveCut( VariableCut& lVarCut, Bool_t lTighterIsLarger, Int_t lBegin, Int_t lEnd );
+
+    Bool_t fUseMCRapidity;         //use fRapMC if requested by the configuration
+    Bool_t fUseSwapBachelorCharge; //flip charge if requested by the configuration
+
+    //Configurations, in group order
+    std::vector<AliCascadeResult*> fResults;
+    //Groups: configurations of one list with one mass hypothesis
+    std::vector<Int_t> fGroupList;
+    std::vector<Int_t> fGroupHypo;
+    std::vector<Int_t> fGroupBegin;
+    std::vector<Int_t> fGroupEnd;
+
+    //Cut columns, one entry per configuration
+    //Types follow the comparisons done in the tasks (Float_t for parametric cuts)
+    std::vector<Int_t>    fCharge;
+    std::vector<Double_t> fMinEtaTracks;
+    std::vector<Double_t> fMaxEtaTracks;
+    std::vector<Double_t> fMinRapidity;
+    std::vector<Double_t> fMaxRapidity;
+    std::vector<UChar_t>  fUseMCProperties;
+    std::vector<Double_t> fDCANegToPV;
+    std::vector<Double_t> fDCAPosToPV;
+    std::vector<Double_t> fDCAV0Daughters;
+    std::vector<Double_t> fV0Radius;
+    std::vector<Double_t> fDCAV0ToPV;
+    std::vector<Double_t> fV0Mass;
+    std::vector<Double_t> fDCABachToPV;
+    std::vector<Double_t> fCascRadius;
+    std::vector<UChar_t>  fNoV0MassSigma;
+    std::vector<Double_t> fV0MassSigma;
+    std::vector<Double_t> fProperLifetime;
+    std::vector<Double_t> fLeastNumberOfClusters;
+    std::vector<Double_t> fTPCdEdx;
+    std::vector<UChar_t>  fUseTOFUnchecked;
+    std::vector<Double_t> fXiRejection;
+    std::vector<Double_t> fDCABachToBaryon;
+    std::vector<Double_t> fMinV0Lifetime;
+    std::vector<Double_t> fMaxV0Lifetime;
+    std::vector<UChar_t>  fNoMaxV0Lifetime;
+    std::vector<UChar_t>  fUseITSRefitTracks;
+    std::vector<UChar_t>  fNoMaxChi2PerCluster;
+    std::vector<Double_t> fMaxChi2PerCluster;
+    std::vector<UChar_t>  fNoMinTrackLength;
+    std::vector<UChar_t>  fUseParametricLength;
+    std::vector<Double_t> fMinTrackLength;
+    std::vector<UChar_t>  fUse276TeVV0CosPA;
+    std::vector<UChar_t>  fNoDCACascadeToPV;
+    std::vector<Double_t> fDCACascadeToPV;
+    std::vector<UChar_t>  fAtLeastOneTOF;
+    std::vector<UChar_t>  fUseITSRefitNegative;
+    std::vector<UChar_t>  fUseITSRefitPositive;
+    std::vector<UChar_t>  fUseITSRefitBachelor;
+    std::vector<UChar_t>  fAcceptCowboy;
+    std::vector<UChar_t>  fAcceptSailor;
+    std::vector<UChar_t>  fAcceptCascadeCowboy;
+    std::vector<UChar_t>  fAcceptCascadeSailor;
+    std::vector<UChar_t>  fNoMinCrossedRowsOverLength;
+    std::vector<Double_t> fMinCrossedRowsOverLength;
+    std::vector<UChar_t>  fNoLeastNumberOfCrossedRows;
+    std::vector<Double_t> fLeastNumberOfCrossedRows;
+    std::vector<UChar_t>  fITSorTOF;
+
+    //Parametric cuts
+    VariableCut fCascCosPA;
+    VariableCut fV0CosPA;
+    VariableCut fBBCosPA;
+    VariableCut fDCACascDaughters;
+
+    //Per-candidate buffers
+    std::vector<UChar_t> fPass;     //selection mask, one per configuration
+    std::vector<Int_t>   fSelected; //passing configurations
+    Float_t fMass[4];
+};
+
+#endif
@@ -0,0 +1,352 @@
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Cut table to test one V0 candidate against all AliV0Result
+// configurations of a task in one go
+//
+// The selection reproduces the "superlight adaptive output mode"
+// of AliAnalysisTaskStrangenessVsMultiplicity(MC)Run2 and of the
+// AOD variants, check by check, with the same types in each comparison.
+// The loops over configurations only read contiguous columns and
+// write the mask, so that the compiler can vectorize them.
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+#include <map>
+#include "TList.h"
+#include "TMath.h"
+#include "AliV0Result.h"
+#include "AliV0CutTable.h"
+
+//________________________________________________________________
+AliV0CutTable::AliV0CutTable() :
+fUseMCRapidity(kFALSE)
+{
+    // Empty table: to be filled with Build()
+    fMass[0] = fMass[1] = fMass[2] = 0;
+}
+
+//________________________________________________________________
+void AliV0CutTable::Clear()
+{
+    fResults.clear();
+    fGroupList.clear();
+    fGroupHypo.clear();
+    fGroupBegin.clear();
+    fGroupEnd.clear();
+
+    fUseOnTheFly.clear();
+    fMinEtaTracks.clear();
+    fMaxEtaTracks.clear();
+    fMinRapidity.clear();
+    fMaxRapidity.clear();
+    fUseMCProperties.clear();
+    fV0Radius.clear();
+    fMaxV0Radius.clear();
+    fDCANegToPV.clear();
+    fDCAPosToPV.clear();
+    fDCAV0Daughters.clear();
+    fV0CosPA.clear();
+    fVarV0CosPAIndex.clear();
+    fProperLifetime.clear();
+    fLeastNumberOfCrossedRows.clear();
+    fLeastNumberOfCrossedRowsOverFindable.clear();
+    fMinBaryonMomentum.clear();
+    fTPCdEdx.clear();
+    fNoArmenteros.clear();
+    fArmenterosParameter.clear();
+    fUseITSRefitTracks.clear();
+    fNoMaxChi2PerCluster.clear();
+    fMaxChi2PerCluster.clear();
+    fNoMinTrackLength.clear();
+    fUseParametricLength.clear();
+    fMinTrackLength.clear();
+    f276TeVLikedEdx.clear();
+    fAtLeastOneTOF.clear();
+    fAcceptCowboy.clear();
+    fAcceptSailor.clear();
+    fNoMinCrossedRowsOverLength.clear();
+    fMinCrossedRowsOverLength.clear();
+    fITSorTOF.clear();
+    fVarV0CosPAPars.clear();
+}
+
+//________________________________________________________________
+void AliV0CutTable::Build( TList **lLists, Int_t lNLists )
+{
+    Clear();
+
+    //Distinct variable CosPA parametrizations: computed once per candidate
+    std::map<std::vector<Float_t>, Int_t> lVarV0CosPAMap;
+
+    for(Int_t ilist=0; ilist<lNLists; ilist++){
+        if( !lLists[ilist] ) continue;
+        for(Int_t ihypo=AliV0Result::kK0Short; ihypo<=AliV0Result::kAntiLambda; ihypo++){
+            Int_t lBegin = (Int_t) fResults.size();
+            for(Int_t icfg=0; icfg<lLists[ilist]->GetEntries(); icfg++){
+                AliV0Result *lV0Result = (AliV0Result*) lLists[ilist]->At(icfg);
+                if( lV0Result->GetMassHypothesis() != ihypo ) continue;
+                fResults.push_back( lV0Result );
+
+                fUseOnTheFly.push_back( lV0Result->GetUseOnTheFly() );
+                fMinEtaTracks.push_back( lV0Result->GetCutMinEtaTracks() );
+                fMaxEtaTracks.push_back( lV0Result->GetCutMaxEtaTracks() );
+                fMinRapidity.push_back( lV0Result->GetCutMinRapidity() );
+                fMaxRapidity.push_back( lV0Result->GetCutMaxRapidity() );
+                fUseMCProperties.push_back( fUseMCRapidity && lV0Result->GetCutMCUseMCProperties() );
+                fV0Radius.push_back( lV0Result->GetCutV0Radius() );
+                fMaxV0Radius.push_back( lV0Result->GetCutMaxV0Radius() );
+                fDCANegToPV.push_back( lV0Result->GetCutDCANegToPV() );
+                fDCAPosToPV.push_back( lV0Result->GetCutDCAPosToPV() );
+                fDCAV0Daughters.push_back( lV0Result->GetCutDCAV0Daughters() );
+                fV0CosPA.push_back( lV0Result->GetCutV0CosPA() );
+                Int_t lVarIndex = -1;
+                if( lV0Result->GetCutUseVarV0CosPA() ){
+                    std::vector<Float_t> lPars(5); //Float_t as in the tasks
+                    lPars[0] = lV0Result->GetCutVarV0CosPAExp0Const();
+                    lPars[1] = lV0Result->GetCutVarV0CosPAExp0Slope();
+                    lPars[2] = lV0Result->GetCutVarV0CosPAExp1Const();
+                    lPars[3] = lV0Result->GetCutVarV0CosPAExp1Slope();
+                    lPars[4] = lV0Result->GetCutVarV0CosPAConst();
+                    std::map<std::vector<Float_t>, Int_t>::iterator it = lVarV0CosPAMap.find(lPars);
+                    if( it == lVarV0CosPAMap.end() ){
+                        lVarIndex = (Int_t) lVarV0CosPAMap.size();
+                        lVarV0CosPAMap[lPars] = lVarIndex;
+                        fVarV0CosPAPars.insert( fVarV0CosPAPars.end(), lPars.begin(), lPars.end() );
+                    }else{
+                        lVarIndex = it->second;
+                    }
+                }
+                fVarV0CosPAIndex.push_back( lVarIndex );
+                fProperLifetime.push_back( lV0Result->GetCutProperLifetime() );
+                fLeastNumberOfCrossedRows.push_back( lV0Result->GetCutLeastNumberOfCrossedRows() );
+                fLeastNumberOfCrossedRowsOverFindable.push_back( lV0Result->GetCutLeastNumberOfCrossedRowsOverFindable() );
+                fMinBaryonMomentum.push_back( lV0Result->GetCutMinBaryonMomentum() );
+                fTPCdEdx.push_back( lV0Result->GetCutTPCdEdx() );
+                fNoArmenteros.push_back( lV0Result->GetCutArmenteros() == kFALSE || ihypo != AliV0Result::kK0Short );
+                fArmenterosParameter.push_back( lV0Result->GetCutArmenterosParameter() );
+                fUseITSRefitTracks.push_back( lV0Result->GetCutUseITSRefitTracks() );
+                fNoMaxChi2PerCluster.push_back( lV0Result->GetCutMaxChi2PerCluster()>1e+3 );
+                fMaxChi2PerCluster.push_back( lV0Result->GetCutMaxChi2PerCluster() );
+                fNoMinTrackLength.push_back( lV0Result->GetCutMinTrackLength()<0 );
+                fUseParametricLength.push_back( lV0Result->GetCutUseParametricLength() );
+                fMinTrackLength.push_back( lV0Result->GetCutMinTrackLength() );
+                f276TeVLikedEdx.push_back( lV0Result->GetCut276TeVLikedEdx() );
+                fAtLeastOneTOF.push_back( lV0Result->GetCutAtLeastOneTOF() );
+                fAcceptCowboy.push_back( lV0Result->GetCutIsCowboy()==0 || lV0Result->GetCutIsCowboy()== 1 );
+                fAcceptSailor.push_back( lV0Result->GetCutIsCowboy()==0 || lV0Result->GetCutIsCowboy()==-1 );
+                fNoMinCrossedRowsOverLength.push_back( lV0Result->GetCutMinCrossedRowsOverLength()<0 );
+                fMinCrossedRowsOverLength.push_back( lV0Result->GetCutMinCrossedRowsOverLength() );
+                fITSorTOF.push_back( lV0Result->GetCutITSorTOF() );
+            }
+            Int_t lEnd = (Int_t) fResults.size();
+            if( lEnd == lBegin ) continue;
+            fGroupList.push_back( ilist );
+            fGroupHypo.push_back( ihypo );
+            fGroupBegin.push_back( lBegin );
+            fGroupEnd.push_back( lEnd );
+        }
+    }
+
+    Int_t lNConfigs = (Int_t) fResults.size();
+    fVarV0CosPAValue.assign( lVarV0CosPAMap.size(), 0 );
+    fV0CosPACut.assign( lNConfigs, 0 );
+    fPass.assign( lNConfigs, 0 );
+    fSelected.clear();
+    fSelected.reserve( lNConfigs );
+}
+
+//________________________________________________________________
+Int_t AliV0CutTable::Select( const Candidate& lCand, const Bool_t *lListEnabled )
+{
+    fSelected.clear();
+
+    fMass[AliV0Result::kK0Short]    = lCand.fInvMassK0s;
+    fMass[AliV0Result::kLambda]     = lCand.fInvMassLambda;
+    fMass[AliV0Result::kAntiLambda] = lCand.fInvMassAntiLambda;
+
+    //Variable CosPA cuts: one evaluation per distinct parametrization
+    const Int_t lNVarV0CosPA = (Int_t) fVarV0CosPAValue.size();
+    for(Int_t ipar=0; ipar<lNVarV0CosPA; ipar++){
+        const Float_t *lPar = &fVarV0CosPAPars[5*ipar];
+        fVarV0CosPAValue[ipar] = TMath::Cos(
+                                            lPar[0]*TMath::Exp(lPar[1]*lCand.fPt) +
+                                            lPar[2]*TMath::Exp(lPar[3]*lCand.fPt) +
+                                            lPar[4]);
+    }
+
+    //Candidate quantities common to all configurations
+    const Int_t    lOnFlyStatus    = lCand.fOnFlyStatus;
+    const Float_t  lNegEta         = lCand.fNegEta;
+    const Float_t  lPosEta         = lCand.fPosEta;
+    const Float_t  lRapMC          = lCand.fRapMC;
+    const Float_t  lV0Radius       = lCand.fV0Radius;
+    const Float_t  lDcaNeg         = lCand.fDcaNegToPrimVertex;
+    const Float_t  lDcaPos         = lCand.fDcaPosToPrimVertex;
+    const Float_t  lDcaV0Dau       = lCand.fDcaV0Daughters;
+    const Float_t  lV0CosPA        = lCand.fV0CosineOfPointingAngle;
+    const Int_t    lCrossedRows    = lCand.fLeastNbrCrossedRows;
+    const Float_t  lCrossedRowsOverFindable = lCand.fLeastRatioCrossedRowsOverFindable;
+    const Float_t  lPtArmV0        = lCand.fPtArmV0;
+    const Float_t  lAbsAlphaV0     = TMath::Abs(lCand.fAlphaV0);
+    const Bool_t   lBothITSrefit   = lCand.fNegITSrefit && lCand.fPosITSrefit;
+    const Float_t  lMaxChi2        = lCand.fMaxChi2PerCluster;
+    const Float_t  lMinTrackLength = lCand.fMinTrackLength;
+    //Parametric track length: min - (1/pt)^1.5 - max(R-85,0)
+    const Double_t lLengthPtTerm   = TMath::Power(1/(lCand.fPt+1e-6),1.5);
+    const Double_t lLengthRTerm    = TMath::Max(lCand.fV0Radius-85., 0.);
+    const Bool_t   lHasTOF         = TMath::Abs(lCand.fNegTOFSignal) < 100 || TMath::Abs(lCand.fPosTOFSignal) < 100;
+    const Bool_t   lIsCowboy       = lCand.fIsCowboy;
+    const Float_t  lNcrOverLength  = lCand.fLeastNcrOverLength;
+    const Bool_t   lITSorTOF       = lCand.fITSorTOFsatisfied;
+
+    const Int_t lNGroups = (Int_t) fGroupBegin.size();
+    for(Int_t igroup=0; igroup<lNGroups; igroup++){
+        if( lListEnabled && !lListEnabled[fGroupList[igroup]] ) continue;
+        const Int_t lBegin = fGroupBegin[igroup];
+        const Int_t lEnd   = fGroupEnd[igroup];
+
+        //Mass hypothesis dependent quantities
+        Float_t lRap  = 0;
+        Float_t lPDGMass = -1;
+        Float_t lNegdEdx = 100;
+        Float_t lPosdEdx = 100;
+        Float_t lBaryonMomentum = -0.5;
+        Float_t lBaryonPt = -0.5;
+        Float_t lBaryondEdxFromProton = 0;
+        if ( fGroupHypo[igroup] == AliV0Result::kK0Short     ){
+            lRap     = lCand.fRapK0Short;
+            lPDGMass = 0.497;
+            lNegdEdx = lCand.fNSigmasNegPion;
+            lPosdEdx = lCand.fNSigmasPosPion;
+        }
+        if ( fGroupHypo[igroup] == AliV0Result::kLambda      ){
+            lRap = lCand.fRapLambda;
+            lPDGMass = 1.115683;
+            lNegdEdx = lCand.fNSigmasNegPion;
+            lPosdEdx = lCand.fNSigmasPosProton;
+            lBaryonMomentum = lCand.fPosInnerP;
+            lBaryonPt = lCand.fPosInnerPt;
+            lBaryondEdxFromProton = lCand.fNSigmasPosProton;
+        }
+        if ( fGroupHypo[igroup] == AliV0Result::kAntiLambda  ){
+            lRap = lCand.fRapLambda;
+            lPDGMass = 1.115683;
+            lNegdEdx = lCand.fNSigmasNegProton;
+            lPosdEdx = lCand.fNSigmasPosPion;
+            lBaryonMomentum = lCand.fNegInnerP;
+            lBaryonPt = lCand.fNegInnerPt;
+            lBaryondEdxFromProton = lCand.fNSigmasNegProton;
+        }
+        const Bool_t  lIsK0Short  = fGroupHypo[igroup] == AliV0Result::kK0Short;
+        const Float_t lLifetime   = lCand.fDistOverTotMom*lPDGMass;
+        const Float_t lAbsNegdEdx = TMath::Abs(lNegdEdx);
+        const Float_t lAbsPosdEdx = TMath::Abs(lPosdEdx);
+        //Check 10 only depends on the hypothesis
+        const Bool_t  l276TeVdEdx = lIsK0Short || ( lBaryonPt > 1.0 || TMath::Abs(lBaryondEdxFromProton)<3.0 );
+
+        //Effective CosPA cut: variable cut only used if tighter
+        const Float_t *lV0CosPACut = fV0CosPA.data();
+        if( lNVarV0CosPA ){
+            for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+                Float_t lCut = fV0CosPA[icfg];
+                Int_t lVarIndex = fVarV0CosPAIndex[icfg];
+                if( lVarIndex >= 0 && fVarV0CosPAValue[lVarIndex] > lCut ) lCut = fVarV0CosPAValue[lVarIndex];
+                fV0CosPACut[icfg] = lCut;
+            }
+            lV0CosPACut = fV0CosPACut.data();
+        }
+
+        UChar_t *lPass = fPass.data();
+
+        //Check 1: Offline Vertexer / Check 2: Basic Acceptance cuts
+        const Int_t    *lUseOnTheFly = fUseOnTheFly.data();
+        const Double_t *lMinEta = fMinEtaTracks.data();
+        const Double_t *lMaxEta = fMaxEtaTracks.data();
+        const Double_t *lMinRap = fMinRapidity.data();
+        const Double_t *lMaxRap = fMaxRapidity.data();
+        const UChar_t  *lUseMC  = fUseMCProperties.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            const Float_t lRapCfg = lUseMC[icfg] ? lRapMC : lRap;
+            lPass[icfg] =
+            ( lOnFlyStatus == lUseOnTheFly[icfg] ) &
+            ( lMinEta[icfg] < lNegEta ) & ( lNegEta < lMaxEta[icfg] ) &
+            ( lMinEta[icfg] < lPosEta ) & ( lPosEta < lMaxEta[icfg] ) &
+            ( lRapCfg > lMinRap[icfg] ) & ( lRapCfg < lMaxRap[icfg] );
+        }
+
+        //Check 3: Topological Variables
+        const Double_t *lMinRadius = fV0Radius.data();
+        const Double_t *lMaxRadius = fMaxV0Radius.data();
+        const Double_t *lMinDcaNeg = fDCANegToPV.data();
+        const Double_t *lMinDcaPos = fDCAPosToPV.data();
+        const Double_t *lMaxDcaV0Dau = fDCAV0Daughters.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lV0Radius > lMinRadius[icfg] ) & ( lV0Radius < lMaxRadius[icfg] ) &
+            ( lDcaNeg > lMinDcaNeg[icfg] ) & ( lDcaPos > lMinDcaPos[icfg] ) &
+            ( lDcaV0Dau < lMaxDcaV0Dau[icfg] ) & ( lV0CosPA > lV0CosPACut[icfg] );
+        }
+        const Double_t *lMaxLifetime = fProperLifetime.data();
+        const Double_t *lMinCrossedRows = fLeastNumberOfCrossedRows.data();
+        const Double_t *lMinCrossedRowsOverFindable = fLeastNumberOfCrossedRowsOverFindable.data();
+        //Check 4: Minimum momentum of baryon daughter / Check 5: TPC dEdx selections
+        const Double_t *lMinBaryonMomentum = fMinBaryonMomentum.data();
+        const Double_t *lMaxdEdx = fTPCdEdx.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lLifetime < lMaxLifetime[icfg] ) &
+            ( lCrossedRows > lMinCrossedRows[icfg] ) &
+            ( lCrossedRowsOverFindable > lMinCrossedRowsOverFindable[icfg] ) &
+            ( lIsK0Short | ( lBaryonMomentum > lMinBaryonMomentum[icfg] ) ) &
+            ( lAbsNegdEdx < lMaxdEdx[icfg] ) & ( lAbsPosdEdx < lMaxdEdx[icfg] );
+        }
+
+        //Check 6: Armenteros-Podolanski space cut (for K0Short analysis)
+        //Check 7: kITSrefit track selection if requested
+        //Check 8: Max Chi2/Clusters if not absurd
+        const UChar_t  *lNoArmenteros = fNoArmenteros.data();
+        const Double_t *lArmenterosParameter = fArmenterosParameter.data();
+        const UChar_t  *lUseITSRefit = fUseITSRefitTracks.data();
+        const UChar_t  *lNoMaxChi2 = fNoMaxChi2PerCluster.data();
+        const Double_t *lMaxChi2Cut = fMaxChi2PerCluster.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( lNoArmenteros[icfg] | ( lPtArmV0 > lArmenterosParameter[icfg]*lAbsAlphaV0 ) ) &
+            ( lBothITSrefit | !lUseITSRefit[icfg] ) &
+            ( lNoMaxChi2[icfg] | ( lMaxChi2 < lMaxChi2Cut[icfg] ) );
+        }
+
+        //Check 9: Min Track Length if positive, [min - (1/pt)^1.5 - max(R-85,0)] if parametric requested
+        const UChar_t  *lNoMinLength = fNoMinTrackLength.data();
+        const UChar_t  *lParametricLength = fUseParametricLength.data();
+        const Double_t *lMinLength = fMinTrackLength.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            lNoMinLength[icfg] |
+            ( ( lMinTrackLength > lMinLength[icfg] ) & !lParametricLength[icfg] ) |
+            ( ( lMinTrackLength > lMinLength[icfg] - lLengthPtTerm - lLengthRTerm ) & lParametricLength[icfg] );
+        }
+
+        //Check 10: Special 2.76TeV-like dedx
+        //Check 14: has at least one track with some TOF info
+        //Check 15: cowboy/sailor for V0
+        //Check 16: modern track quality selections
+        //Check 17: ITS or TOF required
+        const UChar_t  *l276TeV = f276TeVLikedEdx.data();
+        const UChar_t  *lAtLeastOneTOF = fAtLeastOneTOF.data();
+        const UChar_t  *lAcceptCowboySailor = lIsCowboy ? fAcceptCowboy.data() : fAcceptSailor.data();
+        const UChar_t  *lNoNcrOverLength = fNoMinCrossedRowsOverLength.data();
+        const Double_t *lMinNcrOverLength = fMinCrossedRowsOverLength.data();
+        const UChar_t  *lRequireITSorTOF = fITSorTOF.data();
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++){
+            lPass[icfg] &=
+            ( !l276TeV[icfg] | l276TeVdEdx ) &
+            ( !lAtLeastOneTOF[icfg] | lHasTOF ) &
+            lAcceptCowboySailor[icfg] &
+            ( lNoNcrOverLength[icfg] | ( lNcrOverLength > lMinNcrOverLength[icfg] ) ) &
+            ( !lRequireITSorTOF[icfg] | lITSorTOF );
+        }
+
+        for(Int_t icfg=lBegin; icfg<lEnd; icfg++)
+            if( lPass[icfg] ) fSelected.push_back( icfg );
+    }
+    return (Int_t) fSelected.size();
+}
@@ -0,0 +1,143 @@
+#ifndef AliV0CutTable_H
+#define AliV0CutTable_H
+#include <vector>
+#include <Rtypes.h>
+#include "AliV0Result.h"
+
+class TList;
+
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Cut table to test one V0 candidate against all AliV0Result
+// configurations of a task in one go.
+//
+// The configurations are compiled once into one column per cut
+// (structure of arrays), grouped per output list and mass hypothesis.
+// Each candidate is then evaluated with branch-free loops over the
+// configurations of a group, filling a byte mask, and only the
+// configurations passing all cuts are returned for histogram filling.
+//+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+class AliV0CutTable {
+
+public:
+    //Candidate properties as computed in the V0 loop of the tasks
+    struct Candidate {
+        Int_t   fOnFlyStatus;
+        Float_t fPt;
+        Float_t fNegEta;
+        Float_t fPosEta;
+        Float_t fRapK0Short;
+        Float_t fRapLambda;
+        Float_t fRapMC; //only used if SetUseMCRapidity() was called
+        Float_t fInvMassK0s;
+        Float_t fInvMassLambda;
+        Float_t fInvMassAntiLambda;
+        Float_t fV0Radius;
+        Float_t fDcaNegToPrimVertex;
+        Float_t fDcaPosToPrimVertex;
+        Float_t fDcaV0Daughters;
+        Float_t fV0CosineOfPointingAngle;
+        Float_t fDistOverTotMom;
+        Int_t   fLeastNbrCrossedRows;
+        Float_t fLeastRatioCrossedRowsOverFindable;
+        Float_t fNSigmasPosProton;
+        Float_t fNSigmasPosPion;
+        Float_t fNSigmasNegProton;
+        Float_t fNSigmasNegPion;
+        Float_t fPosInnerP;
+        Float_t fNegInnerP;
+        Float_t fPosInnerPt;
+        Float_t fNegInnerPt;
+        Float_t fPtArmV0;
+        Float_t fAlphaV0;
+        Bool_t  fNegITSrefit;
+        Bool_t  fPosITSrefit;
+        Float_t fMaxChi2PerCluster;
+        Float_t fMinTrackLength;
+        Float_t fNegTOFSignal;
+        Float_t fPosTOFSignal;
+        Bool_t  fIsCowboy;
+        Float_t fLeastNcrOverLength;
+        Bool_t  fITSorTOFsatisfied;
+    };
+
+    AliV0CutTable();
+
+    //Replace reconstructed rapidity by fRapMC for configurations with GetCutMCUseMCProperties()
+    //(to be set before Build)
+    void SetUseMCRapidity( Bool_t lOpt = kTRUE ) { fUseMCRapidity = lOpt; }
+
+    //Compile the configurations of lNLists output lists (to be called once they are final)
+    void Build( TList **lLists, Int_t lNLists );
+
+    //Evaluate one candidate, returns the number of passing configurations
+    //lListEnabled (optional): one flag per list, configurations of disabled lists are skipped
+    Int_t Select( const Candidate& lCand, const Bool_t *lListEnabled = 0x0 );
+
+    Int_t GetNConfigurations() const { return (Int_t) fResults.size(); }
+    Int_t GetNSelected() const { return (Int_t) fSelected.size(); }
+    AliV0Result *GetSelected( Int_t lIdx ) const { return fResults[fSelected[lIdx]]; }
+    //Invariant mass of the last selected candidate under a given hypothesis
+    Float_t GetMass( AliV0Result::EMassHypo lHypo ) const { return fMass[lHypo]; }
+
+private:
+    void Clear();
+
+    Bool_t fUseMCRapidity; //use fRapMC if requested by the configuration
+
+    //Configurations, in group order
+    std::vector<AliV0Result*> fResults;
+    //Groups: configurations of one list with one mass hypothesis
+    std::vector<Int_t> fGroupList;
+    std::vector<Int_t> fGroupHypo;
+    std::vector<Int_t> fGroupBegin;
+    std::vector<Int_t> fGroupEnd;
+
+    //Cut columns, one entry per configuration
+    //Types follow the comparisons done in the tasks (Float_t for CosPA cuts)
+    std::vector<Int_t>    fUseOnTheFly;
+    std::vector<Double_t> fMinEtaTracks;
+    std::vector<Double_t> fMaxEtaTracks;
+    std::vector<Double_t> fMinRapidity;
+    std::vector<Double_t> fMaxRapidity;
+    std::vector<UChar_t>  fUseMCProperties;
+    std::vector<Double_t> fV0Radius;
+    std::vector<Double_t> fMaxV0Radius;
+    std::vector<Double_t> fDCANegToPV;
+    std::vector<Double_t> fDCAPosToPV;
+    std::vector<Double_t> fDCAV0Daughters;
+    std::vector<Float_t>  fV0CosPA;
+    std::vector<Int_t>    fVarV0CosPAIndex; //-1: fixed cut only
+    std::vector<Double_t> fProperLifetime;
+    std::vector<Double_t> fLeastNumberOfCrossedRows;
+    std::vector<Double_t> fLeastNumberOfCrossedRowsOverFindable;
+    std::vector<Double_t> fMinBaryonMomentum;
+    std::vector<Double_t> fTPCdEdx;
+    std::vector<UChar_t>  fNoArmenteros; //cut off or not K0Short
+    std::vector<Double_t> fArmenterosParameter;
+    std::vector<UChar_t>  fUseITSRefitTracks;
+    std::vector<UChar_t>  fNoMaxChi2PerCluster;
+    std::vector<Double_t> fMaxChi2PerCluster;
+    std::vector<UChar_t>  fNoMinTrackLength;
+    std::vector<UChar_t>  fUseParametricLength;
+    std::vector<Double_t> fMinTrackLength;
+    std::vector<UChar_t>  f276TeVLikedEdx;
+    std::vector<UChar_t>  fAtLeastOneTOF;
+    std::vector<UChar_t>  fAcceptCowboy;
+    std::vector<UChar_t>  fAcceptSailor;
+    std::vector<UChar_t>  fNoMinCrossedRowsOverLength;
+    std::vector<Double_t> fMinCrossedRowsOverLength;
+    std::vector<UChar_t>  fITSorTOF;
+
+    //Distinct variable CosPA parametrizations (5 parameters each)
+    std::vector<Float_t> fVarV0CosPAPars;
+
+    //Per-candidate buffers
+    std::vector<Float_t> fVarV0CosPAValue; //one per parametrization
+    std::vector<Float_t> fV0CosPACut;      //effective cut, one per configuration
+    std::vector<UChar_t> fPass;            //selection mask, one per configuration
+    std::vector<Int_t>   fSelected;        //passing configurations
+    Float_t fMass[3];
+};
+
+#endif
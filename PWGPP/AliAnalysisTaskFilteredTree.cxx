@@ -88,6 +88,7 @@
 #include "TVectorD.h"
 #include "TStatToolkit.h"
 #include "AliESDtools.h"
+#include "AliNearestTrackIndex.h"
 #include "TVectorF.h"
 #include "AliTPCROC.h"
 using namespace std;
@@ -101,6 +102,7 @@ ClassImp(AliAnalysisTaskFilteredTree)
   , fMC(0)
   , fESDfriend(0)
   , fESDtool(nullptr)
+  , fNearestTrackIndex(nullptr)
   , fOutput(0)
   , fPitList(0)
   , fUseMCInfo(kTRUE)
@@ -124,6 +126,7 @@ ClassImp(AliAnalysisTaskFilteredTree)
   , fProcessAll(kFALSE)
   , fProcessCosmics(kFALSE)
   , fProcessITSTPCmatchOut(kFALSE)  // swittch to process ITS/TPC standalone tracks
+  , fProcessNearestTracks(kFALSE)
   , fHighPtTree(0)
   , fV0Tree(0)
   , fdEdxTree(0)
@@ -170,6 +173,7 @@ AliAnalysisTaskFilteredTree::~AliAnalysisTaskFilteredTree()
   delete fFilteredTreeAcceptanceCuts;
   delete fFilteredTreeRecAcceptanceCuts;
   delete fEsdTrackCuts;
+  delete fNearestTrackIndex;
 }
 
 //____________________________________________________________________________
@@ -370,6 +374,7 @@ void AliAnalysisTaskFilteredTree::UserExec(Option_t *)
   fESDtool->CalculateEventVariables();
   fESDtool->SetMCEvent(fMC);
   fESDtool->DumpEventVariables();
+  if (fNearestTrackIndex) fNearestTrackIndex->Reset();
 
   //if set, use the environment variables to set the downscaling factors
   //AliAnalysisTaskFilteredTree_fLowPtTrackDownscaligF
@@ -1158,8 +1163,8 @@ void AliAnalysisTaskFilteredTree::ProcessAll(AliESDEvent *const esdEvent, AliMCE
       AliExternalTrackParam paramITS;     // nearest ITS track  -   chi2 distance at vertex
       AliExternalTrackParam paramITSC;    // nearest ITS track  -   to constrained track   chi2 distance at vertex
       AliExternalTrackParam paramComb;    // nearest comb. tack -   chi2 distance at inner wall
-      Int_t indexNearestITS, indexNearestITSC, indexNearestComb;
-      if (0) { /// TODO -parameterize the usage for the high multiplicity events
+      Int_t indexNearestITS=-1, indexNearestITSC=-1, indexNearestComb=-1;
+      if (fProcessNearestTracks) {
         indexNearestITS = GetNearestTrack((trackInnerV != NULL) ? trackInnerV : track, iTrack, esdEvent, 0, 0, paramITS);
         if (indexNearestITS < 0) indexNearestITS = GetNearestTrack((trackInnerV != NULL) ? trackInnerV : track, iTrack, esdEvent, 2, 0, paramITS);
         indexNearestITSC = GetNearestTrack((trackInnerC != NULL) ? trackInnerC : track, iTrack, esdEvent, 0, 0, paramITSC);
@@ -3131,14 +3136,19 @@ Int_t   AliAnalysisTaskFilteredTree::GetNearestTrack(const AliExternalTrackParam
     ::Error("AliAnalysisTaskFilteredTree::GetNearestTrack","invalid track pointer");
     return -1;
   }
-  Int_t ntracks=event->GetNumberOfTracks();
   const Double_t ktglCut=0.1;
   const Double_t kqptCut=0.4;
   const Double_t kAlphaCut=0.2;
   //
+  // tracks in the (tgl,q/pt,phi) bins within the rough cuts, built once per event
+  if (fNearestTrackIndex==NULL) fNearestTrackIndex = new AliNearestTrackIndex;
+  const Int_t *candidates=NULL;
+  Int_t ncandidates=fNearestTrackIndex->GetCandidates(event, paramType, trackMatch, TMath::ATan2(trackMatch->Py(),trackMatch->Py()), ktglCut, kqptCut, kAlphaCut, candidates);
+  //
   Double_t chi2Min=100000;
   Int_t indexMin=-1;
-  for (Int_t itrack=0; itrack<ntracks; itrack++){
+  for (Int_t icandidate=0; icandidate<ncandidates; icandidate++){
+    Int_t itrack=candidates[icandidate];
     if (itrack==indexSkip) continue;
     AliESDtrack *ptrack=event->GetTrack(itrack);
     if (ptrack==NULL) continue;
@@ -45,6 +45,7 @@ class TTreeSRedirector;
 class TParticle;
 class TH3D;
 class AliESDtools;
+class AliNearestTrackIndex;
 #include <string>
 
 #include "AliTriggerAnalysis.h"
@@ -124,6 +125,9 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   //
   void   SetProcessProcessITSTPCmatchOut(Bool_t flag) { fProcessITSTPCmatchOut = flag; }
   Bool_t GetProcessProcessITSTPCmatchOut() { return fProcessITSTPCmatchOut; }
+  //
+  void   SetProcessNearestTracks(Bool_t flag) { fProcessNearestTracks = flag; }
+  Bool_t GetProcessNearestTracks() { return fProcessNearestTracks; }
 
   
   void SetProcessAll(Bool_t proc) { fProcessAll = proc; }
@@ -150,6 +154,7 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   AliMCEvent *fMC;      //! MC event
   AliESDfriend *fESDfriend; //! ESDfriend event
   AliESDtools *fESDtool;      /// tools to calculate derived variables from the ESD
+  AliNearestTrackIndex *fNearestTrackIndex; //! per event index of the tracks for GetNearestTrack
   TList* fOutput;       //! list send on output slot 0
   TIterator *fPitList;  //! iterator over the output objetcs
   Bool_t fUseMCInfo;        // use MC information
@@ -178,6 +183,7 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   
   Bool_t fProcessCosmics; // look for cosmic pairs from random trigger
   Bool_t fProcessITSTPCmatchOut;  // switch to process ITS/TPC standalone tracks
+  Bool_t fProcessNearestTracks;   // switch to find the nearest ITS standalone and combined tracks of the high pt tracks
 
   TTree* fHighPtTree;       //! list send on output slot 0
   TTree* fV0Tree;           //! list send on output slot 0
@@ -205,7 +211,7 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
 
   AliAnalysisTaskFilteredTree(const AliAnalysisTaskFilteredTree&); // not implemented
   AliAnalysisTaskFilteredTree& operator=(const AliAnalysisTaskFilteredTree&); // not implemented
-  ClassDef(AliAnalysisTaskFilteredTree, 1); // example of analysis
+  ClassDef(AliAnalysisTaskFilteredTree, 2); // example of analysis
 };
 
 #endif
@@ -58,6 +58,7 @@
 #include "AliRunLoader.h"
 #include "AliTrackReference.h"
 #include "AliExternalTrackParam.h"
+#include "AliNearestTrackIndex.h"
 #include "AliHelix.h"
 #include "TCut.h"
 #include "AliTreePlayer.h"
@@ -118,7 +119,8 @@ AliESDtools::AliESDtools():
   fCacheTrackChi2(nullptr),             // chi2 counter
   fCacheTrackMatchEff(nullptr),         // matchEff counter
   fLumiGraph(nullptr),                  // graph for the interaction rate info for a run
-  fStreamer(nullptr)
+  fStreamer(nullptr),
+  fNearestTrackIndex(nullptr)
 {
   fgInstance=this;
   fTriggerAnalysis=new AliTriggerAnalysis;
@@ -143,6 +145,7 @@ void AliESDtools::Init(TTree *tree, AliESDEvent *event) {
     tools.fEvent =event;
     fTaskMode=kTRUE;
   }
+  if (fNearestTrackIndex) fNearestTrackIndex->Reset();
   if (fHisTPCVertexA == nullptr) {
     tools.fHisITSVertex = new TH1F("hisITSZ", "hisITS", 300, -15, 15);
     tools.fHisTPCVertexA = new TH1F("hisTPCZA", "hisTPCZA", 1000, -250, 250);
@@ -272,14 +275,19 @@ Int_t   AliESDtools::GetNearestTrack(const AliExternalTrackParam * trackMatch, I
     ::Error("AliAnalysisTaskFilteredTree::GetNearestTrack","invalid track pointer");
     return -1;
   }
-  Int_t nTracks=event->GetNumberOfTracks();
   const Double_t kTglCut=0.1;
   const Double_t kQPtCut=0.4;
   const Double_t kAlphaCut=0.2;
   //
+  // tracks in the (tgl,q/pt,phi) bins within the rough cuts, built once per event
+  if (fNearestTrackIndex== nullptr) fNearestTrackIndex=new AliNearestTrackIndex;
+  const Int_t *candidates= nullptr;
+  Int_t nCandidates=fNearestTrackIndex->GetCandidates(event, paramType, trackMatch, TMath::ATan2(trackMatch->Py(),trackMatch->Py()), kTglCut, kQPtCut, kAlphaCut, candidates);
+  //
   Double_t chi2Min=100000;
   Int_t indexMin=-1;
-  for (Int_t iTrack=0; iTrack<nTracks; iTrack++){
+  for (Int_t iCandidate=0; iCandidate<nCandidates; iCandidate++){
+    Int_t iTrack=candidates[iCandidate];
     if (iTrack==indexSkip) continue;
     AliESDtrack *pTrack=event->GetTrack(iTrack);
     if (pTrack== nullptr) continue;
@@ -493,6 +501,8 @@ void AliESDtools::ProcessITSTPCmatchOut(AliESDEvent *const esdEvent, AliESDfrien
 //________________________________________________________________________
 Int_t AliESDtools::CalculateEventVariables(){
   //AliVEvent *event=InputEvent();
+  // new event - in task mode the event pointer and the number of tracks can be the same as for the previous one
+  if (fNearestTrackIndex) fNearestTrackIndex->Reset();
   CacheTPCEventInformation();
   CachePileupVertexTPC(fEvent->GetEventNumberInFile());
   CacheITSVertexInformation(true,0.1,0.2);
@@ -782,6 +792,7 @@ Double_t AliESDtools::LoadESD(Int_t entry, Int_t verbose) {
     printf("connect nTracks=%d\n", nTracks);
   }
   fgInstance->fEvent->ConnectTracks();
+  if (fgInstance->fNearestTrackIndex) fgInstance->fNearestTrackIndex->Reset();
   return 2;
 }
 /// Find (biggest) pile-up TPC vertex  - high efficiency for the PbPb - for pp should be still optimized
@@ -12,6 +12,7 @@ class AliESDEvent;
 class AliESDfriend;
 class AliTriggerAnalysis;
 class AliMCEvent;
+class AliNearestTrackIndex;
 //class TVectorF;
 #include "TNamed.h"
 
@@ -94,6 +95,7 @@ class AliESDtools : public TNamed {
   TGraph           * fLumiGraph;                  // graph for the interaction rate info for a run
   //
   TTreeSRedirector * fStreamer;                  /// streamer
+  AliNearestTrackIndex * fNearestTrackIndex;     //! per event index of the tracks for GetNearestTrack
   static AliESDtools* fgInstance;                /// instance of the tool -needed in order to use static functions (for TTreeFormula)
   private:
   AliESDtools(AliESDtools&);
@@ -0,0 +1,188 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+///////////////////////////////////////////////////////////////////////////
+/// \file AliNearestTrackIndex.cxx
+/// \class AliNearestTrackIndex
+/// \brief Per-event index of the ESD tracks in bins of (tgl, q/pt, phi) for the nearest track search
+///
+/// The bin widths follow the rough cuts of GetNearestTrack (0.1 in tgl, 0.4 in q/pt, 0.2 in phi),
+/// so that a query visits the neighbouring bins only. Tracks are binned with the same parameters
+/// as used in the cuts, kink daughters and tracks without the requested parameters are not indexed.
+/// Example usage (the rough cuts and the track type selection stay in the caller):
+/*
+  const Int_t *candidates = nullptr;
+  Int_t nCandidates = index.GetCandidates(event, paramType, trackMatch, phiMatch, 0.1, 0.4, 0.2, candidates);
+  for (Int_t iCandidate=0; iCandidate<nCandidates; iCandidate++){
+    AliESDtrack *pTrack=event->GetTrack(candidates[iCandidate]);
+    ...
+  }
+*/
+
+#include <algorithm>
+#include "TMath.h"
+#include "AliESDEvent.h"
+#include "AliESDtrack.h"
+#include "AliExternalTrackParam.h"
+#include "AliNearestTrackIndex.h"
+
+ClassImp(AliNearestTrackIndex)
+
+const Int_t    AliNearestTrackIndex::kNTglBins = 30;
+const Double_t AliNearestTrackIndex::kTglMin = -1.5;
+const Double_t AliNearestTrackIndex::kTglWidth = 0.1;
+const Int_t    AliNearestTrackIndex::kNQPtBins = 40;
+const Double_t AliNearestTrackIndex::kQPtMin = -8.;
+const Double_t AliNearestTrackIndex::kQPtWidth = 0.4;
+const Int_t    AliNearestTrackIndex::kNPhiBins = 32;
+
+AliNearestTrackIndex::AliNearestTrackIndex():
+  fEvent(nullptr),
+  fNTracks(0),
+  fTrackBin(),
+  fPhiMask(),
+  fCandidates()
+{
+  fBuilt[0]=kFALSE;
+  fBuilt[1]=kFALSE;
+}
+
+AliNearestTrackIndex::~AliNearestTrackIndex(){
+}
+
+/// Invalidate the index - to be called for each new event
+/// The memory is kept for the next event
+void AliNearestTrackIndex::Reset(){
+  fEvent=nullptr;
+  fNTracks=0;
+  fBuilt[0]=kFALSE;
+  fBuilt[1]=kFALSE;
+}
+
+/// Candidates of the nearest track search
+/// \param event       - ESD event - index is rebuilt if it differs from the event of the previous query
+/// \param paramType   - 0 - global track
+///                      1 - track at inner wall of TPC
+/// \param trackMatch  - input track parameter
+/// \param phiMatch    - azimuthal angle of the input track as used in the phi cut
+/// \param tglCut      - cut on |tgl-tglMatch|
+/// \param qPtCut      - cut on |q/pt-q/ptMatch|
+/// \param phiCut      - cut on |phi-phiMatch|, as in GetNearestTrack also tracks with |phi-phiMatch|>pi are selected
+/// \param candidates  - indices of the candidate tracks in increasing order, valid until the next query
+/// \return            - number of candidates
+Int_t AliNearestTrackIndex::GetCandidates(AliESDEvent *event, Int_t paramType, const AliExternalTrackParam *trackMatch, Double_t phiMatch,
+                                          Double_t tglCut, Double_t qPtCut, Double_t phiCut, const Int_t *&candidates){
+  candidates=nullptr;
+  fCandidates.clear();
+  if (paramType<0 || paramType>1) return 0;   // no parameters - no track selected
+  if (event!=fEvent || event->GetNumberOfTracks()!=fNTracks) {
+    Reset();
+    fEvent=event;
+    fNTracks=event->GetNumberOfTracks();
+  }
+  if (!fBuilt[paramType]) Build(event, paramType);
+
+  const Double_t kEps=1e-6;   // margin for the rounding in the cuts
+  const Double_t tglMatch=trackMatch->GetTgl();
+  const Double_t qPtMatch=trackMatch->GetSigned1Pt();
+  if (!TMath::Finite(tglMatch) || !TMath::Finite(qPtMatch) || !TMath::Finite(phiMatch)) {
+    // the cuts do not reject any track
+    candidates=fAllTracks[paramType].data();
+    return fAllTracks[paramType].size();
+  }
+  fPhiMask.assign(kNPhiBins,0);
+  MarkPhiBins(phiMatch-phiCut-kEps, phiMatch+phiCut+kEps);
+  MarkPhiBins(phiMatch+TMath::Pi()-kEps, TMath::Pi());
+  MarkPhiBins(-TMath::Pi(), phiMatch-TMath::Pi()+kEps);
+
+  const Int_t tglBin0=GetBin(tglMatch-tglCut-kEps, kTglMin, kTglWidth, kNTglBins);
+  const Int_t tglBin1=GetBin(tglMatch+tglCut+kEps, kTglMin, kTglWidth, kNTglBins);
+  const Int_t qPtBin0=GetBin(qPtMatch-qPtCut-kEps, kQPtMin, kQPtWidth, kNQPtBins);
+  const Int_t qPtBin1=GetBin(qPtMatch+qPtCut+kEps, kQPtMin, kQPtWidth, kNQPtBins);
+  const std::vector<Int_t> &binStart=fBinStart[paramType];
+  const std::vector<Int_t> &binTracks=fBinTracks[paramType];
+  for (Int_t iTgl=tglBin0; iTgl<=tglBin1; iTgl++){
+    for (Int_t iQPt=qPtBin0; iQPt<=qPtBin1; iQPt++){
+      const Int_t bin0=(iTgl*kNQPtBins+iQPt)*kNPhiBins;
+      for (Int_t iPhi=0; iPhi<kNPhiBins; iPhi++){
+        if (fPhiMask[iPhi]==0) continue;
+        fCandidates.insert(fCandidates.end(), binTracks.begin()+binStart[bin0+iPhi], binTracks.begin()+binStart[bin0+iPhi+1]);
+      }
+    }
+  }
+  fCandidates.insert(fCandidates.end(), fNotBinned[paramType].begin(), fNotBinned[paramType].end());
+  // same order as in the loop over all tracks - the first of equally near tracks is taken
+  std::sort(fCandidates.begin(), fCandidates.end());
+  candidates=fCandidates.data();
+  return fCandidates.size();
+}
+
+/// Sort the tracks of the event into the bins (counting sort, tracks in increasing index within a bin)
+/// \param event      - ESD event
+/// \param paramType  - 0 - global track, 1 - track at inner wall of TPC
+void AliNearestTrackIndex::Build(AliESDEvent *event, Int_t paramType){
+  const Int_t nBins=kNTglBins*kNQPtBins*kNPhiBins;
+  std::vector<Int_t> &binStart=fBinStart[paramType];
+  std::vector<Int_t> &binTracks=fBinTracks[paramType];
+  binStart.assign(nBins+1,0);
+  fNotBinned[paramType].clear();
+  fAllTracks[paramType].clear();
+  fTrackBin.assign(fNTracks,-1);
+  for (Int_t iTrack=0; iTrack<fNTracks; iTrack++){
+    AliESDtrack *pTrack=event->GetTrack(iTrack);
+    if (pTrack== nullptr) continue;
+    if (pTrack->GetKinkIndex(0)<0) continue;              // kink daughters are skipped by GetNearestTrack
+    const AliExternalTrackParam * track=(paramType==0) ? pTrack : pTrack->GetInnerParam();
+    if (track== nullptr) continue;
+    fAllTracks[paramType].push_back(iTrack);
+    const Double_t tgl=track->GetTgl();
+    const Double_t qPt=track->GetSigned1Pt();
+    const Double_t phi=TMath::ATan2(track->Py(),track->Px());
+    if (!TMath::Finite(tgl) || !TMath::Finite(qPt) || !TMath::Finite(phi)) {
+      fNotBinned[paramType].push_back(iTrack);
+      continue;
+    }
+    const Int_t bin=(GetBin(tgl, kTglMin, kTglWidth, kNTglBins)*kNQPtBins+GetBin(qPt, kQPtMin, kQPtWidth, kNQPtBins))*kNPhiBins
+                    +GetBin(phi, -TMath::Pi(), TMath::TwoPi()/kNPhiBins, kNPhiBins);
+    fTrackBin[iTrack]=bin;
+    binStart[bin+1]++;
+  }
+  for (Int_t iBin=0; iBin<nBins; iBin++) binStart[iBin+1]+=binStart[iBin];
+  binTracks.resize(binStart[nBins]);
+  // fill with the bin starts as insertion points, afterwards shift them back by one bin
+  for (Int_t iTrack=0; iTrack<fNTracks; iTrack++){
+    if (fTrackBin[iTrack]<0) continue;
+    binTracks[binStart[fTrackBin[iTrack]]++]=iTrack;
+  }
+  for (Int_t iBin=nBins; iBin>0; iBin--) binStart[iBin]=binStart[iBin-1];
+  binStart[0]=0;
+  fBuilt[paramType]=kTRUE;
+}
+
+/// Select the phi bins overlapping with the range (phiMin,phiMax)
+void AliNearestTrackIndex::MarkPhiBins(Double_t phiMin, Double_t phiMax){
+  if (phiMax<-TMath::Pi() || phiMin>TMath::Pi() || phiMin>phiMax) return;
+  const Double_t width=TMath::TwoPi()/kNPhiBins;
+  const Int_t bin0=GetBin(phiMin, -TMath::Pi(), width, kNPhiBins);
+  const Int_t bin1=GetBin(phiMax, -TMath::Pi(), width, kNPhiBins);
+  for (Int_t iBin=bin0; iBin<=bin1; iBin++) fPhiMask[iBin]=1;
+}
+
+/// Bin of a finite value, values outside of the range are assigned to the first resp. last bin
+Int_t AliNearestTrackIndex::GetBin(Double_t value, Double_t min, Double_t width, Int_t nBins){
+  const Double_t bin=TMath::Floor((value-min)/width);
+  if (bin<0) return 0;
+  if (bin>=nBins) return nBins-1;
+  return Int_t(bin);
+}
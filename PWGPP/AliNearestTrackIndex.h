@@ -0,0 +1,52 @@
+#ifndef ALINEARESTTRACKINDEX_H
+#define ALINEARESTTRACKINDEX_H
+
+class AliESDEvent;
+class AliExternalTrackParam;
+#include "Rtypes.h"
+#include <vector>
+
+/// \class AliNearestTrackIndex
+/// \brief Per-event index of the ESD tracks in bins of (tgl, q/pt, phi) for the nearest track search
+///
+/// Used in AliAnalysisTaskFilteredTree::GetNearestTrack and AliESDtools::GetNearestTrack to
+/// replace the loop over all tracks for each query. The index is built once per event and track
+/// parameter type (global or inner TPC); a query returns the tracks in the bins within the rough
+/// cut windows, in increasing track index. The rough cuts themselves are still applied by the caller.
+class AliNearestTrackIndex {
+  public:
+  AliNearestTrackIndex();
+  virtual ~AliNearestTrackIndex();
+  void  Reset();
+  Int_t GetCandidates(AliESDEvent *event, Int_t paramType, const AliExternalTrackParam *trackMatch, Double_t phiMatch,
+                      Double_t tglCut, Double_t qPtCut, Double_t phiCut, const Int_t *&candidates);
+  private:
+  void  Build(AliESDEvent *event, Int_t paramType);
+  void  MarkPhiBins(Double_t phiMin, Double_t phiMax);
+  static Int_t GetBin(Double_t value, Double_t min, Double_t width, Int_t nBins);
+  //
+  static const Int_t    kNTglBins;                 ///< number of tgl bins, values outside in the first resp. last bin
+  static const Double_t kTglMin;                   ///< lower edge of the tgl bins
+  static const Double_t kTglWidth;                 ///< width of the tgl bins
+  static const Int_t    kNQPtBins;                 ///< number of q/pt bins, values outside in the first resp. last bin
+  static const Double_t kQPtMin;                   ///< lower edge of the q/pt bins
+  static const Double_t kQPtWidth;                 ///< width of the q/pt bins
+  static const Int_t    kNPhiBins;                 ///< number of phi bins in (-pi,pi)
+  //
+  const AliESDEvent   *fEvent;                     //! event of the index - class is not owner
+  Int_t                fNTracks;                   //! number of tracks of the event
+  Bool_t               fBuilt[2];                  //! index built for the global resp. inner TPC parameters
+  std::vector<Int_t>   fBinStart[2];               //! first entry of each bin in fBinTracks, one more for the end
+  std::vector<Int_t>   fBinTracks[2];              //! track indices sorted by bin
+  std::vector<Int_t>   fNotBinned[2];              //! tracks with non finite parameters - candidates for all queries
+  std::vector<Int_t>   fAllTracks[2];              //! all indexed tracks - candidates for queries with non finite parameters
+  std::vector<Int_t>   fTrackBin;                  //! buffer - bin of each track while building
+  std::vector<Char_t>  fPhiMask;                   //! buffer - phi bins of the current query
+  std::vector<Int_t>   fCandidates;                //! buffer - candidates of the current query
+  //
+  AliNearestTrackIndex(const AliNearestTrackIndex&);
+  AliNearestTrackIndex &operator=(const AliNearestTrackIndex&);
+  ClassDef(AliNearestTrackIndex, 1)
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "AliESDtrack.h"
 #include "AliPIDtools.h"
 #include "TLeaf.h"
+#include "TStopwatch.h"
 #include "TSystem.h"
 
 std::map<Int_t, AliTPCPIDResponse *> AliPIDtools::pidTPC;     /// we should use better hash map
@@ -13,6 +14,8 @@ std::map<Int_t, AliPIDResponse *> AliPIDtools::pidAll;        /// we should use
 AliESDtrack  AliPIDtools::dummyTrack;/// dummy value to save CPU - unfortunately PID object use AliVtrack - for the moment create global variable t avoid object constructions
 TTree *       AliPIDtools::fFilteredTree = NULL;
 TTree *       AliPIDtools::fFilteredTreeV0 = NULL;
+std::map<Long64_t, AliPIDtools::ExpectedSignalTable> AliPIDtools::fExpectedSignalTables;
+std::map<Long64_t, AliPIDtools::ExpectedSignalTable> AliPIDtools::fExpectedSigmaTables;
 
 AliPIDResponse* AliPIDtools::GetPID(Int_t hash ) {return pidAll[hash];}
 AliTPCPIDResponse& AliPIDtools::GetTPCPID(Int_t hash ) {return pidAll[hash]->GetTPCResponse();}
@@ -781,6 +784,309 @@ Float_t AliPIDtools::ComputePIDProbabilityCombinedMask(Int_t hash, Int_t detMask
 
 
 
+/// Bethe-Bloch of the TPC response for an array of beta*gamma
+/// \param hash     - hash value of PID
+/// \param n        - number of values
+/// \param bg       - beta*gamma
+/// \param dEdx     - output array of n values
+void AliPIDtools::BetheBlochAlephBulk(Int_t hash, Int_t n, const Double_t *bg, Double_t *dEdx){
+  AliTPCPIDResponse *tpcPID=pidTPC[hash];
+  for (Int_t i=0; i<n; i++) dEdx[i]=(tpcPID) ? tpcPID->Bethe(bg[i]):0;
+}
+
+/// Expected signal of one species for the bulk interface and for the tables
+/// \param detCode  - detector code (0-ITS, 1-TPC)
+/// \return          - as GetExpectedITSSignal resp. GetExpectedTPCSignal
+Double_t AliPIDtools::GetExpectedSignal(Int_t hash, Int_t detCode, Double_t p, Int_t particle){
+  if (detCode==0) return GetExpectedITSSignal(hash,p,particle);
+  if (detCode==1) return GetExpectedTPCSignal(hash,p,particle);
+  return 0;
+}
+
+/// Tabulate the expected signal of all species in equidistant steps of log(p)
+/// GetExpectedSignalBulk interpolates linearly in the table instead of evaluating the response for each track and species.
+/// The TPC table keeps the multiplicity correction set in the response at the time of the tabulation.
+/// \param hash      - hash value of PID
+/// \param detCode   - detector code (0-ITS, 1-TPC)
+/// \param nPoints   - number of points per species
+/// \param pMin      - momentum range of the table, outside the response is evaluated
+/// \param pMax
+/// \return          - kTRUE if the table was created
+Bool_t AliPIDtools::MakeExpectedSignalTable(Int_t hash, Int_t detCode, Int_t nPoints, Double_t pMin, Double_t pMax){
+  if (nPoints<2 || pMin<=0 || pMax<=pMin){
+    ::Error("AliPIDtools::MakeExpectedSignalTable","Invalid range nPoints=%d, pMin=%f, pMax=%f",nPoints,pMin,pMax);
+    return kFALSE;
+  }
+  if ((detCode==0 && pidAll[hash]==NULL) || (detCode==1 && pidTPC[hash]==NULL) || detCode<0 || detCode>1){
+    ::Error("AliPIDtools::MakeExpectedSignalTable","Invalid PID hash %d or detector %d",hash,detCode);
+    return kFALSE;
+  }
+  ExpectedSignalTable &table=fExpectedSignalTables[16*Long64_t(hash)+detCode];
+  table.fLogPMin=TMath::Log(pMin);
+  table.fDLogP=(TMath::Log(pMax)-table.fLogPMin)/(nPoints-1);
+  table.fNPoints=nPoints;
+  table.fNRows=1;
+  table.fValues.resize(AliPID::kSPECIESC*nPoints);
+  for (Int_t iSpecies=0; iSpecies<AliPID::kSPECIESC; iSpecies++){
+    for (Int_t iPoint=0; iPoint<nPoints; iPoint++){
+      table.fValues[iSpecies*nPoints+iPoint]=GetExpectedSignal(hash,detCode,TMath::Exp(table.fLogPMin+iPoint*table.fDLogP),iSpecies);
+    }
+  }
+  return kTRUE;
+}
+
+/// Remove the table - GetExpectedSignalBulk evaluates the response again
+void AliPIDtools::ClearExpectedSignalTable(Int_t hash, Int_t detCode){
+  fExpectedSignalTables.erase(16*Long64_t(hash)+detCode);
+}
+
+/// Expected signal of all species for an array of tracks
+/// Without table the same values as GetExpectedITSSignal resp. GetExpectedTPCSignal(hash,p,particle) are returned,
+/// the response is looked up once per call and the dummy track set once per track.
+/// \param hash      - hash value of PID
+/// \param detCode   - detector code (0-ITS, 1-TPC)
+/// \param n         - number of tracks
+/// \param p         - momenta (e.g. esdTrack.fIp.P())
+/// \param expected  - output array of AliPID::kSPECIESC*n values, index iSpecies*n+iTrack
+/// \return          - number of tracks evaluated, 0 if the response is not available
+Int_t AliPIDtools::GetExpectedSignalBulk(Int_t hash, Int_t detCode, Int_t n, const Double_t *p, Double_t *expected){
+  const Int_t nSpecies=AliPID::kSPECIESC;
+  std::map<Long64_t, ExpectedSignalTable>::const_iterator itTable=fExpectedSignalTables.find(16*Long64_t(hash)+detCode);
+  if (itTable!=fExpectedSignalTables.end()){
+    const ExpectedSignalTable &table=itTable->second;
+    const Int_t nPoints=table.fNPoints;
+    // position in the table first, then the interpolation per species - loops without function calls
+    std::vector<Int_t> index(n);
+    std::vector<Double_t> fraction(n);
+    Int_t nOutside=0;
+    for (Int_t i=0; i<n; i++){
+      Double_t x=(TMath::Log(p[i])-table.fLogPMin)/table.fDLogP;
+      if (x>=0 && x<nPoints-1){
+        index[i]=Int_t(x);
+        fraction[i]=x-index[i];
+      }else{
+        index[i]=-1;
+        fraction[i]=0;
+        nOutside++;
+      }
+    }
+    for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++){
+      const Double_t *values=table.fValues.data()+iSpecies*nPoints;
+      Double_t *out=expected+iSpecies*n;
+      for (Int_t i=0; i<n; i++){
+        Int_t k=(index[i]<0) ? 0:index[i];
+        out[i]=values[k]+fraction[i]*(values[k+1]-values[k]);
+      }
+    }
+    if (nOutside>0) for (Int_t i=0; i<n; i++){
+      if (index[i]>=0) continue;
+      for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++) expected[iSpecies*n+i]=GetExpectedSignal(hash,detCode,p[i],iSpecies);
+    }
+    return n;
+  }
+  //
+  if (detCode==0){
+    if (pidAll[hash]== nullptr) return 0;
+    AliITSPIDResponse &itsPID=GetITSPID(hash);
+    for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++){
+      for (Int_t i=0; i<n; i++) expected[iSpecies*n+i]=itsPID.Bethe(p[i], (AliPID::EParticleType)iSpecies);
+    }
+    return n;
+  }
+  if (detCode==1){
+    AliTPCPIDResponse *tpcPID=pidTPC[hash];
+    if (tpcPID==0) return 0;
+    Double_t xyz[3] = {0., 0., 0.};
+    Double_t pxyz[3] = {0, 0., 0.};
+    Double_t cv[21] = {0.}; // dummy parameters for dummy tracks
+    for (Int_t i=0; i<n; i++){
+      pxyz[0]=p[i];
+      dummyTrack.Set(xyz, pxyz, cv, 1);
+      for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++){
+        expected[iSpecies*n+i]=tpcPID->GetExpectedSignal(&dummyTrack, (AliPID::EParticleType)iSpecies, AliTPCPIDResponse::kdEdxDefault, kFALSE, kTRUE);
+      }
+    }
+    return n;
+  }
+  return 0;
+}
+
+/// Expected sigma of one species for the bulk interface and for the tables - as in the response without eta correction
+/// \param detCode  - detector code (0-ITS, 1-TPC)
+/// \param signal   - measured signal (TPC: used only to select the response, not in the sigma without corrections)
+/// \param nPoints  - number of clusters used for the signal (TPC: fTPCsignalN, ITS: number of dEdx samples)
+/// \return          - expected sigma, 0 if the response is not available
+Double_t AliPIDtools::GetExpectedSigma(Int_t hash, Int_t detCode, Double_t p, Double_t signal, Int_t nPoints, Int_t particle){
+  if (detCode==0){
+    if (pidAll[hash]== nullptr) return 0;
+    AliITSPIDResponse &itsPID=GetITSPID(hash);
+    Double_t bethe=itsPID.Bethe(p, (AliPID::EParticleType)particle);
+    return itsPID.GetResolution(bethe, nPoints, kFALSE, p, (AliPID::EParticleType)particle);
+  }
+  if (detCode==1){
+    AliTPCPIDResponse *tpcPID=pidTPC[hash];
+    if (tpcPID==0) return 0;
+    Double_t xyz[3] = {0., 0., 0.};
+    Double_t pxyz[3] = {p, 0., 0.};
+    Double_t cv[21] = {0.}; // dummy parameters for dummy tracks
+    dummyTrack.Set(xyz, pxyz, cv, 1);
+    dummyTrack.SetTPCsignal(signal, 0, nPoints);
+    Double_t sigma=tpcPID->GetExpectedSigma(&dummyTrack, (AliPID::EParticleType)particle, AliTPCPIDResponse::kdEdxDefault, kFALSE, kTRUE);
+    dummyTrack.SetTPCsignal(0, 0, 0);
+    return sigma;
+  }
+  return 0;
+}
+
+/// Tabulate the expected sigma of all species in equidistant steps of log(p), for each number of clusters
+/// (TPC 0-159, ITS 0-4). GetExpectedSigmaBulk interpolates linearly in log(p) instead of evaluating the response.
+/// The TPC table is made with the expected signal of each species as measured signal, and keeps the multiplicity
+/// correction set in the response at the time of the tabulation.
+/// \param hash      - hash value of PID
+/// \param detCode   - detector code (0-ITS, 1-TPC)
+/// \param nPoints   - number of points per species and number of clusters
+/// \param pMin      - momentum range of the table, outside the response is evaluated
+/// \param pMax
+/// \return          - kTRUE if the table was created
+Bool_t AliPIDtools::MakeExpectedSigmaTable(Int_t hash, Int_t detCode, Int_t nPoints, Double_t pMin, Double_t pMax){
+  if (nPoints<2 || pMin<=0 || pMax<=pMin){
+    ::Error("AliPIDtools::MakeExpectedSigmaTable","Invalid range nPoints=%d, pMin=%f, pMax=%f",nPoints,pMin,pMax);
+    return kFALSE;
+  }
+  if ((detCode==0 && pidAll[hash]==NULL) || (detCode==1 && pidTPC[hash]==NULL) || detCode<0 || detCode>1){
+    ::Error("AliPIDtools::MakeExpectedSigmaTable","Invalid PID hash %d or detector %d",hash,detCode);
+    return kFALSE;
+  }
+  ExpectedSignalTable &table=fExpectedSigmaTables[16*Long64_t(hash)+detCode];
+  table.fLogPMin=TMath::Log(pMin);
+  table.fDLogP=(TMath::Log(pMax)-table.fLogPMin)/(nPoints-1);
+  table.fNPoints=nPoints;
+  table.fNRows=(detCode==0) ? 5:160;
+  table.fValues.resize(AliPID::kSPECIESC*table.fNRows*nPoints);
+  for (Int_t iSpecies=0; iSpecies<AliPID::kSPECIESC; iSpecies++){
+    for (Int_t iPoint=0; iPoint<nPoints; iPoint++){
+      Double_t p=TMath::Exp(table.fLogPMin+iPoint*table.fDLogP);
+      Double_t signal=GetExpectedSignal(hash,detCode,p,iSpecies);
+      for (Int_t iRow=0; iRow<table.fNRows; iRow++){
+        table.fValues[(iSpecies*table.fNRows+iRow)*nPoints+iPoint]=GetExpectedSigma(hash,detCode,p,signal,iRow,iSpecies);
+      }
+    }
+  }
+  return kTRUE;
+}
+
+/// Remove the table - GetExpectedSigmaBulk evaluates the response again
+void AliPIDtools::ClearExpectedSigmaTable(Int_t hash, Int_t detCode){
+  fExpectedSigmaTables.erase(16*Long64_t(hash)+detCode);
+}
+
+/// Expected sigma of all species for an array of tracks
+/// Without table the sigma of the response is evaluated for each track and species on the dummy track
+/// (AliTPCPIDResponse::GetExpectedSigma without eta correction, AliITSPIDResponse::GetResolution for tracks with TPC)
+/// \param hash      - hash value of PID
+/// \param detCode   - detector code (0-ITS, 1-TPC)
+/// \param n         - number of tracks
+/// \param p         - momenta (e.g. esdTrack.fIp.P())
+/// \param signal    - measured signals (e.g. esdTrack.fTPCsignal)
+/// \param nPoints   - number of clusters of the signals (e.g. esdTrack.fTPCsignalN)
+/// \param sigma     - output array of AliPID::kSPECIESC*n values, index iSpecies*n+iTrack
+/// \return          - number of tracks evaluated, 0 if the response is not available
+Int_t AliPIDtools::GetExpectedSigmaBulk(Int_t hash, Int_t detCode, Int_t n, const Double_t *p, const Double_t *signal, const Double_t *nPoints, Double_t *sigma){
+  const Int_t nSpecies=AliPID::kSPECIESC;
+  if ((detCode==0 && pidAll[hash]==NULL) || (detCode==1 && pidTPC[hash]==NULL) || detCode<0 || detCode>1) return 0;
+  std::map<Long64_t, ExpectedSignalTable>::const_iterator itTable=fExpectedSigmaTables.find(16*Long64_t(hash)+detCode);
+  if (itTable!=fExpectedSigmaTables.end()){
+    const ExpectedSignalTable &table=itTable->second;
+    const Int_t nPointsTable=table.fNPoints;
+    for (Int_t i=0; i<n; i++){
+      Double_t x=(TMath::Log(p[i])-table.fLogPMin)/table.fDLogP;
+      Int_t row=TMath::Min(TMath::Max(Int_t(nPoints[i]),0),table.fNRows-1);
+      if (x>=0 && x<nPointsTable-1){
+        Int_t k=Int_t(x);
+        Double_t fraction=x-k;
+        for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++){
+          const Double_t *values=table.fValues.data()+(iSpecies*table.fNRows+row)*nPointsTable;
+          sigma[iSpecies*n+i]=values[k]+fraction*(values[k+1]-values[k]);
+        }
+      }else{
+        for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++) sigma[iSpecies*n+i]=GetExpectedSigma(hash,detCode,p[i],signal[i],Int_t(nPoints[i]),iSpecies);
+      }
+    }
+    return n;
+  }
+  for (Int_t i=0; i<n; i++){
+    for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++) sigma[iSpecies*n+i]=GetExpectedSigma(hash,detCode,p[i],signal[i],Int_t(nPoints[i]),iSpecies);
+  }
+  return n;
+}
+
+/// Number of sigmas of all species for an array of tracks - approximation of NumberOfSigmas
+/// Expected signal and sigma of the response for each track and species, without eta and pile-up corrections:
+/// without tables this is NumberOfSigmas with corrMask=0 for the TPC. For the ITS the resolution of tracks with TPC is used.
+/// The tables of MakeExpectedSignalTable and MakeExpectedSigmaTable are used if available.
+/// \param hash        - hash value of PID
+/// \param detCode     - detector code (0-ITS, 1-TPC)
+/// \param n           - number of tracks
+/// \param p           - momenta
+/// \param signal      - measured signals (e.g. esdTrack.fTPCsignal)
+/// \param nPoints     - number of clusters of the signals (e.g. esdTrack.fTPCsignalN)
+/// \param nSigma      - output array of AliPID::kSPECIESC*n values, index iSpecies*n+iTrack, 0 if the expected sigma is not positive
+/// \return            - number of tracks evaluated
+Int_t AliPIDtools::NumberOfSigmasApproxBulk(Int_t hash, Int_t detCode, Int_t n, const Double_t *p, const Double_t *signal, const Double_t *nPoints, Double_t *nSigma){
+  std::vector<Double_t> sigma(AliPID::kSPECIESC*n);
+  if (GetExpectedSigmaBulk(hash,detCode,n,p,signal,nPoints,sigma.data())==0) return 0;
+  if (GetExpectedSignalBulk(hash,detCode,n,p,nSigma)==0) return 0;   // expected signal in place
+  for (Int_t iSpecies=0; iSpecies<AliPID::kSPECIESC; iSpecies++){
+    Double_t *out=nSigma+iSpecies*n;
+    const Double_t *sigmaSpecies=sigma.data()+iSpecies*n;
+    for (Int_t i=0; i<n; i++){
+      out[i]=(sigmaSpecies[i]>0) ? (signal[i]-out[i])/sigmaSpecies[i]:0;
+    }
+  }
+  return n;
+}
+
+/// Combined probability of all species for an array of tracks - approximation of ComputePIDProbabilityCombined
+/// Same combination of the detectors, but with the gaussian probability exp(-0.5*nSigma^2) of each detector instead
+/// of AliPIDResponse::ComputePIDProbability, as ComputePIDProbabilityCombined does for the TOF only
+/// \param n           - number of tracks
+/// \param nDet        - number of detectors
+/// \param nSigma      - nDet arrays of AliPID::kSPECIESC*n values as from NumberOfSigmasApproxBulk
+///                      a detector without measurement for a track has a non finite value for the first species
+/// \param norm        - flag - normalization (see ComputePIDProbabilityCombined)
+/// \param fakeProb    - fake probability  ( used for  normalization)
+/// \param prob        - output array of AliPID::kSPECIESC*n values, 1 for tracks without any measurement
+void AliPIDtools::ComputePIDProbabilityCombinedApproxBulk(Int_t n, Int_t nDet, const Double_t * const *nSigma, Int_t norm, Float_t fakeProb, Double_t *prob){
+  const Int_t nSpecies=AliPID::kSPECIESC;
+  std::vector<Int_t> nDetectors(n,0);
+  std::vector<Char_t> status(n,0);
+  for (Int_t i=0; i<nSpecies*n; i++) prob[i]=1;
+  for (Int_t iDet=0; iDet<nDet; iDet++){
+    const Double_t *nSigmaDet=nSigma[iDet];
+    for (Int_t i=0; i<n; i++){
+      status[i]=TMath::Finite(nSigmaDet[i]);
+      nDetectors[i]+=status[i];
+    }
+    for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++){
+      for (Int_t i=0; i<n; i++){
+        Double_t x=nSigmaDet[iSpecies*n+i];
+        if (status[i]) prob[iSpecies*n+i]*=TMath::Exp(-0.5*x*x)+fakeProb/nSpecies;
+      }
+    }
+  }
+  for (Int_t i=0; i<n; i++){
+    if (nDetectors[i]==0) continue;  // default value 1
+    if (norm&0x2){
+      for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++) prob[iSpecies*n+i]=TMath::Power(prob[iSpecies*n+i],1./nDetectors[i]);
+    }
+    if (norm&0x1){
+      Double_t sum=fakeProb*nSpecies;
+      for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++) sum+=prob[iSpecies*n+i];
+      for (Int_t iSpecies=0; iSpecies<nSpecies; iSpecies++) prob[iSpecies*n+i]/=sum;
+    }
+  }
+}
+
 /// Unit test of invariants - check internal consistency of wrappers
 void AliPIDtools::UnitTest() {
   Bool_t status=0;
@@ -808,7 +1114,93 @@ void AliPIDtools::UnitTest() {
           "TOFOn&&abs(nSigma1_2)<5&&abs(nSigma3_2)<5","goff",1000);
   status=TMath::RMS(entries, fFilteredTree->GetV1())<kEpsilon;
   ::Info("UnitTest","AliPIDtools::ComputePIDProbabilityCombined(pidHash,10,2,-1,3+0,0,0.0)-AliPIDtools::ComputePIDProbability(pidHash,1,2,-1,3+0,0,0.0)*AliPIDtools::ComputePIDProbability(pidHash,3,2,-1,3+0,0,0.0)\tStatus=%d",status);
-
+  //
+  // Bulk interface - expected TPC signal of all species against GetExpectedTPCSignal, without and with table
+  entries=fFilteredTree->Draw("esdTrack.fIp.P():pidHash","esdTrack.fIp.P()>0","goff",10000);
+  if (entries>0) {
+    Int_t pidHash=fFilteredTree->GetV2()[0];
+    std::vector<Double_t> mom(fFilteredTree->GetV1(),fFilteredTree->GetV1()+entries);
+    std::vector<Double_t> expected(AliPID::kSPECIESC*entries), expectedTable(AliPID::kSPECIESC*entries);
+    TStopwatch timer;
+    Double_t maxDelta=0, maxDeltaTable=0;
+    timer.Start();
+    for (Int_t iSpecies=0; iSpecies<AliPID::kSPECIESC; iSpecies++)
+      for (Int_t i=0; i<entries; i++) expected[iSpecies*entries+i]=GetExpectedTPCSignal(pidHash,mom[i],iSpecies);
+    Double_t timeScalar=timer.RealTime();
+    timer.Start();
+    GetExpectedSignalBulk(pidHash,1,entries,mom.data(),expectedTable.data());
+    Double_t timeBulk=timer.RealTime();
+    for (Int_t i=0; i<AliPID::kSPECIESC*entries; i++) maxDelta=TMath::Max(maxDelta,TMath::Abs(expectedTable[i]-expected[i]));
+    status=maxDelta<kEpsilon;
+    ::Info("UnitTest","GetExpectedSignalBulk(pidHash,1,...)-GetExpectedTPCSignal(pidHash,p,i)\tStatus=%d\ttime scalar %f s, bulk %f s",status,timeScalar,timeBulk);
+    MakeExpectedSignalTable(pidHash,1);
+    timer.Start();
+    GetExpectedSignalBulk(pidHash,1,entries,mom.data(),expectedTable.data());
+    Double_t timeTable=timer.RealTime();
+    ClearExpectedSignalTable(pidHash,1);
+    for (Int_t i=0; i<AliPID::kSPECIESC*entries; i++) {
+      if (expected[i]>0) maxDeltaTable=TMath::Max(maxDeltaTable,TMath::Abs(expectedTable[i]/expected[i]-1));
+    }
+    status=maxDeltaTable<0.001;
+    ::Info("UnitTest","GetExpectedSignalBulk(pidHash,1,...) with table - relative difference %f\tStatus=%d\ttime table %f s",maxDeltaTable,status,timeTable);
+  }
+  //
+  entries=fFilteredTree->Draw("pidHash","1","goff",1);
+  Int_t pidHash=(entries>0) ? fFilteredTree->GetV1()[0]:0;
+  // Bulk interface - TPC number of sigmas of all species against NumberOfSigmas without corrections, evaluated
+  // independently for each species, without and with the tables
+  TString selection="esdTrack.fIp.P()>0&&esdTrack.fTPCsignal>0&&esdTrack.fTPCsignalN>0";
+  entries=fFilteredTree->Draw("esdTrack.fIp.P():esdTrack.fTPCsignal:esdTrack.fTPCsignalN",selection,"goff",1000);
+  if (entries>0) {
+    std::vector<Double_t> mom(fFilteredTree->GetV1(),fFilteredTree->GetV1()+entries);
+    std::vector<Double_t> signal(fFilteredTree->GetV2(),fFilteredTree->GetV2()+entries);
+    std::vector<Double_t> nPoints(fFilteredTree->GetV3(),fFilteredTree->GetV3()+entries);
+    std::vector<Double_t> nSigmaScalar(AliPID::kSPECIESC*entries), nSigma(AliPID::kSPECIESC*entries);
+    for (Int_t iSpecies=0; iSpecies<AliPID::kSPECIESC; iSpecies++){
+      fFilteredTree->Draw(TString::Format("AliPIDtools::NumberOfSigmas(pidHash,1,%d,-1,0)",iSpecies),selection,"goff",1000);
+      for (Int_t i=0; i<entries; i++) nSigmaScalar[iSpecies*entries+i]=fFilteredTree->GetV1()[i];
+    }
+    if (pidTPC[pidHash]) pidTPC[pidHash]->SetCurrentEventMultiplicity(0);   // no multiplicity correction, as for corrMask=0
+    NumberOfSigmasApproxBulk(pidHash,1,entries,mom.data(),signal.data(),nPoints.data(),nSigma.data());
+    Double_t maxDelta=0;
+    for (Int_t i=0; i<AliPID::kSPECIESC*entries; i++) maxDelta=TMath::Max(maxDelta,TMath::Abs(nSigma[i]-nSigmaScalar[i]));
+    status=maxDelta<0.001;
+    ::Info("UnitTest","NumberOfSigmasApproxBulk(pidHash,1,...)-NumberOfSigmas(pidHash,1,i,-1,0)\tmax difference %f\tStatus=%d",maxDelta,status);
+    MakeExpectedSignalTable(pidHash,1);
+    MakeExpectedSigmaTable(pidHash,1);
+    NumberOfSigmasApproxBulk(pidHash,1,entries,mom.data(),signal.data(),nPoints.data(),nSigma.data());
+    ClearExpectedSignalTable(pidHash,1);
+    ClearExpectedSigmaTable(pidHash,1);
+    maxDelta=0;
+    for (Int_t i=0; i<AliPID::kSPECIESC*entries; i++) {
+      if (TMath::Abs(nSigmaScalar[i])<10) maxDelta=TMath::Max(maxDelta,TMath::Abs(nSigma[i]-nSigmaScalar[i]));
+    }
+    status=maxDelta<0.01;
+    ::Info("UnitTest","NumberOfSigmasApproxBulk(pidHash,1,...) with tables-NumberOfSigmas(pidHash,1,i,-1,0)\tmax difference %f\tStatus=%d",maxDelta,status);
+  }
+  //
+  // Bulk interface - TOF combined probability against ComputePIDProbabilityCombined(pidHash,8,...), which uses the same
+  // gaussian probability for the TOF (no measurement if the electron hypothesis is outside 4 sigma)
+  entries=fFilteredTree->Draw("AliPIDtools::ComputePIDProbabilityCombined(pidHash,8,2,-1,3,1,0.01):AliPIDtools::ComputePIDProbabilityCombined(pidHash,8,4,-1,3,1,0.01)","ITSRefit","goff",1000);
+  if (entries>0) {
+    std::vector<Double_t> probPion(fFilteredTree->GetV1(),fFilteredTree->GetV1()+entries);
+    std::vector<Double_t> probProton(fFilteredTree->GetV2(),fFilteredTree->GetV2()+entries);
+    std::vector<Double_t> nSigma(AliPID::kSPECIESC*entries), prob(AliPID::kSPECIESC*entries);
+    for (Int_t iSpecies=0; iSpecies<AliPID::kSPECIESC; iSpecies++){
+      fFilteredTree->Draw(TString::Format("AliPIDtools::NumberOfSigmas(pidHash,3,%d,-1,3)",iSpecies),"ITSRefit","goff",1000);
+      for (Int_t i=0; i<entries; i++) nSigma[iSpecies*entries+i]=fFilteredTree->GetV1()[i];
+    }
+    for (Int_t i=0; i<entries; i++) if (TMath::Abs(nSigma[i])>=4) nSigma[i]=TMath::QuietNaN();
+    const Double_t *nSigmaDet[1]={nSigma.data()};
+    ComputePIDProbabilityCombinedApproxBulk(entries,1,nSigmaDet,1,0.01,prob.data());
+    Double_t maxDelta=0;
+    for (Int_t i=0; i<entries; i++) {
+      maxDelta=TMath::Max(maxDelta,TMath::Abs(prob[AliPID::kPion*entries+i]-probPion[i]));
+      maxDelta=TMath::Max(maxDelta,TMath::Abs(prob[AliPID::kProton*entries+i]-probProton[i]));
+    }
+    status=maxDelta<kEpsilon;
+    ::Info("UnitTest","ComputePIDProbabilityCombinedApproxBulk(...)-ComputePIDProbabilityCombined(pidHash,8,i,-1,3,1,0.01)\tmax difference %f\tStatus=%d",maxDelta,status);
+  }
 }
 
 ///
@@ -21,8 +21,18 @@
 /// #### Example 3: Draw Expected dEdx
 /// AliPIDtools::SetFilteredTreeV0(treeV0)
 /// treeV0->Draw("log(track0.fTPCsignal/(AliPIDtools::GetExpectedTPCSignalV0(pidHash,0,0x1,0)))","type==1&&abs(log(track1.fTPCsignal/(AliPIDtools::GetExpectedTPCSignalV0(pidHash,0,0x1,1))))<0.1","colz",20000)
+/// #### Example 4: Bulk evaluation for all species of many tracks - arrays as filled by TTree::Draw
+/// \code
+/// Int_t entries = treeV0->Draw("track0.fIp.P():track0.fTPCsignal:track0.fTPCsignalN","type==1","goff",100000);
+/// std::vector<Double_t> expected(AliPID::kSPECIESC*entries), nSigma(AliPID::kSPECIESC*entries);
+/// AliPIDtools::MakeExpectedSignalTable(hash,1);    // optional - tabulated expected signals, interpolation instead of the response
+/// AliPIDtools::MakeExpectedSigmaTable(hash,1);     // optional - tabulated expected sigmas
+/// AliPIDtools::GetExpectedSignalBulk(hash,1,entries,treeV0->GetV1(),expected.data());
+/// AliPIDtools::NumberOfSigmasApproxBulk(hash,1,entries,treeV0->GetV1(),treeV0->GetV2(),treeV0->GetV3(),nSigma.data());
+/// \endcode
 
 #include "map"
+#include "vector"
 #include  "AliESDtrack.h"
 class AliPIDResponse;
 class AliTPCPIDResponse;
@@ -71,6 +81,18 @@ public:
   static Bool_t    RegisterPIDAliases(Int_t pidHash, TString fakeRate="0.1", Int_t suffix=-1);
   static Bool_t    RegisterPIDAliasesV0(Int_t pidHash, Float_t powerLike=0.6, Float_t powerLegN=0.2, Float_t powerLeg=0.2,  const char *fakeR="0.1", const char *  suffix="");
   //
+  // Bulk interface - arrays of n tracks, all AliPID::kSPECIESC species at once, output index iSpecies*n+iTrack
+  static void     BetheBlochAlephBulk(Int_t hash, Int_t n, const Double_t *bg, Double_t *dEdx);
+  static Bool_t   MakeExpectedSignalTable(Int_t hash, Int_t detCode, Int_t nPoints=2000, Double_t pMin=0.05, Double_t pMax=100.);
+  static void     ClearExpectedSignalTable(Int_t hash, Int_t detCode);
+  static Int_t    GetExpectedSignalBulk(Int_t hash, Int_t detCode, Int_t n, const Double_t *p, Double_t *expected);
+  static Bool_t   MakeExpectedSigmaTable(Int_t hash, Int_t detCode, Int_t nPoints=200, Double_t pMin=0.05, Double_t pMax=100.);
+  static void     ClearExpectedSigmaTable(Int_t hash, Int_t detCode);
+  static Int_t    GetExpectedSigmaBulk(Int_t hash, Int_t detCode, Int_t n, const Double_t *p, const Double_t *signal, const Double_t *nPoints, Double_t *sigma);
+  // approximations of NumberOfSigmas and ComputePIDProbabilityCombined - no eta and pile-up corrections, gaussian probability
+  static Int_t    NumberOfSigmasApproxBulk(Int_t hash, Int_t detCode, Int_t n, const Double_t *p, const Double_t *signal, const Double_t *nPoints, Double_t *nSigma);
+  static void     ComputePIDProbabilityCombinedApproxBulk(Int_t n, Int_t nDet, const Double_t * const *nSigma, Int_t norm, Float_t fakeProb, Double_t *prob);
+  //
   //
   static std::map<Int_t, AliTPCPIDResponse *> pidTPC;     /// we should use better hash map
   static std::map<Int_t, AliPIDResponse *> pidAll;        /// we should use better hash map
@@ -85,6 +107,18 @@ public:
   static void UnitTest();                       /// unit test of invariants
 private:
   static AliESDtrack  dummyTrack;     /// dummy value to save CPU - unfortunately PID object use AliVtrack - for the moment create global varaible t avoid object constructions
+  /// expected signal (sigma) of all species tabulated in equidistant steps of log(p) (and number of clusters)
+  struct ExpectedSignalTable {
+    Double_t fLogPMin;                 /// log of the first momentum
+    Double_t fDLogP;                   /// step in log(p)
+    Int_t    fNPoints;                 /// number of points per species and row
+    Int_t    fNRows;                   /// number of rows per species - number of clusters 0..fNRows-1 for sigma, 1 for signal
+    std::vector<Double_t> fValues;     /// expected values, index (iSpecies*fNRows+iRow)*fNPoints+iPoint
+  };
+  static std::map<Long64_t, ExpectedSignalTable> fExpectedSignalTables;   /// tables per pidHash and detector, key 16*hash+detCode
+  static std::map<Long64_t, ExpectedSignalTable> fExpectedSigmaTables;    /// tables per pidHash and detector, key 16*hash+detCode
+  static Double_t GetExpectedSignal(Int_t hash, Int_t detCode, Double_t p, Int_t particle);
+  static Double_t GetExpectedSigma(Int_t hash, Int_t detCode, Double_t p, Double_t signal, Int_t nPoints, Int_t particle);
 
 };
 
@@ -59,6 +59,7 @@
 #pragma link C++ class std::map<int,AliTPCPIDResponse *>+;
 #pragma link C++ class std::map<int,AliPIDResponse *>+;
 #pragma link C++ class AliESDtools+;
+#pragma link C++ class AliNearestTrackIndex+;
 #pragma link C++ class AliIntSpotEstimator+;
 #pragma link C++ class AliAnalysisTaskIPInfo+;
 
@@ -0,0 +1,248 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+/* AliAO2DColumnWriter
+ *
+ * Columnar staging of the AO2D tables, see the header for details.
+ */
+
+#include <TBranch.h>
+#include <TDirectory.h>
+#include <TLeaf.h>
+#include <TObjString.h>
+#include <TTree.h>
+
+#include <cstring>
+
+#include "AliAO2DColumnWriter.h"
+#include "AliMathBase.h"
+#include "AliLog.h"
+
+namespace
+{
+  // Leaf type code from the leaf type name
+  Char_t LeafTypeCode(const TLeaf *leaf)
+  {
+    TString type(leaf->GetTypeName());
+    if (type == "Int_t")
+      return 'I';
+    if (type == "UInt_t")
+      return 'i';
+    if (type == "Float_t")
+      return 'F';
+    if (type == "Short_t")
+      return 'S';
+    if (type == "UShort_t")
+      return 's';
+    if (type == "Long64_t")
+      return 'L';
+    if (type == "ULong64_t")
+      return 'l';
+    if (type == "Char_t")
+      return 'B';
+    if (type == "UChar_t")
+      return 'b';
+    if (type == "Double_t")
+      return 'D';
+    return 0;
+  }
+
+  const char *CodecName(AliAO2DColumnWriter::ColumnCodec codec)
+  {
+    switch (codec)
+    {
+    case AliAO2DColumnWriter::kDelta:
+      return "delta";
+    case AliAO2DColumnWriter::kTruncate:
+      return "truncate";
+    default:
+      return "raw";
+    }
+  }
+} // namespace
+
+AliAO2DColumnWriter::AliAO2DColumnWriter(Int_t ntables)
+    : fNtables(ntables), fColumns(ntables), fTrees(ntables, nullptr), fRows(ntables, 0), fCodecs(ntables)
+{
+} // AliAO2DColumnWriter::AliAO2DColumnWriter(Int_t ntables)
+
+void AliAO2DColumnWriter::SetCodec(Int_t table, const char *branch, ColumnCodec codec, UInt_t mask)
+{
+  if (table < 0 || table >= fNtables)
+    AliFatalGeneral("AliAO2DColumnWriter", Form("Invalid table index %d", table));
+  fCodecs[table][branch] = CodecSetting{codec, mask};
+} // void AliAO2DColumnWriter::SetCodec(Int_t table, const char *branch, ColumnCodec codec, UInt_t mask)
+
+AliAO2DColumnWriter *AliAO2DColumnWriter::CloneSettings() const
+{
+  AliAO2DColumnWriter *writer = new AliAO2DColumnWriter(fNtables);
+  writer->fDeltaIndices = fDeltaIndices;
+  writer->fCodecs = fCodecs;
+  return writer;
+} // AliAO2DColumnWriter *AliAO2DColumnWriter::CloneSettings() const
+
+void AliAO2DColumnWriter::AttachTable(Int_t table, TTree *tree)
+{
+  fTrees[table] = tree;
+  fRows[table] = 0;
+  fColumns[table].clear();
+  if (!tree)
+    return;
+
+  TObjArray *branches = tree->GetListOfBranches();
+  for (Int_t ib = 0; ib < branches->GetEntriesFast(); ++ib)
+  {
+    TBranch *branch = (TBranch *)branches->At(ib);
+    if (branch->TestBit(kDoNotProcess)) // Pruned branch
+      continue;
+    TLeaf *leaf = (TLeaf *)branch->GetListOfLeaves()->At(0);
+    Column col;
+    col.fBranch = branch;
+    col.fAddress = branch->GetAddress();
+    col.fLen = leaf->GetLen();
+    col.fSize = leaf->GetLenType() * col.fLen;
+    col.fType = LeafTypeCode(leaf);
+
+    TString name(branch->GetName());
+    auto setting = fCodecs[table].find(name);
+    if (setting != fCodecs[table].end())
+    {
+      col.fCodec = setting->second.fCodec;
+      col.fMask = setting->second.fMask;
+    }
+    else if (fDeltaIndices && name.BeginsWith("fIndex"))
+    {
+      col.fCodec = kDelta;
+    }
+
+    // Check that the codec is applicable to the column type
+    if ((col.fCodec == kDelta && (col.fType != 'I' || col.fLen != 1)) || (col.fCodec == kTruncate && col.fType != 'F'))
+    {
+      AliWarningGeneral("AliAO2DColumnWriter", Form("Codec %s not applicable to %s.%s, writing it raw", CodecName(col.fCodec), tree->GetName(), name.Data()));
+      col.fCodec = kRaw;
+    }
+    fColumns[table].push_back(col);
+  }
+} // void AliAO2DColumnWriter::AttachTable(Int_t table, TTree *tree)
+
+Int_t AliAO2DColumnWriter::Stage(Int_t table)
+{
+  Int_t nbytes = 0;
+  for (auto &col : fColumns[table])
+  {
+    size_t offset = col.fData.size();
+    col.fData.resize(offset + col.fSize);
+    memcpy(&col.fData[offset], col.fAddress, col.fSize);
+    nbytes += col.fSize;
+  }
+  fRows[table]++;
+  return nbytes;
+} // Int_t AliAO2DColumnWriter::Stage(Int_t table)
+
+void AliAO2DColumnWriter::Encode(Column &col, Long64_t nrows) const
+{
+  switch (col.fCodec)
+  {
+  case kDelta:
+  {
+    Int_t *values = (Int_t *)col.fData.data();
+    for (Long64_t i = nrows - 1; i > 0; --i)
+      values[i] -= values[i - 1];
+    break;
+  }
+  case kTruncate:
+  {
+    Float_t *values = (Float_t *)col.fData.data();
+    Long64_t n = nrows * col.fLen;
+    for (Long64_t i = 0; i < n; ++i)
+      values[i] = AliMathBase::TruncateFloatFraction(values[i], col.fMask);
+    break;
+  }
+  default:
+    break;
+  }
+} // void AliAO2DColumnWriter::Encode(Column &col, Long64_t nrows) const
+
+Long64_t AliAO2DColumnWriter::FlushTable(Int_t table)
+{
+  TTree *tree = fTrees[table];
+  if (!tree)
+    return 0;
+  Long64_t nrows = fRows[table];
+  Long64_t nbytes = 0;
+  for (auto &col : fColumns[table])
+  {
+    Encode(col, nrows);
+    // One basket for the full column (ROOT limits the basket size to 1 GB)
+    Long64_t colBytes = nrows * col.fSize + 1024;
+    col.fBranch->SetBasketSize(colBytes < 1000000000 ? (Int_t)colBytes : 1000000000);
+    // Fill the branch alone: the loop runs over one contiguous column.
+    // The rows go through a private buffer, so that the converter structures
+    // can already be filled with the next TF while this one is written
+    std::vector<char> row(col.fSize);
+    col.fBranch->SetAddress(row.data());
+    const char *data = col.fData.data();
+    for (Long64_t irow = 0; irow < nrows; ++irow)
+    {
+      memcpy(row.data(), data + irow * col.fSize, col.fSize);
+      Int_t nb = col.fBranch->Fill();
+      if (nb > 0)
+        nbytes += nb;
+    }
+    col.fBranch->SetAddress(col.fAddress);
+    std::vector<char>().swap(col.fData);
+  }
+  tree->SetEntries(nrows);
+  fRows[table] = 0;
+  return nbytes;
+} // Long64_t AliAO2DColumnWriter::FlushTable(Int_t table)
+
+void AliAO2DColumnWriter::WriteCodecs(TDirectory *dir) const
+{
+  // Record the non-raw codecs, needed to decode the columns when reading
+  TString codecs;
+  for (Int_t table = 0; table < fNtables; ++table)
+  {
+    if (!fTrees[table])
+      continue;
+    for (auto &col : fColumns[table])
+    {
+      if (col.fCodec == kRaw)
+        continue;
+      codecs += TString::Format("%s.%s:%s:0x%08x;", fTrees[table]->GetName(), col.fBranch->GetName(), CodecName(col.fCodec), col.fMask);
+    }
+  }
+  if (codecs.IsNull())
+    return;
+  dir->cd();
+  TObjString ocodecs(codecs);
+  ocodecs.Write("ColumnCodecs");
+} // void AliAO2DColumnWriter::WriteCodecs(TDirectory *dir) const
+
+void AliAO2DColumnWriter::Clear()
+{
+  for (Int_t table = 0; table < fNtables; ++table)
+  {
+    fColumns[table].clear();
+    fTrees[table] = nullptr;
+    fRows[table] = 0;
+  }
+} // void AliAO2DColumnWriter::Clear()
+
+void AliAO2DColumnWriter::DecodeDelta(Int_t *values, Long64_t n)
+{
+  for (Long64_t i = 1; i < n; ++i)
+    values[i] += values[i - 1];
+} // void AliAO2DColumnWriter::DecodeDelta(Int_t *values, Long64_t n)
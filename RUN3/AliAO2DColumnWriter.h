@@ -0,0 +1,79 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliAO2DColumnWriter_H
+#define AliAO2DColumnWriter_H
+
+/// \class AliAO2DColumnWriter
+///
+/// Columnar staging backend for the AO2D converter.
+/// Each output table (TTree) is staged in per-branch column buffers instead of being
+/// filled row by row. At the end of the timeframe the columns are encoded with the
+/// selected codec and written branch by branch, with baskets sized to hold the whole
+/// column, i.e. one compressed block per column and timeframe.
+
+#include <Rtypes.h>
+#include <TString.h>
+
+#include <map>
+#include <vector>
+
+class TBranch;
+class TDirectory;
+class TTree;
+
+class AliAO2DColumnWriter
+{
+public:
+  enum ColumnCodec { // Per-column encoding applied before writing
+    kRaw = 0,        // Values written as filled
+    kDelta,          // Integer columns: difference to the previous row (first row unchanged)
+    kTruncate        // Float columns: mantissa truncated with AliMathBase::TruncateFloatFraction
+  };
+
+  AliAO2DColumnWriter(Int_t ntables);
+  virtual ~AliAO2DColumnWriter() {}
+
+  void SetCodec(Int_t table, const char *branch, ColumnCodec codec, UInt_t mask = 0xFFFFFF00);
+  void SetDeltaCodedIndices(Bool_t flag = kTRUE) { fDeltaIndices = flag; }
+  AliAO2DColumnWriter *CloneSettings() const; // New writer with the same codecs and no columns
+
+  void AttachTable(Int_t table, TTree *tree); // Create the columns from the active branches of the tree
+  Int_t Stage(Int_t table);                   // Copy the current row of the table into its columns
+  Long64_t FlushTable(Int_t table);           // Encode the columns and fill the tree branch by branch
+  void WriteCodecs(TDirectory *dir) const;    // Store the list of non-raw codecs in the TF directory
+  void Clear();                               // Drop the columns at the end of the TF
+
+  Long64_t GetNrows(Int_t table) const { return fRows[table]; }
+
+  static void DecodeDelta(Int_t *values, Long64_t n); // Inverse of the kDelta codec
+
+private:
+  struct Column {
+    TBranch *fBranch = nullptr; // Output branch
+    char *fAddress = nullptr;   // Address of the branch buffer (the converter structures)
+    Int_t fSize = 0;            // Bytes per row
+    Int_t fLen = 1;             // Number of elements per row
+    Char_t fType = 0;           // Leaf type code: 'I', 'F', ...
+    ColumnCodec fCodec = kRaw;  // Codec used for this column
+    UInt_t fMask = 0xFFFFFFFF;  // Truncation mask for kTruncate
+    std::vector<char> fData;    // Staged values
+  };
+
+  struct CodecSetting {
+    ColumnCodec fCodec;
+    UInt_t fMask;
+  };
+
+  void Encode(Column &col, Long64_t nrows) const;
+
+  Int_t fNtables;                                     // Number of tables
+  Bool_t fDeltaIndices = kFALSE;                      // Delta coding of all fIndex* integer columns
+  std::vector<std::vector<Column> > fColumns;         // Columns of each table
+  std::vector<TTree *> fTrees;                        // Output tree of each table
+  std::vector<Long64_t> fRows;                        // Staged rows of each table
+  std::vector<std::map<TString, CodecSetting> > fCodecs; // Codec settings by branch name for each table
+};
+
+#endif
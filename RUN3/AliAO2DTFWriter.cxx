@@ -0,0 +1,106 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+/* AliAO2DTFWriter
+ *
+ * Writes the finished AO2D timeframes in a background thread, see the header for details.
+ */
+
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+
+#include <chrono>
+
+#include "AliAO2DColumnWriter.h"
+#include "AliAO2DTFWriter.h"
+
+AliAO2DTFWriter::AliAO2DTFWriter(TFile *file, Int_t maxQueued, TableReport report)
+    : fFile(file), fMaxQueued(maxQueued > 0 ? maxQueued : 1), fReport(report), fQueue(), fMutex(), fCondition(), fStop(kFALSE), fThread()
+{
+  fThread = std::thread(&AliAO2DTFWriter::Run, this);
+} // AliAO2DTFWriter::AliAO2DTFWriter(TFile *file, Int_t maxQueued, TableReport report)
+
+AliAO2DTFWriter::~AliAO2DTFWriter()
+{
+  Stop();
+} // AliAO2DTFWriter::~AliAO2DTFWriter()
+
+void AliAO2DTFWriter::Push(TF *tf)
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  fCondition.wait(lock, [this] { return (Int_t)fQueue.size() < fMaxQueued; });
+  fQueue.push_back(tf);
+  fCondition.notify_all();
+} // void AliAO2DTFWriter::Push(TF *tf)
+
+void AliAO2DTFWriter::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  fCondition.notify_all();
+  if (fThread.joinable())
+    fThread.join();
+} // void AliAO2DTFWriter::Stop()
+
+void AliAO2DTFWriter::Run()
+{
+  while (true)
+  {
+    TF *tf = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock, [this] { return !fQueue.empty() || fStop; });
+      if (fQueue.empty())
+        return; // Stopped and nothing left to write
+      tf = fQueue.front();
+    }
+    // The TF stays in the queue while it is written, so that it counts in the memory bound
+    Write(tf);
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fQueue.pop_front();
+    }
+    fCondition.notify_all();
+  }
+} // void AliAO2DTFWriter::Run()
+
+void AliAO2DTFWriter::Write(TF *tf)
+{
+  // The directory and the trees are only touched by this thread from now on
+  TDirectory *dir = fFile->mkdir(tf->fDirName);
+  for (Int_t i = 0; i < (Int_t)tf->fTrees.size(); i++)
+  {
+    TTree *tree = tf->fTrees[i];
+    if (!tree)
+      continue;
+    auto start = std::chrono::steady_clock::now();
+    tree->SetDirectory(dir);
+    tf->fColumns->FlushTable(i);
+    dir->cd();
+    tree->Write();
+    Double_t time = std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+    if (fReport)
+      fReport(i, tree, tf->fStageTime[i] + time);
+  }
+  tf->fColumns->WriteCodecs(dir);
+
+  for (auto tree : tf->fTrees)
+    delete tree;
+  delete tf->fColumns;
+  delete tf;
+} // void AliAO2DTFWriter::Write(TF *tf)
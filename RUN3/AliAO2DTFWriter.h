@@ -0,0 +1,66 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliAO2DTFWriter_H
+#define AliAO2DTFWriter_H
+
+/// \class AliAO2DTFWriter
+///
+/// Background writer of the AO2D timeframes.
+/// The event loop stages the rows of a TF in an AliAO2DColumnWriter and hands the
+/// finished TF over to this class. A single thread then creates the TF directory,
+/// encodes, compresses and writes the tables, in the order in which the TFs were
+/// finished, while the event loop already fills the next TF. The number of TFs
+/// waiting to be written is bounded to limit the memory usage.
+
+#include <Rtypes.h>
+#include <TString.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TFile;
+class TTree;
+class AliAO2DColumnWriter;
+
+class AliAO2DTFWriter
+{
+public:
+  struct TF {
+    TString fDirName;                  // Name of the TF directory (DF_<tfId>)
+    std::vector<TTree *> fTrees;       // Output trees, not attached to any directory yet
+    std::vector<Double_t> fStageTime;  // Time spent staging each table in the event loop
+    AliAO2DColumnWriter *fColumns = nullptr; // Staged columns
+  };
+  // Called from the writer thread after each table is written
+  typedef std::function<void(Int_t table, TTree *tree, Double_t time)> TableReport;
+
+  AliAO2DTFWriter(TFile *file, Int_t maxQueued, TableReport report);
+  virtual ~AliAO2DTFWriter();
+
+  void Push(TF *tf); // Queue a finished TF, blocks while maxQueued TFs are waiting
+  void Stop();       // Write the pending TFs and join the writer thread
+
+private:
+  AliAO2DTFWriter(const AliAO2DTFWriter &);            // not implemented
+  AliAO2DTFWriter &operator=(const AliAO2DTFWriter &); // not implemented
+
+  void Run();
+  void Write(TF *tf);
+
+  TFile *fFile;                       // Output file, only accessed by the writer thread
+  Int_t fMaxQueued;                   // Maximum number of TFs waiting to be written
+  TableReport fReport;                // Per table report
+  std::deque<TF *> fQueue;            // Finished TFs, in order
+  std::mutex fMutex;                  // Protects fQueue and fStop
+  std::condition_variable fCondition; // Signals changes of fQueue and fStop
+  Bool_t fStop = kFALSE;              // No more TFs will be pushed
+  std::thread fThread;                // Writer thread
+};
+
+#endif
@@ -25,16 +25,20 @@
 #include <TMath.h>
 #include <TTimeStamp.h>
 #include <TSystem.h>
+#include <TROOT.h>
 #include "AliAnalysisTask.h"
 #include "AliAnalysisManager.h"
 #include "AliESDEvent.h"
 #include "AliESDInputHandler.h"
 #include "AliEMCALGeometry.h"
 #include "AliAnalysisTaskAO2Dconverter.h"
+#include "AliAO2DTFWriter.h"
 #include "AliVHeader.h"
 #include "COMMON/MULTIPLICITY/AliMultSelection.h"
 #include "limits.h"
 
+#include <chrono>
+
 #include "AliESDCaloCells.h"
 #include "AliESDCaloTrigger.h"
 #include "AliESDHeader.h"
@@ -152,6 +156,8 @@ AliAnalysisTaskAO2Dconverter::~AliAnalysisTaskAO2Dconverter()
 {
   fOutputList->Delete();
   delete fOutputList;
+  delete fTFWriter;
+  delete fColumnWriter;
 } // AliAnalysisTaskAO2Dconverter::~AliAnalysisTaskAO2Dconverter()
 
 void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
@@ -250,6 +256,47 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   fOutputList->Add(fCentralityHist);
   fOutputList->Add(fCentralityINT7);
   fOutputList->Add(fHistPileupEvents);
+
+  // Per table report, to compare the output backends on the same input
+  fHistTableRows = new TH1D("tableRows", "Rows per table", kTrees, 0, kTrees);
+  fHistTableTime = new TH1D("tableTime", "Real time per table (s)", kTrees, 0, kTrees);
+  fHistTableTotBytes = new TH1D("tableTotBytes", "Uncompressed bytes per table", kTrees, 0, kTrees);
+  fHistTableZipBytes = new TH1D("tableZipBytes", "Compressed bytes per table", kTrees, 0, kTrees);
+  for (TH1D *h : {fHistTableRows, fHistTableTime, fHistTableTotBytes, fHistTableZipBytes})
+  {
+    for (Int_t i = 0; i < kTrees; i++)
+      h->GetXaxis()->SetBinLabel(i + 1, TreeName[i]);
+    h->SetStats(0);
+    fOutputList->Add(h);
+  }
+
+  // Columnar backend and its codecs
+  if (fColumnarOutput)
+  {
+    fColumnWriter = new AliAO2DColumnWriter(kTrees);
+    fColumnWriter->SetDeltaCodedIndices(fDeltaCodedIndices);
+    TObjArray *settings = fColumnCodecs.Tokenize(";");
+    for (Int_t i = 0; i < settings->GetEntries(); i++)
+    {
+      TObjArray *fields = TString(settings->At(i)->GetName()).Tokenize(":");
+      TString column = fields->At(0)->GetName();
+      Int_t dot = column.Index(".");
+      TString tname = column(0, dot);
+      TString bname = column(dot + 1, column.Length());
+      for (Int_t j = 0; j < kTrees; j++)
+        if (tname.EqualTo(TreeName[j]))
+          fColumnWriter->SetCodec(j, bname, (AliAO2DColumnWriter::ColumnCodec)TString(fields->At(1)->GetName()).Atoi(), (UInt_t)TString(fields->At(2)->GetName()).Atoll());
+      delete fields;
+    }
+    delete settings;
+  }
+
+  // Background writer of the finished TFs
+  if (fPipelinedOutput)
+  {
+    ROOT::EnableThreadSafety(); // the writer thread creates and writes trees
+    fTFWriter = new AliAO2DTFWriter(fOutputFile, fMaxQueuedTFs, [this](Int_t t, TTree *tree, Double_t time) { FillTableReport(t, tree, time); });
+  }
   if (fSkipTPCPileup || fSkipPileup || fUseEventCuts)
     fEventCuts.AddQAplotsToList(fOutputList);
   if (fSkipTPCPileup)
@@ -373,10 +420,40 @@ void AliAnalysisTaskAO2Dconverter::FinishTaskOutput()
 {
   // called at the end of the event loop on the worker
   FinishTF();
+  if (fTFWriter)
+    fTFWriter->Stop(); // Wait for all the TFs to be written
   fOutputFile->Write(); // Do not close the file since this is then re-opened and overwritten by the framework
   AliInfo(Form("Total size of output trees: %lu bytes\n", fBytes));
+  ReportTables();
 }
 
+void AliAnalysisTaskAO2Dconverter::SetColumnCodec(const char *tree, const char *branch, AliAO2DColumnWriter::ColumnCodec codec, UInt_t mask)
+{
+  // Stored as a string to be streamed with the task configuration
+  Bool_t found = kFALSE;
+  for (Int_t i = 0; i < kTrees; i++)
+    found |= TreeName[i].EqualTo(tree);
+  if (!found)
+    AliFatal(Form("Unknown tree %s", tree));
+  fColumnCodecs += TString::Format("%s.%s:%d:%u;", tree, branch, (Int_t)codec, mask);
+} // void AliAnalysisTaskAO2Dconverter::SetColumnCodec(const char *tree, const char *branch, AliAO2DColumnWriter::ColumnCodec codec, UInt_t mask)
+
+void AliAnalysisTaskAO2Dconverter::ReportTables()
+{
+  AliInfo(Form("Output tables (%s backend):", fColumnarOutput ? "columnar" : "TTree"));
+  for (Int_t i = 0; i < kTrees; i++)
+  {
+    Double_t rows = fHistTableRows->GetBinContent(i + 1);
+    if (rows <= 0)
+      continue;
+    Double_t time = fHistTableTime->GetBinContent(i + 1);
+    Double_t totBytes = fHistTableTotBytes->GetBinContent(i + 1);
+    Double_t zipBytes = fHistTableZipBytes->GetBinContent(i + 1);
+    AliInfo(Form("%-20s rows: %12.0f  time: %8.3f s  rate: %10.3g rows/s  %8.2f MB/s  size: %10.0f bytes  compression: %5.2f",
+                 TreeName[i].Data(), rows, time, time > 0 ? rows / time : 0., time > 0 ? totBytes / time / 1.e6 : 0., zipBytes, zipBytes > 0 ? totBytes / zipBytes : 0.));
+  }
+} // void AliAnalysisTaskAO2Dconverter::ReportTables()
+
 void AliAnalysisTaskAO2Dconverter::Terminate(Option_t *)
 {
   // called at the END of the analysis AFTER merging. In grid this is NOT called on the workers
@@ -422,12 +499,21 @@ TTree *AliAnalysisTaskAO2Dconverter::CreateTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
     return 0x0;
-  // Create the tree in the corresponding (TF) directory
-  if (!fOutputDir)
-    AliFatal("No Root subdir|");
-  fOutputDir->cd();
   AliInfo(Form("Creating tree %s\n", TreeName[t].Data()));
-  fTree[t] = new TTree(TreeName[t], TreeTitle[t]);
+  if (fTFWriter)
+  {
+    // The tree is attached to its TF directory by the writer thread
+    TDirectory::TContext context(nullptr);
+    fTree[t] = new TTree(TreeName[t], TreeTitle[t]);
+  }
+  else
+  {
+    // Create the tree in the corresponding (TF) directory
+    if (!fOutputDir)
+      AliFatal("No Root subdir|");
+    fOutputDir->cd();
+    fTree[t] = new TTree(TreeName[t], TreeTitle[t]);
+  }
   fTree[t]->SetAutoFlush(0);
   return fTree[t];
 } // TTree* AliAnalysisTaskAO2Dconverter::CreateTree(TreeIndex t)
@@ -462,7 +548,9 @@ void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
     return;
-  Int_t nbytes = fTree[t]->Fill();
+  auto start = std::chrono::steady_clock::now();
+  Int_t nbytes = fColumnWriter ? fColumnWriter->Stage(t) : fTree[t]->Fill();
+  fTableTime[t] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
   if (nbytes > 0)
     fBytes += nbytes;
 } // void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
@@ -476,9 +564,24 @@ void AliAnalysisTaskAO2Dconverter::WriteTree(TreeIndex t)
     AliFatal("No Root subdir|");
   fOutputDir->cd();
   AliInfo(Form("Writing tree %s\n", TreeName[t].Data()));
+  auto start = std::chrono::steady_clock::now();
+  if (fColumnWriter)
+    fColumnWriter->FlushTable(t);
   fTree[t]->Write();
+  fTableTime[t] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+  FillTableReport(t, fTree[t], fTableTime[t]);
+  fTableTime[t] = 0;
 } // void AliAnalysisTaskAO2Dconverter::WriteTree(TreeIndex t)
 
+void AliAnalysisTaskAO2Dconverter::FillTableReport(Int_t t, TTree *tree, Double_t time)
+{
+  // With the pipelined output this is called by the writer thread only
+  fHistTableRows->Fill(t, tree->GetEntries());
+  fHistTableTime->Fill(t, time);
+  fHistTableTotBytes->Fill(t, tree->GetTotBytes());
+  fHistTableZipBytes->Fill(t, tree->GetZipBytes());
+} // void AliAnalysisTaskAO2Dconverter::FillTableReport(Int_t t, TTree *tree, Double_t time)
+
 void AliAnalysisTaskAO2Dconverter::InitTF(ULong64_t tfId)
 {
   // Reset the event count
@@ -501,7 +604,11 @@ void AliAnalysisTaskAO2Dconverter::InitTF(ULong64_t tfId)
   }
 
   // Create the output directory for the current time frame
-  fOutputDir = fOutputFile->mkdir(Form("DF_%llu", tfId));
+  // With the pipelined output this is done by the writer thread, which owns the output file
+  if (fTFWriter)
+    fTFDirName = Form("DF_%llu", tfId);
+  else
+    fOutputDir = fOutputFile->mkdir(Form("DF_%llu", tfId));
 
   // Associate branches for fEventTree
   TTree *tEvents = CreateTree(kEvents);
@@ -856,6 +963,11 @@ void AliAnalysisTaskAO2Dconverter::InitTF(ULong64_t tfId)
   }
 
   Prune(); //Removing all unwanted branches (if any)
+
+  // The columns are created from the active branches, i.e. after pruning
+  if (fColumnWriter)
+    for (Int_t i = 0; i < kTrees; i++)
+      fColumnWriter->AttachTable(i, fTreeStatus[i] ? fTree[i] : nullptr);
 } // void AliAnalysisTaskAO2Dconverter::InitTF(Int_t tfId)
 
 void AliAnalysisTaskAO2Dconverter::FillEventInTF()
@@ -1962,9 +2074,37 @@ void AliAnalysisTaskAO2Dconverter::FillEventInTF()
 
 void AliAnalysisTaskAO2Dconverter::FinishTF()
 {
+  if (fTFWriter)
+  {
+    // Hand the staged TF over to the writer thread. All the indices in the TF (track -> collision,
+    // cluster -> track, ...) were resolved with the per TF offsets when the rows were staged
+    Bool_t open = kFALSE;
+    for (Int_t i = 0; i < kTrees; i++)
+      open |= (fTree[i] != 0x0);
+    if (!open)
+      return; // No TF opened since the last one was handed over
+    AliAO2DTFWriter::TF *tf = new AliAO2DTFWriter::TF();
+    tf->fDirName = fTFDirName;
+    tf->fColumns = fColumnWriter;
+    for (Int_t i = 0; i < kTrees; i++)
+    {
+      tf->fTrees.push_back(fTreeStatus[i] ? fTree[i] : nullptr);
+      tf->fStageTime.push_back(fTableTime[i]);
+      fTree[i] = 0x0;
+      fTableTime[i] = 0;
+    }
+    fColumnWriter = tf->fColumns->CloneSettings();
+    fTFWriter->Push(tf);
+    return;
+  }
   // Write all trees
   for (Int_t i = 0; i < kTrees; i++)
     WriteTree((TreeIndex)i);
+  if (fColumnWriter)
+  {
+    fColumnWriter->WriteCodecs(fOutputDir);
+    fColumnWriter->Clear();
+  }
   // Remove trees
   for (Int_t i = 0; i < kTrees; i++)
     if (fTree[i])
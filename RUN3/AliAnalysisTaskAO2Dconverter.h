@@ -15,6 +15,10 @@
 
 #include <Rtypes.h>
 
+#include "AliAO2DColumnWriter.h"
+
+class AliAO2DTFWriter;
+
 class AliESDEvent;
 class TFile;
 class TDirectory;
@@ -46,6 +50,21 @@ public:
   virtual void SetMaxBytes(ULong_t nbytes = 100000000) {fMaxBytes = nbytes;}
   void SetEMCALAmplitudeThreshold(Double_t threshold) { fEMCALAmplitudeThreshold = threshold; }
 
+  // Columnar output backend: stage the tables in column buffers and write them in blocks at the end of each TF
+  void SetColumnarOutput(Bool_t columnar = kTRUE) { fColumnarOutput = columnar; }
+  void SetDeltaCodedIndices(Bool_t delta = kTRUE) { fDeltaCodedIndices = delta; }
+  void SetColumnCodec(const char *tree, const char *branch, AliAO2DColumnWriter::ColumnCodec codec, UInt_t mask = 0xFFFFFF00);
+  // Pipelined output: the finished TFs are encoded, compressed and written by a background thread
+  // while the event loop fills the next TF. Implies the columnar backend.
+  // The baskets are compressed in parallel if the caller enabled ROOT::EnableImplicitMT
+  void SetPipelinedOutput(Bool_t pipelined = kTRUE, Int_t maxQueuedTFs = 2)
+  {
+    fPipelinedOutput = pipelined;
+    fMaxQueuedTFs = maxQueuedTFs;
+    if (pipelined)
+      fColumnarOutput = kTRUE;
+  }
+
   static AliAnalysisTaskAO2Dconverter* AddTask(TString suffix = "");
   enum TreeIndex { // Index of the output trees
     kEvents = 0,
@@ -162,6 +181,8 @@ private:
   void InitTF(ULong64_t tfId);           // Initialize output subdir and trees for TF tfId
   void FillEventInTF();
   void FinishTF();
+  void ReportTables(); // Print the per table rows, time and size
+  void FillTableReport(Int_t t, TTree *tree, Double_t time); // Add a written table to the report
 
   // Task configuration variables
   TString fPruneList = "";                // Names of the branches that will not be saved to output file
@@ -525,17 +546,32 @@ private:
   TH1F *fCentralityHist = nullptr; ///! Centrality histogram
   TH1F *fCentralityINT7 = nullptr; ///! Centrality histogram for the INT7 triggers
   TH1I *fHistPileupEvents = nullptr; ///! Counter histogram for pileup events
+  TH1D *fHistTableRows = nullptr; ///! Rows written per table
+  TH1D *fHistTableTime = nullptr; ///! Real time (s) spent filling and writing each table
+  TH1D *fHistTableTotBytes = nullptr; ///! Uncompressed bytes per table
+  TH1D *fHistTableZipBytes = nullptr; ///! Compressed bytes per table
   Double_t fEMCALAmplitudeThreshold = 0.1; ///< EMCAL amplitude threshold (for compression - default: 100 MeV := cluster cell threshold)
 
   /// Byte counter
   ULong_t fBytes = 0; ///! Number of bytes stored in all trees
   ULong_t fMaxBytes = 100000000; ///| Approximative size limit on the total TF output trees
 
+  /// Columnar output
+  Bool_t fColumnarOutput = kFALSE;    /// Use the columnar staging backend instead of filling the trees row by row
+  Bool_t fDeltaCodedIndices = kFALSE; /// Delta coding of the fIndex* columns (columnar backend only)
+  TString fColumnCodecs = "";         /// Per-column codecs, "tree.branch:codec:mask;" (columnar backend only)
+  AliAO2DColumnWriter *fColumnWriter = nullptr; ///! Column buffers of the current TF
+  Double_t fTableTime[kTrees] = {0.}; ///! Time spent in the current TF for each table
+  Bool_t fPipelinedOutput = kFALSE;   /// Write the finished TFs in a background thread
+  Int_t fMaxQueuedTFs = 2;            /// Maximum number of finished TFs in memory waiting to be written
+  AliAO2DTFWriter *fTFWriter = nullptr; ///! Background TF writer
+  TString fTFDirName = "";            ///! Directory name of the current TF (pipelined output)
+
   /// Pointer to the output file
   TFile * fOutputFile = 0x0; ///! Pointer to the output file
   TDirectory * fOutputDir = 0x0; ///! Pointer to the output Root subdirectory
   
-  ClassDef(AliAnalysisTaskAO2Dconverter, 15);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 17);
 };
 
 #endif